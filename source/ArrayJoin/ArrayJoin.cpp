@@ -0,0 +1,309 @@
+#include <cstdio>
+#include <cstring>
+#include "ArrayJoin.h"
+
+/***************
+ * Constructor *
+ ***************/
+
+ArrayJoin::ArrayJoin(Relation *relR, Relation *relS, bool buildOnR,
+    unsigned long long minKey, unsigned long long maxKey,
+    JobScheduler *jobScheduler)
+{
+    this->relR = relR;
+    this->relS = relS;
+    this->buildOnR = buildOnR;
+    this->minKey = minKey;
+    this->maxKey = maxKey;
+    this->jobScheduler = jobScheduler;
+
+    /* The array is created when the join is executed */
+    offsets = NULL;
+    rowIds = NULL;
+}
+
+/**************
+ * Destructor *
+ **************/
+
+ArrayJoin::~ArrayJoin()
+{
+    freeBuild();
+}
+
+/************************************************************
+ * Getter - Returns what the last call of 'executeJoin' did *
+ ************************************************************/
+
+JoinStatistics ArrayJoin::getStatistics() const
+{
+    return statistics;
+}
+
+/*****************************************************************
+ * Determines whether the keys between 'minKey' and 'maxKey' are *
+ *    dense enough for an array join with a build side of the    *
+ *                    given amount of tuples                     *
+ *****************************************************************/
+
+bool ArrayJoin::isDense(unsigned long long minKey, unsigned long long maxKey,
+    unsigned long long tuplesNum)
+{
+    if(tuplesNum == 0 || maxKey < minKey)
+        return false;
+
+    return (maxKey - minKey) < MAX_DENSE_KEYS_PER_TUPLE * tuplesNum;
+}
+
+/****************************************************************
+ * Finds the smallest and the largest key of the given relation *
+ ****************************************************************/
+
+void ArrayJoin::findKeyRange(Relation *relation, unsigned long long *minKey,
+    unsigned long long *maxKey)
+{
+    Tuple *tuples = relation->getTuples();
+    unsigned int tuplesNum = relation->getNumOfTuples();
+
+    *minKey = ~0ULL;
+    *maxKey = 0;
+
+    for(unsigned int i = 0; i < tuplesNum; i++)
+    {
+        unsigned long long key = *((unsigned long long *) tuples[i].getItem());
+
+        if(key < *minKey)
+            *minKey = key;
+
+        if(key > *maxKey)
+            *maxKey = key;
+    }
+}
+
+/***************************************
+ * Creates the array of the build side *
+ ***************************************/
+
+void ArrayJoin::build()
+{
+    Relation *buildRel = buildOnR ? relR : relS;
+    Tuple *tuples = buildRel->getTuples();
+    unsigned int tuplesNum = buildRel->getNumOfTuples();
+    unsigned long long keysNum = maxKey - minKey + 1;
+    unsigned int i;
+
+    /* We count the tuples of every key two positions to the right of
+     * it, so after the prefix sum 'offsets[k + 1]' is where the row IDs
+     * of the key 'k' start. Every row ID that is placed moves it one
+     * position forward, so in the end it is where they finish, which is
+     * exactly where the row IDs of the key 'k + 1' start.
+     */
+    offsets = new unsigned int[keysNum + 2];
+    memset(offsets, 0, (keysNum + 2) * sizeof(unsigned int));
+
+    for(i = 0; i < tuplesNum; i++)
+        offsets[*((unsigned long long *) tuples[i].getItem()) - minKey + 2]++;
+
+    for(unsigned long long k = 2; k < keysNum + 2; k++)
+        offsets[k] += offsets[k - 1];
+
+    rowIds = new unsigned int[tuplesNum];
+
+    for(i = 0; i < tuplesNum; i++)
+    {
+        unsigned long long key = *((unsigned long long *) tuples[i].getItem());
+        rowIds[offsets[key - minKey + 1]++] = tuples[i].getRowId();
+    }
+}
+
+/*************************************
+ * Frees the array of the build side *
+ *************************************/
+
+void ArrayJoin::freeBuild()
+{
+    delete[] offsets;
+    delete[] rowIds;
+
+    offsets = NULL;
+    rowIds = NULL;
+}
+
+/****************************************************************
+ * Probes the array with the given tuples of the probe side and *
+ * deposits the row ID pairs of the matches in the given buffer *
+ ****************************************************************/
+
+void ArrayJoin::probe(Tuple *probeTuples, unsigned int probeTuplesNum,
+    RowIdRelation **result) const
+{
+    unsigned int i;
+    unsigned long long pairsNum = 0;
+
+    /* We count the matches first, so the pairs fit in an exact array */
+    for(i = 0; i < probeTuplesNum; i++)
+    {
+        unsigned long long key = *((unsigned long long *) probeTuples[i].getItem());
+
+        if(key >= minKey && key <= maxKey)
+            pairsNum += offsets[key - minKey + 1] - offsets[key - minKey];
+    }
+
+    RowIdPair *pairs = new RowIdPair[pairsNum];
+    unsigned long long position = 0;
+
+    for(i = 0; i < probeTuplesNum; i++)
+    {
+        unsigned long long key = *((unsigned long long *) probeTuples[i].getItem());
+
+        if(key < minKey || key > maxKey)
+            continue;
+
+        unsigned int probeRowId = probeTuples[i].getRowId();
+        unsigned int end = offsets[key - minKey + 1];
+
+        /* The row ID of 'R' is always the left one of the pair */
+        for(unsigned int j = offsets[key - minKey]; j < end; j++)
+        {
+            pairs[position++] = buildOnR ? RowIdPair(rowIds[j], probeRowId)
+                : RowIdPair(probeRowId, rowIds[j]);
+        }
+    }
+
+    *result = new RowIdRelation(pairs, pairsNum);
+}
+
+/*******************************************************************
+ * Probes the array of the given join with the given tuples of the *
+ *  probe side and deposits the row ID pairs in the given output   *
+ *           buffer (it is used as the routine of a job)           *
+ *******************************************************************/
+
+void ArrayJoin::probeRange(ArrayJoin *join, Tuple *probeTuples,
+    unsigned int probeTuplesNum, RowIdRelation **result)
+{
+    join->probe(probeTuples, probeTuplesNum, result);
+}
+
+/**************************************************************
+ * The routine of a array probe job, which calls 'probeRange' *
+ *             with the fields of the given input             *
+ **************************************************************/
+
+void ArrayJoin::arrayProbeJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    ArrayProbeJobInput *arrayProbeJobInput = (ArrayProbeJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    probeRange(
+        arrayProbeJobInput->join,
+        arrayProbeJobInput->probeTuples,
+        arrayProbeJobInput->probeTuplesNum,
+        arrayProbeJobInput->result
+    );
+}
+
+/*************************************
+ * Executes the Array Join Algorithm *
+ *************************************/
+
+RowIdRelation *ArrayJoin::executeJoin()
+{
+    /* Nothing has been done by this call yet */
+    statistics = JoinStatistics();
+    statistics.algorithm = ArrayJoinAlgorithm;
+
+    Relation *probeRel = buildOnR ? relS : relR;
+    Tuple *probeTuples = probeRel->getTuples();
+    unsigned int probeTuplesNum = probeRel->getNumOfTuples();
+
+    RowIdRelation *result;
+
+    /* An empty build side has no keys to index */
+    if((buildOnR ? relR : relS)->getNumOfTuples() == 0)
+        return new RowIdRelation(NULL, 0);
+
+    build();
+
+    /* Without a job scheduler the probe side is probed at once */
+    if(jobScheduler == NULL || probeTuplesNum == 0)
+    {
+        probe(probeTuples, probeTuplesNum, &result);
+        freeBuild();
+
+        return result;
+    }
+
+    /* Else we split the probe side in a few ranges per thread, which
+     * are probed by different jobs with their own output buffers
+     */
+    unsigned int rangesNum = jobScheduler->getMaxThreads() * ARRAY_PROBE_RANGES_PER_THREAD;
+
+    if(rangesNum > probeTuplesNum)
+        rangesNum = probeTuplesNum;
+
+    RowIdRelation **results = new RowIdRelation*[rangesNum];
+    ArrayProbeJobInput **probeJobInputs = new ArrayProbeJobInput*[rangesNum];
+    Job **probeJobs = new Job*[rangesNum];
+    unsigned int i;
+
+    for(i = 0; i < rangesNum; i++)
+    {
+        unsigned int start = (unsigned int) (((unsigned long long) i * probeTuplesNum) / rangesNum);
+        unsigned int end = (unsigned int) (((unsigned long long) (i + 1) * probeTuplesNum) / rangesNum);
+
+        probeJobInputs[i] = new ArrayProbeJobInput(this, &probeTuples[start],
+            end - start, &results[i]);
+
+        probeJobs[i] = new Job(arrayProbeJob, probeJobInputs[i]);
+
+        jobScheduler->submitJob(probeJobs[i]);
+    }
+
+    jobScheduler->executeAllJobs();
+    jobScheduler->waitAllTasksFinish();
+
+    freeBuild();
+
+    /* We concatenate the output buffers in the order of the ranges */
+    unsigned long long pairsNum = 0;
+
+    for(i = 0; i < rangesNum; i++)
+        pairsNum += results[i]->getNumOfRowIdPairs();
+
+    RowIdPair *pairs = new RowIdPair[pairsNum];
+    unsigned long long position = 0;
+
+    for(i = 0; i < rangesNum; i++)
+    {
+        RowIdPair *rangePairs = results[i]->getRowIdPairs();
+        unsigned long long rangePairsNum = results[i]->getNumOfRowIdPairs();
+
+        for(unsigned long long j = 0; j < rangePairsNum; j++)
+            pairs[position++] = rangePairs[j];
+
+        freeJoinResult(results[i]);
+        delete probeJobs[i];
+        delete probeJobInputs[i];
+    }
+
+    delete[] results;
+    delete[] probeJobInputs;
+    delete[] probeJobs;
+
+    return new RowIdRelation(pairs, pairsNum);
+}
+
+/*****************************************************
+ * Frees the result that was returned by executeJoin *
+ *****************************************************/
+
+void ArrayJoin::freeJoinResult(RowIdRelation *resultOfExecuteJoin)
+{
+    if(resultOfExecuteJoin != NULL)
+    {
+        delete[] resultOfExecuteJoin->getRowIdPairs();
+        delete resultOfExecuteJoin;
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef _ARRAY_JOIN_H_
+#define _ARRAY_JOIN_H_
+
+#include "Relation.h"
+#include "RowIdRelation.h"
+#include "JobScheduler.h"
+#include "PartitionedHashJoin.h"
+
+/* The keys of a relation are dense enough for the array join if the range
+ * between the smallest and the largest key is smaller than this many times
+ * the amount of tuples of the relation
+ */
+#define MAX_DENSE_KEYS_PER_TUPLE 2
+
+/* The amount of ranges of the probe side that are probed by different
+ * jobs per thread
+ */
+#define ARRAY_PROBE_RANGES_PER_THREAD 4
+
+/* The Array Join Algorithm, an alternative to the Partitioned Hash Join
+ * Algorithm with the same result for joins whose build side has dense
+ * keys, like the primary keys 0..N of the dimension tables.
+ *
+ * Instead of a hash table, the build side becomes an array that is
+ * indexed directly by the key minus the smallest key. Since a key may
+ * appear many times, the array is kept in the compressed sparse row
+ * format: 'offsets[k]' is the position in 'rowIds' where the row IDs of
+ * the key 'minKey + k' start and 'offsets[k + 1]' is where they end.
+ * Every tuple of the probe side finds its matches with two lookups.
+ */
+class ArrayJoin {
+
+private:
+
+/* The relations that take part in the join operation */
+    Relation *relR;
+    Relation *relS;
+
+/* Determines whether 'R' is the build side (else 'S' is) */
+    bool buildOnR;
+
+/* The smallest and the largest key of the build side */
+    unsigned long long minKey;
+    unsigned long long maxKey;
+
+/* A job scheduler that we will use for parallel execution
+ * of the probes ('NULL' to execute them serially)
+ */
+    JobScheduler *jobScheduler;
+
+/* The build side in the compressed sparse row format */
+    unsigned int *offsets;
+    unsigned int *rowIds;
+
+/* What the last call of 'executeJoin' did */
+    JoinStatistics statistics;
+
+/* Creates the array of the build side */
+    void build();
+
+/* Frees the array of the build side */
+    void freeBuild();
+
+/* Probes the array with the given tuples of the probe side and
+ * deposits the row ID pairs of the matches in the given buffer
+ */
+    void probe(Tuple *probeTuples, unsigned int probeTuplesNum,
+        RowIdRelation **result) const;
+
+public:
+
+/* Constructor - 'minKey' and 'maxKey' must be the smallest and the largest
+ * key of the build side (see 'findKeyRange')
+ */
+    ArrayJoin(Relation *relR, Relation *relS, bool buildOnR,
+        unsigned long long minKey, unsigned long long maxKey,
+        JobScheduler *jobScheduler = NULL);
+
+/* Destructor */
+    ~ArrayJoin();
+
+/* Getter - Returns what the last call of 'executeJoin' did */
+    JoinStatistics getStatistics() const;
+
+/* Executes the Array Join Algorithm. The result has the same row ID pairs
+ * as the result of the Partitioned Hash Join Algorithm (the row ID of 'R'
+ * is the left one) and it is freed with 'freeJoinResult'.
+ */
+    RowIdRelation *executeJoin();
+
+/* Frees the result that was returned by 'executeJoin' */
+    static void freeJoinResult(RowIdRelation *resultOfExecuteJoin);
+
+/* Determines whether the keys between 'minKey' and 'maxKey' are dense
+ * enough for an array join with a build side of 'tuplesNum' tuples
+ */
+    static bool isDense(unsigned long long minKey, unsigned long long maxKey,
+        unsigned long long tuplesNum);
+
+/* Finds the smallest and the largest key of the given relation */
+    static void findKeyRange(Relation *relation, unsigned long long *minKey,
+        unsigned long long *maxKey);
+
+/* Probes the array of the given join with the given tuples of the probe
+ * side and deposits the row ID pairs in the given output buffer.
+ *
+ * Used by the array probe jobs.
+ */
+    static void probeRange(ArrayJoin *join, Tuple *probeTuples,
+        unsigned int probeTuplesNum, RowIdRelation **result);
+
+/* The routine of a array probe job, which calls 'probeRange' with the
+ * fields of the given input (a 'ArrayProbeJobInput')
+ */
+    static void arrayProbeJob(void *input);
+
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include <cstring>
+#include <climits>
+#include "BloomFilter.h"
+
+/**************************************************************
+ * The odd constants that pick a bit in every word of a block *
+ **************************************************************/
+
+static const unsigned int blockSalts[BLOOM_FILTER_BLOCK_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/***************
+ * Constructor *
+ ***************/
+
+BloomFilter::BloomFilter(unsigned long long expectedKeysNum)
+{
+    /* Every block holds the bits of 'BLOCK_WORDS * 32 / BITS_PER_KEY' keys */
+    unsigned long long keysPerBlock = BLOOM_FILTER_BLOCK_WORDS * 32
+        / BLOOM_FILTER_BITS_PER_KEY;
+
+    blocksNum = (expectedKeysNum + keysPerBlock - 1) / keysPerBlock;
+
+    if(blocksNum == 0)
+        blocksNum = 1;
+
+    blocks = new unsigned int[blocksNum * BLOOM_FILTER_BLOCK_WORDS];
+    memset(blocks, 0, blocksNum * BLOOM_FILTER_BLOCK_WORDS * sizeof(unsigned int));
+
+    /* Initially no key has been inserted, so the range is empty */
+    minKey = ULLONG_MAX;
+    maxKey = 0;
+    keysNum = 0;
+}
+
+/**************
+ * Destructor *
+ **************/
+
+BloomFilter::~BloomFilter()
+{
+    delete[] blocks;
+}
+
+/*************************************
+ * Returns the hash of the given key *
+ *************************************/
+
+unsigned long long BloomFilter::hash(unsigned long long key)
+{
+    /* A multiplicative hash followed by a shift, so the upper and the
+     * lower half of the result both depend on all the bits of the key
+     */
+    unsigned long long keyHash = key * 0x9e3779b97f4a7c15ULL;
+    return keyHash ^ (keyHash >> 29);
+}
+
+/***************************************
+ * Returns the block of the given hash *
+ ***************************************/
+
+unsigned int *BloomFilter::getBlock(unsigned long long keyHash) const
+{
+    /* The upper 32 bits of the hash are mapped to [0, blocksNum) */
+    unsigned long long block = ((keyHash >> 32) * blocksNum) >> 32;
+    return blocks + block * BLOOM_FILTER_BLOCK_WORDS;
+}
+
+/***************************************
+ * Inserts the given key in the filter *
+ ***************************************/
+
+void BloomFilter::insert(unsigned long long key)
+{
+    unsigned long long keyHash = hash(key);
+    unsigned int *block = getBlock(keyHash);
+
+    /* The lower 32 bits of the hash pick one bit in every word */
+    unsigned int lowerHash = (unsigned int) keyHash;
+
+    for(unsigned int i = 0; i < BLOOM_FILTER_BLOCK_WORDS; i++)
+        block[i] |= 1U << ((lowerHash * blockSalts[i]) >> 27);
+
+    /* We extend the range of the inserted keys */
+    if(key < minKey) minKey = key;
+    if(key > maxKey) maxKey = key;
+
+    keysNum++;
+}
+
+/********************************************************************
+ * Returns 'false' if the given key has certainly not been inserted *
+ ********************************************************************/
+
+bool BloomFilter::mayContain(unsigned long long key) const
+{
+    /* A key outside the range of the inserted keys has not been inserted */
+    if(key < minKey || key > maxKey)
+        return false;
+
+    unsigned long long keyHash = hash(key);
+    const unsigned int *block = getBlock(keyHash);
+    unsigned int lowerHash = (unsigned int) keyHash;
+
+    /* Every bit the key would have set must be set */
+    for(unsigned int i = 0; i < BLOOM_FILTER_BLOCK_WORDS; i++)
+    {
+        if(!(block[i] & (1U << ((lowerHash * blockSalts[i]) >> 27))))
+            return false;
+    }
+
+    return true;
+}
+
+/**********************************************
+ * Getter - Returns the smallest inserted key *
+ **********************************************/
+
+unsigned long long BloomFilter::getMinKey() const
+{
+    return minKey;
+}
+
+/*********************************************
+ * Getter - Returns the largest inserted key *
+ *********************************************/
+
+unsigned long long BloomFilter::getMaxKey() const
+{
+    return maxKey;
+}
+
+/************************************************
+ * Getter - Returns the amount of inserted keys *
+ ************************************************/
+
+unsigned long long BloomFilter::getKeysNum() const
+{
+    return keysNum;
+}
+
+/************************************************************
+ * Getter - Returns the amount of bytes the filter occupies *
+ ************************************************************/
+
+unsigned long long BloomFilter::getSizeInBytes() const
+{
+    return blocksNum * BLOOM_FILTER_BLOCK_WORDS * sizeof(unsigned int);
+}
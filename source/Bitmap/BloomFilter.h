@@ -0,0 +1,71 @@
+#ifndef _BLOOM_FILTER_H_
+#define _BLOOM_FILTER_H_
+
+/* The amount of bits of the filter per inserted key */
+#define BLOOM_FILTER_BITS_PER_KEY 16
+
+/* The amount of 32-bit words of every block of the filter (a block
+ * is 32 bytes, so every lookup touches a single cache line)
+ */
+#define BLOOM_FILTER_BLOCK_WORDS 8
+
+/* A blocked Bloom filter of 64-bit keys, along with the smallest and the
+ * largest inserted key.
+ *
+ * Every key is hashed to a single block of the filter and sets one bit in
+ * each of the words of that block, so an insertion or a lookup costs a
+ * single cache miss. A lookup that returns 'false' means the key has
+ * certainly not been inserted, while 'true' may be a false positive (about
+ * 1 in 1000 keys with the default bits per key). Keys outside the range
+ * of the inserted keys are rejected without touching the filter.
+ */
+class BloomFilter {
+
+private:
+
+    /* The blocks of the filter */
+    unsigned int *blocks;
+
+    /* The amount of blocks of the filter */
+    unsigned long long blocksNum;
+
+    /* The smallest and the largest inserted key */
+    unsigned long long minKey;
+    unsigned long long maxKey;
+
+    /* The amount of inserted keys */
+    unsigned long long keysNum;
+
+    /* Returns the hash of the given key */
+    static unsigned long long hash(unsigned long long key);
+
+    /* Returns the block of the given hash */
+    unsigned int *getBlock(unsigned long long keyHash) const;
+
+public:
+
+    /* Constructor - Creates an empty filter sized for the given amount of keys */
+    BloomFilter(unsigned long long expectedKeysNum);
+
+    /* Destructor */
+    ~BloomFilter();
+
+    /* Inserts the given key in the filter */
+    void insert(unsigned long long key);
+
+    /* Returns 'false' if the given key has certainly not been inserted */
+    bool mayContain(unsigned long long key) const;
+
+    /* Getters - Return the smallest and the largest inserted key */
+    unsigned long long getMinKey() const;
+    unsigned long long getMaxKey() const;
+
+    /* Getter - Returns the amount of inserted keys */
+    unsigned long long getKeysNum() const;
+
+    /* Getter - Returns the amount of bytes the filter occupies */
+    unsigned long long getSizeInBytes() const;
+
+};
+
+#endif
@@ -1,7 +1,42 @@
 #include <iostream>
 #include <climits>
+#include <cstdlib>
+#include <cmath>
 #include "ColumnStatistics.h"
 
+/*********************************************************************
+ * Produces the next number of a pseudo-random sequence (xorshift64) *
+ *********************************************************************/
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    /* We scramble the bits of the current state */
+    (*state) ^= (*state) << 13;
+    (*state) ^= (*state) >> 7;
+    (*state) ^= (*state) << 17;
+
+    /* The new state is the produced number */
+    return (*state);
+}
+
+/****************************************************************
+ * Compares two elements of a sample (used for sorting samples) *
+ ****************************************************************/
+
+static int compareSampleElements(const void *item1, const void *item2)
+{
+    unsigned long long element1 = *((const unsigned long long *) item1);
+    unsigned long long element2 = *((const unsigned long long *) item2);
+
+    if(element1 < element2)
+        return -1;
+
+    if(element1 > element2)
+        return 1;
+
+    return 0;
+}
+
 /***************
  * Constructor *
  ***************/
@@ -98,6 +133,186 @@ ColumnStatistics::ColumnStatistics(
     }
 }
 
+/*****************************************
+ * Constructor - Computes the statistics *
+ *      from a sample of the column      *
+ *****************************************/
+
+ColumnStatistics::ColumnStatistics(
+    unsigned long long *column,
+    unsigned long long size,
+    unsigned long long maxBitmapSize,
+    StatisticsSampling sampling,
+    unsigned long long sampleSize,
+    unsigned long long blockSize)
+{
+    /* Auxiliary variables (used for counting) */
+    unsigned long long i, j;
+
+    /* The number of elements in the column is the given size.
+     * This is known without visiting the column at all.
+     */
+    elementsNum = size;
+
+    /* If the column is empty, there is nothing to sample */
+    if(size == 0)
+    {
+        minElement = 0;
+        maxElement = 0;
+        distinctElementsNum = 0;
+        return;
+    }
+
+    /* A sample larger than the column makes no sense */
+    if(sampleSize == 0 || sampleSize > size)
+        sampleSize = size;
+
+    /* A block must have at least one row and at most the whole column */
+    if(blockSize == 0)
+        blockSize = 1;
+
+    if(blockSize > size)
+        blockSize = size;
+
+    /* We will store the sampled elements here. In case of block
+     * sampling we may gather a bit more than 'sampleSize' rows
+     * because only whole blocks are picked, so we reserve space
+     * for one extra block.
+     */
+    unsigned long long *sample = new unsigned long long[sampleSize + blockSize];
+
+    /* The amount of elements that have been gathered in the sample */
+    unsigned long long sampledNum = 0;
+
+    /* The state of the pseudo-random generator. We seed it with the size
+     * of the column, so the same column always yields the same statistics.
+     */
+    unsigned long long randomState = size * 2654435761ULL + 1;
+
+    /* Case we pick single rows uniformly */
+    if(sampling == UniformSampling)
+    {
+        /* We divide the column in 'sampleSize' equal strata and we pick a
+         * random row from each one. This way no row is picked twice and
+         * the sample is spread evenly over the whole column.
+         */
+        for(i = 0; i < sampleSize; i++)
+        {
+            /* The first and the last row of the current stratum */
+            unsigned long long stratumStart = (i * size) / sampleSize;
+            unsigned long long stratumEnd = ((i + 1) * size) / sampleSize;
+
+            /* We pick a random row of the stratum */
+            unsigned long long pickedRow = stratumStart
+                + nextRandom(&randomState) % (stratumEnd - stratumStart);
+
+            /* We store the element of the picked row in the sample */
+            sample[sampledNum++] = column[pickedRow];
+        }
+    }
+
+    /* Case we pick whole blocks of consecutive rows */
+    else
+    {
+        /* The number of blocks of the column (the last may be partial) */
+        unsigned long long blocksNum = (size + blockSize - 1) / blockSize;
+
+        /* The number of blocks we need to gather 'sampleSize' rows */
+        unsigned long long pickedBlocksNum = (sampleSize + blockSize - 1) / blockSize;
+
+        if(pickedBlocksNum > blocksNum)
+            pickedBlocksNum = blocksNum;
+
+        /* Just like above, we divide the blocks in equal strata
+         * and we pick a random whole block from each stratum
+         */
+        for(i = 0; i < pickedBlocksNum; i++)
+        {
+            /* The first and the last block of the current stratum */
+            unsigned long long stratumStart = (i * blocksNum) / pickedBlocksNum;
+            unsigned long long stratumEnd = ((i + 1) * blocksNum) / pickedBlocksNum;
+
+            /* We pick a random block of the stratum */
+            unsigned long long pickedBlock = stratumStart
+                + nextRandom(&randomState) % (stratumEnd - stratumStart);
+
+            /* The first and the last row of the picked block */
+            unsigned long long blockStart = pickedBlock * blockSize;
+            unsigned long long blockEnd = blockStart + blockSize;
+
+            if(blockEnd > size)
+                blockEnd = size;
+
+            /* We store all the elements of the block in the sample */
+            for(j = blockStart; j < blockEnd && sampledNum < sampleSize + blockSize; j++)
+                sample[sampledNum++] = column[j];
+        }
+    }
+
+    /* We sort the sample, so equal elements become adjacent.
+     * Then the min & max elements are at the edges of the sample.
+     */
+    qsort(sample, sampledNum, sizeof(unsigned long long), compareSampleElements);
+
+    minElement = sample[0];
+    maxElement = sample[sampledNum - 1];
+
+    /* We count the distinct elements of the sample ('d') and how
+     * many of them appear exactly once in the sample ('f1')
+     */
+    unsigned long long sampleDistincts = 0;
+    unsigned long long appearingOnce = 0;
+
+    for(i = 0; i < sampledNum; i = j)
+    {
+        /* We skip all the repetitions of the current element */
+        for(j = i + 1; j < sampledNum && sample[j] == sample[i]; j++);
+
+        /* One more distinct element was found in the sample */
+        sampleDistincts++;
+
+        /* If it has not been repeated, it appears once */
+        if(j - i == 1)
+            appearingOnce++;
+    }
+
+    /* We do not need the sample anymore */
+    delete[] sample;
+
+    /* We scale the distinct elements of the sample up to the whole column
+     * with the estimator of Haas & Stokes, that is:
+     *
+     *     D = n * d / (n - f1 + f1 * n / N)
+     *
+     * where 'n' is the size of the sample and 'N' the size of the column.
+     * If every sampled element is unique, the column is estimated to be
+     * unique as well, while if every sampled element has been repeated,
+     * the column is estimated to have no more distinct elements than the
+     * sample. Since the rows of a sample are not repeated, when the sample
+     * covers the whole column the estimation is exact.
+     */
+    double n = (double) sampledNum;
+    double N = (double) size;
+    double estimation = (n * (double) sampleDistincts)
+        / (n - (double) appearingOnce + (double) appearingOnce * n / N);
+
+    distinctElementsNum = (unsigned long long) llround(estimation);
+
+    /* The estimation may not be less than the distincts of the sample
+     * or more than the elements of the column. Also, the full scan can
+     * never count more distinct elements than the bits of its bitmap,
+     * so we apply the same limit here for the statistics to be comparable.
+     */
+    if(distinctElementsNum < sampleDistincts)
+        distinctElementsNum = sampleDistincts;
+
+    if(distinctElementsNum > size)
+        distinctElementsNum = size;
+
+    if(distinctElementsNum > maxBitmapSize)
+        distinctElementsNum = maxBitmapSize;
+}
+
 /*************************
  * Secondary Constructor *
  *************************/
@@ -2,6 +2,7 @@
 #define _COLUMN_STATISTICS_H_
 
 #include "Bitmap.h"
+#include "StatisticsSampling.h"
 
 class ColumnStatistics {
 
@@ -25,6 +26,19 @@ public:
     ColumnStatistics(unsigned long long *column, unsigned long long size,
         unsigned long long maxBitmapSize);
 
+    /* Constructor - Computes the statistics from a sample of the column
+     *
+     * With uniform sampling 'sampleSize' rows are picked, one from each of
+     * 'sampleSize' equal strata of the column. With block sampling whole
+     * blocks of 'blockSize' consecutive rows are picked until at least
+     * 'sampleSize' rows have been gathered. The min & max elements are the
+     * ones of the sample and the amount of distinct elements is scaled up
+     * to the whole column with the estimator of Haas & Stokes.
+     */
+    ColumnStatistics(unsigned long long *column, unsigned long long size,
+        unsigned long long maxBitmapSize, StatisticsSampling sampling,
+        unsigned long long sampleSize, unsigned long long blockSize);
+
     /* Secondary Constructor */
     ColumnStatistics(unsigned long long minElement = 0, unsigned long long maxElement = 0,
         unsigned long long elementsNum = 0, unsigned long long distinctElementsNum = 0);
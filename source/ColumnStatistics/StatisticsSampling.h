@@ -0,0 +1,25 @@
+#ifndef _STATISTICS_SAMPLING_H_
+#define _STATISTICS_SAMPLING_H_
+
+/* An enumeration with all the ways the statistics of a column may be computed */
+
+enum StatisticsSampling {
+
+	/* Every row of the column is visited to compute the statistics */
+	NoSampling,
+
+	/* The column is divided in as many equal strata as the size of
+	 * the sample and a single random row is picked from each stratum
+	 */
+	UniformSampling,
+
+	/* The column is divided in blocks of consecutive rows and the
+	 * rows of randomly picked whole blocks form the sample. This is
+	 * cheaper to read than a uniform sample, but it is less accurate
+	 * when the values of the column are clustered.
+	 */
+	BlockSampling
+
+};
+
+#endif
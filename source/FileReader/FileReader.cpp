@@ -109,6 +109,148 @@ static int* line_to_array(std::string text)
     return array;
 }
 
+/************************************************************************
+ * Reads the value of the option in the given line of the configuration *
+ *   file (everything after the '=' symbol) and copies it to 'value'.   *
+ *   Returns 'false' if the file has no such line or the line has no    *
+ *    '=' symbol. The 'value' buffer must hold 'messageLength' bytes    *
+ ************************************************************************/
+
+static bool readOptionValue(const char *config_file, unsigned int line, char *value)
+{
+    /* We open the configuration file */
+
+	int fd = open(config_file, O_RDONLY);
+
+	/* We examine if the opening was successful */
+
+	if(fd == -1)
+	{
+		printf("Error opening \"%s\"\n", config_file);
+		perror("open");
+		return false;
+	}
+
+	/* We prepare the variables we will need to read the file */
+
+	char read_char = 0;
+	char buf[messageLength];
+	unsigned int i = 0;
+	unsigned int currentLine = 1;
+	bool found = false;
+
+	/* We read the file character by character until the requested
+	 * line has been read completely or the end of file is reached
+	 */
+
+	while(read(fd, &read_char, 1) > 0)
+	{
+		/* If the read character is not a new line, we store it in the
+		 * buffer (only if it belongs to the requested line) and continue
+		 */
+
+		if(read_char != '\n')
+		{
+			if(currentLine == line && i < messageLength - 1)
+				buf[i++] = read_char;
+
+			continue;
+		}
+
+		/* If the requested line has just been read, we stop reading */
+
+		if(currentLine == line)
+		{
+			buf[i] = '\0';
+			found = true;
+			break;
+		}
+
+		/* Else we proceed to the next line */
+		currentLine++;
+	}
+
+	/* We close the opened configuration file */
+
+	int close_result = close(fd);
+
+	/* We examine if the closing of the file was successful */
+
+	if(close_result == -1)
+	{
+		printf("Error closing \"%s\"\n", config_file);
+		perror("close");
+	}
+
+	/* If the line was not found, there is no value to return */
+
+	if(!found)
+		return false;
+
+	/* We search for the '=' symbol in the line */
+
+	char *optionValue = strchr(buf, '=');
+
+	/* If the line has no '=' symbol, it does not describe an option */
+
+	if(optionValue == NULL)
+		return false;
+
+	/* We copy everything after the '=' symbol to the given buffer */
+
+	strcpy(value, optionValue + 1);
+
+	return true;
+}
+
+/**************************************************************************
+ * Builds the secondary indexes of the columns of the given relation that *
+ *  appear in the hints (a space-separated list of <relation>.<column>)   *
+ **************************************************************************/
+
+static void buildHintedIndexes(Table *table, unsigned int relation, const char *hints)
+{
+    /* We will traverse the hints one by one */
+    const char *currentHint = hints;
+
+    while(*currentHint != '\0')
+    {
+        /* We skip any spaces before the hint */
+
+        if(*currentHint == ' ')
+        {
+            currentHint++;
+            continue;
+        }
+
+        /* We parse the relation and the column of the hint */
+        char *parsingStopPoint;
+
+        unsigned long hintedRelation = strtoul(currentHint, &parsingStopPoint, 10);
+        unsigned long hintedColumn = 0;
+        bool validHint = (*parsingStopPoint == '.');
+
+        if(validHint)
+            hintedColumn = strtoul(parsingStopPoint + 1, &parsingStopPoint, 10);
+
+        /* If the hint refers to an existing column of this relation,
+         * we build the index of that column
+         */
+        if(validHint && hintedRelation == relation && hintedColumn < table->getNumOfColumns())
+            table->buildColumnIndex(hintedColumn);
+
+        /* We proceed to the next hint */
+
+        if(parsingStopPoint == currentHint)
+            parsingStopPoint++;
+
+        currentHint = parsingStopPoint;
+
+        while(*currentHint != ' ' && *currentHint != '\0')
+            currentHint++;
+    }
+}
+
 /*********************************************************************
  *  Reads the "init" file that contains all the relation names that  *
  * will take part in the follow-up queries. Then it reads the binary *
@@ -133,6 +275,48 @@ List *FileReader::readInitFile(const char *init_file, const char *config_file)
         readMaxBitmapSize(config_file, &maxBitmapSize);
     }
 
+    /* We read whether the statistics of each column will be computed
+     * from a sample of the column. By default, every row is visited.
+     */
+    StatisticsSampling sampling = NoSampling;
+    unsigned long long sampleSize = 0;
+    unsigned long long blockSize = 0;
+    bool refineInBackground = false;
+
+    if(config_file != NULL) {
+        readStatisticsSampling(config_file, &sampling, &sampleSize,
+            &blockSize, &refineInBackground);
+    }
+
+    /* We read whether the columns of each table will be compressed.
+     * By default, the columns are not compressed.
+     */
+    bool compressColumns = false;
+    unsigned long long maxDictionarySize = 0;
+
+    if(config_file != NULL) {
+        readColumnCompression(config_file, &compressColumns, &maxDictionarySize);
+    }
+
+    /* We read the amount of rows of each block of the zone maps.
+     * By default, no zone maps are built.
+     */
+    unsigned long long zoneMapBlockSize = 0;
+
+    if(config_file != NULL) {
+        readZoneMapBlockSize(config_file, &zoneMapBlockSize);
+    }
+
+    /* We read whether the secondary indexes of the columns will be built
+     * on their first use and which indexes will be built right now
+     */
+    bool buildIndexesOnFirstUse = false;
+    char *indexHints = NULL;
+
+    if(config_file != NULL) {
+        readColumnIndexes(config_file, &buildIndexesOnFirstUse, &indexHints);
+    }
+
 	/* We read the dataset type from the configuration file */
 
 	char *dataset;
@@ -224,7 +408,24 @@ List *FileReader::readInitFile(const char *init_file, const char *config_file)
         sprintf(currentBinaryFilename, "../input/%s/%s", dataset, buf);
 
         /* We create a new Table giving it the binary file as input */
-        Table *new_table = new Table(currentBinaryFilename, maxBitmapSize);
+        Table *new_table = new Table(currentBinaryFilename, maxBitmapSize,
+            sampling, sampleSize, blockSize, refineInBackground);
+
+        /* If requested, we build the zone maps of the new table */
+        if(zoneMapBlockSize > 0)
+            new_table->buildZoneMaps(zoneMapBlockSize);
+
+        /* If requested, we compress the columns of the new table */
+        if(compressColumns)
+            new_table->compress(maxDictionarySize);
+
+        /* We build the hinted indexes of the new table (its relation
+         * name is its position in the file, starting from zero)
+         */
+        new_table->setBuildIndexesOnFirstUse(buildIndexesOnFirstUse);
+
+        if(indexHints != NULL)
+            buildHintedIndexes(new_table, currentLine - 1, indexHints);
 
         /* We store the new Table we just created in the list */
         relations->insertLast(new_table);
@@ -249,6 +450,11 @@ List *FileReader::readInitFile(const char *init_file, const char *config_file)
 
     free(dataset);
 
+    /* We free the allocated memory for the index hints */
+
+    if(indexHints != NULL)
+        free(indexHints);
+
     /* Finally we return the list of Tables of each relation */
 
     return relations;
@@ -1390,3 +1596,347 @@ void FileReader::readDataset(const char *config_file, char **result)
 		perror("close");
 	}
 }
+
+/********************************************************************
+ * Reads the options that determine whether the statistics of every *
+ *   column are computed from a sample of the column and how the    *
+ *           sample is picked from the rows of the column           *
+ ********************************************************************/
+
+void FileReader::readStatisticsSampling(
+    const char *config_file,
+    StatisticsSampling *sampling,
+    unsigned long long *sampleSize,
+    unsigned long long *blockSize,
+    bool *refineInBackground)
+{
+    /* A buffer where the value of each option will be stored */
+    char value[messageLength];
+
+    /* In the 70th line we read the way the statistics will be computed */
+
+    if(readOptionValue(config_file, 70, value))
+    {
+        if(!strcmp(value, "uniform"))
+            (*sampling) = UniformSampling;
+
+        else if(!strcmp(value, "block"))
+            (*sampling) = BlockSampling;
+
+        else
+            (*sampling) = NoSampling;
+    }
+
+    /* In the 75th line we read the amount of rows of each sample */
+
+    if(readOptionValue(config_file, 75, value))
+        (*sampleSize) = strtoull(value, NULL, 10);
+
+    /* In the 79th line we read the amount of rows of each sampled block */
+
+    if(readOptionValue(config_file, 79, value))
+        (*blockSize) = strtoull(value, NULL, 10);
+
+    /* In the 82nd line we read whether the sampled
+     * statistics will be refined in the background
+     */
+    if(readOptionValue(config_file, 82, value))
+        (*refineInBackground) = (!strcmp(value, "yes")) ? true : false;
+}
+
+/*****************************************************************
+ * Reads the options that determine whether the columns of every *
+ * table are stored compressed and which columns may be encoded  *
+ *                       with a dictionary                       *
+ *****************************************************************/
+
+void FileReader::readColumnCompression(
+    const char *config_file,
+    bool *compressColumns,
+    unsigned long long *maxDictionarySize)
+{
+    /* A buffer where the value of each option will be stored */
+    char value[messageLength];
+
+    /* In the 86th line we read whether the columns will be compressed */
+
+    if(readOptionValue(config_file, 86, value))
+        (*compressColumns) = (!strcmp(value, "yes")) ? true : false;
+
+    /* In the 91st line we read the maximum size of each dictionary */
+
+    if(readOptionValue(config_file, 91, value))
+        (*maxDictionarySize) = strtoull(value, NULL, 10);
+}
+
+/***********************************************************************
+ * Reads the amount of consecutive rows of each block of the zone maps *
+ ***********************************************************************/
+
+void FileReader::readZoneMapBlockSize(const char *config_file, unsigned long long *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 95th line we read the amount of rows of each block */
+
+    if(readOptionValue(config_file, 95, value))
+        (*result) = strtoull(value, NULL, 10);
+}
+
+/***********************************************************************
+ * Reads whether the secondary index of a column is built on its first *
+ *  use and the list of columns whose indexes are built at load time   *
+ ***********************************************************************/
+
+void FileReader::readColumnIndexes(
+    const char *config_file,
+    bool *buildOnFirstUse,
+    char **hints)
+{
+    /* A buffer where the value of each option will be stored */
+    char value[messageLength];
+
+    /* In the 100th line we read whether indexes are built on first use */
+
+    if(readOptionValue(config_file, 100, value))
+        (*buildOnFirstUse) = (!strcmp(value, "yes")) ? true : false;
+
+    /* In the 105th line we read the hinted columns */
+
+    if(readOptionValue(config_file, 105, value))
+    {
+        (*hints) = (char *) malloc(1 + strlen(value));
+        strcpy((*hints), value);
+    }
+}
+
+/*********************************************************
+ * Reads the amount of megabytes the cached build sides  *
+ *             of the hash joins may occupy              *
+ *********************************************************/
+
+void FileReader::readBuildSideCacheSize(const char *config_file, unsigned long long *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 110th line we read the budget of the cache in megabytes */
+
+    if(readOptionValue(config_file, 110, value))
+        (*result) = strtoull(value, NULL, 10);
+}
+
+/**********************************************************
+ * Reads the maximum amount of join orders the plan cache *
+ *  may keep (zero means the join orders are not cached)  *
+ **********************************************************/
+
+void FileReader::readPlanCacheSize(const char *config_file, unsigned int *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 116th line we read the maximum amount of cached join orders */
+
+    if(readOptionValue(config_file, 116, value))
+        (*result) = strtoul(value, NULL, 10);
+}
+
+/***********************************************************************
+ * Reads how the query optimizer estimates the cost of the join orders *
+ ***********************************************************************/
+
+void FileReader::readCostModel(const char *config_file, CostModelType *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 122nd line we read the type of the cost model */
+
+    if(readOptionValue(config_file, 122, value))
+    {
+        if(!strcmp(value, "operators"))
+            (*result) = OperatorCostModel;
+
+        else if(!strcmp(value, "calibrated"))
+            (*result) = CalibratedCostModel;
+
+        else
+            (*result) = CardinalityCostModel;
+    }
+}
+
+/***********************************************************
+ * Reads the factor by which the actual rows of a join may *
+ *   differ from the estimated ones before the remaining   *
+ *         joins are reordered (zero means never)          *
+ ***********************************************************/
+
+void FileReader::readReoptimizationFactor(const char *config_file, double *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 129th line we read the factor of the re-optimization */
+
+    if(readOptionValue(config_file, 129, value))
+        (*result) = strtod(value, NULL);
+}
+
+/**************************************************************
+ * Reads the maximum amount of predicate shapes whose actual  *
+ * rows correct the estimations of the optimizer and the file *
+ *       the corrections are kept in between executions       *
+ **************************************************************/
+
+void FileReader::readCardinalityFeedback(
+    const char *config_file,
+    unsigned int *maxEntriesNum,
+    char **feedbackFile)
+{
+    /* A buffer where the value of each option will be stored */
+    char value[messageLength];
+
+    /* In the 135th line we read the maximum amount of corrections */
+
+    if(readOptionValue(config_file, 135, value))
+        (*maxEntriesNum) = strtoul(value, NULL, 10);
+
+    /* In the 141st line we read the file of the corrections */
+
+    if(readOptionValue(config_file, 141, value) && value[0] != '\0')
+    {
+        (*feedbackFile) = (char *) malloc(1 + strlen(value));
+        strcpy((*feedbackFile), value);
+    }
+}
+
+/**************************************************************************
+ * Reads the minimum ratio between the rows of the larger and the smaller *
+ * input of a hash join for the keys of the smaller input to be passed to *
+ *         the larger one (zero means the keys are never passed)          *
+ **************************************************************************/
+
+void FileReader::readSidewaysFilterRatio(const char *config_file, unsigned int *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 146th line we read the ratio of the sideways filters */
+
+    if(readOptionValue(config_file, 146, value))
+        (*result) = strtoul(value, NULL, 10);
+}
+
+/**************************************************************
+ * Reads whether the plans of the queries are printed and how *
+ **************************************************************/
+
+void FileReader::readExplainMode(const char *config_file, ExplainMode *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 153rd line we read how the plans are explained */
+
+    if(readOptionValue(config_file, 153, value))
+    {
+        if(!strcmp(value, "plan"))
+            (*result) = PlanExplain;
+
+        else if(!strcmp(value, "analyze"))
+            (*result) = AnalyzeExplain;
+
+        else
+            (*result) = NoExplain;
+    }
+}
+
+/*******************************************************
+ * Reads the minimum share of the rows of a join input *
+ *    that makes a key be joined as a heavy hitter     *
+ *******************************************************/
+
+void FileReader::readHeavyHitterShare(const char *config_file, double *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 159th line we read the share of the heavy hitters */
+
+    if(readOptionValue(config_file, 159, value))
+        (*result) = strtod(value, NULL);
+}
+
+/**********************************************************************
+ * Reads the hash function that partitions the relations of the joins *
+ **********************************************************************/
+
+void FileReader::readHashFunction(const char *config_file, HashFunctionType *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 166th line we read the hash function */
+
+    if(readOptionValue(config_file, 166, value))
+    {
+        if(!strcmp(value, "bits"))
+            (*result) = BitsHash;
+
+        else if(!strcmp(value, "fibonacci"))
+            (*result) = FibonacciHash;
+
+        else if(!strcmp(value, "murmur"))
+            (*result) = MurmurHash;
+
+        else if(!strcmp(value, "crc32"))
+            (*result) = Crc32Hash;
+
+        else
+            (*result) = AutoHash;
+    }
+}
+
+/*********************************************************************
+ * Reads whether the partitions of the joins are tuned automatically *
+ *********************************************************************/
+
+void FileReader::readPartitionTuning(const char *config_file, bool *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 174th line we read how the partitions are tuned */
+
+    if(readOptionValue(config_file, 174, value))
+        (*result) = !strcmp(value, "auto");
+}
+
+/**************************************************************
+ * Reads the algorithm that executes the joins of the queries *
+ **************************************************************/
+
+void FileReader::readJoinAlgorithm(const char *config_file, JoinAlgorithmType *result)
+{
+    /* A buffer where the value of the option will be stored */
+    char value[messageLength];
+
+    /* In the 182nd line we read the join algorithm */
+
+    if(readOptionValue(config_file, 182, value))
+    {
+        if(!strcmp(value, "hash"))
+            (*result) = HashJoinAlgorithm;
+
+        else if(!strcmp(value, "sortmerge"))
+            (*result) = SortMergeJoinAlgorithm;
+
+        else if(!strcmp(value, "array"))
+            (*result) = ArrayJoinAlgorithm;
+
+        else
+            (*result) = AutoJoinAlgorithm;
+    }
+}
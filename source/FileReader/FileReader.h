@@ -4,6 +4,10 @@
 #include "Relation.h"
 #include "Table.h"
 #include "Query.h"
+#include "CostModelType.h"
+#include "ExplainMode.h"
+#include "HashFunctionType.h"
+#include "JoinAlgorithmType.h"
 
 /* A namespace with operations that read data from the
  * input files and the configuration file of the program
@@ -68,6 +72,93 @@ void readMaxBitmapSize(const char *config_file, unsigned int *result);
 /* Reads the type of input dataset that will be used as input */
 void readDataset(const char *config_file, char **result);
 
+/* Reads the options that determine whether the statistics of every
+ * column are computed from a sample of the column and how the sample
+ * is picked from the rows of the column. Options that are missing from
+ * the configuration file leave the given addresses untouched.
+ */
+void readStatisticsSampling(
+    const char *config_file,
+    StatisticsSampling *sampling,
+    unsigned long long *sampleSize,
+    unsigned long long *blockSize,
+    bool *refineInBackground
+);
+
+/* Reads the options that determine whether the columns of every table
+ * are stored compressed and which columns may be encoded with a dictionary.
+ * Options that are missing from the configuration file leave the given
+ * addresses untouched.
+ */
+void readColumnCompression(
+    const char *config_file,
+    bool *compressColumns,
+    unsigned long long *maxDictionarySize
+);
+
+/* Reads the amount of consecutive rows of each block for which the min
+ * and max element of every column are kept (zero means no zone maps)
+ */
+void readZoneMapBlockSize(const char *config_file, unsigned long long *result);
+
+/* Reads whether the secondary index of a column is built the first time it
+ * is needed and the space-separated list of <relation>.<column> whose indexes
+ * are built when the tables are loaded. The list is allocated with 'malloc'.
+ */
+void readColumnIndexes(const char *config_file, bool *buildOnFirstUse, char **hints);
+
+/* Reads the amount of megabytes the cached build sides of the hash
+ * joins may occupy (zero means the build sides are not cached)
+ */
+void readBuildSideCacheSize(const char *config_file, unsigned long long *result);
+
+/* Reads the maximum amount of join orders the plan cache
+ * may keep (zero means the join orders are not cached)
+ */
+void readPlanCacheSize(const char *config_file, unsigned int *result);
+
+/* Reads how the query optimizer estimates the cost of the join orders */
+void readCostModel(const char *config_file, CostModelType *result);
+
+/* Reads the factor by which the actual rows of a join may differ from the
+ * estimated ones before the remaining joins are reordered (zero means never)
+ */
+void readReoptimizationFactor(const char *config_file, double *result);
+
+/* Reads the maximum amount of predicate shapes whose actual rows correct
+ * the estimations of the optimizer (zero means no corrections) and the file
+ * the corrections are kept in between executions. The name of the file is
+ * allocated with 'malloc' only if the option is not empty.
+ */
+void readCardinalityFeedback(
+    const char *config_file,
+    unsigned int *maxEntriesNum,
+    char **feedbackFile
+);
+
+/* Reads the minimum ratio between the rows of the larger and the smaller
+ * input of a hash join for the keys of the smaller input to be passed to
+ * the larger one (zero means the keys are never passed)
+ */
+void readSidewaysFilterRatio(const char *config_file, unsigned int *result);
+
+/* Reads whether the plans of the queries are printed and how */
+void readExplainMode(const char *config_file, ExplainMode *result);
+
+/* Reads the minimum share of the rows of a join input
+ * that makes a key be joined as a heavy hitter
+ */
+void readHeavyHitterShare(const char *config_file, double *result);
+
+/* Reads the hash function that partitions the relations of the joins */
+void readHashFunction(const char *config_file, HashFunctionType *result);
+
+/* Reads whether the partitions of the joins are tuned automatically */
+void readPartitionTuning(const char *config_file, bool *result);
+
+/* Reads the algorithm that executes the joins of the queries */
+void readJoinAlgorithm(const char *config_file, JoinAlgorithmType *result);
+
 };
 
 #endif
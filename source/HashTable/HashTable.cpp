@@ -733,6 +733,29 @@ void HashTable::terminateBulkSearchList(List *bulkSearchResult)
 	delete bulkSearchResult;
 }
 
+/******************************************************************
+ * Returns the amount of buckets a table must be created with, so *
+ * that the given amount of elements can be inserted without ever *
+ *                    reaching the load factor                    *
+ ******************************************************************/
+
+unsigned int HashTable::getExactSize(unsigned int elementsNum, double loadFactor)
+{
+	if(loadFactor <= 0.0 || loadFactor > 1.0)
+		loadFactor = 1.0;
+
+	unsigned int bucketsNum = ((unsigned int) (((double) elementsNum) / loadFactor)) + 1;
+
+	/* The quotient elements/buckets must stay below the load factor, with
+	 * the same comparison that 'insert' makes, so the rounding of the
+	 * division above never leaves the table one bucket short
+	 */
+	while(((double) elementsNum) / ((double) bucketsNum) >= loadFactor)
+		bucketsNum++;
+
+	return bucketsNum;
+}
+
 /*********************************************
  * Prints all the contents of the hash table *
  *********************************************/
@@ -109,6 +109,14 @@ public:
 /* Terminates the result returned by 'bulkSearch' */
 	static void terminateBulkSearchList(List *bulkSearchResult);
 
+/* Returns the amount of buckets a table must be created with, so that
+ * the given amount of elements with different keys can be inserted
+ * without reaching the load factor. The table then never grows because
+ * of the load factor and it always has empty entries for the Hopscotch
+ * algorithm (a load factor outside (0, 1] is considered to be 1).
+ */
+	static unsigned int getExactSize(unsigned int elementsNum, double loadFactor);
+
 /* Prints all the contents of the hash table */
 	void print(
 		void (*visitItemAndKey)(void *, void *),
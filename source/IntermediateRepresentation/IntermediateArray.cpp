@@ -1,11 +1,17 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
 #include "IntermediateArray.h"
+#include "BloomFilter.h"
+#include "SortMergeJoin.h"
+#include "ArrayJoin.h"
 
 /*************************************************************
  * Auxiliary static variable used for the printing operation *
  *************************************************************/
 
-static unsigned int staticRowsNum;
+static unsigned long long staticRowsNum;
 
 /*******************************************
  * Operations used to traverse the list of *
@@ -33,7 +39,7 @@ void IntermediateArray::deleteIntermediateRelation(void *item)
 void IntermediateArray::printUnsignedIntegerArray(void *item)
 {
 	unsigned int *my_uint_array = (unsigned int *) item;
-	unsigned int i;
+	unsigned long long i;
 
 	std::cout << "[ ";
 
@@ -48,6 +54,407 @@ void IntermediateArray::deleteUnsignedIntegerArray(void *item)
 	delete[] (unsigned int *) item;
 }
 
+/*******************************************************************
+ * Returns the cached build side of a whole column of a base table *
+ *  or 'NULL' if the build sides of the hash joins are not cached  *
+ *******************************************************************/
+
+static CachedBuildSide *acquireBuildSide(
+	PartitionedHashJoinInput *joinParameters,
+	Table *table,
+	unsigned int relName,
+	unsigned int relColumn,
+	unsigned int bitsNumForHashing,
+	HashFunctionType hashFunction)
+{
+	if(joinParameters->buildSideCache == NULL)
+		return NULL;
+
+	return joinParameters->buildSideCache->acquire(table, relName,
+		relColumn, bitsNumForHashing, hashFunction);
+}
+
+/*******************************************************************
+ * Determines whether the array join may use the given relation as *
+ *  its build side. The statistics of its column must show dense   *
+ *   keys (unless the array join is chosen by the configuration)   *
+ *******************************************************************/
+
+static bool mayBuildArray(
+	Relation *relation,
+	ColumnStatistics *statistics,
+	PartitionedHashJoinInput *joinParameters)
+{
+	if(joinParameters->joinAlgorithm == ArrayJoinAlgorithm)
+		return relation->getNumOfTuples() > 0;
+
+	return (joinParameters->joinAlgorithm == AutoJoinAlgorithm)
+		&& (statistics != NULL)
+		&& ArrayJoin::isDense(statistics->getMinElement(),
+			statistics->getMaxElement(), relation->getNumOfTuples());
+}
+
+/**********************************************************************
+ * Joins the given relations with the algorithm of the configuration  *
+ *  file and keeps what the join did in 'statistics'. The result is   *
+ * freed with 'freeJoinResult' of the Partitioned Hash Join Algorithm *
+ **********************************************************************/
+
+static RowIdRelation *executeJoinAlgorithm(
+	Relation *left,
+	Relation *right,
+	ColumnStatistics *leftStatistics,
+	ColumnStatistics *rightStatistics,
+	PartitionedHashJoinInput *joinParameters,
+	JobScheduler *jobScheduler,
+	CachedBuildSide *leftCache,
+	CachedBuildSide *rightCache,
+	JoinStatistics *statistics)
+{
+	RowIdRelation *joinResult;
+
+	/* A cached build side is already partitioned for the hash join,
+	 * so the other algorithms are only used for relations without one
+	 */
+	bool isCached = (leftCache != NULL) || (rightCache != NULL);
+
+	/* The array is built from the smaller of the relations whose keys
+	 * may be dense. The statistics describe the whole column, so the
+	 * actual keys of the relation must also be dense.
+	 */
+	bool leftMayBuild = !isCached && mayBuildArray(left, leftStatistics, joinParameters);
+	bool rightMayBuild = !isCached && mayBuildArray(right, rightStatistics, joinParameters);
+
+	if(leftMayBuild || rightMayBuild)
+	{
+		bool buildOnLeft = leftMayBuild && (!rightMayBuild
+			|| left->getNumOfTuples() <= right->getNumOfTuples());
+
+		Relation *buildRel = buildOnLeft ? left : right;
+		unsigned long long minKey, maxKey;
+
+		ArrayJoin::findKeyRange(buildRel, &minKey, &maxKey);
+
+		if(ArrayJoin::isDense(minKey, maxKey, buildRel->getNumOfTuples()))
+		{
+			ArrayJoin *join = new ArrayJoin(left, right, buildOnLeft,
+				minKey, maxKey, jobScheduler);
+
+			joinResult = join->executeJoin();
+			*statistics = join->getStatistics();
+			delete join;
+
+			return joinResult;
+		}
+	}
+
+	/* If it is chosen automatically, the sort-merge join
+	 * is used if both relations are (nearly) sorted
+	 */
+	bool sortMerge = !isCached
+		&& ((joinParameters->joinAlgorithm == SortMergeJoinAlgorithm)
+		|| ((joinParameters->joinAlgorithm == AutoJoinAlgorithm)
+		&& (SortMergeJoin::getSortedness(left) >= MIN_SORTED_SHARE)
+		&& (SortMergeJoin::getSortedness(right) >= MIN_SORTED_SHARE)));
+
+	if(sortMerge)
+	{
+		SortMergeJoin *join = new SortMergeJoin(left, right, jobScheduler);
+		joinResult = join->executeJoin();
+		*statistics = join->getStatistics();
+		delete join;
+	}
+
+	else
+	{
+		PartitionedHashJoin *join = new PartitionedHashJoin(left, right,
+			joinParameters, jobScheduler, leftCache, rightCache);
+
+		joinResult = join->executeJoin();
+		*statistics = join->getStatistics();
+		delete join;
+	}
+
+	return joinResult;
+}
+
+/*********************************************************************
+ * Returns the bits the first partition of a join of inputs with the *
+ *  given rows uses for hashing. A cached build side is partitioned  *
+ *    before the join is executed, so if the partitions are tuned    *
+ *   automatically, the bits are chosen here from the rows instead   *
+ *********************************************************************/
+
+static unsigned int resolveBitsNum(
+	PartitionedHashJoinInput *joinParameters,
+	unsigned long long leftRows,
+	unsigned long long rightRows,
+	JobScheduler *jobScheduler)
+{
+	if(!joinParameters->autoTunedPartitioning || joinParameters->buildSideCache == NULL)
+		return joinParameters->bitsNumForHashing;
+
+	unsigned int bitsPerPass, passesNum;
+
+	PartitionedHashJoin::tunePartitioning(leftRows, rightRows,
+		(jobScheduler != NULL) ? jobScheduler->getMaxThreads() : 1,
+		joinParameters->maxAllowedSizeModifier, joinParameters->maxPartitionDepth,
+		&bitsPerPass, &passesNum);
+
+	return bitsPerPass;
+}
+
+/***********************************************************************
+ * Returns the hash function of a join of the given base table columns *
+ *  ('otherTable' may be 'NULL'). A cached build side is partitioned   *
+ *   before the join is executed, so if the hash function is chosen    *
+ *   automatically, it is chosen here from a sample of the columns.    *
+ ***********************************************************************/
+
+static HashFunctionType resolveHashFunction(
+	PartitionedHashJoinInput *joinParameters,
+	Table *table,
+	unsigned int column,
+	Table *otherTable,
+	unsigned int otherColumn,
+	unsigned int bitsNumForHashing)
+{
+	if(joinParameters->hashFunction != AutoHash || joinParameters->buildSideCache == NULL)
+		return joinParameters->hashFunction;
+
+	unsigned long long *sample = new unsigned long long[2 * HASH_FUNCTION_SAMPLE_SIZE];
+	unsigned int sampledNum = 0;
+
+	Table *tables[2] = { table, otherTable };
+	unsigned int columns[2] = { column, otherColumn };
+
+	for(unsigned int t = 0; t < 2; t++)
+	{
+		if(tables[t] == NULL)
+			continue;
+
+		/* We sample the elements of evenly spaced rows of the column */
+		unsigned long long rowsNum = tables[t]->getNumOfTuples();
+		unsigned long long step = rowsNum / HASH_FUNCTION_SAMPLE_SIZE;
+
+		if(step == 0)
+			step = 1;
+
+		unsigned int tableSampledNum = 0;
+
+		for(unsigned long long row = 0; row < rowsNum
+			&& tableSampledNum < HASH_FUNCTION_SAMPLE_SIZE; row += step)
+		{
+			sample[sampledNum++] = tables[t]->getValue(columns[t], row);
+			tableSampledNum++;
+		}
+	}
+
+	HashFunctionType result = PartitionedHashJoin::chooseHashFunction(
+		sample, sampledNum, bitsNumForHashing);
+
+	delete[] sample;
+	return result;
+}
+
+/************************************************
+ * Compares two row IDs (used for sorting them) *
+ ************************************************/
+
+static int compareRowIds(const void *item1, const void *item2)
+{
+	unsigned int rowId1 = *((const unsigned int *) item1);
+	unsigned int rowId2 = *((const unsigned int *) item2);
+
+	if(rowId1 < rowId2)
+		return -1;
+
+	if(rowId1 > rowId2)
+		return 1;
+
+	return 0;
+}
+
+/**************************************************************************
+ * Returns a Bloom filter with the given elements of the smaller input of *
+ * a join, if the other input has enough more rows for the filter to pay  *
+ *              off (see 'sidewaysFilterRatio'), else 'NULL'              *
+ **************************************************************************/
+
+static BloomFilter *createSidewaysFilter(
+	PartitionedHashJoinInput *joinParameters,
+	const unsigned long long *elements,
+	unsigned long long elementsNum,
+	unsigned long long otherElementsNum)
+{
+	unsigned long long ratio = joinParameters->sidewaysFilterRatio;
+
+	if(ratio == 0 || elementsNum * ratio > otherElementsNum)
+		return NULL;
+
+	BloomFilter *filter = new BloomFilter(elementsNum);
+
+	for(unsigned long long i = 0; i < elementsNum; i++)
+		filter->insert(elements[i]);
+
+	return filter;
+}
+
+/**************************************************************************
+ * Creates the tuples <position, element> of the given elements of a join *
+ *  input. If a sideways filter is given, only the elements that may be   *
+ *   in the filter get a tuple, since the rest cannot match any element   *
+ *   of the other input. The amount of tuples is stored in 'tuplesNum'.   *
+ **************************************************************************/
+
+static Tuple *createJoinTuples(
+	const unsigned long long *elements,
+	unsigned long long elementsNum,
+	const BloomFilter *sidewaysFilter,
+	unsigned long long *tuplesNum)
+{
+	unsigned long long i, j;
+
+	/* Case every element takes part in the join */
+	if(sidewaysFilter == NULL)
+	{
+		Tuple *tuples = new Tuple[elementsNum];
+
+		for(i = 0; i < elementsNum; i++)
+		{
+			/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
+			tuples[i].setRowId(i);
+
+			/* We place the corresponding element to the current tuple */
+			tuples[i].setItem(new unsigned long long(elements[i]));
+		}
+
+		(*tuplesNum) = elementsNum;
+		return tuples;
+	}
+
+	/* Else we find the positions of the elements that may match first,
+	 * so that only their tuples are allocated
+	 */
+	unsigned int *positions = new unsigned int[elementsNum];
+	unsigned long long positionsNum = 0;
+
+	for(i = 0; i < elementsNum; i++)
+	{
+		if(sidewaysFilter->mayContain(elements[i]))
+			positions[positionsNum++] = i;
+	}
+
+	Tuple *tuples = new Tuple[positionsNum];
+
+	for(j = 0; j < positionsNum; j++)
+	{
+		/* The row ID of the tuple is still the position of its element */
+		tuples[j].setRowId(positions[j]);
+		tuples[j].setItem(new unsigned long long(elements[positions[j]]));
+	}
+
+	delete[] positions;
+
+	(*tuplesNum) = positionsNum;
+	return tuples;
+}
+
+/**************************************************************************
+ * Joins the given elements of an outer relation with an inner base table *
+ * column by probing the secondary index of that column with each element *
+ **************************************************************************/
+
+unsigned long long IntermediateArray::executeIndexJoin(
+	unsigned long long *outerElements,
+	unsigned long long outerElementsNum,
+	ColumnIndex *innerIndex,
+	unsigned int **outerPositions,
+	unsigned int **innerRowIds) const
+{
+	/* Auxiliary variables (used for counting) */
+	unsigned long long i, j, resultRowsNum = 0;
+
+	/* The row IDs of the inner table that match the current element */
+	const unsigned int *matchingRowIds;
+
+	/* First we count the result pairs, so we can allocate the result arrays */
+
+	for(i = 0; i < outerElementsNum; i++)
+		resultRowsNum += innerIndex->equalityLookup(outerElements[i], &matchingRowIds);
+
+	(*outerPositions) = new unsigned int[resultRowsNum];
+	(*innerRowIds) = new unsigned int[resultRowsNum];
+
+	/* Then we probe the index again and we store each result pair */
+
+	unsigned long long pairsNum = 0;
+
+	for(i = 0; i < outerElementsNum; i++)
+	{
+		unsigned long long matchesNum = innerIndex->equalityLookup(
+			outerElements[i], &matchingRowIds);
+
+		for(j = 0; j < matchesNum; j++)
+		{
+			(*outerPositions)[pairsNum] = i;
+			(*innerRowIds)[pairsNum] = matchingRowIds[j];
+			pairsNum++;
+		}
+	}
+
+	return resultRowsNum;
+}
+
+/***********************************************************************
+ * Replaces every row ID array with a new one that keeps only the rows *
+ *             in the given positions (in the given order)             *
+ ***********************************************************************/
+
+void IntermediateArray::renewRowIdArrays(unsigned int *positions, unsigned long long newRowsNum)
+{
+	/* We retrieve the amount of relations in the intermediate array */
+	unsigned int localRelsCount = relations->getCounter();
+	unsigned int *localRowIdArrays[localRelsCount];
+	unsigned int *renewedLocalRowIdArrays[localRelsCount];
+
+	/* Auxiliary variables (used for counting) */
+	unsigned int i;
+	unsigned long long j;
+
+	/* We retrieve the current row ID arrays
+	 * and allocate memory for the new ones
+	 */
+	for(i = 0; i < localRelsCount; i++)
+	{
+		localRowIdArrays[i] = (unsigned int *) rowIdArrays->getItemInPos(i+1);
+		renewedLocalRowIdArrays[i] = new unsigned int[newRowsNum];
+	}
+
+	/* We fill the new arrays with the row IDs of the given positions */
+
+	for(i = 0; i < localRelsCount; i++)
+	{
+		for(j = 0; j < newRowsNum; j++)
+			renewedLocalRowIdArrays[i][j] = localRowIdArrays[i][positions[j]];
+	}
+
+	/* We delete the old row ID arrays and remove them from the list */
+
+	rowIdArrays->traverseFromHead(deleteUnsignedIntegerArray);
+
+	while(!rowIdArrays->isEmpty())
+		rowIdArrays->removeFront();
+
+	/* We insert the renewed row ID arrays in the structure */
+
+	for(i = 0; i < localRelsCount; i++)
+		rowIdArrays->insertLast(renewedLocalRowIdArrays[i]);
+
+	/* We update the amount of rows of the intermediate array */
+	rowsNum = newRowsNum;
+}
+
 /********************************************
  * A constructor that initializes the array *
  *  with two relations that must be joined  *
@@ -79,56 +486,131 @@ IntermediateArray::IntermediateArray(
 	unsigned long long leftTableRows = leftTable->getNumOfTuples();
 	unsigned long long rightTableRows = rightTable->getNumOfTuples();
 
+	/* If the larger table has a secondary index on its column (or the index
+	 * may be built now), we probe it with every element of the smaller table
+	 * (index nested-loop join) instead of executing the hash join
+	 */
+	bool leftIsOuter = (leftTableRows <= rightTableRows);
+
+	ColumnIndex *innerIndex = leftIsOuter
+		? rightTable->getColumnIndex(rightRelColumn)
+		: leftTable->getColumnIndex(leftRelColumn);
+
+	if(innerIndex != NULL)
+	{
+		/* We copy the elements of the smaller (outer) table */
+		Table *outerTable = leftIsOuter ? leftTable : rightTable;
+		unsigned long long outerRows = leftIsOuter ? leftTableRows : rightTableRows;
+		unsigned int outerColumn = leftIsOuter ? leftRelColumn : rightRelColumn;
+
+		unsigned long long *outerElements = new unsigned long long[outerRows];
+		outerTable->gatherColumn(outerColumn, NULL, outerRows, outerElements);
+
+		/* We probe the index. The positions of the outer elements are
+		 * the row IDs of the outer table, since all its rows were copied.
+		 */
+		unsigned int *outerRowIds, *innerRowIds;
+
+		this->rowsNum = executeIndexJoin(outerElements, outerRows,
+			innerIndex, &outerRowIds, &innerRowIds);
+
+		delete[] outerElements;
+
+		/* We insert both relations and their row IDs in the structure */
+		relations->insertLast(new IntermediateRelation(leftRel, leftRelPriority));
+		relations->insertLast(new IntermediateRelation(rightRel, rightRelPriority));
+
+		rowIdArrays->insertLast(leftIsOuter ? outerRowIds : innerRowIds);
+		rowIdArrays->insertLast(leftIsOuter ? innerRowIds : outerRowIds);
+
+		return;
+	}
+
 	/* Auxiliary variable (used for counting) */
 	unsigned long long i;
 
-	/* We create the array of tuples for the left array
-	 *
-	 * Each tuple will have the form <RowIdLeft,ValueLeft>
+	/* If the build sides of the hash joins are cached, the tuples of
+	 * each column are taken from the cache, already partitioned
 	 */
-	Tuple *leftTuples = new Tuple[leftTableRows];
+	unsigned int bitsNumForHashing = resolveBitsNum(joinParameters,
+		leftTableRows, rightTableRows, jobScheduler);
+
+	HashFunctionType hashFunction = resolveHashFunction(joinParameters,
+		leftTable, leftRelColumn, rightTable, rightRelColumn, bitsNumForHashing);
 
-	for(i = 0; i < leftTableRows; i++)
+	CachedBuildSide *leftCache = acquireBuildSide(joinParameters, leftTable,
+		leftRel, leftRelColumn, bitsNumForHashing, hashFunction);
+
+	CachedBuildSide *rightCache = acquireBuildSide(joinParameters, rightTable,
+		rightRel, rightRelColumn, bitsNumForHashing, hashFunction);
+
+	/* Else we copy the elements of the columns that take part in the join
+	 * from the tables (the tables decode them if they are compressed)
+	 */
+	unsigned long long *leftValues = NULL, *rightValues = NULL;
+
+	if(leftCache == NULL)
 	{
-		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
-		leftTuples[i].setRowId(i);
+		leftValues = new unsigned long long[leftTableRows];
+		leftTable->gatherColumn(leftRelColumn, NULL, leftTableRows, leftValues);
+	}
 
-		/* We place the corresponding value of the table to the current tuple */
-		leftTuples[i].setItem(new unsigned long long(leftTable->
-			getTable()[leftRelColumn][i]));
+	if(rightCache == NULL)
+	{
+		rightValues = new unsigned long long[rightTableRows];
+		rightTable->gatherColumn(rightRelColumn, NULL, rightTableRows, rightValues);
 	}
 
-	/* We create the array of tuples for the right array
-	 *
-	 * Each tuple will have the form <RowIdRight,ValueRight>
+	/* If one table is much smaller than the other, the keys of the smaller
+	 * table are passed to the larger one as a Bloom filter, so the rows of
+	 * the larger table that cannot match are not partitioned and probed.
+	 * The keys are only passed if both columns have been copied.
 	 */
-	Tuple *rightTuples = new Tuple[rightTableRows];
+	BloomFilter *filterForRight = NULL, *filterForLeft = NULL;
 
-	for(i = 0; i < rightTableRows; i++)
+	if(leftValues != NULL && rightValues != NULL)
 	{
-		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
-		rightTuples[i].setRowId(i);
+		filterForRight = createSidewaysFilter(joinParameters,
+			leftValues, leftTableRows, rightTableRows);
 
-		/* We place the corresponding value of the table to the current tuple */
-		rightTuples[i].setItem(new unsigned long long(rightTable->
-			getTable()[rightRelColumn][i]));
+		if(filterForRight == NULL)
+			filterForLeft = createSidewaysFilter(joinParameters,
+				rightValues, rightTableRows, leftTableRows);
 	}
 
-	/* We use the tuples we made above to create the input
-	 * relations for the Partitioned Hash Join Algorithm
+	/* We create the arrays of tuples for the left and the right array
+	 *
+	 * Each tuple will have the form <RowIdLeft,ValueLeft> or <RowIdRight,ValueRight>
 	 */
-	Relation *left = new Relation(leftTuples, leftTableRows);
-	Relation *right = new Relation(rightTuples, rightTableRows);
+	unsigned long long leftTuplesNum = leftTableRows;
+	Tuple *leftTuples = (leftCache != NULL) ? leftCache->getTuples()
+		: createJoinTuples(leftValues, leftTableRows, filterForLeft, &leftTuplesNum);
+
+	unsigned long long rightTuplesNum = rightTableRows;
+	Tuple *rightTuples = (rightCache != NULL) ? rightCache->getTuples()
+		: createJoinTuples(rightValues, rightTableRows, filterForRight, &rightTuplesNum);
 
-	/* We execute the Partitioned Hash Join Algorithm */
-	PartitionedHashJoin *join = new PartitionedHashJoin(
-		left, right, this->joinParameters, this->jobScheduler);
+	/* We do not need the copied elements and the filters anymore */
+	delete[] leftValues;
+	delete[] rightValues;
+	delete filterForRight;
+	delete filterForLeft;
 
-	RowIdRelation *joinResult = join->executeJoin();
+	/* We use the tuples we made above to create the input
+	 * relations for the join algorithm
+	 */
+	Relation *left = new Relation(leftTuples, leftTuplesNum);
+	Relation *right = new Relation(rightTuples, rightTuplesNum);
+
+	/* We execute the join algorithm and keep what the join operation did */
+	RowIdRelation *joinResult = executeJoinAlgorithm(left, right,
+		leftTable->getColumnStatistics()[leftRelColumn],
+		rightTable->getColumnStatistics()[rightRelColumn], joinParameters,
+		jobScheduler, leftCache, rightCache, &lastJoinStatistics);
 
 	/* We retrieve the row ID pairs of the join result as well as the amount of them */
 	RowIdPair *resultPairs = joinResult->getRowIdPairs();
-	unsigned int resultRowsNum = joinResult->getNumOfRowIdPairs();
+	unsigned long long resultRowsNum = joinResult->getNumOfRowIdPairs();
 
 	/* We update the 'rowsNum' field of the class with the amount of row ID pairs */
 	this->rowsNum = resultRowsNum;
@@ -161,28 +643,37 @@ IntermediateArray::IntermediateArray(
 	rowIdArrays->insertLast(rightRowIds);
 
 	/* We free the result of join */
-	join->freeJoinResult(joinResult);
-	delete join;
+	PartitionedHashJoin::freeJoinResult(joinResult);
 
 	/* We free the relations for the join */
 	delete right;
 	delete left;
 
-	/* We free the allocated memory for the copies
-	 * of each data value of the right array
+	/* We give the cached tuples back to the cache or else we free
+	 * the allocated memory for the copies of each data value and
+	 * the arrays of tuples for the left and right relation
 	 */
-	for(i = 0; i < rightTableRows; i++)
-		delete (unsigned long long *) rightTuples[i].getItem();
+	if(rightCache != NULL)
+		joinParameters->buildSideCache->release(rightCache);
 
-	/* We free the allocated memory for the copies
-	 * of each data value of the left array
-	 */
-	for(i = 0; i < leftTableRows; i++)
-		delete (unsigned long long *) leftTuples[i].getItem();
+	else
+	{
+		for(i = 0; i < rightTuplesNum; i++)
+			delete (unsigned long long *) rightTuples[i].getItem();
+
+		delete[] rightTuples;
+	}
+
+	if(leftCache != NULL)
+		joinParameters->buildSideCache->release(leftCache);
+
+	else
+	{
+		for(i = 0; i < leftTuplesNum; i++)
+			delete (unsigned long long *) leftTuples[i].getItem();
 
-	/* We free the arrays of tuples for the left and right relation */
-	delete[] rightTuples;
-	delete[] leftTuples;
+		delete[] leftTuples;
+	}
 }
 
 /**********************************************
@@ -207,90 +698,139 @@ IntermediateArray::IntermediateArray(
 	this->joinParameters = joinParameters;
 	this->jobScheduler = jobScheduler;
 
+	/* We keep the rows of the relation that satisfy the filter */
+	filterBaseTable(relName, relPriority, 1, &relColumn, &filterValue,
+		&filterOperator, NULL);
+}
+
+/***********************************************
+ *  A constructor that initializes the array   *
+ * with one relation that must satisfy all the *
+ *     given filters (in the given order)      *
+ ***********************************************/
+
+IntermediateArray::IntermediateArray(
+	unsigned int relName,
+	unsigned int relPriority,
+	unsigned int filtersNum,
+	const unsigned int *relColumns,
+	const unsigned int *filterValues,
+	const char *filterOperators,
+	List *tables,
+	PartitionedHashJoinInput *joinParameters,
+	JobScheduler *jobScheduler,
+	unsigned long long *passedNums)
+{
+	/* We initialize all the fields of the class (apart from 'rowsNum' for now) */
+	this->tables = tables;
+	this->relations = new List();
+	this->rowIdArrays = new List();
+	this->joinParameters = joinParameters;
+	this->jobScheduler = jobScheduler;
+
+	/* We keep the rows of the relation that satisfy all the filters */
+	filterBaseTable(relName, relPriority, filtersNum, relColumns,
+		filterValues, filterOperators, passedNums);
+}
+
+/********************************************************************
+ * Initializes the array with the rows of the given base table that *
+ *          satisfy all the given filters (in their order)          *
+ ********************************************************************/
+
+void IntermediateArray::filterBaseTable(
+	unsigned int relName,
+	unsigned int relPriority,
+	unsigned int filtersNum,
+	const unsigned int *relColumns,
+	const unsigned int *filterValues,
+	const char *filterOperators,
+	unsigned long long *passedNums)
+{
 	/* We retrieve a pointer to the original table with all the data */
 	Table *table = (Table *) tables->getItemInPos(relName + 1);
 
 	/* We find the number of rows of the given relation */
 	unsigned int numOfRows = table->getNumOfTuples();
 
-	/* A list with the row IDs of the intermediate array that contain
-	 * row IDs of the given relation that satisfy the filter
-	 */
-	List *resultRowIds = new List();
-
-	/* Auxiliary variable (used for counting) */
-	unsigned int i;
+	/* The table expects the columns and the values of the filters as 64-bit */
+	unsigned long long columns[filtersNum], values[filtersNum];
 
-	for(i = 0; i < numOfRows; i++)
+	for(unsigned int k = 0; k < filtersNum; k++)
 	{
-		/* We retrieve the value of the current element */
-		unsigned long long currentElement = table->getTable()[relColumn][i];
+		columns[k] = relColumns[k];
+		values[k] = filterValues[k];
+	}
 
-		/* We initialize an auxiliary boolean flag to 'false' */
-		bool elementSatisfiesFilter = false;
+	/* If the column of the first filter has a secondary index (or the index
+	 * may be built now), we retrieve the rows that satisfy the filter from
+	 * the index. We use the index for equality filters and for range filters
+	 * that keep at most one out of eight rows. Else scanning is cheaper.
+	 */
+	ColumnIndex *index = table->getColumnIndex(relColumns[0]);
 
-		/* Depending on the filter operator we take one of the actions below */
+	if(index != NULL)
+	{
+		const unsigned int *indexedRowIds;
+		unsigned long long indexedRowsNum = index->rangeLookup(filterOperators[0],
+			filterValues[0], &indexedRowIds);
 
-		switch(filterOperator)
+		if(filterOperators[0] == '=' || indexedRowsNum <= numOfRows / 8)
 		{
-			/* Case the filter operator is '<' */
+			/* We copy the row IDs of the index to the intermediate array */
+			this->rowsNum = indexedRowsNum;
 
-			case '<':
-			{
-				if(currentElement < filterValue)
-					elementSatisfiesFilter = true;
+			unsigned int *resultRowIdArray = new unsigned int[rowsNum];
+			memcpy(resultRowIdArray, indexedRowIds, rowsNum * sizeof(unsigned int));
 
-				break;
-			}
+			/* The rows of a range filter are sorted by their element,
+			 * so we sort them by row ID to visit the table in order
+			 * later (the rows of an equality filter are sorted already)
+			 */
+			if(filterOperators[0] != '=')
+				qsort(resultRowIdArray, rowsNum, sizeof(unsigned int), compareRowIds);
 
-			/* Case the filter operator is '>' */
+			/* We insert the relation and its row IDs in the structure */
+			relations->insertLast(new IntermediateRelation(relName, relPriority));
+			rowIdArrays->insertLast(resultRowIdArray);
 
-			case '>':
-			{
-				if(currentElement > filterValue)
-					elementSatisfiesFilter = true;
+			if(passedNums != NULL)
+				passedNums[0] = rowsNum;
 
-				break;
-			}
+			/* The rest of the filters examine the rows of the index together */
+			if(filtersNum > 1)
+			{
+				unsigned int *positions = new unsigned int[rowsNum];
 
-			/* Case the filter operator is '=' */
+				unsigned long long matchesNum = table->filterColumns(filtersNum - 1,
+					columns + 1, filterOperators + 1, values + 1, resultRowIdArray,
+					rowsNum, positions, (passedNums != NULL) ? passedNums + 1 : NULL);
 
-			case '=':
-			{
-				if(currentElement == filterValue)
-					elementSatisfiesFilter = true;
+				renewRowIdArrays(positions, matchesNum);
 
-				break;
+				delete[] positions;
 			}
-		}
 
-		/* If the current element satisfies the filter, we
-		 * insert the row ID of that element in the list
-		 */
-		if(elementSatisfiesFilter)
-			resultRowIds->insertLast(new unsigned int(i));
+			return;
+		}
 	}
 
-	/* We update the amount of row IDs of the intermediate array */
-	this->rowsNum = resultRowIds->getCounter();
+	/* An array with the row IDs of the given relation that satisfy the
+	 * filters. At most all the rows of the relation may satisfy them.
+	 */
+	unsigned int *matchingRowIds = new unsigned int[numOfRows];
 
-	/* We will move each row ID from the list to the intermediate array */
-	i = 0;
+	/* We let the table scan the columns. The table compares the elements
+	 * directly in their packed form if the table is compressed.
+	 */
+	this->rowsNum = table->filterColumns(filtersNum, columns, filterOperators,
+		values, NULL, numOfRows, matchingRowIds, passedNums);
 
 	/* Here we create the array that will be stored in the structure */
 	unsigned int *resultRowIdArray = new unsigned int[rowsNum];
 
-	/* We move every element from the list to the above array */
-
-	while(!resultRowIds->isEmpty())
-	{
-		unsigned int *currentRowIdAddress = (unsigned int *) resultRowIds->getItemInPos(1);
-		unsigned int currentRowId = (*currentRowIdAddress);
-		resultRowIds->removeFront();
-		delete currentRowIdAddress;
-		resultRowIdArray[i] = currentRowId;
-		i++;
-	}
+	/* We move every matching row ID to the above array */
+	memcpy(resultRowIdArray, matchingRowIds, rowsNum * sizeof(unsigned int));
 
 	/* We insert the relation in the list of relations */
 	relations->insertLast(new IntermediateRelation(relName, relPriority));
@@ -298,8 +838,8 @@ IntermediateArray::IntermediateArray(
 	/* We insert the array of row IDs in the list of row ID arrays */
 	rowIdArrays->insertLast(resultRowIdArray);
 
-	/* We free the allocated memory for the temporary list */
-	delete resultRowIds;
+	/* We free the allocated memory for the temporary array */
+	delete[] matchingRowIds;
 }
 
 /**************
@@ -343,11 +883,21 @@ List *IntermediateArray::getRowIdArrays() const
  * Getter - Returns the number of rows of the intermediate array *
  *****************************************************************/
 
-unsigned int IntermediateArray::getRowsNum() const
+unsigned long long IntermediateArray::getRowsNum() const
 {
 	return rowsNum;
 }
 
+/*****************************************************************
+ * Getter - Returns what the last join of the array did (nothing *
+ *     if it was executed without the partitioned hash join)     *
+ *****************************************************************/
+
+JoinStatistics IntermediateArray::getLastJoinStatistics() const
+{
+	return lastJoinStatistics;
+}
+
 /********************************************
  * Searches whether the given relation name *
  *     exists in the intermediate array     *
@@ -385,6 +935,28 @@ bool IntermediateArray::search(unsigned int foreignRelationName,
 	return false;
 }
 
+/*********************************************************************
+ * Stops the program if the rows of the array are more than a 32-bit *
+ * position can address, so the array cannot take part in the given  *
+ *                  operation ("join" or "filter")                   *
+ *********************************************************************/
+
+void IntermediateArray::requireAddressableRows(const char *operation) const
+{
+	/* The positions of the rows become the row IDs of the tuples of a join
+	 * and the offsets of the rows that satisfy a filter, which are 32-bit.
+	 * Wrapped positions would silently give a wrong result.
+	 */
+	if(rowsNum <= UINT_MAX)
+		return;
+
+	std::cerr << "Cannot " << operation << " an intermediate array of "
+		<< rowsNum << " rows, since a position addresses at most "
+		<< UINT_MAX << " rows" << std::endl;
+
+	exit(EXIT_FAILURE);
+}
+
 /********************************************************************
  * Finds and returns the position in the list of the given relation *
  ********************************************************************/
@@ -442,6 +1014,12 @@ void IntermediateArray::executeJoinWithForeignRelation(
 	unsigned int foreignRelationColumn,
 	unsigned int foreignRelationPriority)
 {
+	/* The positions of the rows must fit in the row IDs of the tuples */
+	requireAddressableRows("join");
+
+	/* Nothing has been done by this join yet */
+	lastJoinStatistics = JoinStatistics();
+
 	/* We retrieve pointers to the original tables with all the data */
 	Table *localTable = (Table *) tables->getItemInPos(localRelationName + 1);
 	Table *foreignTable = (Table *) tables->getItemInPos(foreignRelationName + 1);
@@ -454,15 +1032,49 @@ void IntermediateArray::executeJoinWithForeignRelation(
 	unsigned long long localTableRows = rowsNum;
 	unsigned long long foreignTableRows = foreignTable->getNumOfTuples();
 
+	/* If the foreign table has a secondary index on its column (or the index
+	 * may be built now), we probe it with every element of the local relation
+	 * (index nested-loop join) instead of executing the hash join
+	 */
+	ColumnIndex *foreignIndex = foreignTable->getColumnIndex(foreignRelationColumn);
+
+	if(foreignIndex != NULL)
+	{
+		/* We copy the elements of the reserved rows of the local relation */
+		unsigned int *reservedRowIds = (unsigned int *) rowIdArrays->getItemInPos(
+			posOfRelationInList(localRelationName, localRelationPriority));
+
+		unsigned long long *localElements = new unsigned long long[localTableRows];
+		localTable->gatherColumn(localRelationColumn, reservedRowIds,
+			localTableRows, localElements);
+
+		/* We probe the index of the foreign column */
+		unsigned int *localPositions, *matchingForeignRowIds;
+
+		unsigned long long resultRowsNum = executeIndexJoin(localElements, localTableRows,
+			foreignIndex, &localPositions, &matchingForeignRowIds);
+
+		delete[] localElements;
+
+		/* We keep only the rows of the intermediate array that were matched */
+		renewRowIdArrays(localPositions, resultRowsNum);
+
+		delete[] localPositions;
+
+		/* The foreign relation is not foreign anymore. We insert its
+		 * row IDs, name and priority in the intermediate array.
+		 */
+		rowIdArrays->insertLast(matchingForeignRowIds);
+
+		relations->insertLast(new IntermediateRelation(foreignRelationName,
+			foreignRelationPriority));
+
+		return;
+	}
+
 	/* Auxiliary variables (used for counting) */
 	unsigned long long i, j;
 
-	/* We create the array of tuples for the local array
-	 *
-	 * Each tuple will have the form <RowIdIntermediateArray,LocalValue>
-	 */
-	Tuple *localTuples = new Tuple[localTableRows];
-
 	/* We find the position of the local relation in the relations list */
 	unsigned int posOfLocalRelInList = posOfRelationInList(
 		localRelationName, localRelationPriority);
@@ -473,49 +1085,85 @@ void IntermediateArray::executeJoinWithForeignRelation(
 	unsigned int *localRowIds = (unsigned int *) rowIdArrays->
 		getItemInPos(posOfLocalRelInList);
 
-	/* We fill the tuples of the local relation with contents */
+	/* We copy the elements of the column that take part in the join
+	 * from the table (the table decodes them if it is compressed)
+	 */
+	unsigned long long *localValues = new unsigned long long[localTableRows];
+	localTable->gatherColumn(localRelationColumn, localRowIds, localTableRows, localValues);
 
-	for(i = 0; i < localTableRows; i++)
-	{
-		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
-		localTuples[i].setRowId(i);
+	/* If the build sides of the hash joins are cached, the tuples of
+	 * the foreign column are taken from the cache, already partitioned
+	 */
+	unsigned int bitsNumForHashing = resolveBitsNum(joinParameters,
+		localTableRows, foreignTableRows, jobScheduler);
 
-		/* We place the corresponding value of the intermediate table to the current tuple */
-		localTuples[i].setItem(new unsigned long long(localTable->getTable()
-			[localRelationColumn][localRowIds[i]]));
+	HashFunctionType hashFunction = resolveHashFunction(joinParameters,
+		foreignTable, foreignRelationColumn, NULL, 0, bitsNumForHashing);
+
+	CachedBuildSide *foreignCache = acquireBuildSide(joinParameters, foreignTable,
+		foreignRelationName, foreignRelationColumn, bitsNumForHashing, hashFunction);
+
+	/* Else we copy the elements of the foreign column too */
+	unsigned long long *foreignValues = NULL;
+
+	if(foreignCache == NULL)
+	{
+		foreignValues = new unsigned long long[foreignTableRows];
+		foreignTable->gatherColumn(foreignRelationColumn, NULL, foreignTableRows, foreignValues);
 	}
 
-	/* We create the array of tuples for the right array
+	/* If one input is much smaller than the other, the keys of the smaller
+	 * input are passed to the larger one as a Bloom filter, so the rows of
+	 * the larger input that cannot match are not partitioned and probed.
+	 * The cached foreign tuples are already partitioned, so they are kept.
+	 */
+	BloomFilter *filterForForeign = (foreignCache == NULL) ? createSidewaysFilter(
+		joinParameters, localValues, localTableRows, foreignTableRows) : NULL;
+
+	BloomFilter *filterForLocal = (filterForForeign == NULL && foreignValues != NULL)
+		? createSidewaysFilter(joinParameters, foreignValues, foreignTableRows,
+		localTableRows) : NULL;
+
+	/* We create the array of tuples for the local array
 	 *
-	 * Each tuple will have the form <RowIdRight,ValueRight>
+	 * Each tuple will have the form <RowIdIntermediateArray,LocalValue>
 	 */
-	Tuple *foreignTuples = new Tuple[foreignTableRows];
+	unsigned long long localTuplesNum;
+	Tuple *localTuples = createJoinTuples(localValues, localTableRows,
+		filterForLocal, &localTuplesNum);
 
-	for(i = 0; i < foreignTableRows; i++)
-	{
-		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
-		foreignTuples[i].setRowId(i);
+	/* We do not need the copied elements anymore */
+	delete[] localValues;
 
-		/* We place the corresponding value of the table to the current tuple */
-		foreignTuples[i].setItem(new unsigned long long(foreignTable->getTable()
-			[foreignRelationColumn][i]));
-	}
+	/* We create the array of tuples for the right array (if it is not cached)
+	 *
+	 * Each tuple will have the form <RowIdRight,ValueRight>
+	 */
+	unsigned long long foreignTuplesNum = foreignTableRows;
+	Tuple *foreignTuples = (foreignCache != NULL) ? foreignCache->getTuples()
+		: createJoinTuples(foreignValues, foreignTableRows, filterForForeign,
+		&foreignTuplesNum);
+
+	/* We do not need the copied elements and the filters anymore */
+	delete[] foreignValues;
+	delete filterForForeign;
+	delete filterForLocal;
 
 	/* We use the tuples we made above to create the input
-	 * relations for the Partitioned Hash Join Algorithm
+	 * relations for the join algorithm
 	 */
-	Relation *left = new Relation(localTuples, localTableRows);
-	Relation *right = new Relation(foreignTuples, foreignTableRows);
+	Relation *left = new Relation(localTuples, localTuplesNum);
+	Relation *right = new Relation(foreignTuples, foreignTuplesNum);
 
-	/* We execute the Partitioned Hash Join Algorithm */
-	PartitionedHashJoin *join = new PartitionedHashJoin(
-		left, right, joinParameters, jobScheduler);
-
-	RowIdRelation *joinResult = join->executeJoin();
+	/* We execute the join algorithm and keep what the join operation did */
+	RowIdRelation *joinResult = executeJoinAlgorithm(left, right,
+		localTable->getColumnStatistics()[localRelationColumn],
+		foreignTable->getColumnStatistics()[foreignRelationColumn], joinParameters,
+		jobScheduler, NULL, foreignCache, &lastJoinStatistics);
 
 	/* We retrieve the row ID pairs of the join result as well as the amount of them */
 	RowIdPair *resultPairs = joinResult->getRowIdPairs();
-	unsigned int resultRowsNum = joinResult->getNumOfRowIdPairs();
+	unsigned long long resultRowsNum = joinResult->getNumOfRowIdPairs();
 
 	/* We update the 'rowsNum' field of the class with the amount of row ID pairs */
 	this->rowsNum = resultRowsNum;
@@ -553,27 +1201,34 @@ void IntermediateArray::executeJoinWithForeignRelation(
 		rowIdArrays->removeFront();
 
 	/* We free the result of join */
-	join->freeJoinResult(joinResult);
-	delete join;
+	PartitionedHashJoin::freeJoinResult(joinResult);
 
 	/* We free the relations for the join */
 	delete right;
 	delete left;
 
-	/* We free the allocated memory for the copies
-	 * of each data value of the foreign array
+	/* We give the cached foreign tuples back to the cache or else we free
+	 * the allocated memory for the copies of each data value of the
+	 * foreign array and the array of tuples of the foreign relation
 	 */
-	for(i = 0; i < foreignTableRows; i++)
-		delete (unsigned long long *) foreignTuples[i].getItem();
+	if(foreignCache != NULL)
+		joinParameters->buildSideCache->release(foreignCache);
+
+	else
+	{
+		for(i = 0; i < foreignTuplesNum; i++)
+			delete (unsigned long long *) foreignTuples[i].getItem();
+
+		delete[] foreignTuples;
+	}
 
 	/* We free the allocated memory for the copies
 	 * of each data value of the local array
 	 */
-	for(i = 0; i < localTableRows; i++)
+	for(i = 0; i < localTuplesNum; i++)
 		delete (unsigned long long *) localTuples[i].getItem();
 
-	/* We free the arrays of tuples for the local and foreign relation */
-	delete[] foreignTuples;
+	/* We free the array of tuples of the local relation */
 	delete[] localTuples;
 
 	/* We insert the renewed arrays of reserved row IDs in the structure */
@@ -606,6 +1261,12 @@ void IntermediateArray::executeJoinWithTwoRelationsInTheArray(
 	unsigned int rightLocalRelationColumn,
 	unsigned int rightLocalRelationPriority)
 {
+	/* The positions of the rows must fit in the row IDs of the tuples */
+	requireAddressableRows("join");
+
+	/* Nothing has been done by this join yet */
+	lastJoinStatistics = JoinStatistics();
+
 	/* We retrieve pointers to the original tables with all the data */
 	Table *leftLocalTable = (Table *) tables->getItemInPos(leftLocalRelationName + 1);
 	Table *rightLocalTable = (Table *) tables->getItemInPos(rightLocalRelationName + 1);
@@ -639,16 +1300,24 @@ void IntermediateArray::executeJoinWithTwoRelationsInTheArray(
 
 	/* We fill the left tuples with the data of the intermediate array */
 
+	/* We copy the elements of the column that take part in the join
+	 * from the table (the table decodes them if it is compressed)
+	 */
+	unsigned long long *leftLocalValues = new unsigned long long[leftLocalTableRows];
+	leftLocalTable->gatherColumn(leftLocalRelationColumn, leftLocalRowIds, leftLocalTableRows, leftLocalValues);
+
 	for(i = 0; i < leftLocalTableRows; i++)
 	{
 		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
 		leftLocalTuples[i].setRowId(i);
 
 		/* We place the corresponding value of the intermediate table to the current tuple */
-		leftLocalTuples[i].setItem(new unsigned long long(leftLocalTable->getTable()
-			[leftLocalRelationColumn][leftLocalRowIds[i]]));
+		leftLocalTuples[i].setItem(new unsigned long long(leftLocalValues[i]));
 	}
 
+	/* We do not need the copied elements anymore */
+	delete[] leftLocalValues;
+
 	/* We create the array of tuples for the right array
 	 *
 	 * Each tuple will have the form <RowIdIntermediateArray,RightLocalValue>
@@ -667,31 +1336,39 @@ void IntermediateArray::executeJoinWithTwoRelationsInTheArray(
 
 	/* We fill the right tuples with the data of the intermediate array */
 
+	/* We copy the elements of the column that take part in the join
+	 * from the table (the table decodes them if it is compressed)
+	 */
+	unsigned long long *rightLocalValues = new unsigned long long[rightLocalTableRows];
+	rightLocalTable->gatherColumn(rightLocalRelationColumn, rightLocalRowIds, rightLocalTableRows, rightLocalValues);
+
 	for(i = 0; i < rightLocalTableRows; i++)
 	{
 		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
 		rightLocalTuples[i].setRowId(i);
 
 		/* We place the corresponding value of the table to the current tuple */
-		rightLocalTuples[i].setItem(new unsigned long long(rightLocalTable->getTable()
-			[rightLocalRelationColumn][rightLocalRowIds[i]]));
+		rightLocalTuples[i].setItem(new unsigned long long(rightLocalValues[i]));
 	}
 
+	/* We do not need the copied elements anymore */
+	delete[] rightLocalValues;
+
 	/* We use the tuples we made above to create the input
-	 * relations for the Partitioned Hash Join Algorithm
+	 * relations for the join algorithm
 	 */
 	Relation *left = new Relation(leftLocalTuples, leftLocalTableRows);
 	Relation *right = new Relation(rightLocalTuples, rightLocalTableRows);
 
-	/* We execute the Partitioned Hash Join Algorithm */
-	PartitionedHashJoin *join = new PartitionedHashJoin(
-		left, right, joinParameters, jobScheduler);
-
-	RowIdRelation *joinResult = join->executeJoin();
+	/* We execute the join algorithm and keep what the join operation did */
+	RowIdRelation *joinResult = executeJoinAlgorithm(left, right,
+		leftLocalTable->getColumnStatistics()[leftLocalRelationColumn],
+		rightLocalTable->getColumnStatistics()[rightLocalRelationColumn], joinParameters,
+		jobScheduler, NULL, NULL, &lastJoinStatistics);
 
 	/* We retrieve the row ID pairs of the join result as well as the amount of them */
 	RowIdPair *resultPairs = joinResult->getRowIdPairs();
-	unsigned int resultRowsNum = joinResult->getNumOfRowIdPairs();
+	unsigned long long resultRowsNum = joinResult->getNumOfRowIdPairs();
 
 	/* We retrieve the amount of relations in the intermediate array */
 	unsigned int localRelsCount = relations->getCounter();
@@ -706,7 +1383,7 @@ void IntermediateArray::executeJoinWithTwoRelationsInTheArray(
 	/* We create a list with all the row IDs of
 	 * the Intermediate array that we must save
 	 */
-	unsigned int finalRowsOfResult = 0;
+	unsigned long long finalRowsOfResult = 0;
 	List *results = new List();
 
 	for(i = 0; i < resultRowsNum; i++)
@@ -778,8 +1455,7 @@ void IntermediateArray::executeJoinWithTwoRelationsInTheArray(
 		rowIdArrays->removeFront();
 
 	/* We free the result of join */
-	join->freeJoinResult(joinResult);
-	delete join;
+	PartitionedHashJoin::freeJoinResult(joinResult);
 
 	/* We free the relations for the join */
 	delete right;
@@ -821,6 +1497,15 @@ void IntermediateArray::executeJoinWithRelationOfOtherArray(
 	unsigned int foreignRelationColumn,
 	unsigned int foreignRelationPriority)
 {
+	/* The positions of the rows of both arrays must
+	 * fit in the row IDs of the tuples
+	 */
+	requireAddressableRows("join");
+	other->requireAddressableRows("join");
+
+	/* Nothing has been done by this join yet */
+	lastJoinStatistics = JoinStatistics();
+
 	/* We retrieve pointers to the original tables with all the data */
 	Table *localTable = (Table *) tables->getItemInPos(localRelationName + 1);
 	Table *foreignTable = (Table *) tables->getItemInPos(foreignRelationName + 1);
@@ -832,13 +1517,6 @@ void IntermediateArray::executeJoinWithRelationOfOtherArray(
 	/* Auxiliary variables (used for counting) */
 	unsigned long long i, j;
 
-	/* We create the array of tuples for the left array
-	 *
-	 * Each tuple will have the form <RowIdLocalIntermediateArray (Ih), LocalValue>
-	 * (h is an index to an intermediate result inside the current Intermediate Array)
-	 */
-	Tuple *localTuples = new Tuple[localTableRows];
-
 	/* We find the position of the left local relation in the relations list */
 	unsigned int posOfLocalRelInList = posOfRelationInList(
 		localRelationName, localRelationPriority);
@@ -849,24 +1527,11 @@ void IntermediateArray::executeJoinWithRelationOfOtherArray(
 	unsigned int *localRowIds = (unsigned int *) rowIdArrays->
 		getItemInPos(posOfLocalRelInList);
 
-	for(i = 0; i < localTableRows; i++)
-	{
-		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
-		localTuples[i].setRowId(i);
-
-		/* We place the corresponding value of the intermediate table to the current tuple */
-		localTuples[i].setItem(new unsigned long long(localTable->getTable()
-			[localRelationColumn][localRowIds[i]]));
-	}
-
-	/* We create the array of tuples for the right array
-	 *
-	 * Each tuple will have the form <RowIdForeignIntermediateArray (Ig), ForeignValue>
-	 *
-	 * (g is an index to an intermediate result different
-	 * from Ih outside of the current Intermediate Array)
+	/* We copy the elements of the column that take part in the join
+	 * from the table (the table decodes them if it is compressed)
 	 */
-	Tuple *foreignTuples = new Tuple[foreignTableRows];
+	unsigned long long *localValues = new unsigned long long[localTableRows];
+	localTable->gatherColumn(localRelationColumn, localRowIds, localTableRows, localValues);
 
 	/* We find the position of the right relation in the
 	 * relations list of the foreign intermediate array
@@ -880,31 +1545,63 @@ void IntermediateArray::executeJoinWithRelationOfOtherArray(
 	unsigned int *foreignRowIds = (unsigned int *) other->
 		rowIdArrays->getItemInPos(posOfForeignRelInList);
 
-	for(i = 0; i < foreignTableRows; i++)
-	{
-		/* We will take the row IDs in natural order (0, 1, 2, 3, ...) */
-		foreignTuples[i].setRowId(i);
+	/* We copy the elements of the column that take part in the join
+	 * from the table (the table decodes them if it is compressed)
+	 */
+	unsigned long long *foreignValues = new unsigned long long[foreignTableRows];
+	foreignTable->gatherColumn(foreignRelationColumn, foreignRowIds, foreignTableRows, foreignValues);
 
-		/* We place the corresponding value of the table to the current tuple */
-		foreignTuples[i].setItem(new unsigned long long(foreignTable->getTable()
-			[foreignRelationColumn][foreignRowIds[i]]));
-	}
+	/* If one input is much smaller than the other, the keys of the smaller
+	 * input are passed to the larger one as a Bloom filter, so the rows of
+	 * the larger input that cannot match are not partitioned and probed
+	 */
+	BloomFilter *filterForForeign = createSidewaysFilter(joinParameters,
+		localValues, localTableRows, foreignTableRows);
 
-	/* We use the tuples we made above to create the input
-	 * relations for the Partitioned Hash Join Algorithm
+	BloomFilter *filterForLocal = (filterForForeign == NULL) ? createSidewaysFilter(
+		joinParameters, foreignValues, foreignTableRows, localTableRows) : NULL;
+
+	/* We create the array of tuples for the left array
+	 *
+	 * Each tuple will have the form <RowIdLocalIntermediateArray (Ih), LocalValue>
+	 * (h is an index to an intermediate result inside the current Intermediate Array)
+	 */
+	unsigned long long localTuplesNum;
+	Tuple *localTuples = createJoinTuples(localValues, localTableRows,
+		filterForLocal, &localTuplesNum);
+
+	/* We create the array of tuples for the right array
+	 *
+	 * Each tuple will have the form <RowIdForeignIntermediateArray (Ig), ForeignValue>
+	 *
+	 * (g is an index to an intermediate result different
+	 * from Ih outside of the current Intermediate Array)
 	 */
-	Relation *left = new Relation(localTuples, localTableRows);
-	Relation *right = new Relation(foreignTuples, foreignTableRows);
+	unsigned long long foreignTuplesNum;
+	Tuple *foreignTuples = createJoinTuples(foreignValues, foreignTableRows,
+		filterForForeign, &foreignTuplesNum);
+
+	/* We do not need the copied elements and the filters anymore */
+	delete[] localValues;
+	delete[] foreignValues;
+	delete filterForForeign;
+	delete filterForLocal;
 
-	/* We execute the Partitioned Hash Join Algorithm */
-	PartitionedHashJoin *join = new PartitionedHashJoin(
-		left, right, joinParameters, jobScheduler);
+	/* We use the tuples we made above to create the input
+	 * relations for the join algorithm
+	 */
+	Relation *left = new Relation(localTuples, localTuplesNum);
+	Relation *right = new Relation(foreignTuples, foreignTuplesNum);
 
-	RowIdRelation *joinResult = join->executeJoin();
+	/* We execute the join algorithm and keep what the join operation did */
+	RowIdRelation *joinResult = executeJoinAlgorithm(left, right,
+		localTable->getColumnStatistics()[localRelationColumn],
+		foreignTable->getColumnStatistics()[foreignRelationColumn], joinParameters,
+		jobScheduler, NULL, NULL, &lastJoinStatistics);
 
 	/* We retrieve the row ID pairs of the join result as well as the amount of them */
 	RowIdPair *resultPairs = joinResult->getRowIdPairs();
-	unsigned int resultRowsNum = joinResult->getNumOfRowIdPairs();
+	unsigned long long resultRowsNum = joinResult->getNumOfRowIdPairs();
 
 	/* We retrieve the amount of relations in both intermediate arrays */
 	unsigned int localRelsCount = relations->getCounter();
@@ -971,8 +1668,7 @@ void IntermediateArray::executeJoinWithRelationOfOtherArray(
 		other->rowIdArrays->removeFront();
 
 	/* We free the result of join */
-	join->freeJoinResult(joinResult);
-	delete join;
+	PartitionedHashJoin::freeJoinResult(joinResult);
 
 	/* We free the relations for the join */
 	delete right;
@@ -981,13 +1677,13 @@ void IntermediateArray::executeJoinWithRelationOfOtherArray(
 	/* We free the allocated memory for the copies
 	 * of each data value of the foreign array
 	 */
-	for(i = 0; i < localTableRows; i++)
+	for(i = 0; i < localTuplesNum; i++)
 		delete (unsigned long long *) localTuples[i].getItem();
 
 	/* We free the allocated memory for the copies
 	 * of each data value of the local array
 	 */
-	for(i = 0; i < foreignTableRows; i++)
+	for(i = 0; i < foreignTuplesNum; i++)
 		delete (unsigned long long *) foreignTuples[i].getItem();
 
 	/* We free the arrays of tuples for the local and foreign relation */
@@ -1039,6 +1735,28 @@ void IntermediateArray::executeFilter(
 	unsigned int filterValue,
 	char filterOperator)
 {
+	executeFilters(relationName, relationPriority, 1, &relationColumn,
+		&filterValue, &filterOperator);
+}
+
+/*************************************************************
+ * Applies all the given filters (in the given order) to the *
+ *    implied local relation with a single pass over its     *
+ *                       reserved rows                       *
+ *************************************************************/
+
+void IntermediateArray::executeFilters(
+	unsigned int relationName,
+	unsigned int relationPriority,
+	unsigned int filtersNum,
+	const unsigned int *relationColumns,
+	const unsigned int *filterValues,
+	const char *filterOperators,
+	unsigned long long *passedNums)
+{
+	/* The positions of the rows must fit in the offsets of the satisfying rows */
+	requireAddressableRows("filter");
+
 	/* We retrieve a pointer to the original table with all the data */
 	Table *table = (Table *) tables->getItemInPos(relationName + 1);
 
@@ -1049,124 +1767,37 @@ void IntermediateArray::executeFilter(
 	unsigned int *reservedRowIdsOfRel = (unsigned int *) rowIdArrays->
 		getItemInPos(relationPosInList);
 
-	/* A list with the row IDs of the intermediate array that contain
-	 * row IDs of the given relation that satisfy the filter
-	 */
-	List *resultRowIds = new List();
+	/* The table expects the columns and the values of the filters as 64-bit */
+	unsigned long long columns[filtersNum], values[filtersNum];
 
-	/* Auxiliary variables (used for counting) */
-	unsigned int i, j;
-
-	for(i = 0; i < rowsNum; i++)
+	for(unsigned int k = 0; k < filtersNum; k++)
 	{
-		/* We retrieve the value of the current element */
-		unsigned long long currentElement = table->getTable()
-			[relationColumn][reservedRowIdsOfRel[i]];
-
-		/* We initialize an auxiliary boolean flag to 'false' */
-		bool elementSatisfiesFilter = false;
-
-		/* Depending on the filter operator we take one of the actions below */
-
-		switch(filterOperator)
-		{
-			/* Case the filter operator is '<' */
-
-			case '<':
-			{
-				if(currentElement < filterValue)
-					elementSatisfiesFilter = true;
-
-				break;
-			}
-
-			/* Case the filter operator is '>' */
-
-			case '>':
-			{
-				if(currentElement > filterValue)
-					elementSatisfiesFilter = true;
-
-				break;
-			}
-
-			/* Case the filter operator is '=' */
-
-			case '=':
-			{
-				if(currentElement == filterValue)
-					elementSatisfiesFilter = true;
-
-				break;
-			}
-		}
-
-		/* If the current element satisfies the filter, we
-		 * insert the row ID of that element in the list
-		 */
-		if(elementSatisfiesFilter)
-			resultRowIds->insertLast(new unsigned int(i));
+		columns[k] = relationColumns[k];
+		values[k] = filterValues[k];
 	}
 
-	/* We update the amount of row IDs of the intermediate array */
-	this->rowsNum = resultRowIds->getCounter();
-
-	/* We retrieve the amount of relations in the intermediate array */
-	unsigned int localRelsCount = relations->getCounter();
-	unsigned int *localRowIdArrays[localRelsCount];
-	unsigned int *renewedLocalRowIdArrays[localRelsCount];
-
-	/* We retrieve the current row ID arrays
-	 * and allocate memory for the new ones
+	/* An array with the row IDs of the intermediate array that contain
+	 * row IDs of the given relation that satisfy the filters
 	 */
-	for(i = 0; i < localRelsCount; i++)
-	{
-		localRowIdArrays[i] = (unsigned int *) rowIdArrays->getItemInPos(i+1);
-		renewedLocalRowIdArrays[i] = new unsigned int[rowsNum];
-	}
-
-	/* We will update the arrays of reserved row IDs */
-	i = 0;
-
-	/* As long as the list is not empty, we do the following */
-
-	while(!resultRowIds->isEmpty())
-	{
-		/* We retrieve the row ID of the current head of the list */
-		unsigned int *currentRowIdAddress = (unsigned int *) resultRowIds->getItemInPos(1);
+	unsigned int *resultRowIds = new unsigned int[rowsNum];
 
-		/* We retrieve the row ID value stored in the address */
-		unsigned int currentRowId = (*currentRowIdAddress);
-
-		/* We remove the current head of the list */
-		resultRowIds->removeFront();
-
-		/* We free the allocated memory for the row ID */
-		delete currentRowIdAddress;
-
-		/* We update the row ID arrays  with the row IDs indicated by the list */
-
-		for(j = 0; j < localRelsCount; j++)
-			renewedLocalRowIdArrays[j][i] = localRowIdArrays[j][currentRowId];
-
-		/* We increase the offset for the arrays */
-		i++;
-	}
-
-	/* We delete the old row ID arrays and remove them from the list */
-
-	rowIdArrays->traverseFromHead(deleteUnsignedIntegerArray);
-
-	while(!rowIdArrays->isEmpty())
-		rowIdArrays->removeFront();
-
-	/* We insert the renewed row ID arrays in the structure */
+	/* We let the table examine the reserved rows of the relation. The
+	 * table compares the elements directly in their packed form if the
+	 * table is compressed. The offsets of the satisfying rows in the
+	 * array of reserved row IDs are the row IDs of the intermediate array.
+	 */
+	unsigned long long matchesNum = table->filterColumns(filtersNum, columns,
+		filterOperators, values, reservedRowIdsOfRel, rowsNum, resultRowIds,
+		passedNums);
 
-	for(i = 0; i < localRelsCount; i++)
-		rowIdArrays->insertLast(renewedLocalRowIdArrays[i]);
+	/* We keep only the rows of the intermediate array that satisfy
+	 * the filters. The row IDs arrays are renewed only once, no matter
+	 * how many filters are applied.
+	 */
+	renewRowIdArrays(resultRowIds, matchesNum);
 
-	/* We free the allocated memory for the temporary list */
-	delete resultRowIds;
+	/* We free the allocated memory for the temporary array */
+	delete[] resultRowIds;
 }
 
 /*******************************************************
@@ -1200,13 +1831,10 @@ void IntermediateArray::produceSum(
 	/* We retrieve the table of the reserved row IDs of this relation */
 	unsigned int *reservedRowIds = (unsigned int *) rowIdArrays->getItemInPos(posOfRel);
 
-	/* Auxiliary variable (used for counting) */
-	unsigned int i;
-
-	/* We compute the suggested sum of the reserved row IDs */
-
-	for(i = 0; i < rowsNum; i++)
-		sum += table->getTable()[relColumn][reservedRowIds[i]];
+	/* We compute the suggested sum of the reserved row IDs. The table sums
+	 * the elements directly in their packed form if the table is compressed.
+	 */
+	sum = table->sumColumn(relColumn, reservedRowIds, rowsNum);
 
 	/* We print the sum in the standard output */
 	std::cout << sum;
@@ -20,8 +20,13 @@ private:
 	/* A list of unsigned integer arrays, representing the row IDs of each relation */
 	List *rowIdArrays;
 
-	/* The amount of row IDs each of the arrays has */
-	unsigned int rowsNum;
+	/* The amount of row IDs each of the arrays has. A join may leave more
+	 * rows than a row ID can address, but the positions of the rows are
+	 * the row IDs of the tuples when the array is joined again and the
+	 * offsets of the satisfying rows when it is filtered, so such an
+	 * array can only be summed (see 'requireAddressableRows').
+	 */
+	unsigned long long rowsNum;
 
 	/* The additional parameters for a 'JOIN' operation */
 	PartitionedHashJoinInput *joinParameters;
@@ -31,10 +36,42 @@ private:
      */
 	JobScheduler *jobScheduler;
 
+	/* What the last join of the array did (see 'JoinStatistics') */
+	JoinStatistics lastJoinStatistics;
+
+	/* Stops the program if the rows of the array are more than a 32-bit
+	 * position can address, since the array cannot take part in the given
+	 * operation ("join" or "filter") without wrapping its positions
+	 */
+	void requireAddressableRows(const char *operation) const;
+
 	/* Finds and returns the position in the list of the given relation */
 	unsigned int posOfRelationInList(unsigned int relationName,
 		unsigned int relationPriority) const;
 
+	/* Joins the given elements of an outer relation with an inner base table
+	 * column by probing the secondary index of that column with each element
+	 * (index nested-loop join). For each of the 'resultRowsNum' result pairs,
+	 * 'outerPositions' stores the offset of the outer element and 'innerRowIds'
+	 * stores the row ID of the inner table. Both arrays are allocated here.
+	 */
+	unsigned long long executeIndexJoin(unsigned long long *outerElements,
+		unsigned long long outerElementsNum, ColumnIndex *innerIndex,
+		unsigned int **outerPositions, unsigned int **innerRowIds) const;
+
+	/* Replaces every row ID array with a new one that keeps only the rows
+	 * in the given positions (in the given order) and updates 'rowsNum'
+	 */
+	void renewRowIdArrays(unsigned int *positions, unsigned long long newRowsNum);
+
+	/* Initializes the array with the rows of the given base table that
+	 * satisfy all the given filters (see 'executeFilters')
+	 */
+	void filterBaseTable(unsigned int relName, unsigned int relPriority,
+		unsigned int filtersNum, const unsigned int *relColumns,
+		const unsigned int *filterValues, const char *filterOperators,
+		unsigned long long *passedNums);
+
 	/* Prints a relation - used to traverse the list of relations */
 	static void printIntermediateRelation(void *item);
 
@@ -78,6 +115,21 @@ public:
 		PartitionedHashJoinInput *joinParameters,
 		JobScheduler *jobScheduler = NULL);
 
+	/* A constructor that initializes the array with one
+	 * relation that must satisfy all the given filters
+	 */
+	IntermediateArray(
+		unsigned int relName,
+		unsigned int relPriority,
+		unsigned int filtersNum,
+		const unsigned int *relColumns,
+		const unsigned int *filterValues,
+		const char *filterOperators,
+		List *tables,
+		PartitionedHashJoinInput *joinParameters,
+		JobScheduler *jobScheduler = NULL,
+		unsigned long long *passedNums = NULL);
+
 	/* Destructor */
 	~IntermediateArray();
 
@@ -88,7 +140,12 @@ public:
 	List *getRowIdArrays() const;
 
 	/* Getter - Returns the number of rows of the intermediate array */
-	unsigned int getRowsNum() const;
+	unsigned long long getRowsNum() const;
+
+	/* Getter - Returns what the last join of the array did (nothing
+	 * if it was executed without the partitioned hash join)
+	 */
+	JoinStatistics getLastJoinStatistics() const;
 
 	/* Searches whether the given relation exists in the intermediate array */
 	bool search(unsigned int foreignRelationName,
@@ -134,6 +191,21 @@ public:
 		unsigned int filterValue,
 		char filterOperator);
 
+	/* Applies all the given filters to the implied local relation with a
+	 * single pass over its reserved rows. The filters are examined in the
+	 * given order, so the most selective one should be first. If
+	 * 'passedNums' is not NULL, the amount of rows that satisfy the first
+	 * k+1 filters is stored in 'passedNums[k]' for every filter.
+	 */
+	void executeFilters(
+		unsigned int relationName,
+		unsigned int relationPriority,
+		unsigned int filtersNum,
+		const unsigned int *relationColumns,
+		const unsigned int *filterValues,
+		const char *filterOperators,
+		unsigned long long *passedNums = NULL);
+
 	/* Prints the sum of the items in the reserved row IDs
 	 * of the given relation in the requested column
 	 */
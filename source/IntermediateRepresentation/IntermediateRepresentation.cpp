@@ -247,6 +247,24 @@ void IntermediateRepresentation::executeFilter(
 	unsigned int relPriority,
 	unsigned int filterValue,
 	char filterOperator)
+{
+	executeFilters(relName, relPriority, 1, &relColumn, &filterValue,
+		&filterOperator);
+}
+
+/*********************************************************************
+ * Applies all the given filters to the given relation with a single *
+ *                        pass over its rows                         *
+ *********************************************************************/
+
+void IntermediateRepresentation::executeFilters(
+	unsigned int relName,
+	unsigned int relPriority,
+	unsigned int filtersNum,
+	const unsigned int *relColumns,
+	const unsigned int *filterValues,
+	const char *filterOperators,
+	unsigned long long *passedNums)
 {
 	/* We search the relation in the intermediate representation */
 	IntermediateArray *intermediateArray = relationExists(relName, relPriority);
@@ -257,27 +275,31 @@ void IntermediateRepresentation::executeFilter(
 	{
 		IntermediateArray *newArray = new IntermediateArray(
 			relName,
-			relColumn,
 			relPriority,
-			filterValue,
-			filterOperator,
+			filtersNum,
+			relColumns,
+			filterValues,
+			filterOperators,
 			tables,
 			joinParameters,
-			jobScheduler);
+			jobScheduler,
+			passedNums);
 
 		intermediateArrays->insertLast(newArray);
 	}
 
-	/* Else we have the array apply the filter on the relation */
+	/* Else we have the array apply the filters on the relation */
 
 	else
 	{
-		intermediateArray->executeFilter(
+		intermediateArray->executeFilters(
 			relName,
-			relColumn,
 			relPriority,
-			filterValue,
-			filterOperator);
+			filtersNum,
+			relColumns,
+			filterValues,
+			filterOperators,
+			passedNums);
 	}
 }
 
@@ -299,8 +321,8 @@ void IntermediateRepresentation::produceSum(
 	 */
 	if(intermediateArray == NULL)
 	{
-		/* The sum (initialized with zero) and an auxiliary counter */
-		unsigned long long sum = 0, i;
+		/* The sum (initialized with zero) */
+		unsigned long long sum = 0;
 
 		/* We retrieve the table pointed by the relation name */
 		Table *table = (Table *) tables->getItemInPos(relName + 1);
@@ -318,8 +340,7 @@ void IntermediateRepresentation::produceSum(
 		 */
 		else
 		{
-			for(i = 0; i < numRows; i++)
-				sum += table->getTable()[relColumn][i];
+			sum = table->sumColumn(relColumn, NULL, numRows);
 
 			std::cout << sum;
 		}
@@ -21,13 +21,6 @@ private:
      */
 	JobScheduler *jobScheduler;
 
-	/* Searches if the given relation exists in any of the
-	 * intermediate arrays of the intermediate representation.
-	 * If it exists, that intermediate array is returned
-	 */
-	IntermediateArray *relationExists(unsigned int relationName,
-		unsigned int relationPriority) const;
-
 	/* Returns the position in the list of the given intermediate array */
 	unsigned int posOfIntermediateArray(IntermediateArray *array) const;
 
@@ -50,6 +43,13 @@ public:
 	/* Getter - Returns the additional parameters for the 'JOIN' operation */
 	PartitionedHashJoinInput *getJoinParameters() const;
 
+	/* Searches if the given relation exists in any of the
+	 * intermediate arrays of the intermediate representation.
+	 * If it exists, that intermediate array is returned
+	 */
+	IntermediateArray *relationExists(unsigned int relationName,
+		unsigned int relationPriority) const;
+
 	/* Executes the 'JOIN' operation between the two given relations */
 	void executeJoin(
 		unsigned int leftRel,
@@ -67,6 +67,20 @@ public:
 		unsigned int filterValue,
 		char filterOperator);
 
+	/* Applies all the given filters to the given relation with a single
+	 * pass over its rows. The filters are examined in the given order.
+	 * If 'passedNums' is not NULL, the amount of rows that satisfy the
+	 * first k+1 filters is stored in 'passedNums[k]' for every filter.
+	 */
+	void executeFilters(
+		unsigned int relName,
+		unsigned int relPriority,
+		unsigned int filtersNum,
+		const unsigned int *relColumns,
+		const unsigned int *filterValues,
+		const char *filterOperators,
+		unsigned long long *passedNums = NULL);
+
 	/* Prints the sum of the items in the reserved row IDs
 	 * of the given relation in the requested column
 	 */
@@ -4,6 +4,14 @@
 #include <pthread.h>
 #include "Tuple.h"
 #include "List.h"
+#include "CachedBuildSide.h"
+#include "HashFunctionType.h"
+
+class PartitionedHashJoin;
+class RowIdRelation;
+class RowIdPair;
+struct SortedTuple;
+class ArrayJoin;
 
 /* The Input for a Histogram Job
  *                 ^^^^^^^^^
@@ -25,6 +33,9 @@ struct HistogramJobInput {
     /* Determines the amount of bits selected for hashing */
     unsigned int bitsNumForHashing;
 
+    /* The hash function that partitions the relation */
+    HashFunctionType hashFunction;
+
     /* A simple constructor for the structure */
 
     HistogramJobInput(
@@ -32,12 +43,14 @@ struct HistogramJobInput {
         Tuple *relation,
         unsigned int leftLimit,
         unsigned int rightLimit,
-        unsigned int bitsNumForHashing
+        unsigned int bitsNumForHashing,
+        HashFunctionType hashFunction
     ) : histogram(histogram),
         relation(relation),
         leftLimit(leftLimit),
         rightLimit(rightLimit),
-        bitsNumForHashing(bitsNumForHashing)
+        bitsNumForHashing(bitsNumForHashing),
+        hashFunction(hashFunction)
     {}
 
 };
@@ -68,6 +81,9 @@ struct PartitionJobInput {
     /* Determines the amount of bits selected for hashing */
     unsigned int bitsNumForHashing;
 
+    /* The hash function that partitions the relation */
+    HashFunctionType hashFunction;
+
     /* The utility mutex that will be used in critical sections inside the job
      *                                                          ^^^^^^
      */
@@ -83,6 +99,7 @@ struct PartitionJobInput {
         unsigned int leftLimit,
         unsigned int rightLimit,
         unsigned int bitsNumForHashing,
+        HashFunctionType hashFunction,
         pthread_mutex_t *utilityMutex
     ) : relation(relation),
         reorderedRelation(reorderedRelation),
@@ -91,6 +108,7 @@ struct PartitionJobInput {
         leftLimit(leftLimit),
         rightLimit(rightLimit),
         bitsNumForHashing(bitsNumForHashing),
+        hashFunction(hashFunction),
         utilityMutex(utilityMutex)
     {}
 
@@ -101,8 +119,16 @@ struct PartitionJobInput {
  */
 struct JoinJobInput {
 
-    /* The rank of the job */
-    unsigned int rank;
+    /* The buckets that must be joined, the largest ones first, grouped
+     * in batches (batch 'i' consists of the buckets of 'bucketOrder' from
+     * 'batchBounds[i]' until 'batchBounds[i + 1]'). The jobs share the
+     * batches through the cursor 'nextBatch', which every job moves one
+     * batch forward at a time with an atomic addition.
+     */
+    unsigned int *bucketOrder;
+    unsigned int *batchBounds;
+    unsigned int batchesNum;
+    unsigned int *nextBatch;
 
     /* The left and right relations whose buckets must be joined */
     Tuple *leftRel;
@@ -120,7 +146,6 @@ struct JoinJobInput {
     unsigned int bucketsNum;
 
     /* The parameters to configure a Hopscotch Hash Table */
-    unsigned int hopscotchBuckets;
     unsigned int hopscotchRange;
     bool resizableByLoadFactor;
     double loadFactor;
@@ -133,16 +158,22 @@ struct JoinJobInput {
     /* The list where all the results will be deposited */
     List *result;
 
-    /* In some cases we do not need to actually execute
-     * the job because the buckets have been joined already
-     * in the past. It happens in cases of multipartitioning
+    /* The cached build sides of the left and right relation (or 'NULL') */
+    CachedBuildSide *leftCache;
+    CachedBuildSide *rightCache;
+
+    /* The hash function of the family that partitioned the relations,
+     * which places the tuples of a bucket in its hash table
      */
-    bool resultHasAlreadyBeenDeposited;
+    HashFunctionType hashFunction;
 
     /* A simple constructor for the structure */
 
     JoinJobInput(
-        unsigned int rank,
+        unsigned int *bucketOrder,
+        unsigned int *batchBounds,
+        unsigned int batchesNum,
+        unsigned int *nextBatch,
         Tuple *leftRel,
         Tuple *rightRel,
         unsigned int leftRelSize,
@@ -150,14 +181,18 @@ struct JoinJobInput {
         unsigned int *leftPrefixSum,
         unsigned int *rightPrefixSum,
         unsigned int bucketsNum,
-        unsigned int hopscotchBuckets,
         unsigned int hopscotchRange,
         bool resizableByLoadFactor,
         double loadFactor,
         pthread_mutex_t *utilityMutex,
         List *result,
-        bool resultHasAlreadyBeenDeposited
-    ) : rank(rank),
+        CachedBuildSide *leftCache = NULL,
+        CachedBuildSide *rightCache = NULL,
+        HashFunctionType hashFunction = BitsHash
+    ) : bucketOrder(bucketOrder),
+        batchBounds(batchBounds),
+        batchesNum(batchesNum),
+        nextBatch(nextBatch),
         leftRel(leftRel),
         rightRel(rightRel),
         leftRelSize(leftRelSize),
@@ -165,13 +200,177 @@ struct JoinJobInput {
         leftPrefixSum(leftPrefixSum),
         rightPrefixSum(rightPrefixSum),
         bucketsNum(bucketsNum),
-        hopscotchBuckets(hopscotchBuckets),
         hopscotchRange(hopscotchRange),
         resizableByLoadFactor(resizableByLoadFactor),
         loadFactor(loadFactor),
         utilityMutex(utilityMutex),
         result(result),
-        resultHasAlreadyBeenDeposited(resultHasAlreadyBeenDeposited)
+        leftCache(leftCache),
+        rightCache(rightCache),
+        hashFunction(hashFunction)
+    {}
+
+};
+
+/* The Input for a Subjoin Job
+ *                 ^^^^^^^
+ */
+struct SubjoinJobInput {
+
+    /* The join of two buckets that need further partition */
+    PartitionedHashJoin *subjoin;
+
+    /* The output buffer where the result of the join will be
+     * deposited (it is written only by this job)
+     */
+    RowIdRelation **result;
+
+    /* A simple constructor for the structure */
+    SubjoinJobInput(
+        PartitionedHashJoin *subjoin,
+        RowIdRelation **result
+    ) : subjoin(subjoin),
+        result(result)
+    {}
+
+};
+
+/* The Input for a Cross Product Job
+ *                 ^^^^^^^^^^^^^
+ */
+struct CrossProductJobInput {
+
+    /* A piece of the tuples of a heavy hitter in one relation */
+    Tuple *outerTuples;
+    unsigned int outerTuplesNum;
+
+    /* All the tuples of the same heavy hitter in the other relation */
+    Tuple *innerTuples;
+    unsigned int innerTuplesNum;
+
+    /* Determines whether the outer tuples belong to 'R' */
+    bool outerIsR;
+
+    /* The part of the output buffer where the row ID pairs of
+     * the piece will be written (it is written only by this job)
+     */
+    RowIdPair *result;
+
+    /* A simple constructor for the structure */
+    CrossProductJobInput(
+        Tuple *outerTuples,
+        unsigned int outerTuplesNum,
+        Tuple *innerTuples,
+        unsigned int innerTuplesNum,
+        bool outerIsR,
+        RowIdPair *result
+    ) : outerTuples(outerTuples),
+        outerTuplesNum(outerTuplesNum),
+        innerTuples(innerTuples),
+        innerTuplesNum(innerTuplesNum),
+        outerIsR(outerIsR),
+        result(result)
+    {}
+
+};
+
+/* The Input for a Sort Job
+ *                 ^^^^
+ */
+struct SortJobInput {
+
+    /* The tuples that will be sorted by their keys */
+    SortedTuple *tuples;
+
+    /* An array with as many tuples, which the job may overwrite */
+    SortedTuple *buffer;
+
+    /* The amount of tuples of both arrays */
+    unsigned int tuplesNum;
+
+    /* The tuples are sorted by the rightmost 'bitsNum' bits
+     * of their keys after 'minKey' is subtracted from them
+     */
+    unsigned long long minKey;
+    unsigned int bitsNum;
+
+    /* A simple constructor for the structure */
+    SortJobInput(
+        SortedTuple *tuples,
+        SortedTuple *buffer,
+        unsigned int tuplesNum,
+        unsigned long long minKey,
+        unsigned int bitsNum
+    ) : tuples(tuples),
+        buffer(buffer),
+        tuplesNum(tuplesNum),
+        minKey(minKey),
+        bitsNum(bitsNum)
+    {}
+
+};
+
+/* The Input for a Merge Job
+ *                 ^^^^^
+ */
+struct MergeJobInput {
+
+    /* A range of the sorted tuples of 'R' */
+    SortedTuple *R_tuples;
+    unsigned int R_tuplesNum;
+
+    /* The range of the sorted tuples of 'S' with the same keys */
+    SortedTuple *S_tuples;
+    unsigned int S_tuplesNum;
+
+    /* The output buffer where the row ID pairs of the ranges
+     * will be deposited (it is written only by this job)
+     */
+    RowIdRelation **result;
+
+    /* A simple constructor for the structure */
+    MergeJobInput(
+        SortedTuple *R_tuples,
+        unsigned int R_tuplesNum,
+        SortedTuple *S_tuples,
+        unsigned int S_tuplesNum,
+        RowIdRelation **result
+    ) : R_tuples(R_tuples),
+        R_tuplesNum(R_tuplesNum),
+        S_tuples(S_tuples),
+        S_tuplesNum(S_tuplesNum),
+        result(result)
+    {}
+
+};
+
+/* The Input for an Array Probe Job
+ *                    ^^^^^^^^^^^
+ */
+struct ArrayProbeJobInput {
+
+    /* The array join whose build side is probed */
+    ArrayJoin *join;
+
+    /* A range of the tuples of the probe side */
+    Tuple *probeTuples;
+    unsigned int probeTuplesNum;
+
+    /* The output buffer where the row ID pairs of the range
+     * will be deposited (it is written only by this job)
+     */
+    RowIdRelation **result;
+
+    /* A simple constructor for the structure */
+    ArrayProbeJobInput(
+        ArrayJoin *join,
+        Tuple *probeTuples,
+        unsigned int probeTuplesNum,
+        RowIdRelation **result
+    ) : join(join),
+        probeTuples(probeTuples),
+        probeTuplesNum(probeTuplesNum),
+        result(result)
     {}
 
 };
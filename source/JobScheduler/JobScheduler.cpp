@@ -2,6 +2,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include "JobScheduler.h"
 
 /************************************************************
@@ -170,15 +171,11 @@ static void cond_broadcast(pthread_cond_t *condition_variable)
 /*****************************************************************
  *  Returns 'true' if there are no working threads. If at least  *
  * one thread is working on a job, the operation returns 'false' *
+ *        (the status mutex must be locked by the caller)        *
  *****************************************************************/
 
 bool JobScheduler::silence()
 {
-	/* We lock the status mutex before we
-	 * take any actions on the shared array
-	 */
-	lock(&statusMutex);
-
 	/* Initially we consider there is silence */
 	bool result = true;
 
@@ -196,9 +193,6 @@ bool JobScheduler::silence()
 			result = false;
 	}
 
-	/* We unlock the mutex guarding the array */
-	unlock(&statusMutex);
-
 	/* We return the final result */
 	return result;
 }
@@ -242,6 +236,7 @@ void *JobScheduler::threadsRoutine(void *input)
 	pthread_mutex_t *mutexForJobs = threadInput->job_mutex;
 	pthread_mutex_t *mutexForStatus = threadInput->status_mutex;
 	Queue *jobsInQueue = threadInput->queue;
+	double *busyTimes = threadInput->busy_times;
 
 	while(1)
 	{
@@ -264,12 +259,16 @@ void *JobScheduler::threadsRoutine(void *input)
 			/* We update the status with 'false' (= non-working) */
 			workStatus[myRank] = false;
 
+			/* We signal the main thread in case it is sleeping. The
+			 * main thread sleeps with the status mutex, so we signal
+			 * it before unlocking the mutex, or else the signal could
+			 * be lost between its check of the status and its sleep.
+			 */
+			cond_signal(sleepCondVar);
+
 			/* We unlock the mutex guarding the table */
 			unlock(mutexForStatus);
 
-			/* We signal the main thread in case it is sleeping */
-			cond_signal(sleepCondVar);
-
 			/* We wait on the exit condition variable until
 			 * a job is available
 			 */
@@ -338,8 +337,21 @@ void *JobScheduler::threadsRoutine(void *input)
 		 */
 		unlock(mutexForJobs);
 
-		/* The thread executes the next job */
+		/* The thread executes the next job, measuring how long it takes */
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
 		nextJob->executeJob();
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		/* We add the time of the job to the busy time of the thread */
+		lock(mutexForStatus);
+
+		busyTimes[myRank] += (double) (end.tv_sec - start.tv_sec)
+			+ (double) (end.tv_nsec - start.tv_nsec) / 1000000000.0;
+
+		unlock(mutexForStatus);
 	}
 
 	/* Here each thread exits */
@@ -365,7 +377,6 @@ JobScheduler::JobScheduler(unsigned int maxThreads)
 	cond_init(&sleepConditionVariable);
 	mutex_init(&jobMutex);
 	mutex_init(&queueMutex);
-	mutex_init(&sleepMutex);
 	mutex_init(&statusMutex);
 	mutex_init(utilityMutex);
 
@@ -380,6 +391,9 @@ JobScheduler::JobScheduler(unsigned int maxThreads)
 	/* We set each working status to 'false' by using 'calloc' */
 	workingStatus = (bool *) calloc(maxThreads, sizeof(bool));
 
+	/* Initially no thread has executed a job */
+	busyTimes = (double *) calloc(maxThreads, sizeof(double));
+
 	/* We initialize the array of threads */
 	threads = new pthread_t[maxThreads];
 
@@ -401,7 +415,8 @@ JobScheduler::JobScheduler(unsigned int maxThreads)
 			&queueMutex,
 			&statusMutex,
 			utilityMutex,
-			submittedJobs);
+			submittedJobs,
+			busyTimes);
 
 		/* We create a new thread */
 
@@ -449,10 +464,14 @@ JobScheduler::~JobScheduler()
 		/* We unlock the mutex guarding the queue */
 		unlock(&queueMutex);
 
-		/* We signal one of the threads that
-		 * there are new items in the queue
+		/* We signal one of the threads that there are new items
+		 * in the queue. A thread checks the queue and sleeps while
+		 * it holds the job mutex, so we lock the job mutex before
+		 * the signal, or else the signal could be lost.
 		 */
+		lock(&jobMutex);
 		cond_signal(&exitConditionVariable);
+		unlock(&jobMutex);
 	}
 
 	/* We terminate the threads */
@@ -485,6 +504,9 @@ JobScheduler::~JobScheduler()
 	/* We free the allocated memory for the working status of each thread */
 	free(workingStatus);
 
+	/* We free the allocated memory for the busy time of each thread */
+	free(busyTimes);
+
 	/* We free the allocated memory for the queue */
 	delete submittedJobs;
 
@@ -493,7 +515,6 @@ JobScheduler::~JobScheduler()
 	cond_destroy(&sleepConditionVariable);
 	mutex_destroy(&jobMutex);
 	mutex_destroy(&queueMutex);
-	mutex_destroy(&sleepMutex);
 	mutex_destroy(&statusMutex);
 	mutex_destroy(utilityMutex);
 
@@ -546,7 +567,12 @@ void JobScheduler::submitJob(Job *newJob)
 
 void JobScheduler::executeAllJobs()
 {
+	/* A thread checks the queue and sleeps while it holds the job
+	 * mutex, so the signal is not lost between the check and the sleep
+	 */
+	lock(&jobMutex);
 	cond_signal(&exitConditionVariable);
+	unlock(&jobMutex);
 }
 
 /******************************************************
@@ -555,19 +581,18 @@ void JobScheduler::executeAllJobs()
 
 void JobScheduler::waitAllTasksFinish()
 {
-	/* This mutex is only used by the main thread, not
-	 * by mutliple threads. So why do we use it? -> We
-	 * use it just because we want to be able to wait
-	 * on the sleep condition variable. The main thread
-	 * should sleep on a condition variable while the
-	 * worker threads are executing their jobs. When all
-	 * the threads finish their jobs and no more jobs
-	 * are in the queue, the main thread is signaled.
+	/* The main thread should sleep on a condition variable
+	 * while the worker threads are executing their jobs.
+	 * When all the threads finish their jobs and no more
+	 * jobs are in the queue, the main thread is signaled.
 	 *
-	 * We lock the sleep mutex to prepare a wait on the
-	 * sleep condition variable.
+	 * A thread that becomes idle updates its status and
+	 * signals the main thread while it holds the status
+	 * mutex. So we sleep with the status mutex, in order
+	 * for the signal not to be lost between our check of
+	 * the status and our sleep.
 	 */
-	lock(&sleepMutex);
+	lock(&statusMutex);
 
 	/* As long as there are still working threads or the
 	 * queue of jobs is not empty, the main thread sleeps
@@ -575,8 +600,29 @@ void JobScheduler::waitAllTasksFinish()
 	 * all jobs are finished
 	 */
 	while((!silence()) || (!queueIsEmpty(submittedJobs, &queueMutex)))
-		cond_wait(&sleepConditionVariable, &sleepMutex);
+		cond_wait(&sleepConditionVariable, &statusMutex);
+
+	/* We unlock the status mutex */
+	unlock(&statusMutex);
+}
+
+/**************************************************************
+ * Getter - Returns the seconds all the threads together have *
+ *    spent executing jobs since the scheduler was created    *
+ **************************************************************/
+
+double JobScheduler::getBusyTime()
+{
+	/* We lock the status mutex before we read the busy times */
+	lock(&statusMutex);
+
+	double busyTime = 0;
+
+	for(unsigned int i = 0; i < maxThreads; i++)
+		busyTime += busyTimes[i];
+
+	/* We unlock the mutex guarding the busy times */
+	unlock(&statusMutex);
 
-	/* We unlock the sleep mutex */
-	unlock(&sleepMutex);
+	return busyTime;
 }
@@ -34,6 +34,11 @@ struct ThreadInput {
 	/* The job queue is part of the threads' input */
 	Queue *queue;
 
+	/* The seconds each thread has spent executing jobs
+	 * (guarded by the status mutex)
+	 */
+	double *busy_times;
+
 	/* A simple constructor for the structure */
 	ThreadInput(
 		unsigned int rank,
@@ -44,9 +49,11 @@ struct ThreadInput {
 		pthread_mutex_t *queue_mutex,
 		pthread_mutex_t *status_mutex,
 		pthread_mutex_t *utility_mutex,
-		Queue *queue) : rank(rank), work_table(work_table), exit_var(exit_var),
+		Queue *queue,
+		double *busy_times) : rank(rank), work_table(work_table), exit_var(exit_var),
 		sleep_var(sleep_var), job_mutex(job_mutex), queue_mutex(queue_mutex),
-		status_mutex(status_mutex), utility_mutex(utility_mutex), queue(queue) {}
+		status_mutex(status_mutex), utility_mutex(utility_mutex), queue(queue),
+		busy_times(busy_times) {}
 
 };
 
@@ -80,9 +87,6 @@ private:
 	/* A mutex that will be guarding the queue of jobs */
 	pthread_mutex_t queueMutex;
 
-	/* A mutex that will be guarding the queue of jobs */
-	pthread_mutex_t sleepMutex;
-
 	/* A mutex that will be guarding the working status table */
 	pthread_mutex_t statusMutex;
 
@@ -91,8 +95,12 @@ private:
 	 */
 	pthread_mutex_t *utilityMutex;
 
+	/* The seconds each thread has spent executing jobs */
+	double *busyTimes;
+
 	/* Returns 'true' if there are no working threads. If at least
 	 * one thread is working on a job, the operation returns 'false'
+	 * (the status mutex must be locked by the caller)
 	 */
 	bool silence();
 
@@ -122,6 +130,12 @@ public:
 	/* Getter - Returns the utility mutex to the user */
 	pthread_mutex_t *getUtilityMutex() const;
 
+	/* Getter - Returns the seconds all the threads together have spent
+	 * executing jobs since the scheduler was created. Divided by the
+	 * threads and the elapsed time, it gives the utilization of the threads.
+	 */
+	double getBusyTime();
+
 	/* Places a new job at the end of the queue */
 	void submitJob(Job *newJob);
 
@@ -32,7 +32,7 @@ Listnode *List::getTail() const
 	return tail;
 }
 
-unsigned int List::getCounter() const
+unsigned long long List::getCounter() const
 {
 	return counter;
 }
@@ -51,7 +51,7 @@ void List::setTail(Listnode *new_tail)
 	tail = new_tail;
 }
 
-void List::setCounter(unsigned int new_counter)
+void List::setCounter(unsigned long long new_counter)
 {
 	counter = new_counter;
 }
@@ -92,7 +92,7 @@ void *List::getItemInPos(unsigned int pos) const
 	else
 	{
 		current = tail;
-		unsigned int i = counter;
+		unsigned long long i = counter;
 
 		while(i > pos)
 		{
@@ -261,7 +261,7 @@ void List::insertAfterPos(void *item, unsigned int pos)
 	else
 	{
 		current = tail;
-		unsigned int i = counter;
+		unsigned long long i = counter;
 
 		while(i > pos)
 		{
@@ -331,7 +331,7 @@ void List::insertBeforePos(void *item, unsigned int pos)
 	else
 	{
 		current = tail;
-		unsigned int i = counter;
+		unsigned long long i = counter;
 
 		while(i > pos)
 		{
@@ -525,7 +525,7 @@ void List::removePos(unsigned int pos)
 	else
 	{
 		current = tail;
-		unsigned int i = counter;
+		unsigned long long i = counter;
 
 		while(i > pos)
 		{
@@ -674,10 +674,10 @@ void List::split(List **firstPart, List **secondPart)
 	Listnode *current = head;
 
 	/* We keep a counter on how many nodes we have copied */
-	unsigned int pos = 1;
+	unsigned long long pos = 1;
 
 	/* We find the index of the middle position in the list */
-	unsigned int middle_pos = (counter + 1) / 2;
+	unsigned long long middle_pos = (counter + 1) / 2;
 
 	/* As long as we have not reached the middle position,
 	 * we copy each node to the list storing the left part
@@ -13,7 +13,7 @@ protected:
  */
 	Listnode *head;
 	Listnode *tail;
-	unsigned int counter;
+	unsigned long long counter;
 
 public:
 
@@ -24,12 +24,12 @@ public:
 /* Getters */
 	Listnode *getHead() const;
 	Listnode *getTail() const;
-	unsigned int getCounter() const;
+	unsigned long long getCounter() const;
 
 /* Setters */
 	void setHead(Listnode *new_head);
 	void setTail(Listnode *new_tail);
-	void setCounter(unsigned int new_counter);
+	void setCounter(unsigned long long new_counter);
 
 /* Retrieve the item saved after 'pos' nodes */
 	void *getItemInPos(unsigned int pos) const;
@@ -0,0 +1,200 @@
+#include <iostream>
+#include "BuildSideCache.h"
+
+/***********************************************
+ * Compares two build sides by their addresses *
+ ***********************************************/
+
+static int compareBuildSides(void *item_1, void *item_2)
+{
+    return (item_1 == item_2) ? 0 : 1;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+BuildSideCache::BuildSideCache(unsigned long long budgetBytes)
+{
+    this->budgetBytes = budgetBytes;
+    entries = new List();
+    clock = 0;
+
+    pthread_mutex_init(&mutex, NULL);
+}
+
+/**************
+ * Destructor *
+ **************/
+
+BuildSideCache::~BuildSideCache()
+{
+    /* We free every cached build side and then the list itself */
+
+    while(!entries->isEmpty())
+    {
+        delete (CachedBuildSide *) entries->getHead()->getItem();
+        entries->removeFront();
+    }
+
+    delete entries;
+
+    pthread_mutex_destroy(&mutex);
+}
+
+/*************************************************************
+ * Getter - Returns the maximum amount of bytes of the cache *
+ *************************************************************/
+
+unsigned long long BuildSideCache::getBudgetBytes() const
+{
+    return budgetBytes;
+}
+
+/***************************************************************
+ * Returns the amount of build sides that are currently cached *
+ ***************************************************************/
+
+unsigned int BuildSideCache::getEntriesNum()
+{
+    pthread_mutex_lock(&mutex);
+    unsigned int entriesNum = entries->getCounter();
+    pthread_mutex_unlock(&mutex);
+
+    return entriesNum;
+}
+
+/******************************************************************
+ * Returns the amount of bytes that the cached build sides occupy *
+ ******************************************************************/
+
+unsigned long long BuildSideCache::getMemoryBytes()
+{
+    unsigned long long memoryBytes = 0;
+
+    pthread_mutex_lock(&mutex);
+
+    for(Listnode *current = entries->getHead(); current != NULL; current = current->getNext())
+        memoryBytes += ((CachedBuildSide *) current->getItem())->getMemoryBytes();
+
+    pthread_mutex_unlock(&mutex);
+
+    return memoryBytes;
+}
+
+/****************************************************************
+ * Evicts least recently used build sides that no join is using *
+ *    until the rest of them fit in the budget of the cache     *
+ ****************************************************************/
+
+void BuildSideCache::evictEntries()
+{
+    while(1)
+    {
+        /* We find the bytes all the build sides occupy and the least
+         * recently used build side among those no join is using
+         */
+        unsigned long long memoryBytes = 0;
+        CachedBuildSide *victim = NULL;
+
+        for(Listnode *current = entries->getHead(); current != NULL; current = current->getNext())
+        {
+            CachedBuildSide *buildSide = (CachedBuildSide *) current->getItem();
+            memoryBytes += buildSide->getMemoryBytes();
+
+            if(buildSide->getUsersNum() == 0 &&
+                (victim == NULL || buildSide->getLastUse() < victim->getLastUse()))
+            {
+                victim = buildSide;
+            }
+        }
+
+        /* If the build sides fit in the budget or every build
+         * side is being used by some join, we stop evicting
+         */
+        if(memoryBytes <= budgetBytes || victim == NULL)
+            return;
+
+        entries->removeKeyNode(victim, compareBuildSides);
+        delete victim;
+    }
+}
+
+/**********************************************************************
+ * Returns the cached build side of the given column of the table. It *
+ *  is created now if it is not cached. Returns 'NULL' if the column  *
+ *                  alone does not fit in the budget                  *
+ **********************************************************************/
+
+CachedBuildSide *BuildSideCache::acquire(
+    Table *table,
+    unsigned int relation,
+    unsigned int column,
+    unsigned int bitsNumForHashing,
+    HashFunctionType hashFunction)
+{
+    /* If the column would not fit in the cache even if it was
+     * the only cached column, we do not cache it at all
+     */
+    if(CachedBuildSide::estimateMemoryBytes(table->getNumOfTuples(),
+        bitsNumForHashing) > budgetBytes)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    /* We search the requested build side among the cached ones */
+    CachedBuildSide *result = NULL;
+
+    for(Listnode *current = entries->getHead(); current != NULL; current = current->getNext())
+    {
+        CachedBuildSide *buildSide = (CachedBuildSide *) current->getItem();
+
+        if(buildSide->getRelation() == relation && buildSide->getColumn() == column
+            && buildSide->getBitsNumForHashing() == bitsNumForHashing
+            && buildSide->getHashFunction() == hashFunction)
+        {
+            result = buildSide;
+            break;
+        }
+    }
+
+    /* If the build side is not cached, we create it now */
+
+    if(result == NULL)
+    {
+        result = new CachedBuildSide(table, relation, column,
+            bitsNumForHashing, hashFunction);
+        entries->insertLast(result);
+    }
+
+    /* The build side is now used by one more join */
+    result->setUsersNum(result->getUsersNum() + 1);
+    result->setLastUse(++clock);
+
+    /* We make room for the new build side if the cache is full */
+    evictEntries();
+
+    pthread_mutex_unlock(&mutex);
+
+    return result;
+}
+
+/*********************************************************************
+ * Informs the cache that a join does not use the build side anymore *
+ *********************************************************************/
+
+void BuildSideCache::release(CachedBuildSide *buildSide)
+{
+    pthread_mutex_lock(&mutex);
+
+    buildSide->setUsersNum(buildSide->getUsersNum() - 1);
+
+    /* The hash tables the join kept in the build side may have
+     * made the cache exceed its budget, so we evict if needed
+     */
+    evictEntries();
+
+    pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,69 @@
+#ifndef _BUILD_SIDE_CACHE_H_
+#define _BUILD_SIDE_CACHE_H_
+
+#include <pthread.h>
+#include "List.h"
+#include "CachedBuildSide.h"
+
+/* A memory-bounded cache of the partitioned and hashed columns of the base
+ * tables, keyed by (relation, column, bits and hash function used for
+ * partitioning). When the cached build sides occupy more bytes than the
+ * budget of the cache, the least recently used ones that no join is using
+ * are evicted.
+ */
+class BuildSideCache {
+
+private:
+
+/* The cached build sides (each one knows when it was last requested) */
+    List *entries;
+
+/* The maximum amount of bytes the cached build sides may occupy */
+    unsigned long long budgetBytes;
+
+/* Increases by one every time a build side is requested */
+    unsigned long long clock;
+
+/* Guards the list of entries and the users of each entry */
+    pthread_mutex_t mutex;
+
+/* Evicts least recently used build sides that no join is using
+ * until the rest of them fit in the budget of the cache
+ */
+    void evictEntries();
+
+public:
+
+/* Constructor - Creates an empty cache with the given budget in bytes */
+    BuildSideCache(unsigned long long budgetBytes);
+
+/* Destructor - Frees every cached build side */
+    ~BuildSideCache();
+
+/* Getter - Returns the maximum amount of bytes of the cache */
+    unsigned long long getBudgetBytes() const;
+
+/* Returns the amount of build sides that are currently cached */
+    unsigned int getEntriesNum();
+
+/* Returns the amount of bytes that the cached build sides occupy */
+    unsigned long long getMemoryBytes();
+
+/* Returns the cached build side of the given column of the table, which
+ * is created now if it is not cached. Returns 'NULL' if the column alone
+ * does not fit in the budget. The returned build side will not be evicted
+ * until it is given back to the cache with 'release'.
+ */
+    CachedBuildSide *acquire(
+        Table *table,
+        unsigned int relation,
+        unsigned int column,
+        unsigned int bitsNumForHashing,
+        HashFunctionType hashFunction = BitsHash);
+
+/* Informs the cache that a join does not use the build side anymore */
+    void release(CachedBuildSide *buildSide);
+
+};
+
+#endif
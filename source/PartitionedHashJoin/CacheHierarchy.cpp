@@ -0,0 +1,257 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "CacheHierarchy.h"
+
+/******************************************************************
+ * Reads the first line of the given file in the given buffer and *
+ *         returns 'false' if the file could not be read          *
+ ******************************************************************/
+
+static bool readFirstLine(const char *path, char *buffer, unsigned int bufferSize)
+{
+    FILE *file = fopen(path, "r");
+
+    if(file == NULL)
+        return false;
+
+    bool success = (fgets(buffer, bufferSize, file) != NULL);
+    fclose(file);
+
+    return success;
+}
+
+/*******************************************************************
+ * Converts a size of sysfs (like "48K" or "8M") to bytes. Returns *
+ *              zero if the size cannot be converted               *
+ *******************************************************************/
+
+static unsigned long long parseSysfsSize(const char *size)
+{
+    char *suffix;
+    unsigned long long result = strtoull(size, &suffix, 10);
+
+    if(*suffix == 'K')
+        result <<= 10;
+
+    else if(*suffix == 'M')
+        result <<= 20;
+
+    else if(*suffix == 'G')
+        result <<= 30;
+
+    return result;
+}
+
+/**********************************************
+ * The hierarchy of the system, which is read *
+ *      once, before the program starts       *
+ **********************************************/
+
+static CacheHierarchy systemHierarchy;
+
+/***************
+ * Constructor *
+ ***************/
+
+CacheHierarchy::CacheHierarchy()
+{
+    /* Initially no part of the hierarchy is known */
+    lvl1CacheSize = 0;
+    lvl2CacheSize = 0;
+    lvl3CacheSize = 0;
+    cacheLineSize = 0;
+    dataTlbEntries = 0;
+
+    readSysfsCaches();
+    readTlbEntries();
+
+    /* Whatever sysfs does not tell, we ask from 'sysconf' */
+    long value;
+
+    if(lvl1CacheSize == 0 && (value = sysconf(_SC_LEVEL1_DCACHE_SIZE)) > 0)
+        lvl1CacheSize = value;
+
+    if(lvl2CacheSize == 0 && (value = sysconf(_SC_LEVEL2_CACHE_SIZE)) > 0)
+        lvl2CacheSize = value;
+
+    if(lvl3CacheSize == 0 && (value = sysconf(_SC_LEVEL3_CACHE_SIZE)) > 0)
+        lvl3CacheSize = value;
+
+    if(cacheLineSize == 0 && (value = sysconf(_SC_LEVEL1_DCACHE_LINESIZE)) > 0)
+        cacheLineSize = value;
+
+    value = sysconf(_SC_PAGESIZE);
+    pageSize = (value > 0) ? value : DEFAULT_PAGE_SIZE;
+
+    /* Whatever the system cannot tell at all, we assume */
+    if(lvl1CacheSize == 0) lvl1CacheSize = DEFAULT_LVL1_CACHE_SIZE;
+    if(lvl2CacheSize == 0) lvl2CacheSize = DEFAULT_LVL2_CACHE_SIZE;
+    if(lvl3CacheSize == 0) lvl3CacheSize = DEFAULT_LVL3_CACHE_SIZE;
+    if(cacheLineSize == 0) cacheLineSize = DEFAULT_CACHE_LINE_SIZE;
+    if(dataTlbEntries == 0) dataTlbEntries = DEFAULT_DATA_TLB_ENTRIES;
+}
+
+/******************************************************
+ * Reads the caches of the first processor from sysfs *
+ ******************************************************/
+
+void CacheHierarchy::readSysfsCaches()
+{
+    char path[128], value[64], type[64];
+
+    /* Every directory 'indexN' describes one cache of the processor */
+    for(unsigned int index = 0; ; index++)
+    {
+        snprintf(path, sizeof(path),
+            "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+
+        if(!readFirstLine(path, value, sizeof(value)))
+            break;
+
+        unsigned int level = strtoul(value, NULL, 10);
+
+        /* The instruction caches do not hold the relations */
+        snprintf(path, sizeof(path),
+            "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+
+        if(!readFirstLine(path, type, sizeof(type)) || !strncmp(type, "Instruction", 11))
+            continue;
+
+        snprintf(path, sizeof(path),
+            "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+
+        if(!readFirstLine(path, value, sizeof(value)))
+            continue;
+
+        unsigned long long size = parseSysfsSize(value);
+
+        if(level == 1) lvl1CacheSize = size;
+        else if(level == 2) lvl2CacheSize = size;
+        else if(level == 3) lvl3CacheSize = size;
+
+        snprintf(path, sizeof(path),
+            "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", index);
+
+        if(level == 1 && readFirstLine(path, value, sizeof(value)))
+            cacheLineSize = strtoul(value, NULL, 10);
+    }
+}
+
+/*******************************************************
+ * Reads the amount of entries of the TLB from cpuinfo *
+ *******************************************************/
+
+void CacheHierarchy::readTlbEntries()
+{
+    FILE *file = fopen("/proc/cpuinfo", "r");
+
+    if(file == NULL)
+        return;
+
+    /* Some processors report a line like "TLB size : 3072 4K pages" */
+    char line[256];
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        if(strncmp(line, "TLB size", 8))
+            continue;
+
+        char *colon = strchr(line, ':');
+
+        if(colon != NULL)
+            dataTlbEntries = strtoul(colon + 1, NULL, 10);
+
+        break;
+    }
+
+    fclose(file);
+}
+
+/***********************************************************
+ * Returns the hierarchy of the system, which is read once *
+ ***********************************************************/
+
+const CacheHierarchy *CacheHierarchy::getInstance()
+{
+    return &systemHierarchy;
+}
+
+/****************************************************************
+ * Getter - Returns the size of the level-1 data cache in bytes *
+ ****************************************************************/
+
+unsigned long long CacheHierarchy::getLvl1CacheSize() const
+{
+    return lvl1CacheSize;
+}
+
+/***********************************************************
+ * Getter - Returns the size of the level-2 cache in bytes *
+ ***********************************************************/
+
+unsigned long long CacheHierarchy::getLvl2CacheSize() const
+{
+    return lvl2CacheSize;
+}
+
+/***********************************************************
+ * Getter - Returns the size of the level-3 cache in bytes *
+ ***********************************************************/
+
+unsigned long long CacheHierarchy::getLvl3CacheSize() const
+{
+    return lvl3CacheSize;
+}
+
+/******************************************************
+ * Getter - Returns the size of a cache line in bytes *
+ ******************************************************/
+
+unsigned int CacheHierarchy::getCacheLineSize() const
+{
+    return cacheLineSize;
+}
+
+/*******************************************************
+ * Getter - Returns the size of a memory page in bytes *
+ *******************************************************/
+
+unsigned int CacheHierarchy::getPageSize() const
+{
+    return pageSize;
+}
+
+/**********************************************************
+ * Getter - Returns the amount of entries of the data TLB *
+ **********************************************************/
+
+unsigned int CacheHierarchy::getDataTlbEntries() const
+{
+    return dataTlbEntries;
+}
+
+/*********************************************************************
+ * Returns the most bits a single partition pass may use for hashing *
+ *********************************************************************/
+
+unsigned int CacheHierarchy::getMaxBitsPerPass() const
+{
+    /* Every bucket a pass writes to is in a different page, so the
+     * buckets should not be more than the entries of the TLB. Every
+     * bucket also needs the line it writes to in the level-1 cache.
+     */
+    unsigned long long maxBuckets = lvl1CacheSize / cacheLineSize;
+
+    if(dataTlbEntries < maxBuckets)
+        maxBuckets = dataTlbEntries;
+
+    /* We find the largest power of 2 that does not exceed that amount */
+    unsigned int bits = 1;
+
+    while((2ULL << bits) <= maxBuckets)
+        bits++;
+
+    return bits;
+}
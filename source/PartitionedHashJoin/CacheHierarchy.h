@@ -0,0 +1,71 @@
+#ifndef _CACHE_HIERARCHY_H_
+#define _CACHE_HIERARCHY_H_
+
+/* The sizes that are assumed for the parts of the hierarchy
+ * that can be read neither from sysfs nor from 'sysconf'
+ */
+#define DEFAULT_LVL1_CACHE_SIZE 32768
+#define DEFAULT_LVL2_CACHE_SIZE 262144
+#define DEFAULT_LVL3_CACHE_SIZE 8388608
+#define DEFAULT_CACHE_LINE_SIZE 64
+#define DEFAULT_PAGE_SIZE 4096
+
+/* The amount of entries of the data TLB that is assumed if the system does
+ * not report it (Linux only reports the TLB of some processors in cpuinfo)
+ */
+#define DEFAULT_DATA_TLB_ENTRIES 64
+
+/* The caches and the TLB of the processor the program runs on.
+ *
+ * They are read once, when the program starts, from the directories of
+ * the caches of the first processor in sysfs. Every size that cannot be
+ * read there is asked from 'sysconf' and if the system still cannot tell,
+ * a typical size is assumed instead, so the joins never have to give up.
+ */
+class CacheHierarchy {
+
+private:
+
+/* The sizes of the caches in bytes (the level-1 cache is the data cache) */
+    unsigned long long lvl1CacheSize;
+    unsigned long long lvl2CacheSize;
+    unsigned long long lvl3CacheSize;
+
+/* The size of a cache line and of a memory page in bytes */
+    unsigned int cacheLineSize;
+    unsigned int pageSize;
+
+/* The amount of pages the data TLB can translate without a miss */
+    unsigned int dataTlbEntries;
+
+/* Reads the caches of the first processor from sysfs */
+    void readSysfsCaches();
+
+/* Reads the amount of entries of the TLB from '/proc/cpuinfo' */
+    void readTlbEntries();
+
+public:
+
+/* Constructor - Reads the hierarchy of the system */
+    CacheHierarchy();
+
+/* Returns the hierarchy of the system, which is read once */
+    static const CacheHierarchy *getInstance();
+
+/* Getters */
+    unsigned long long getLvl1CacheSize() const;
+    unsigned long long getLvl2CacheSize() const;
+    unsigned long long getLvl3CacheSize() const;
+    unsigned int getCacheLineSize() const;
+    unsigned int getPageSize() const;
+    unsigned int getDataTlbEntries() const;
+
+/* Returns the most bits a single partition pass may use for hashing, so
+ * that the buckets it writes to stay within the reach of the TLB and
+ * every bucket can keep the line it writes to in the level-1 cache
+ */
+    unsigned int getMaxBitsPerPass() const;
+
+};
+
+#endif
@@ -0,0 +1,297 @@
+#include <iostream>
+#include "CachedBuildSide.h"
+#include "PartitionedHashJoin.h"
+
+/*************************************************
+ * Returns the amount of bytes that a hash table *
+ *      occupies together with its contents      *
+ *************************************************/
+
+static unsigned long long hashTableBytes(HashTable *hashTable)
+{
+    /* Each entry of the table has a list of items and a bitmap */
+    unsigned long long entryBytes = sizeof(HashTableEntry) + sizeof(List)
+        + sizeof(Bitmap) + hashTable->getHopInfoCapacity() / 8;
+
+    /* Each inserted item is a pair of addresses in a node of a list */
+    unsigned long long itemBytes = sizeof(HashEntryItem) + sizeof(Listnode);
+
+    return sizeof(HashTable)
+        + hashTable->getBucketsNum() * entryBytes
+        + hashTable->getElementsNum() * itemBytes;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+CachedBuildSide::CachedBuildSide(
+    Table *table,
+    unsigned int relation,
+    unsigned int column,
+    unsigned int bitsNumForHashing,
+    HashFunctionType hashFunction)
+{
+    /* We store the key of the cached build side */
+    this->relation = relation;
+    this->column = column;
+    this->bitsNumForHashing = bitsNumForHashing;
+    this->hashFunction = hashFunction;
+
+    /* Initially no join is using the cached build side */
+    usersNum = 0;
+    lastUse = 0;
+
+    /* We copy the elements of the column (the table decodes them if needed) */
+    numOfTuples = table->getNumOfTuples();
+    elements = new unsigned long long[numOfTuples];
+    table->gatherColumn(column, NULL, numOfTuples, elements);
+
+    /* Helper variable for counting */
+    unsigned int i;
+
+    /* We create the histogram of the column, the same way the
+     * Partitioned Hash Join Algorithm creates it for a relation
+     */
+    bucketsNum = 1 << bitsNumForHashing;
+    histogram = new unsigned int[bucketsNum];
+
+    for(i = 0; i < bucketsNum; i++)
+        histogram[i] = 0;
+
+    for(i = 0; i < numOfTuples; i++)
+        histogram[PartitionedHashJoin::partitionHash(elements[i], bitsNumForHashing, hashFunction)]++;
+
+    /* We compute the prefix sum, which is where each bucket starts */
+    prefixSum = new unsigned int[bucketsNum];
+    unsigned int sum = 0;
+
+    for(i = 0; i < bucketsNum; i++)
+    {
+        prefixSum[i] = sum;
+        sum += histogram[i];
+    }
+
+    /* We place each tuple in its bucket, keeping the row order in each bucket */
+    tuples = new Tuple[numOfTuples];
+    unsigned int *elementsCounter = new unsigned int[bucketsNum];
+
+    for(i = 0; i < bucketsNum; i++)
+        elementsCounter[i] = 0;
+
+    for(i = 0; i < numOfTuples; i++)
+    {
+        unsigned int bucket = PartitionedHashJoin::partitionHash(elements[i],
+            bitsNumForHashing, hashFunction);
+        Tuple *tuple = &tuples[prefixSum[bucket] + elementsCounter[bucket]];
+
+        tuple->setItem(&elements[i]);
+        tuple->setRowId(i);
+
+        elementsCounter[bucket]++;
+    }
+
+    delete[] elementsCounter;
+
+    /* No hash table has been built yet for any bucket */
+    bucketHashTables = new HashTable *[bucketsNum];
+
+    for(i = 0; i < bucketsNum; i++)
+        bucketHashTables[i] = NULL;
+
+    memoryBytes = estimateMemoryBytes(numOfTuples, bitsNumForHashing);
+}
+
+/**************
+ * Destructor *
+ **************/
+
+CachedBuildSide::~CachedBuildSide()
+{
+    for(unsigned int i = 0; i < bucketsNum; i++)
+        delete bucketHashTables[i];
+
+    delete[] bucketHashTables;
+    delete[] prefixSum;
+    delete[] histogram;
+    delete[] tuples;
+    delete[] elements;
+}
+
+/******************************************************
+ * Getter - Returns the relation of the cached column *
+ ******************************************************/
+
+unsigned int CachedBuildSide::getRelation() const
+{
+    return relation;
+}
+
+/**************************************
+ * Getter - Returns the cached column *
+ **************************************/
+
+unsigned int CachedBuildSide::getColumn() const
+{
+    return column;
+}
+
+/********************************************************************
+ * Getter - Returns the amount of bits used to partition the column *
+ ********************************************************************/
+
+unsigned int CachedBuildSide::getBitsNumForHashing() const
+{
+    return bitsNumForHashing;
+}
+
+/*******************************************************************
+ * Getter - Returns the hash function used to partition the column *
+ *******************************************************************/
+
+HashFunctionType CachedBuildSide::getHashFunction() const
+{
+    return hashFunction;
+}
+
+/***************************************************
+ * Getter - Returns the tuples reordered by bucket *
+ ***************************************************/
+
+Tuple *CachedBuildSide::getTuples() const
+{
+    return tuples;
+}
+
+/*****************************************
+ * Getter - Returns the amount of tuples *
+ *****************************************/
+
+unsigned int CachedBuildSide::getNumOfTuples() const
+{
+    return numOfTuples;
+}
+
+/******************************************
+ * Getter - Returns the amount of buckets *
+ ******************************************/
+
+unsigned int CachedBuildSide::getBucketsNum() const
+{
+    return bucketsNum;
+}
+
+/********************************************************
+ * Getter - Returns the amount of tuples of each bucket *
+ ********************************************************/
+
+unsigned int *CachedBuildSide::getHistogram() const
+{
+    return histogram;
+}
+
+/**********************************************************
+ * Getter - Returns the position where each bucket starts *
+ **********************************************************/
+
+unsigned int *CachedBuildSide::getPrefixSum() const
+{
+    return prefixSum;
+}
+
+/****************************************************************
+ * Getter - Returns the amount of bytes the build side occupies *
+ ****************************************************************/
+
+unsigned long long CachedBuildSide::getMemoryBytes() const
+{
+    return __atomic_load_n(&memoryBytes, __ATOMIC_ACQUIRE);
+}
+
+/***********************************************************************
+ * Getter - Returns the amount of joins that use the cached build side *
+ ***********************************************************************/
+
+unsigned int CachedBuildSide::getUsersNum() const
+{
+    return usersNum;
+}
+
+/**********************************************************************
+ * Getter - Returns the last time the cached build side was requested *
+ **********************************************************************/
+
+unsigned long long CachedBuildSide::getLastUse() const
+{
+    return lastUse;
+}
+
+/*************************************************************
+ * Setter - Sets the amount of joins that use the build side *
+ *************************************************************/
+
+void CachedBuildSide::setUsersNum(unsigned int newUsersNum)
+{
+    usersNum = newUsersNum;
+}
+
+/************************************************************
+ * Setter - Sets the last time the build side was requested *
+ ************************************************************/
+
+void CachedBuildSide::setLastUse(unsigned long long newLastUse)
+{
+    lastUse = newLastUse;
+}
+
+/***************************************************************
+ * Returns the hash table of the bucket or 'NULL' if it is not *
+ *                          built yet                          *
+ ***************************************************************/
+
+HashTable *CachedBuildSide::getBucketHashTable(unsigned int bucket) const
+{
+    return __atomic_load_n(&bucketHashTables[bucket], __ATOMIC_ACQUIRE);
+}
+
+/********************************************************************
+ * Keeps the given hash table of the bucket for the following joins *
+ ********************************************************************/
+
+bool CachedBuildSide::setBucketHashTable(unsigned int bucket, HashTable *hashTable)
+{
+    /* The buckets of a join may be joined by many threads at the same
+     * time, so we only keep the hash table if the bucket has none yet
+     */
+    HashTable *expected = NULL;
+
+    if(!__atomic_compare_exchange_n(&bucketHashTables[bucket], &expected,
+        hashTable, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    /* The cached build side now also occupies the memory of the table */
+    __atomic_add_fetch(&memoryBytes, hashTableBytes(hashTable), __ATOMIC_ACQ_REL);
+
+    return true;
+}
+
+/****************************************************************
+ * Returns the amount of bytes a column of that many rows would *
+ * occupy once cached (without the hash tables of the buckets)  *
+ ****************************************************************/
+
+unsigned long long CachedBuildSide::estimateMemoryBytes(
+    unsigned long long numOfTuples,
+    unsigned int bitsNumForHashing)
+{
+    /* Each row has its element and its tuple */
+    unsigned long long rowBytes = sizeof(unsigned long long) + sizeof(Tuple);
+
+    /* Each bucket has its histogram value, its prefix sum and its hash table */
+    unsigned long long bucketBytes = 2 * sizeof(unsigned int) + sizeof(HashTable *);
+
+    return sizeof(CachedBuildSide) + numOfTuples * rowBytes
+        + (1ULL << bitsNumForHashing) * bucketBytes;
+}
@@ -0,0 +1,115 @@
+#ifndef _CACHED_BUILD_SIDE_H_
+#define _CACHED_BUILD_SIDE_H_
+
+#include "Tuple.h"
+#include "HashTable.h"
+#include "Table.h"
+#include "HashFunctionType.h"
+
+/* The partitioned (and hashed) form of a whole column of a base table, as
+ * the Partitioned Hash Join Algorithm would produce it for that column.
+ * It is kept alive by the 'BuildSideCache' across queries, so the joins
+ * on the same column skip the histogram, the reordering and (for every
+ * bucket whose hash table has been built once) the building phase.
+ *
+ * The contents are never modified after they are created, so many joins
+ * may use the same cached build side at the same time.
+ */
+class CachedBuildSide {
+
+private:
+
+/* The relation (base table) and its column whose elements are cached */
+    unsigned int relation;
+    unsigned int column;
+
+/* The amount of bits that were used to partition the elements */
+    unsigned int bitsNumForHashing;
+
+/* The hash function that was used to partition the elements */
+    HashFunctionType hashFunction;
+
+/* The elements of the column. Every tuple points to one of them */
+    unsigned long long *elements;
+
+/* The tuples <RowId, Element> of the column reordered by bucket */
+    Tuple *tuples;
+
+/* The amount of tuples (which is the amount of rows of the table) */
+    unsigned int numOfTuples;
+
+/* The amount of buckets, which is 2 ^ 'bitsNumForHashing' */
+    unsigned int bucketsNum;
+
+/* The amount of tuples of each bucket */
+    unsigned int *histogram;
+
+/* The position in 'tuples' where each bucket starts */
+    unsigned int *prefixSum;
+
+/* The hash table of each bucket or 'NULL' if it has not been built yet */
+    HashTable **bucketHashTables;
+
+/* The amount of bytes the cached build side occupies */
+    unsigned long long memoryBytes;
+
+/* The amount of joins that are currently using the cached build side.
+ * It is only modified by the cache, which never evicts a used entry.
+ */
+    unsigned int usersNum;
+
+/* The last time the cached build side was requested (used for LRU) */
+    unsigned long long lastUse;
+
+public:
+
+/* Constructor - Copies the given column of the table and partitions its
+ * elements the same way 'PartitionedHashJoin' partitions a relation
+ */
+    CachedBuildSide(
+        Table *table,
+        unsigned int relation,
+        unsigned int column,
+        unsigned int bitsNumForHashing,
+        HashFunctionType hashFunction);
+
+/* Destructor */
+    ~CachedBuildSide();
+
+/* Getters */
+    unsigned int getRelation() const;
+    unsigned int getColumn() const;
+    unsigned int getBitsNumForHashing() const;
+    HashFunctionType getHashFunction() const;
+    Tuple *getTuples() const;
+    unsigned int getNumOfTuples() const;
+    unsigned int getBucketsNum() const;
+    unsigned int *getHistogram() const;
+    unsigned int *getPrefixSum() const;
+    unsigned long long getMemoryBytes() const;
+    unsigned int getUsersNum() const;
+    unsigned long long getLastUse() const;
+
+/* Setters (used by the cache only) */
+    void setUsersNum(unsigned int newUsersNum);
+    void setLastUse(unsigned long long newLastUse);
+
+/* Returns the hash table of the bucket or 'NULL' if it is not built yet */
+    HashTable *getBucketHashTable(unsigned int bucket) const;
+
+/* Keeps the given hash table (built from the tuples of the bucket) for the
+ * following joins. Returns 'false' if another join kept a hash table for
+ * the bucket first, in which case the caller still owns the given table.
+ */
+    bool setBucketHashTable(unsigned int bucket, HashTable *hashTable);
+
+/* Returns the amount of bytes a column of that many rows would occupy
+ * once cached (without the hash tables of the buckets)
+ */
+    static unsigned long long estimateMemoryBytes(
+        unsigned long long numOfTuples,
+        unsigned int bitsNumForHashing);
+
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef _HASH_FUNCTION_TYPE_H_
+#define _HASH_FUNCTION_TYPE_H_
+
+/* An enumeration with all the hash functions that may partition the
+ * relations of a join and place the tuples of a bucket in its hash table
+ */
+
+enum HashFunctionType {
+
+    /* The rightmost bits of the key itself. It is the cheapest and it
+     * spreads dense sequential keys perfectly, but keys with a stride
+     * or with the same rightmost bits land in a few buckets
+     */
+    BitsHash,
+
+    /* The leftmost bits of the key multiplied by 2^64 divided by
+     * the golden ratio (multiplicative or Fibonacci hashing)
+     */
+    FibonacciHash,
+
+    /* The rightmost bits of the key after the finalizer of MurmurHash3,
+     * which makes every bit of the result depend on every bit of the key
+     */
+    MurmurHash,
+
+    /* The rightmost bits of the CRC32 (Castagnoli) checksum of the key */
+    Crc32Hash,
+
+    /* One of the above, chosen for every join from a sample of its keys */
+    AutoHash
+
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <cstdio>
 #include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <new>
 #include <unistd.h>
 #include "PartitionedHashJoin.h"
 
@@ -167,29 +170,254 @@ static int compareTupleUserData(void *item_1, void *item_2)
     return compareUnsignedLongLongs(tuple_1_item, tuple_2_item);
 }
 
-/*********************************************************************
- * Returns the size of the LVL2 cache or -1 in case an error occured *
- *********************************************************************/
+/*****************************************************
+ * Compares two sampled keys (used to sort a sample) *
+ *****************************************************/
+
+static int compareSampledKeys(const void *item_1, const void *item_2)
+{
+    unsigned long long key_1 = *((const unsigned long long *) item_1);
+    unsigned long long key_2 = *((const unsigned long long *) item_2);
+
+    if(key_1 > key_2)
+        return 1;
+
+    if(key_1 < key_2)
+        return -1;
+
+    return 0;
+}
+
+/* The estimated cost of joining a pair of buckets */
+struct BucketCost {
+
+    unsigned long long cost;
+    unsigned int bucket;
+
+};
+
+/**********************************************************************
+ * Compares the costs of two pairs of buckets (used to sort them from *
+ *         the most expensive one to the least expensive one)         *
+ **********************************************************************/
+
+static int compareBucketCosts(const void *item_1, const void *item_2)
+{
+    const BucketCost *bucket_1 = (const BucketCost *) item_1;
+    const BucketCost *bucket_2 = (const BucketCost *) item_2;
+
+    if(bucket_1->cost > bucket_2->cost)
+        return -1;
+
+    if(bucket_1->cost < bucket_2->cost)
+        return 1;
+
+    /* Equal costs keep the order of the buckets */
+    if(bucket_1->bucket < bucket_2->bucket)
+        return -1;
+
+    if(bucket_1->bucket > bucket_2->bucket)
+        return 1;
+
+    return 0;
+}
 
-static long get_Lvl2_Cache_Size()
+/************************************************************
+ * Returns the position of the given key in the sorted keys *
+ *    of the heavy hitters or their amount if it is not     *
+ *                      a heavy hitter                      *
+ ************************************************************/
+
+static unsigned int findHeavyHitter(unsigned long long key,
+    const unsigned long long *heavyKeys, unsigned int heavyKeysNum)
+{
+    /* We perform a binary search in the sorted keys */
+    unsigned int low = 0, high = heavyKeysNum;
+
+    while(low < high)
+    {
+        unsigned int middle = low + (high - low) / 2;
+
+        if(heavyKeys[middle] < key)
+            low = middle + 1;
+
+        else
+            high = middle;
+    }
+
+    if(low < heavyKeysNum && heavyKeys[low] == key)
+        return low;
+
+    return heavyKeysNum;
+}
+
+/**********************************************************************
+ *    Appends to 'heavyKeys' the keys that have at least the given    *
+ * share of a sample of the given relation and more estimated tuples  *
+ * than 'bucketCapacity', up to the limit of 'MAX_HEAVY_HITTERS' keys *
+ **********************************************************************/
+
+static void sampleHeavyHitters(Tuple *relation, unsigned int relationSize,
+    double share, unsigned long long bucketCapacity,
+    unsigned long long *heavyKeys, unsigned int *heavyKeysNum)
 {
-    /* We use 'sysconf' with the '_SC_LEVEL2_CACHE_SIZE'
-     * parameter to read the size of the level-2 cache
+    if(relationSize == 0)
+        return;
+
+    /* We sample the keys of evenly spaced tuples of the relation */
+    unsigned int step = relationSize / HEAVY_HITTER_SAMPLE_SIZE;
+
+    if(step == 0)
+        step = 1;
+
+    unsigned long long *sample = new unsigned long long[HEAVY_HITTER_SAMPLE_SIZE];
+    unsigned int sampledNum = 0;
+
+    for(unsigned int i = 0; i < relationSize && sampledNum < HEAVY_HITTER_SAMPLE_SIZE; i += step)
+        sample[sampledNum++] = *((unsigned long long *) relation[i].getItem());
+
+    /* The equal keys of the sorted sample are consecutive */
+    qsort(sample, sampledNum, sizeof(unsigned long long), compareSampledKeys);
+
+    /* A key is a heavy hitter if it has at least the given share of the
+     * sample. A single occurrence never suffices, so that every key of a
+     * very small relation is not considered a heavy hitter.
      */
-    long lvl_2_cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    double minOccurrences = share * sampledNum;
+
+    if(minOccurrences < 2)
+        minOccurrences = 2;
 
-    /* If an error has occured and the cache size cannot
-     * be determined, we print an informative message on
-     * the screen about the reason why the error occured
+    /* A frequent key is only worth joining as a cross product if its
+     * tuples alone would not fit in a bucket, since the partition can
+     * split the tuples of every other key among the buckets
      */
-    if(lvl_2_cache_size == -1)
+    double tuplesPerSample = ((double) relationSize) / sampledNum;
+
+    unsigned int runStart = 0;
+
+    for(unsigned int i = 1; i <= sampledNum; i++)
+    {
+        if(i < sampledNum && sample[i] == sample[runStart])
+            continue;
+
+        double estimatedTuplesNum = (i - runStart) * tuplesPerSample;
+
+        if((i - runStart) >= minOccurrences && estimatedTuplesNum > bucketCapacity
+        && (*heavyKeysNum) < MAX_HEAVY_HITTERS)
+            heavyKeys[(*heavyKeysNum)++] = sample[runStart];
+
+        runStart = i;
+    }
+
+    delete[] sample;
+}
+
+/**********************************************************************
+ * Appends to 'keys' the keys of at most 'limit' evenly spaced tuples *
+ *                       of the given relation                        *
+ **********************************************************************/
+
+static void sampleKeys(Tuple *relation, unsigned int relationSize,
+    unsigned int limit, unsigned long long *keys, unsigned int *keysNum)
+{
+    unsigned int step = relationSize / limit;
+
+    if(step == 0)
+        step = 1;
+
+    unsigned int sampledNum = 0;
+
+    for(unsigned int i = 0; i < relationSize && sampledNum < limit; i += step)
+    {
+        keys[(*keysNum)++] = *((unsigned long long *) relation[i].getItem());
+        sampledNum++;
+    }
+}
+
+/********************************************************************
+ * The table of the CRC32 (Castagnoli) checksum, with the remainder *
+ *       of every possible byte, and the object that fills it       *
+ *                 once, before the program starts                  *
+ ********************************************************************/
+
+static unsigned int crc32Table[256];
+
+static struct Crc32TableInitializer {
+
+    Crc32TableInitializer()
+    {
+        for(unsigned int byte = 0; byte < 256; byte++)
+        {
+            unsigned int remainder = byte;
+
+            /* The reflected polynomial of CRC32C is '0x82F63B78' */
+            for(unsigned int bit = 0; bit < 8; bit++)
+                remainder = (remainder >> 1) ^ ((remainder & 1) ? 0x82F63B78U : 0);
+
+            crc32Table[byte] = remainder;
+        }
+    }
+
+} crc32TableInitializer;
+
+/********************************************************
+ * Returns the leftmost 'bitsNum' bits of the given key *
+ *    multiplied by 2^64 divided by the golden ratio    *
+ ********************************************************/
+
+static unsigned int fibonacciMix(unsigned long long key, unsigned int bitsNum)
+{
+    /* A shift by 64 bits is undefined, so no bits give the value 0 */
+    if(bitsNum == 0)
+        return 0;
+
+    return (unsigned int) ((key * 0x9E3779B97F4A7C15ULL) >> (64 - bitsNum));
+}
+
+/************************************************************
+ * Returns the given key after the finalizer of MurmurHash3 *
+ ************************************************************/
+
+static unsigned long long murmurMix(unsigned long long key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+
+    return key;
+}
+
+/**************************************************
+ * Returns the CRC32 (Castagnoli) checksum of the *
+ *            8 bytes of the given key            *
+ **************************************************/
+
+static unsigned int crc32Mix(unsigned long long key)
+{
+    unsigned int crc = 0xFFFFFFFFU;
+
+    for(unsigned int i = 0; i < 8; i++)
     {
-        std::cout << "Could not determine the size of LVL2 Cache" << std::endl;
-        perror("Reason");
+        crc = (crc >> 8) ^ crc32Table[(crc ^ (unsigned int) key) & 0xFF];
+        key >>= 8;
     }
 
-    /* We return the final result */
-    return lvl_2_cache_size;
+    return ~crc;
+}
+
+/*************************************************************
+ * Returns a mask with the rightmost 'bitsNum' bits set to 1 *
+ *************************************************************/
+
+static unsigned long long rightmostBitsMask(unsigned int bitsNum)
+{
+    if(bitsNum >= 64)
+        return ~0ULL;
+
+    return (1ULL << bitsNum) - 1;
 }
 
 /***********************************************************************
@@ -203,18 +431,6 @@ static long capacity_limit(long lvl_2_cache_size, double max_percent_of_size = 1
     return (long) max_allowed_size;
 }
 
-/***********************************************************************
- * When a partition needs to be done, the amount of bits that will be  *
- * used to determine the hash code of each element must increase. This *
- *  function, given the current amount of bits that are used, decides  *
- *    the new amount of bits that must be used to hash the elements    *
- ***********************************************************************/
-
-static unsigned int alterBitsNum(unsigned int currentBitsNumForHashing)
-{
-    return currentBitsNumForHashing + 2;
-}
-
 /***************
  * Constructor *
  ***************/
@@ -223,7 +439,9 @@ PartitionedHashJoin::PartitionedHashJoin(
     Relation *relR,
     Relation *relS,
     PartitionedHashJoinInput *inputStructure,
-    JobScheduler *jobScheduler)
+    JobScheduler *jobScheduler,
+    CachedBuildSide *cachedR,
+    CachedBuildSide *cachedS)
 {
     /* We assign the given relations to the fields of the class */
     this->relR = relR;
@@ -233,21 +451,46 @@ PartitionedHashJoin::PartitionedHashJoin(
      * the value provided by the given input structure
      */
     this->bitsNumForHashing = inputStructure->bitsNumForHashing;
+    this->bitsPerPass = DEFAULT_BITS_PER_PASS;
+    this->autoTunedPartitioning = inputStructure->autoTunedPartitioning;
     this->showInitialRelations = inputStructure->showInitialRelations;
     this->showAuxiliaryArrays = inputStructure->showAuxiliaryArrays;
     this->showHashTable = inputStructure->showHashTable;
     this->showSubrelations = inputStructure->showSubrelations;
     this->showResult = inputStructure->showResult;
-    this->hopscotchBuckets = inputStructure->hopscotchBuckets;
     this->hopscotchRange = inputStructure->hopscotchRange;
     this->resizableByLoadFactor = inputStructure->resizableByLoadFactor;
     this->loadFactor = inputStructure->loadFactor;
     this->maxAllowedSizeModifier = inputStructure->maxAllowedSizeModifier;
     this->maxPartitionDepth = inputStructure->maxPartitionDepth;
+    this->heavyHitterShare = inputStructure->heavyHitterShare;
+
+    /* A cached build side was partitioned with its own hash function,
+     * so the join has to partition the other relation with that one
+     */
+    if(cachedR != NULL)
+        this->hashFunction = cachedR->getHashFunction();
+
+    else if(cachedS != NULL)
+        this->hashFunction = cachedS->getHashFunction();
+
+    else
+        this->hashFunction = inputStructure->hashFunction;
+
+    /* The same holds for the bits it was partitioned with */
+    if(cachedR != NULL)
+        this->bitsNumForHashing = cachedR->getBitsNumForHashing();
+
+    else if(cachedS != NULL)
+        this->bitsNumForHashing = cachedS->getBitsNumForHashing();
 
     /* We assign the given job scheduler to the job scheduler of the class */
     this->jobScheduler = jobScheduler;
 
+    /* We keep the cached build sides that 'relR' and 'relS' consist of */
+    this->cachedR = cachedR;
+    this->cachedS = cachedS;
+
     /* Since this object was created through a 'PartitionedHashJoinInput'
      * structure, it is the object that the query handler created and not
      * an object created by another 'PartitionedHashJoin' object. That
@@ -265,17 +508,18 @@ PartitionedHashJoin::PartitionedHashJoin(
     Relation *relR,
     Relation *relS,
     unsigned int bitsNumForHashing,
+    unsigned int bitsPerPass,
     bool showInitialRelations,
     bool showAuxiliaryArrays,
     bool showHashTable,
     bool showSubrelations,
     bool showResult,
-    unsigned int hopscotchBuckets,
     unsigned int hopscotchRange,
     bool resizableByLoadFactor,
     double loadFactor,
     double maxAllowedSizeModifier,
     unsigned int maxPartitionDepth,
+    HashFunctionType hashFunction,
     JobScheduler *jobScheduler)
 {
     /* We set the value of every variable field to
@@ -284,19 +528,34 @@ PartitionedHashJoin::PartitionedHashJoin(
     this->relR = relR;
     this->relS = relS;
     this->bitsNumForHashing = bitsNumForHashing;
+    this->bitsPerPass = bitsPerPass;
     this->showInitialRelations = showInitialRelations;
     this->showAuxiliaryArrays = showAuxiliaryArrays;
     this->showHashTable = showHashTable;
     this->showSubrelations = showSubrelations;
     this->showResult = showResult;
-    this->hopscotchBuckets = hopscotchBuckets;
     this->hopscotchRange = hopscotchRange;
     this->resizableByLoadFactor = resizableByLoadFactor;
     this->loadFactor = loadFactor;
     this->maxAllowedSizeModifier = maxAllowedSizeModifier;
     this->maxPartitionDepth = maxPartitionDepth;
+    this->hashFunction = hashFunction;
     this->jobScheduler = jobScheduler;
 
+    /* The heavy hitters are taken out of the whole relations before
+     * they are partitioned, so the subrelations do not have any
+     */
+    this->heavyHitterShare = 0;
+
+    /* The partitions of the whole relations were already tuned */
+    this->autoTunedPartitioning = false;
+
+    /* The subrelations are buckets that are reordered in place,
+     * so they are never the contents of a cached build side
+     */
+    this->cachedR = NULL;
+    this->cachedS = NULL;
+
     /* An object initialized by this constructor
      * always depicts subrelations. Consequently,
      * we set the value of 'hasSubrelations' to 'true'
@@ -337,6 +596,46 @@ unsigned int PartitionedHashJoin::getBitsNumForHashing() const
     return bitsNumForHashing;
 }
 
+/********************************************************************
+ * Getter - Returns the hash function that partitions the relations *
+ ********************************************************************/
+
+HashFunctionType PartitionedHashJoin::getHashFunction() const
+{
+    return hashFunction;
+}
+
+/************************************************************
+ * Getter - Returns what the last call of 'executeJoin' did *
+ ************************************************************/
+
+JoinStatistics PartitionedHashJoin::getStatistics() const
+{
+    return statistics;
+}
+
+/*******************************************************************
+ * Counts the hash table of a pair of buckets with the given sizes *
+ *     in the statistics (it is built from the smaller bucket)     *
+ *******************************************************************/
+
+void PartitionedHashJoin::recordHashTable(unsigned int R_bucketSize,
+    unsigned int S_bucketSize)
+{
+    /* If one of the buckets is empty, no hash table is needed */
+    if(R_bucketSize == 0 || S_bucketSize == 0)
+        return;
+
+    unsigned int hashTableSize = (R_bucketSize < S_bucketSize)
+        ? R_bucketSize : S_bucketSize;
+
+    statistics.hashTablesNum++;
+    statistics.hashTableTuplesNum += hashTableSize;
+
+    if(hashTableSize > statistics.largestHashTableSize)
+        statistics.largestHashTableSize = hashTableSize;
+}
+
 /***************************************************************
  * Determines wheter a bucket of the relation 'rerR' or 'relS' *
  *    needs to be further partitioned to additional buckets    *
@@ -364,7 +663,7 @@ bool PartitionedHashJoin::partitionRequired(
     if(R_numOfItemsInBucket > 0)
     {
         /* We find the total size in bytes of the bucket */
-        unsigned int totalSize = R_numOfItemsInBucket * item_size;
+        long long totalSize = ((long long) R_numOfItemsInBucket) * item_size;
 
         /* If the total size surpasses the cache size,
          * the bucket needs to be further partitioned
@@ -383,7 +682,7 @@ bool PartitionedHashJoin::partitionRequired(
     if(S_numOfItemsInBucket > 0)
     {
         /* We find the total size in bytes of the bucket */
-        unsigned int totalSize = S_numOfItemsInBucket * item_size;
+        long long totalSize = ((long long) S_numOfItemsInBucket) * item_size;
 
         /* If the total size surpasses the cache size,
          * the bucket needs to be further partitioned
@@ -396,6 +695,202 @@ bool PartitionedHashJoin::partitionRequired(
     return false;
 }
 
+/**************************************************************************
+ * Finds the keys that have at least the share 'heavyHitterShare' of the  *
+ * sampled keys of 'relR' or 'relS' and too many tuples for a bucket that *
+ *  fits the cache and places them sorted in 'heavyKeys'. Returns their   *
+ *                                 amount                                 *
+ **************************************************************************/
+
+unsigned int PartitionedHashJoin::detectHeavyHitters(
+    Tuple *R_table,
+    unsigned int R_numOfTuples,
+    Tuple *S_table,
+    unsigned int S_numOfTuples,
+    long lvl_2_cache_size,
+    unsigned long long *heavyKeys) const
+{
+    /* The amount of tuples of a bucket that needs no further partition */
+    unsigned long long bucketCapacity = (unsigned long long) (capacity_limit(
+        lvl_2_cache_size, maxAllowedSizeModifier) / sizeof(Tuple));
+
+    /* A key that is frequent in either relation fills a single
+     * bucket of that relation, so we sample both relations
+     */
+    unsigned int heavyKeysNum = 0;
+
+    sampleHeavyHitters(R_table, R_numOfTuples, heavyHitterShare,
+        bucketCapacity, heavyKeys, &heavyKeysNum);
+
+    sampleHeavyHitters(S_table, S_numOfTuples, heavyHitterShare,
+        bucketCapacity, heavyKeys, &heavyKeysNum);
+
+    /* We sort the keys and remove the ones found in both relations */
+    qsort(heavyKeys, heavyKeysNum, sizeof(unsigned long long), compareSampledKeys);
+
+    unsigned int distinctKeysNum = 0;
+
+    for(unsigned int i = 0; i < heavyKeysNum; i++)
+    {
+        if(distinctKeysNum == 0 || heavyKeys[i] != heavyKeys[distinctKeysNum - 1])
+            heavyKeys[distinctKeysNum++] = heavyKeys[i];
+    }
+
+    return distinctKeysNum;
+}
+
+/**********************************************************************
+ *   Moves the tuples of the given heavy hitters to the end of the    *
+ * relation, grouped by key in the order of the keys. The rest of the *
+ *   tuples keep their order in the start of the relation and their   *
+ *                         amount is returned                         *
+ **********************************************************************/
+
+unsigned int PartitionedHashJoin::separateHeavyHitters(
+    Tuple *relation,
+    unsigned int relationSize,
+    const unsigned long long *heavyKeys,
+    unsigned int heavyKeysNum,
+    Tuple **heavyTuples,
+    unsigned int *heavyHistogram,
+    unsigned int *heavyPrefixSum)
+{
+    unsigned int i, key;
+
+    /* First we count the tuples of every heavy hitter */
+
+    for(key = 0; key < heavyKeysNum; key++)
+        heavyHistogram[key] = 0;
+
+    for(i = 0; i < relationSize; i++)
+    {
+        key = findHeavyHitter(*((unsigned long long *) relation[i].getItem()),
+            heavyKeys, heavyKeysNum);
+
+        if(key < heavyKeysNum)
+            heavyHistogram[key]++;
+    }
+
+    /* The tuples of every key start after the tuples of the previous keys */
+    unsigned int heavyTuplesNum = 0;
+
+    for(key = 0; key < heavyKeysNum; key++)
+    {
+        heavyPrefixSum[key] = heavyTuplesNum;
+        heavyTuplesNum += heavyHistogram[key];
+    }
+
+    Tuple *separatedTuples = new Tuple[heavyTuplesNum];
+
+    /* Then we move every tuple of a heavy hitter to its place in a
+     * temporary array and every other tuple to the next free position
+     * of the start of the relation (which is never after the position
+     * of the tuple)
+     */
+    unsigned int *elementsCounter = new unsigned int[heavyKeysNum];
+
+    for(key = 0; key < heavyKeysNum; key++)
+        elementsCounter[key] = 0;
+
+    unsigned int remainingTuplesNum = 0;
+
+    for(i = 0; i < relationSize; i++)
+    {
+        key = findHeavyHitter(*((unsigned long long *) relation[i].getItem()),
+            heavyKeys, heavyKeysNum);
+
+        if(key < heavyKeysNum)
+        {
+            separatedTuples[heavyPrefixSum[key] + elementsCounter[key]] = relation[i];
+            elementsCounter[key]++;
+        }
+
+        else
+        {
+            relation[remainingTuplesNum] = relation[i];
+            remainingTuplesNum++;
+        }
+    }
+
+    delete[] elementsCounter;
+
+    /* The tuples of the heavy hitters fill the end of the relation, so the
+     * relation keeps every one of its tuples exactly once. The caller owns
+     * the tuples (and their items), so none of them may be lost or copied.
+     */
+    (*heavyTuples) = relation + remainingTuplesNum;
+
+    for(i = 0; i < heavyTuplesNum; i++)
+        (*heavyTuples)[i] = separatedTuples[i];
+
+    delete[] separatedTuples;
+
+    return remainingTuplesNum;
+}
+
+/****************************************************************************
+ *   Pairs every outer tuple with every inner tuple (all of them have the   *
+ * same key) and writes the row ID pairs to 'result', one outer tuple after *
+ *              the other (it is used as the routine of a job)              *
+ ****************************************************************************/
+
+void PartitionedHashJoin::emitCrossProduct(
+    Tuple *outerTuples,
+    unsigned int outerTuplesNum,
+    Tuple *innerTuples,
+    unsigned int innerTuplesNum,
+    bool outerIsR,
+    RowIdPair *result)
+{
+    /* All the tuples have the same key, so every pair satisfies
+     * the join. The row ID of 'R' is always the left one.
+     */
+    for(unsigned int i = 0; i < outerTuplesNum; i++)
+    {
+        unsigned int outerRowId = outerTuples[i].getRowId();
+
+        for(unsigned int j = 0; j < innerTuplesNum; j++)
+        {
+            unsigned int innerRowId = innerTuples[j].getRowId();
+
+            if(outerIsR)
+            {
+                result->setLeftRowId(outerRowId);
+                result->setRightRowId(innerRowId);
+            }
+
+            else
+            {
+                result->setLeftRowId(innerRowId);
+                result->setRightRowId(outerRowId);
+            }
+
+            result++;
+        }
+    }
+}
+
+/**********************************************************************
+ * The routine of a cross product job, which calls 'emitCrossProduct' *
+ *                 with the fields of the given input                 *
+ **********************************************************************/
+
+void PartitionedHashJoin::crossProductJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    CrossProductJobInput *crossProductJobInput = (CrossProductJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    emitCrossProduct(
+        crossProductJobInput->outerTuples,
+        crossProductJobInput->outerTuplesNum,
+        crossProductJobInput->innerTuples,
+        crossProductJobInput->innerTuplesNum,
+        crossProductJobInput->outerIsR,
+        crossProductJobInput->result
+    );
+}
+
 /****************************************************************
  * Displays in the screen the contents of the initial relations *
  ****************************************************************/
@@ -519,6 +1014,272 @@ unsigned int PartitionedHashJoin::hashTuple(void *item)
     return (unsigned int) integer_item;
 }
 
+/********************************************************************
+ * Hashes a given integer into one of the (2 ^ 'bitsNumForHashing') *
+ *               buckets with the given hash function               *
+ ********************************************************************/
+
+unsigned int PartitionedHashJoin::partitionHash(
+    unsigned long long integer,
+    unsigned int bitsNumForHashing,
+    HashFunctionType hashFunction)
+{
+    switch(hashFunction)
+    {
+        case FibonacciHash:
+            return fibonacciMix(integer, bitsNumForHashing);
+
+        case MurmurHash:
+            return (unsigned int) (murmurMix(integer) & rightmostBitsMask(bitsNumForHashing));
+
+        case Crc32Hash:
+            return (unsigned int) (crc32Mix(integer) & rightmostBitsMask(bitsNumForHashing));
+
+        /* An undecided hash function falls back to the cheapest one */
+        default:
+            return bitReductionHash(integer, bitsNumForHashing);
+    }
+}
+
+/****************************************************************************
+ * Returns the cheapest hash function that spreads the given sample of keys *
+ *   in (2 ^ 'bitsNumForHashing') buckets about as evenly as the best one   *
+ ****************************************************************************/
+
+HashFunctionType PartitionedHashJoin::chooseHashFunction(
+    const unsigned long long *keys,
+    unsigned int keysNum,
+    unsigned int bitsNumForHashing)
+{
+    /* The candidates in order of increasing cost */
+    static const HashFunctionType candidates[] = {
+        BitsHash, FibonacciHash, MurmurHash, Crc32Hash
+    };
+
+    unsigned int candidatesNum = sizeof(candidates) / sizeof(candidates[0]);
+
+    /* Without keys or buckets every function is as good as the cheapest */
+    if(keysNum == 0 || bitsNumForHashing == 0)
+        return BitsHash;
+
+    /* The sample never has more distinct buckets than keys, so
+     * we count at most as many buckets as twice the sampled keys
+     */
+    unsigned int bitsNum = bitsNumForHashing;
+
+    while(bitsNum > 1 && (1U << bitsNum) > 2 * keysNum)
+        bitsNum--;
+
+    unsigned int bucketsNum = 1U << bitsNum;
+    unsigned int *histogram = new unsigned int[bucketsNum];
+
+    /* The score of a function is the sum of the squared sizes of its
+     * buckets, which is the amount of comparisons its hash tables make.
+     * It is the smallest when the keys are spread evenly.
+     */
+    double scores[sizeof(candidates) / sizeof(candidates[0])];
+    double bestScore = 0;
+
+    for(unsigned int c = 0; c < candidatesNum; c++)
+    {
+        memset(histogram, 0, bucketsNum * sizeof(unsigned int));
+
+        for(unsigned int i = 0; i < keysNum; i++)
+            histogram[partitionHash(keys[i], bitsNum, candidates[c])]++;
+
+        scores[c] = 0;
+
+        for(unsigned int b = 0; b < bucketsNum; b++)
+            scores[c] += ((double) histogram[b]) * histogram[b];
+
+        if(c == 0 || scores[c] < bestScore)
+            bestScore = scores[c];
+    }
+
+    delete[] histogram;
+
+    /* We prefer the cheapest function that is close enough to the best */
+    for(unsigned int c = 0; c < candidatesNum; c++)
+    {
+        if(scores[c] <= bestScore * HASH_FUNCTION_TOLERANCE)
+            return candidates[c];
+    }
+
+    return BitsHash;
+}
+
+/*********************************************************************
+ * Returns the function that hashes a tuple into its position in the *
+ *  hash table of its bucket for the given family of hash functions  *
+ *********************************************************************/
+
+unsigned int (*PartitionedHashJoin::getTupleHash(HashFunctionType hashFunction))(void *)
+{
+    switch(hashFunction)
+    {
+        case FibonacciHash:
+            return hashTupleFibonacci;
+
+        case MurmurHash:
+            return hashTupleMurmur;
+
+        case Crc32Hash:
+            return hashTupleCrc32;
+
+        default:
+            return hashTuple;
+    }
+}
+
+/***********************************************************************
+ *  Hashes the key of a tuple with the multiplicative hash function.   *
+ * The leftmost bits of the product determined the bucket of the tuple *
+ *   and are the same in the whole bucket, so the rest bits are used   *
+ ***********************************************************************/
+
+unsigned int PartitionedHashJoin::hashTupleFibonacci(void *item)
+{
+    unsigned long long key = *((unsigned long long *) ((Tuple *) item)->getItem());
+    unsigned long long product = key * 0x9E3779B97F4A7C15ULL;
+
+    return (unsigned int) (product ^ (product >> 32));
+}
+
+/*************************************************************************
+ *   Hashes the key of a tuple with the finalizer of MurmurHash3. The    *
+ * rightmost bits determined the bucket of the tuple, so the leftmost 32 *
+ *                             bits are used                             *
+ *************************************************************************/
+
+unsigned int PartitionedHashJoin::hashTupleMurmur(void *item)
+{
+    unsigned long long key = *((unsigned long long *) ((Tuple *) item)->getItem());
+    return (unsigned int) (murmurMix(key) >> 32);
+}
+
+/**********************************************************************
+ *  Hashes the key of a tuple with the CRC32 checksum. The rightmost  *
+ * bits determined the bucket of the tuple, so the bytes are reversed *
+ **********************************************************************/
+
+unsigned int PartitionedHashJoin::hashTupleCrc32(void *item)
+{
+    unsigned long long key = *((unsigned long long *) ((Tuple *) item)->getItem());
+    return __builtin_bswap32(crc32Mix(key));
+}
+
+/*************************************************************************
+ * Chooses how many times two relations with the given amounts of tuples *
+ *  are partitioned and how many bits every partition uses for hashing   *
+ *************************************************************************/
+
+void PartitionedHashJoin::tunePartitioning(
+    unsigned long long R_numOfTuples,
+    unsigned long long S_numOfTuples,
+    unsigned int threadsNum,
+    double maxAllowedSizeModifier,
+    unsigned int maxPartitionDepth,
+    unsigned int *bitsPerPass,
+    unsigned int *passesNum)
+{
+    const CacheHierarchy *hierarchy = CacheHierarchy::getInstance();
+    unsigned int maxBitsPerPass = hierarchy->getMaxBitsPerPass();
+
+    /* The amount of tuples of a bucket that fits the usable part of the cache */
+    unsigned long long bucketCapacity = (unsigned long long) (capacity_limit(
+        hierarchy->getLvl2CacheSize(), maxAllowedSizeModifier) / sizeof(Tuple));
+
+    if(bucketCapacity == 0)
+        bucketCapacity = 1;
+
+    /* The larger relation determines how many buckets are needed */
+    unsigned long long largerNumOfTuples = (R_numOfTuples > S_numOfTuples)
+        ? R_numOfTuples : S_numOfTuples;
+
+    unsigned int neededBits = 0;
+
+    while((largerNumOfTuples >> neededBits) > bucketCapacity)
+        neededBits++;
+
+    /* The least bits that give every thread a few buckets to join */
+    unsigned int parallelBits = 0;
+
+    while((1ULL << parallelBits) < ((unsigned long long) threadsNum) * PARTITION_BUCKETS_PER_THREAD)
+        parallelBits++;
+
+    /* If the relations fit the cache, they are not partitioned. The bits
+     * are still chosen, in case their buckets have to be cached.
+     */
+    if(neededBits == 0 || maxPartitionDepth == 0)
+    {
+        (*passesNum) = 0;
+        (*bitsPerPass) = (parallelBits < maxBitsPerPass) ? parallelBits : maxBitsPerPass;
+
+        if((*bitsPerPass) == 0)
+            (*bitsPerPass) = 1;
+
+        return;
+    }
+
+    if(neededBits < parallelBits)
+        neededBits = parallelBits;
+
+    /* Every pass uses at most the bits the TLB can reach, so we need as
+     * many passes as that takes (but no more than the maximum depth)
+     */
+    (*passesNum) = (neededBits + maxBitsPerPass - 1) / maxBitsPerPass;
+
+    if((*passesNum) > maxPartitionDepth)
+        (*passesNum) = maxPartitionDepth;
+
+    /* The needed bits are split evenly among the passes */
+    (*bitsPerPass) = (neededBits + (*passesNum) - 1) / (*passesNum);
+
+    if((*bitsPerPass) > maxBitsPerPass)
+        (*bitsPerPass) = maxBitsPerPass;
+}
+
+/********************************************************************
+ * Searches the given tuples of one bucket in the hash table of the *
+ *  other bucket and places the row ID pairs of the matches in the  *
+ * given list. The row ID of 'R' is always the left one of a pair,  *
+ *          no matter which bucket the hash table contains          *
+ ********************************************************************/
+
+void PartitionedHashJoin::probeBucket(
+    HashTable *hash_table,
+    Tuple *probeTable,
+    unsigned int start_index,
+    unsigned int end_index,
+    bool probeIsR,
+    HashFunctionType hashFunction,
+    List *result)
+{
+    for(unsigned int i = start_index; i < end_index; i++)
+    {
+        /* We search the current tuple in the hash table */
+        List *matchingKeys = hash_table->bulkSearchKeys(
+            &probeTable[i], getTupleHash(hashFunction), compareTupleUserData);
+
+        unsigned int probeRowId = probeTable[i].getRowId();
+
+        /* Every tuple of the list has the same user data as the current one */
+        while(!matchingKeys->isEmpty())
+        {
+            Tuple *current_tuple = (Tuple *) matchingKeys->getItemInPos(1);
+            matchingKeys->removeFront();
+
+            unsigned int builtRowId = current_tuple->getRowId();
+
+            result->insertLast(probeIsR ? new RowIdPair(probeRowId, builtRowId)
+                : new RowIdPair(builtRowId, probeRowId));
+        }
+
+        /* Finally, we terminate the list of matching keys */
+        HashTable::terminateBulkSearchList(matchingKeys);
+    }
+}
+
 /****************************************************************
  *  Executes Building and Probing for a pair of buckets of the  *
  * relations 'S' and 'R'. The four indexes determine the start  *
@@ -533,7 +1294,10 @@ void PartitionedHashJoin::probeRelations(
     unsigned int R_end_index,
     unsigned int S_start_index,
     unsigned int S_end_index,
-    List *result) const
+    List *result,
+    CachedBuildSide *R_cache,
+    CachedBuildSide *S_cache,
+    unsigned int bucket) const
 {
     /* If one of the two buckets is empty, the join
      * operation produces no result for these buckets
@@ -544,48 +1308,22 @@ void PartitionedHashJoin::probeRelations(
         return;
     }
 
-    /* We find the number of elements of each of the two buckets */
-
-	unsigned int R_tuples_num = R_end_index - R_start_index;
-	unsigned int S_tuples_num = S_end_index - S_start_index;
-
-    /* We will start building the index of one of the relations */
-
-	HashTable *hash_table = new HashTable(hopscotchBuckets,
-		resizableByLoadFactor, loadFactor, hopscotchRange);
-
     /* We retrieve the relational tables of 'relR' and 'relS' */
     Tuple *R_table = relR->getTuples();
     Tuple *S_table = relS->getTuples();
 
-    /* Helper variable for counting */
-    unsigned int i;
+    /* We retrieve the hash table of one of the two buckets
+     * (it is built now, unless a cached build side has it)
+     */
+    bool builtFromR, isCached;
 
-	if(R_tuples_num < S_tuples_num)
-	{
-	    /* Starting from the given starting index of 'R', we place
-		 * every tuple of the 'R' table to the hash table. We keep
-		 * inserting items until we reach the given end index of 'R'
-		 */
-		for(i = R_start_index; i < R_end_index; i++)
-		{
-			hash_table->insert(&R_table[i], &R_table[i],
-				hashTuple, compareTupleUserData);
-		}
-	}
-
-	else
-	{
-	    /* Starting from the given starting index of 'S', we place
-		 * every tuple of the 'S' table to the hash table. We keep
-		 * inserting items until we reach the given end index of 'S'
-		 */
-		for(i = S_start_index; i < S_end_index; i++)
-		{
-			hash_table->insert(&S_table[i], &S_table[i],
-				hashTuple, compareTupleUserData);
-		}
-	}
+    HashTable *hash_table = getBucketHashTable(
+        R_table, R_start_index, R_end_index,
+        S_table, S_start_index, S_end_index,
+        R_cache, S_cache, bucket,
+        hopscotchRange,
+        resizableByLoadFactor, loadFactor, hashFunction,
+        &builtFromR, &isCached);
 
     /* We print the contents of the hash table if we need to */
 
@@ -621,104 +1359,16 @@ void PartitionedHashJoin::probeRelations(
         }
     }
 
-	if(R_tuples_num < S_tuples_num)
-	{
-		/* Starting from the given starting index of 'S', we search
-		 * every tuple of the 'S' table in the hash table. If we
-		 * find an item with the same value in the hash table, we
-		 * include it in the final result of the 'join' operation
-		 *
-		 * We keep searching the tuples of 'S' in the hash
-		 * table until we reach the given end index of 'S'
-		 */
-		for(i = S_start_index; i < S_end_index; i++)
-		{
-			/* We search the current tuple of 'S' in the hash table */
-
-			List *matchingKeys = hash_table->bulkSearchKeys(
-				&S_table[i], hashTuple, compareTupleUserData);
-
-			/* As long as the list is not empty, we do the following */
-
-			while(!matchingKeys->isEmpty())
-			{
-				/* We retrieve the current content of the head of the list */
-				Tuple *current_tuple = (Tuple *) matchingKeys->getItemInPos(1);
-
-				/* The current content of the head is removed from the list
-				 *
-				 * The next node of the head becomes the new head
-				 */
-				matchingKeys->removeFront();
-
-				/* Now we have found a tuple of 'S' and a tuple of 'R'
-				 * that have the same user data. We retrieve the row
-				 * IDs of these two tuples
-				 */
-				unsigned int R_tuple_rowId = current_tuple->getRowId();
-				unsigned int S_tuple_rowId = S_table[i].getRowId();
-
-				/* We create an item that stores the pair of the above
-				* two row IDs and we insert that item in the list
-				*/
-				result->insertLast(new RowIdPair(R_tuple_rowId, S_tuple_rowId));
-			}
-
-			/* Finally, we terminate the list of matching keys */
-			HashTable::terminateBulkSearchList(matchingKeys);
-		}
-	}
+    /* The tuples of the other bucket are searched in the hash table */
+    if(builtFromR)
+        probeBucket(hash_table, S_table, S_start_index, S_end_index, false, hashFunction, result);
 
-	else
-	{
-		/* Starting from the given starting index of 'R', we search
-		 * every tuple of the 'R' table in the hash table. If we
-		 * find an item with the same value in the hash table, we
-		 * include it in the final result of the 'join' operation
-		 *
-		 * We keep searching the tuples of 'R' in the hash
-		 * table until we reach the given end index of 'R'
-		 */
-		for(i = R_start_index; i < R_end_index; i++)
-		{
-			/* We search the current tuple of 'R' in the hash table */
-
-			List *matchingKeys = hash_table->bulkSearchKeys(
-                &R_table[i], hashTuple, compareTupleUserData);
-
-			/* As long as the list is not empty, we do the following */
-
-			while(!matchingKeys->isEmpty())
-			{
-				/* We retrieve the current content of the head of the list */
-				Tuple *current_tuple = (Tuple *) matchingKeys->getItemInPos(1);
-
-				/* The current content of the head is removed from the list
-				 *
-				 * The next node of the head becomes the new head
-				 */
-				matchingKeys->removeFront();
-
-				/* Now we have found a tuple of 'S' and a tuple of 'R'
-				 * that have the same user data. We retrieve the row
-				 * IDs of these two tuples
-				 */
-				unsigned int S_tuple_rowId = current_tuple->getRowId();
-				unsigned int R_tuple_rowId = R_table[i].getRowId();
-
-				/* We create an item that stores the pair of the above
-				* two row IDs and we insert that item in the list
-				*/
-				result->insertLast(new RowIdPair(R_tuple_rowId, S_tuple_rowId));
-			}
-
-			/* Finally, we terminate the list of matching keys */
-			HashTable::terminateBulkSearchList(matchingKeys);
-		}
-	}
+    else
+        probeBucket(hash_table, R_table, R_start_index, R_end_index, true, hashFunction, result);
 
     /* We free the allocated memory for the hash table */
-    delete hash_table;
+    if(!isCached)
+        delete hash_table;
 }
 
 /**********************************************************
@@ -731,7 +1381,8 @@ void PartitionedHashJoin::createHistogram(
     Tuple *relation,
     unsigned int relationStartIndex,
     unsigned int relationEndIndex,
-    unsigned int selectedBitsNumForHashing)
+    unsigned int selectedBitsNumForHashing,
+    HashFunctionType hashFunction)
 {
     unsigned int i;
 
@@ -740,8 +1391,9 @@ void PartitionedHashJoin::createHistogram(
         /* We retrieve the value of the current element */
         unsigned long long currentItem = *((unsigned long long *) relation[i].getItem());
 
-        /* We hash that value with bit reduction hashing */
-        unsigned int hash_value = bitReductionHash(currentItem, selectedBitsNumForHashing);
+        /* We hash that value with the hash function of the join */
+        unsigned int hash_value = partitionHash(currentItem,
+            selectedBitsNumForHashing, hashFunction);
 
         /* The value of the histogram's element of the index
         * that matches the hash value is now increased by 1,
@@ -752,6 +1404,27 @@ void PartitionedHashJoin::createHistogram(
     }
 }
 
+/*****************************************************************
+ * The routine of a histogram job, which calls 'createHistogram' *
+ *              with the fields of the given input               *
+ *****************************************************************/
+
+void PartitionedHashJoin::histogramJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    HistogramJobInput *histogramJobInput = (HistogramJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    createHistogram(
+        histogramJobInput->histogram,
+        histogramJobInput->relation,
+        histogramJobInput->leftLimit,
+        histogramJobInput->rightLimit,
+        histogramJobInput->bitsNumForHashing,
+        histogramJobInput->hashFunction
+    );
+}
+
 /**********************************************************************
  * Sums the contents of all the partial histograms into one histogram *
  **********************************************************************/
@@ -783,11 +1456,15 @@ void PartitionedHashJoin::parallelMethodForHistogramCreation(
 {
     unsigned int maxThreads = jobScheduler->getMaxThreads();
     unsigned int *partialHistograms[maxThreads];
+
+    /* The partial histograms are placed in the scratch arena of this thread */
+    ScratchArena *arena = ScratchArena::getThreadArena();
+    ScratchMark arenaMark = arena->getMark();
     unsigned int i, j;
 
     for(i = 0; i < maxThreads; i++)
     {
-        partialHistograms[i] = new unsigned int[histogramSize];
+        partialHistograms[i] = (unsigned int *) arena->allocate(histogramSize * sizeof(unsigned int));
 
         for(j = 0; j < histogramSize; j++)
             partialHistograms[i][j] = 0;
@@ -809,7 +1486,8 @@ void PartitionedHashJoin::parallelMethodForHistogramCreation(
             relation,
             leftBound,
             rightBound,
-            bitsNumForHashing
+            bitsNumForHashing,
+            hashFunction
         );
 
         leftBound += step;
@@ -820,7 +1498,7 @@ void PartitionedHashJoin::parallelMethodForHistogramCreation(
 
     for(i = 0; i < maxThreads; i++)
     {
-        histogramJobs[i] = new Job(createHistogram, histogramJobInputs[i], NULL, NULL, NULL, NULL);
+        histogramJobs[i] = new Job(histogramJob, histogramJobInputs[i]);
         jobScheduler->submitJob(histogramJobs[i]);
     }
 
@@ -838,8 +1516,9 @@ void PartitionedHashJoin::parallelMethodForHistogramCreation(
     {
         delete histogramJobs[i];
         delete histogramJobInputs[i];
-        delete[] partialHistograms[i];
     }
+
+    arena->rewind(arenaMark);
 }
 
 /**********************************************
@@ -856,6 +1535,7 @@ void PartitionedHashJoin::reorderTuples(
     unsigned int relationStartIndex,
     unsigned int relationEndIndex,
     unsigned int selectedBitsNumForHashing,
+    HashFunctionType hashFunction,
     pthread_mutex_t *util)
 {
     unsigned int i;
@@ -865,8 +1545,9 @@ void PartitionedHashJoin::reorderTuples(
         /* We retrieve the value of the current tuple */
         unsigned long long currentItem = *((unsigned long long *) relation[i].getItem());
 
-        /* We hash that value with bit reduction hashing */
-        unsigned int hash_value = bitReductionHash(currentItem, selectedBitsNumForHashing);
+        /* We hash that value with the hash function of the join */
+        unsigned int hash_value = partitionHash(currentItem,
+            selectedBitsNumForHashing, hashFunction);
 
         /* We are about to enter a critical section. Only one thread at a time should
          * access the 'elementsCounterOfRel' array. The implementation of the job
@@ -878,8 +1559,9 @@ void PartitionedHashJoin::reorderTuples(
         /* According to its hash value and the amount of previous
         * items that have been hashed to the same bucket, we
         * insert the current item to the reordered array of 'relR'
+        * (its memory is raw, so we copy-construct the tuple there)
         */
-        reorderedRelation[prefixSumOfRel[hash_value] + elementsCounterOfRel[hash_value]] = relation[i];
+        new (&reorderedRelation[prefixSumOfRel[hash_value] + elementsCounterOfRel[hash_value]]) Tuple(relation[i]);
 
         /* We increase the amount of inserted items in this bucket by 1 */
         elementsCounterOfRel[hash_value]++;
@@ -889,6 +1571,30 @@ void PartitionedHashJoin::reorderTuples(
     }
 }
 
+/***************************************************************
+ * The routine of a partition job, which calls 'reorderTuples' *
+ *             with the fields of the given input              *
+ ***************************************************************/
+
+void PartitionedHashJoin::partitionJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    PartitionJobInput *partitionJobInput = (PartitionJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    reorderTuples(
+        partitionJobInput->relation,
+        partitionJobInput->reorderedRelation,
+        partitionJobInput->prefixSum,
+        partitionJobInput->elementsCounter,
+        partitionJobInput->leftLimit,
+        partitionJobInput->rightLimit,
+        partitionJobInput->bitsNumForHashing,
+        partitionJobInput->hashFunction,
+        partitionJobInput->utilityMutex
+    );
+}
+
 /***********************************************************
  * A parallel method to reorder the contents of a relation *
  ***********************************************************/
@@ -937,6 +1643,7 @@ void PartitionedHashJoin::parallelMethodForTupleReordering(
             leftBound,
             rightBound,
             bitsNumForHashing,
+            hashFunction,
             utilMutex
         );
 
@@ -951,7 +1658,7 @@ void PartitionedHashJoin::parallelMethodForTupleReordering(
     for(i = 0; i < maxThreads; i++)
     {
         /* We create the next job */
-        partitionJobs[i] = new Job(NULL, NULL, reorderTuples, partitionJobInputs[i], NULL, NULL);
+        partitionJobs[i] = new Job(partitionJob, partitionJobInputs[i]);
 
         /* We submit the job to the scheduler */
         jobScheduler->submitJob(partitionJobs[i]);
@@ -973,6 +1680,82 @@ void PartitionedHashJoin::parallelMethodForTupleReordering(
     }
 }
 
+/*******************************************************************
+ *  Returns the hash table of a pair of buckets. It is taken from  *
+ *   a cached build side if possible, else it is built from the    *
+ * smaller bucket and kept in the cached build side of that bucket *
+ *******************************************************************/
+
+HashTable *PartitionedHashJoin::getBucketHashTable(
+    Tuple *R_table,
+    unsigned int R_start_index,
+    unsigned int R_end_index,
+    Tuple *S_table,
+    unsigned int S_start_index,
+    unsigned int S_end_index,
+    CachedBuildSide *R_cache,
+    CachedBuildSide *S_cache,
+    unsigned int bucket,
+    unsigned int hopscotchRange,
+    bool resizableByLoadFactor,
+    double loadFactor,
+    HashFunctionType hashFunction,
+    bool *builtFromR,
+    bool *isCached)
+{
+    /* If the hash table of one of the buckets has been built by a previous
+     * join, we use that table no matter which bucket is the smaller one
+     */
+    HashTable *hash_table;
+
+    if(R_cache != NULL && (hash_table = R_cache->getBucketHashTable(bucket)) != NULL)
+    {
+        *builtFromR = true;
+        *isCached = true;
+        return hash_table;
+    }
+
+    if(S_cache != NULL && (hash_table = S_cache->getBucketHashTable(bucket)) != NULL)
+    {
+        *builtFromR = false;
+        *isCached = true;
+        return hash_table;
+    }
+
+    /* Else we build the hash table from the smaller bucket
+     * (the bucket of 'R' if both buckets have the same size)
+     */
+    *builtFromR = ((R_end_index - R_start_index) <= (S_end_index - S_start_index));
+
+    Tuple *table = (*builtFromR) ? R_table : S_table;
+    unsigned int start_index = (*builtFromR) ? R_start_index : S_start_index;
+    unsigned int end_index = (*builtFromR) ? R_end_index : S_end_index;
+
+    /* The table is created with enough buckets for every tuple of the
+     * bucket, so it never has to grow (and rehash) while it is built
+     */
+    hash_table = new HashTable(HashTable::getExactSize(end_index - start_index,
+        loadFactor), resizableByLoadFactor, loadFactor, hopscotchRange);
+
+    /* Starting from the given starting index, we place every tuple of the
+     * table to the hash table until we reach the given end index
+     */
+    for(unsigned int i = start_index; i < end_index; i++)
+    {
+        hash_table->insert(&table[i], &table[i],
+            getTupleHash(hashFunction), compareTupleUserData);
+    }
+
+    /* If the bucket belongs to a cached build side, the cached side keeps
+     * the hash table for the following joins on the same column
+     */
+    CachedBuildSide *cache = (*builtFromR) ? R_cache : S_cache;
+
+    *isCached = (cache != NULL && cache->setBucketHashTable(bucket, hash_table));
+
+    return hash_table;
+}
+
 /***********************************************************
  * Joins the two buckets indicated by the 'rank' parameter *
  ***********************************************************/
@@ -986,22 +1769,15 @@ void PartitionedHashJoin::joinBuckets(
     unsigned int *leftPrefixSum,
     unsigned int *rightPrefixSum,
     unsigned int bucketsNum,
-    unsigned int hopscotchBuckets,
     unsigned int hopscotchRange,
     bool resizableByLoadFactor,
     double loadFactor,
     pthread_mutex_t *util,
     List *result,
-    bool resultHasAlreadyBeenDeposited)
+    CachedBuildSide *leftCache,
+    CachedBuildSide *rightCache,
+    HashFunctionType hashFunction)
 {
-    /* If the result of joining these two buckets has already
-     * been deposited, we just exit immediatelly. This happens
-     * when the buckets are partitioned further into smaller
-     * buckets (we call that 'multipartitioning').
-     */
-    if(resultHasAlreadyBeenDeposited)
-        return;
-
     /* We determine the bounds of the buckets according to the rank */
 
     unsigned int R_start_index = leftPrefixSum[rank];
@@ -1029,171 +1805,132 @@ void PartitionedHashJoin::joinBuckets(
         return;
     }
 
-    /* We find the amount of tuples of each of the two buckets */
-
-	unsigned int R_tuples_num = R_end_index - R_start_index;
-	unsigned int S_tuples_num = S_end_index - S_start_index;
-
-    /* We will start building the index of one of the relations */
+    /* We retrieve the hash table of one of the two buckets
+     * (it is built now, unless a cached build side has it)
+     */
+    bool builtFromR, isCached;
 
-	HashTable *hash_table = new HashTable(hopscotchBuckets,
-		resizableByLoadFactor, loadFactor, hopscotchRange);
+    HashTable *hash_table = getBucketHashTable(
+        leftRel, R_start_index, R_end_index,
+        rightRel, S_start_index, S_end_index,
+        leftCache, rightCache, rank,
+        hopscotchRange,
+        resizableByLoadFactor, loadFactor, hashFunction,
+        &builtFromR, &isCached);
 
     /* We store the pointers in more convinient variables */
     Tuple *R_table = leftRel;
     Tuple *S_table = rightRel;
 
-    /* Helper variable for counting */
-    unsigned int i;
+    /* The tuples of the other bucket are searched in the hash table and
+     * the pairs are gathered in a list of this job, so the list of the
+     * result is only locked once for the whole pair of buckets
+     */
+    List *bucketResult = new List();
 
-	if(R_tuples_num < S_tuples_num)
-	{
-	    /* Starting from the given starting index of 'R', we place
-		 * every tuple of the 'R' table to the hash table. We keep
-		 * inserting items until we reach the given end index of 'R'
-		 */
-		for(i = R_start_index; i < R_end_index; i++)
-		{
-			hash_table->insert(&R_table[i], &R_table[i],
-				PartitionedHashJoin::hashTuple, compareTupleUserData);
-		}
-	}
+    if(builtFromR)
+        probeBucket(hash_table, S_table, S_start_index, S_end_index, false, hashFunction, bucketResult);
 
-	else
-	{
-	    /* Starting from the given starting index of 'S', we place
-		 * every tuple of the 'S' table to the hash table. We keep
-		 * inserting items until we reach the given end index of 'S'
-		 */
-		for(i = S_start_index; i < S_end_index; i++)
-		{
-			hash_table->insert(&S_table[i], &S_table[i],
-				PartitionedHashJoin::hashTuple, compareTupleUserData);
-		}
-	}
+    else
+        probeBucket(hash_table, R_table, R_start_index, R_end_index, true, hashFunction, bucketResult);
 
-	if(R_tuples_num < S_tuples_num)
-	{
-		/* Starting from the given starting index of 'S', we search
-		 * every tuple of the 'S' table in the hash table. If we
-		 * find an item with the same value in the hash table, we
-		 * include it in the final result of the 'join' operation
-		 *
-		 * We keep searching the tuples of 'S' in the hash
-		 * table until we reach the given end index of 'S'
-		 */
-		for(i = S_start_index; i < S_end_index; i++)
-		{
-			/* We search the current tuple of 'S' in the hash table */
-
-			List *matchingKeys = hash_table->bulkSearchKeys(
-				&S_table[i], PartitionedHashJoin::hashTuple,
-                compareTupleUserData);
-
-			/* As long as the list is not empty, we do the following */
-
-			while(!matchingKeys->isEmpty())
-			{
-				/* We retrieve the current content of the head of the list */
-				Tuple *current_tuple = (Tuple *) matchingKeys->getItemInPos(1);
-
-				/* The current content of the head is removed from the list
-				 *
-				 * The next node of the head becomes the new head
-				 */
-				matchingKeys->removeFront();
-
-				/* Now we have found a tuple of 'S' and a tuple of 'R'
-				 * that have the same user data. We retrieve the row
-				 * IDs of these two tuples
-				 */
-				unsigned int R_tuple_rowId = current_tuple->getRowId();
-				unsigned int S_tuple_rowId = S_table[i].getRowId();
-
-                /* We are about to enter a critical section. Only one
-                 * thread at a time should access the 'result' lists.
-                 * We use the utility mutex of the Job Scheduler to
-                 * create critical sections inside our functions that
-                 * we give as jobs to the scheduler.
-                 */
-                lock(util);
-
-				/* We create an item that stores the pair of the above
-				 * two row IDs and we insert that item in the list
-				 */
-				result->insertLast(new RowIdPair(R_tuple_rowId, S_tuple_rowId));
-
-                /* End of critical section - we unlock the mutex */
-                unlock(util);
-			}
-
-			/* Finally, we terminate the list of matching keys */
-			HashTable::terminateBulkSearchList(matchingKeys);
-		}
-	}
+    /* We are about to enter a critical section. Only one
+     * thread at a time should access the 'result' lists.
+     * We use the utility mutex of the Job Scheduler to
+     * create critical sections inside our functions that
+     * we give as jobs to the scheduler.
+     */
+    lock(util);
 
-	else
-	{
-		/* Starting from the given starting index of 'R', we search
-		 * every tuple of the 'R' table in the hash table. If we
-		 * find an item with the same value in the hash table, we
-		 * include it in the final result of the 'join' operation
-		 *
-		 * We keep searching the tuples of 'R' in the hash
-		 * table until we reach the given end index of 'R'
-		 */
-		for(i = R_start_index; i < R_end_index; i++)
-		{
-			/* We search the current tuple of 'R' in the hash table */
-
-			List *matchingKeys = hash_table->bulkSearchKeys(
-                &R_table[i], PartitionedHashJoin::hashTuple,
-                compareTupleUserData);
-
-			/* As long as the list is not empty, we do the following */
-
-			while(!matchingKeys->isEmpty())
-			{
-				/* We retrieve the current content of the head of the list */
-				Tuple *current_tuple = (Tuple *) matchingKeys->getItemInPos(1);
-
-				/* The current content of the head is removed from the list
-				 *
-				 * The next node of the head becomes the new head
-				 */
-				matchingKeys->removeFront();
-
-				/* Now we have found a tuple of 'S' and a tuple of 'R'
-				 * that have the same user data. We retrieve the row
-				 * IDs of these two tuples
-				 */
-				unsigned int S_tuple_rowId = current_tuple->getRowId();
-				unsigned int R_tuple_rowId = R_table[i].getRowId();
-
-                /* We are about to enter a critical section. Only one
-                 * thread at a time should access the 'result' lists.
-                 * We use the utility mutex of the Job Scheduler to
-                 * create critical sections inside our functions that
-                 * we give as jobs to the scheduler.
-                 */
-                lock(util);
-
-				/* We create an item that stores the pair of the above
-				 * two row IDs and we insert that item in the list
-				 */
-				result->insertLast(new RowIdPair(R_tuple_rowId, S_tuple_rowId));
-
-                /* End of critical section - we unlock the mutex */
-                unlock(util);
-			}
-
-			/* Finally, we terminate the list of matching keys */
-			HashTable::terminateBulkSearchList(matchingKeys);
-		}
-	}
+    result->append(bucketResult);
+
+    /* End of critical section - we unlock the mutex */
+    unlock(util);
+
+    delete bucketResult;
 
     /* We free the allocated memory for the hash table */
-    delete hash_table;
+    if(!isCached)
+        delete hash_table;
+}
+
+/*************************************************************************
+ * Joins the pairs of buckets of the batches that the cursor 'nextBatch' *
+ * points to, until no batches are left (it is used as the routine of a  *
+ *                                 job)                                  *
+ *************************************************************************/
+
+void PartitionedHashJoin::joinBucketBatches(
+    unsigned int *bucketOrder,
+    unsigned int *batchBounds,
+    unsigned int batchesNum,
+    unsigned int *nextBatch,
+    Tuple *leftRel,
+    Tuple *rightRel,
+    unsigned int leftRelSize,
+    unsigned int rightRelSize,
+    unsigned int *leftPrefixSum,
+    unsigned int *rightPrefixSum,
+    unsigned int bucketsNum,
+    unsigned int hopscotchRange,
+    bool resizableByLoadFactor,
+    double loadFactor,
+    pthread_mutex_t *util,
+    List *result,
+    CachedBuildSide *leftCache,
+    CachedBuildSide *rightCache,
+    HashFunctionType hashFunction)
+{
+    while(1)
+    {
+        /* We take the next batch that no other thread has taken */
+        unsigned int batch = __atomic_fetch_add(nextBatch, 1, __ATOMIC_RELAXED);
+
+        if(batch >= batchesNum)
+            break;
+
+        for(unsigned int i = batchBounds[batch]; i < batchBounds[batch + 1]; i++)
+        {
+            joinBuckets(bucketOrder[i], leftRel, rightRel, leftRelSize,
+                rightRelSize, leftPrefixSum, rightPrefixSum, bucketsNum,
+                hopscotchRange, resizableByLoadFactor, loadFactor, util,
+                result, leftCache, rightCache, hashFunction);
+        }
+    }
+}
+
+/**************************************************************
+ * The routine of a join job, which calls 'joinBucketBatches' *
+ *             with the fields of the given input             *
+ **************************************************************/
+
+void PartitionedHashJoin::joinJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    JoinJobInput *joinJobInput = (JoinJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    joinBucketBatches(
+        joinJobInput->bucketOrder,
+        joinJobInput->batchBounds,
+        joinJobInput->batchesNum,
+        joinJobInput->nextBatch,
+        joinJobInput->leftRel,
+        joinJobInput->rightRel,
+        joinJobInput->leftRelSize,
+        joinJobInput->rightRelSize,
+        joinJobInput->leftPrefixSum,
+        joinJobInput->rightPrefixSum,
+        joinJobInput->bucketsNum,
+        joinJobInput->hopscotchRange,
+        joinJobInput->resizableByLoadFactor,
+        joinJobInput->loadFactor,
+        joinJobInput->utilityMutex,
+        joinJobInput->result,
+        joinJobInput->leftCache,
+        joinJobInput->rightCache,
+        joinJobInput->hashFunction
+    );
 }
 
 /**********************************************************
@@ -1217,13 +1954,89 @@ void PartitionedHashJoin::parallelMethodForBucketJoining(
     /* Auxiliary variable (used for counting) */
     unsigned int i;
 
-    /* We define the input for each partition job */
-    JoinJobInput *joinJobInputs[bucketsNum];
+    /* The auxiliary arrays are placed in the scratch arena of this thread */
+    ScratchArena *arena = ScratchArena::getThreadArena();
+    ScratchMark arenaMark = arena->getMark();
+
+    /* The pairs of buckets whose result has already been deposited (they
+     * were partitioned further, which we call 'multipartitioning') or that
+     * have an empty bucket have nothing to join. We estimate the cost of
+     * every other pair by the amount of tuples it builds and probes.
+     */
+    BucketCost *bucketCosts = (BucketCost *) arena->allocate(bucketsNum * sizeof(BucketCost));
+    unsigned int pairsNum = 0;
+    unsigned long long totalCost = 0;
 
     for(i = 0; i < bucketsNum; i++)
+    {
+        if(resultHasAlreadyBeenDeposited[i])
+            continue;
+
+        unsigned int leftEnd = (i == bucketsNum - 1) ? leftRelSize : leftPrefixSum[i + 1];
+        unsigned int rightEnd = (i == bucketsNum - 1) ? rightRelSize : rightPrefixSum[i + 1];
+
+        if(leftPrefixSum[i] >= leftEnd || rightPrefixSum[i] >= rightEnd)
+            continue;
+
+        bucketCosts[pairsNum].cost = (unsigned long long) (leftEnd - leftPrefixSum[i])
+            + (rightEnd - rightPrefixSum[i]);
+
+        bucketCosts[pairsNum].bucket = i;
+        totalCost += bucketCosts[pairsNum].cost;
+        pairsNum++;
+    }
+
+    /* The most expensive pairs are joined first, so the threads do not
+     * wait for a large pair that was taken last
+     */
+    qsort(bucketCosts, pairsNum, sizeof(BucketCost), compareBucketCosts);
+
+    /* We group the sorted pairs in batches of about the same cost. A pair
+     * that exceeds that cost is a batch of its own, while many small pairs
+     * are grouped together, so a thread takes them with a single step of
+     * the cursor.
+     */
+    unsigned int threadsNum = jobScheduler->getMaxThreads();
+    unsigned long long batchCost = totalCost / (threadsNum * JOIN_BATCHES_PER_THREAD);
+
+    unsigned int *bucketOrder = (unsigned int *) arena->allocate(pairsNum * sizeof(unsigned int));
+    unsigned int *batchBounds = (unsigned int *) arena->allocate((pairsNum + 1) * sizeof(unsigned int));
+    unsigned int batchesNum = 0;
+    unsigned long long currentBatchCost = 0;
+
+    for(i = 0; i < pairsNum; i++)
+    {
+        bucketOrder[i] = bucketCosts[i].bucket;
+
+        if(i == 0 || currentBatchCost + bucketCosts[i].cost > batchCost)
+        {
+            batchBounds[batchesNum++] = i;
+            currentBatchCost = 0;
+        }
+
+        currentBatchCost += bucketCosts[i].cost;
+    }
+
+    batchBounds[batchesNum] = pairsNum;
+
+    /* Every thread gets one job that takes batches from the shared
+     * cursor until none are left (a thread never gets more jobs than
+     * there are batches). The scheduler may already have jobs of the
+     * sub-joins and the cross products, which are executed with them.
+     */
+    unsigned int nextBatch = 0;
+    unsigned int jobsNum = (threadsNum < batchesNum) ? threadsNum : batchesNum;
+
+    JoinJobInput **joinJobInputs = new JoinJobInput*[jobsNum];
+    Job **joinJobs = new Job*[jobsNum];
+
+    for(i = 0; i < jobsNum; i++)
     {
         joinJobInputs[i] = new JoinJobInput(
-            i,
+            bucketOrder,
+            batchBounds,
+            batchesNum,
+            &nextBatch,
             leftRel,
             rightRel,
             leftRelSize,
@@ -1231,23 +2044,18 @@ void PartitionedHashJoin::parallelMethodForBucketJoining(
             leftPrefixSum,
             rightPrefixSum,
             bucketsNum,
-            hopscotchBuckets,
             hopscotchRange,
             resizableByLoadFactor,
             loadFactor,
             utilMutex,
             result,
-            resultHasAlreadyBeenDeposited[i]
+            cachedR,
+            cachedS,
+            hashFunction
         );
-    }
 
-    /* Now we will create the jobs using the above input objects */
-    Job *joinJobs[bucketsNum];
-
-    for(i = 0; i < bucketsNum; i++)
-    {
         /* We create the next job */
-        joinJobs[i] = new Job(NULL, NULL, NULL, NULL, joinBuckets, joinJobInputs[i]);
+        joinJobs[i] = new Job(joinJob, joinJobInputs[i]);
 
         /* We submit the job to the scheduler */
         jobScheduler->submitJob(joinJobs[i]);
@@ -1262,11 +2070,44 @@ void PartitionedHashJoin::parallelMethodForBucketJoining(
     /* The jobs have been completed. We free the allocated
      * memory for the job objects and the job input objects
      */
-    for(i = 0; i < bucketsNum; i++)
+    for(i = 0; i < jobsNum; i++)
     {
         delete joinJobs[i];
         delete joinJobInputs[i];
     }
+
+    delete[] joinJobs;
+    delete[] joinJobInputs;
+
+    arena->rewind(arenaMark);
+}
+
+/********************************************************************
+ * Executes the given sub-join and deposits its result in the given *
+ *        output buffer (it is used as the routine of a job)        *
+ ********************************************************************/
+
+void PartitionedHashJoin::executeSubjoin(PartitionedHashJoin *subjoin,
+    RowIdRelation **result)
+{
+    *result = subjoin->executeJoin();
+}
+
+/**************************************************************
+ * The routine of a subjoin job, which calls 'executeSubjoin' *
+ *             with the fields of the given input             *
+ **************************************************************/
+
+void PartitionedHashJoin::subjoinJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    SubjoinJobInput *subjoinJobInput = (SubjoinJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    executeSubjoin(
+        subjoinJobInput->subjoin,
+        subjoinJobInput->result
+    );
 }
 
 /************************************************
@@ -1275,6 +2116,20 @@ void PartitionedHashJoin::parallelMethodForBucketJoining(
 
 RowIdRelation *PartitionedHashJoin::executeJoin()
 {
+    /* The row IDs of the tuples are 32-bit, so a relation cannot have more
+     * tuples than a row ID can address. Such a relation can only be made
+     * of a larger intermediate result, whose positions would have wrapped
+     * around, so we stop instead of returning a wrong result.
+     */
+    if((relR->getNumOfTuples() > UINT_MAX) || (relS->getNumOfTuples() > UINT_MAX))
+    {
+        fprintf(stderr, "Relations of %llu and %llu tuples cannot be joined, "
+            "since a row ID addresses at most %u tuples\n",
+            relR->getNumOfTuples(), relS->getNumOfTuples(), UINT_MAX);
+
+        exit(EXIT_FAILURE);
+    }
+
     /* We print the initial contents of the relations */
 
     if(hasSubrelations)
@@ -1289,17 +2144,24 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
             displayInitialRelations("Relations in the beginning");
     }
 
-    /* We retrieve the size of the level-2 cache */
-    long lvl2CacheSize = get_Lvl2_Cache_Size();
+    /* Nothing has been done by this call yet */
+    statistics = JoinStatistics();
 
-    /* If the cache size could not be retrieved,
-     * we cancel the join operation and return 'NULL'
+    /* The auxiliary arrays of the join are placed in the scratch arena of
+     * this thread. Everything we allocate there is freed at once when we
+     * rewind the arena to this mark, so the arena keeps its memory for the
+     * sub-joins and the following joins of the query.
      */
-    if(lvl2CacheSize == -1)
-        return NULL;
+    ScratchArena *arena = ScratchArena::getThreadArena();
+    ScratchMark arenaMark = arena->getMark();
+
+    /* We retrieve the size of the level-2 cache (a typical size is
+     * assumed if the system cannot tell, so the join always proceeds)
+     */
+    long lvl2CacheSize = CacheHierarchy::getInstance()->getLvl2CacheSize();
 
     /* Variables we will need later in the algorithm */
-    unsigned int i, R_numOfTuples, S_numOfTuples;
+    unsigned long long i, R_numOfTuples, S_numOfTuples;
 
     /* This is the number of tuples of the relation 'relR' */
     R_numOfTuples = relR->getNumOfTuples();
@@ -1312,6 +2174,44 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
 
     /* This is the array itself of the relation 'relS' */
     Tuple *S_table = relS->getTuples();
+
+    /* If the partitions are tuned automatically, we choose their bits
+     * from the sizes of the whole relations. The bits of the first
+     * partition of a cached relation were chosen when it was cached.
+     * The relations are partitioned at most as many times as the tuned
+     * passes, whose buckets already fit the cache, so a bucket that is
+     * still too large after them is joined without partitioning it more.
+     */
+    if(autoTunedPartitioning)
+    {
+        unsigned int passesNum;
+
+        tunePartitioning(R_numOfTuples, S_numOfTuples,
+            (jobScheduler != NULL) ? jobScheduler->getMaxThreads() : 1,
+            maxAllowedSizeModifier, maxPartitionDepth, &bitsPerPass, &passesNum);
+
+        if(cachedR == NULL && cachedS == NULL)
+            bitsNumForHashing = bitsPerPass;
+
+        if(passesNum > 0 && passesNum < maxPartitionDepth)
+            maxPartitionDepth = passesNum;
+    }
+
+    /* If the hash function is chosen automatically, we choose it from a
+     * sample of the keys of both relations. The subrelations inherit it.
+     */
+    if(hashFunction == AutoHash)
+    {
+        unsigned long long *sample = (unsigned long long *) arena->allocate(
+            2 * HASH_FUNCTION_SAMPLE_SIZE * sizeof(unsigned long long));
+        unsigned int sampledNum = 0;
+
+        sampleKeys(R_table, R_numOfTuples, HASH_FUNCTION_SAMPLE_SIZE, sample, &sampledNum);
+        sampleKeys(S_table, S_numOfTuples, HASH_FUNCTION_SAMPLE_SIZE, sample, &sampledNum);
+
+        hashFunction = chooseHashFunction(sample, sampledNum, bitsNumForHashing);
+        arena->rewind(arenaMark);
+    }
 /*
 	if(hasSubrelations)
 		std::cout << "Subrelation with " << R_numOfTuples << " R tuples and " << S_numOfTuples << " S tuples" << std::endl;
@@ -1324,6 +2224,118 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
     if((maxPartitionDepth > 0) && (partitionRequired(R_numOfTuples,
         S_numOfTuples, sizeof(Tuple), lvl2CacheSize)))
     {
+        /* The relations are partitioned in at least one level */
+        statistics.partitionDepth = 1;
+
+        /* All the tuples of a key land in the same bucket, so a key that
+         * is too frequent (a heavy hitter) makes a bucket that no further
+         * partition can split. We find such keys in a sample of the whole
+         * relations and we take their tuples out of the relations before
+         * the partition. The relations of a cached build side are already
+         * partitioned, so they keep all their tuples.
+         */
+        unsigned long long heavyKeys[MAX_HEAVY_HITTERS];
+        unsigned int heavyKeysNum = 0;
+
+        if(!hasSubrelations && (heavyHitterShare > 0)
+        && (cachedR == NULL) && (cachedS == NULL))
+        {
+            heavyKeysNum = detectHeavyHitters(R_table, R_numOfTuples,
+                S_table, S_numOfTuples, lvl2CacheSize, heavyKeys);
+        }
+
+        statistics.heavyHittersNum = heavyKeysNum;
+
+        /* The tuples of the heavy hitters of both relations
+         * grouped by key, along with their amounts and offsets
+         */
+        Tuple *R_heavyTuples = NULL;
+        Tuple *S_heavyTuples = NULL;
+
+        unsigned int R_heavyHistogram[MAX_HEAVY_HITTERS];
+        unsigned int S_heavyHistogram[MAX_HEAVY_HITTERS];
+        unsigned int R_heavyPrefixSum[MAX_HEAVY_HITTERS];
+        unsigned int S_heavyPrefixSum[MAX_HEAVY_HITTERS];
+
+        /* The rest of the tuples remain in the start of the relations and
+         * they are the only ones we partition. The tuples of the heavy
+         * hitters are moved to the end of the relations, so the arrays of
+         * the caller still hold every tuple exactly once after the join.
+         */
+        if(heavyKeysNum > 0)
+        {
+            R_numOfTuples = separateHeavyHitters(R_table, R_numOfTuples,
+                heavyKeys, heavyKeysNum, &R_heavyTuples,
+                R_heavyHistogram, R_heavyPrefixSum);
+
+            S_numOfTuples = separateHeavyHitters(S_table, S_numOfTuples,
+                heavyKeys, heavyKeysNum, &S_heavyTuples,
+                S_heavyHistogram, S_heavyPrefixSum);
+        }
+
+        /* Every tuple of a heavy hitter in one relation matches every
+         * tuple of the same key in the other relation. We know the size
+         * of every cross product, so its pairs are written directly to
+         * their own output buffer. The larger side of every key is split
+         * into pieces, so the threads share the work of a single key.
+         */
+        unsigned long long heavyPairsNum = 0;
+        unsigned int key;
+
+        for(key = 0; key < heavyKeysNum; key++)
+            heavyPairsNum += ((unsigned long long) R_heavyHistogram[key]) * S_heavyHistogram[key];
+
+        RowIdPair *heavyPairs = new RowIdPair[heavyPairsNum];
+
+        unsigned int piecesPerKey = (jobScheduler != NULL)
+            ? jobScheduler->getMaxThreads() : 1;
+
+        CrossProductJobInput **crossProducts =
+            new CrossProductJobInput*[heavyKeysNum * piecesPerKey];
+
+        unsigned int crossProductsNum = 0;
+        RowIdPair *keyPairs = heavyPairs;
+
+        for(key = 0; key < heavyKeysNum; key++)
+        {
+            bool outerIsR = (R_heavyHistogram[key] >= S_heavyHistogram[key]);
+
+            Tuple *outerTuples = outerIsR ? R_heavyTuples + R_heavyPrefixSum[key]
+                : S_heavyTuples + S_heavyPrefixSum[key];
+
+            Tuple *innerTuples = outerIsR ? S_heavyTuples + S_heavyPrefixSum[key]
+                : R_heavyTuples + R_heavyPrefixSum[key];
+
+            unsigned int outerTuplesNum = outerIsR ? R_heavyHistogram[key]
+                : S_heavyHistogram[key];
+
+            unsigned int innerTuplesNum = outerIsR ? S_heavyHistogram[key]
+                : R_heavyHistogram[key];
+
+            /* A key that is missing from one relation has no pairs */
+            if(innerTuplesNum == 0)
+                continue;
+
+            unsigned int piecesNum = (outerTuplesNum < piecesPerKey)
+                ? outerTuplesNum : piecesPerKey;
+
+            for(unsigned int piece = 0; piece < piecesNum; piece++)
+            {
+                unsigned int start = (unsigned int)
+                    (((unsigned long long) outerTuplesNum) * piece / piecesNum);
+
+                unsigned int end = (unsigned int)
+                    (((unsigned long long) outerTuplesNum) * (piece + 1) / piecesNum);
+
+                crossProducts[crossProductsNum++] = new CrossProductJobInput(
+                    outerTuples + start, end - start, innerTuples,
+                    innerTuplesNum, outerIsR,
+                    keyPairs + ((unsigned long long) start) * innerTuplesNum);
+            }
+
+            keyPairs += ((unsigned long long) outerTuplesNum) * innerTuplesNum;
+        }
+
         /* We will build the histogram of the relation 'relR'
          *
          * First we initialize the histogram size to 1
@@ -1340,46 +2352,59 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         R_histogramSize <<= bitsNumForHashing;
 
         /* We define the histogram of 'relR' */
-        unsigned int *R_histogram = new unsigned int[R_histogramSize];
-
-        /* We initialize every element of the histogram to zero */
-
-        for(i = 0; i < R_histogramSize; i++)
-            R_histogram[i] = 0;
+        unsigned int *R_histogram;
 
-        /* Then we fill the histogram with the desired content
-         *
-         * The value of the element of index 'i' in the histogram
-         * indicates the amount of elements of the relational
-         * array 'relR' that were hashed to the bucket 'i'
-         *
-         * Case a job scheduler does not exist.
-         *
-         * We make the histogram serially.
+        /* If 'relR' consists of the tuples of a cached build side,
+         * it is partitioned already, so we take its histogram from
+         * the cache. Else we compute the histogram now.
          */
-        if(jobScheduler == NULL)
-        {
-            createHistogram(
-                R_histogram,
-                R_table,
-                0,
-                R_numOfTuples,
-                bitsNumForHashing
-            );
-        }
+        if(cachedR != NULL)
+            R_histogram = cachedR->getHistogram();
 
-        /* Case a job scheduler exists.
-         *
-         * We make the histogram in parallel.
-         */
         else
         {
-            parallelMethodForHistogramCreation(
-                R_table,
-                R_histogram,
-                R_numOfTuples,
-                R_histogramSize
-            );
+            R_histogram = (unsigned int *) arena->allocate(R_histogramSize * sizeof(unsigned int));
+
+            /* We initialize every element of the histogram to zero */
+
+            for(i = 0; i < R_histogramSize; i++)
+                R_histogram[i] = 0;
+
+            /* Then we fill the histogram with the desired content
+             *
+             * The value of the element of index 'i' in the histogram
+             * indicates the amount of elements of the relational
+             * array 'relR' that were hashed to the bucket 'i'
+             *
+             * Case a job scheduler does not exist.
+             *
+             * We make the histogram serially.
+             */
+            if(jobScheduler == NULL)
+            {
+                createHistogram(
+                    R_histogram,
+                    R_table,
+                    0,
+                    R_numOfTuples,
+                    bitsNumForHashing,
+                    hashFunction
+                );
+            }
+
+            /* Case a job scheduler exists.
+             *
+             * We make the histogram in parallel.
+             */
+            else
+            {
+                parallelMethodForHistogramCreation(
+                    R_table,
+                    R_histogram,
+                    R_numOfTuples,
+                    R_histogramSize
+                );
+            }
         }
 
         /* We will build the histogram of the relation 'relS'
@@ -1398,46 +2423,59 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         S_histogramSize <<= bitsNumForHashing;
 
         /* We define the histogram of 'relS' */
-        unsigned int *S_histogram = new unsigned int[S_histogramSize];
+        unsigned int *S_histogram;
 
-        /* We initialize every element of the histogram to zero */
-
-        for(i = 0; i < S_histogramSize; i++)
-            S_histogram[i] = 0;
-
-        /* Then we fill the histogram with the desired content
-         *
-         * The value of the element of index 'i' in the histogram
-         * indicates the amount of elements of the relational
-         * array 'relS' that were hashed to the bucket 'i'
-         *
-         * Case a job scheduler does not exist.
-         *
-         * We make the histogram serially.
+        /* If 'relS' consists of the tuples of a cached build side,
+         * it is partitioned already, so we take its histogram from
+         * the cache. Else we compute the histogram now.
          */
-        if(jobScheduler == NULL)
-        {
-            createHistogram(
-                S_histogram,
-                S_table,
-                0,
-                S_numOfTuples,
-                bitsNumForHashing
-            );
-        }
+        if(cachedS != NULL)
+            S_histogram = cachedS->getHistogram();
 
-        /* Case a job scheduler exists.
-         *
-         * We make the histogram in parallel.
-         */
         else
         {
-            parallelMethodForHistogramCreation(
-                S_table,
-                S_histogram,
-                S_numOfTuples,
-                S_histogramSize
-            );
+            S_histogram = (unsigned int *) arena->allocate(S_histogramSize * sizeof(unsigned int));
+
+            /* We initialize every element of the histogram to zero */
+
+            for(i = 0; i < S_histogramSize; i++)
+                S_histogram[i] = 0;
+
+            /* Then we fill the histogram with the desired content
+             *
+             * The value of the element of index 'i' in the histogram
+             * indicates the amount of elements of the relational
+             * array 'relS' that were hashed to the bucket 'i'
+             *
+             * Case a job scheduler does not exist.
+             *
+             * We make the histogram serially.
+             */
+            if(jobScheduler == NULL)
+            {
+                createHistogram(
+                    S_histogram,
+                    S_table,
+                    0,
+                    S_numOfTuples,
+                    bitsNumForHashing,
+                    hashFunction
+                );
+            }
+
+            /* Case a job scheduler exists.
+             *
+             * We make the histogram in parallel.
+             */
+            else
+            {
+                parallelMethodForHistogramCreation(
+                    S_table,
+                    S_histogram,
+                    S_numOfTuples,
+                    S_histogramSize
+                );
+            }
         }
 
         /* Now we are going to build the prefix sum arrays
@@ -1449,7 +2487,7 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         /* This is the prefix sum array of the relation 'relR'
          * It has the same size as the histogram of 'relR'
          */
-        unsigned int *prefixSum_R = new unsigned int[R_histogramSize];
+        unsigned int *prefixSum_R = (unsigned int *) arena->allocate(R_histogramSize * sizeof(unsigned int));
 
         /* We build the prefix sum of 'relR' */
 
@@ -1473,7 +2511,7 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         /* This is the prefix sum array of the relation 'relS'
          * It has the same size as the histogram of 'relS'
          */
-        unsigned int *prefixSum_S = new unsigned int[S_histogramSize];
+        unsigned int *prefixSum_S = (unsigned int *) arena->allocate(S_histogramSize * sizeof(unsigned int));
 
         /* We build the prefix sum of 'relS' */
 
@@ -1514,13 +2552,7 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         /* Now we have everything we need to reorder the contents
          * of the relational arrays 'relR' and 'relS'.
          *
-         * First, we will allocate two new arrays with the same
-         * size as the relational arrays in the heap.
-         */
-        Tuple *reordered_R = new Tuple[R_numOfTuples];
-        Tuple *reordered_S = new Tuple[S_numOfTuples];
-
-        /* When an item is hashed to a bucket (with the help of the prefix
+         * When an item is hashed to a bucket (with the help of the prefix
          * sum auxiliary array), then another item that will be hashed
          * to the same bucket cannot take the position of the first one.
          * It has to be inserted in the next index of the first item.
@@ -1531,7 +2563,7 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
          * past. We keep track of how many items have been inserted to
          * every bucket with the 'elementsCounter' auxiliary array.
          */
-        unsigned int *elementsCounter = new unsigned int[R_histogramSize];
+        unsigned int *elementsCounter = (unsigned int *) arena->allocate(R_histogramSize * sizeof(unsigned int));
 
         /* Initially, there are no elements in any bucket.
          *
@@ -1540,47 +2572,61 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         for(i = 0; i < R_histogramSize; i++)
             elementsCounter[i] = 0;
 
-        /* We start reordering the relational array 'relR'
-         *
-         * Case a job scheduler does not exist (we do it serially)
+        /* If 'relR' consists of the tuples of a cached build side,
+         * its tuples are already in the order of their buckets
          */
-        if(jobScheduler == NULL)
+        if(cachedR == NULL)
         {
-            for(i = 0; i < R_numOfTuples; i++)
+            /* We allocate a new array with the same size as the
+             * relational array 'relR' in the scratch arena. Its memory
+             * is raw, so every tuple is copy-constructed in its position
+             * when it is scattered. Tuples own nothing, so they are never
+             * destroyed and the arena simply frees their memory.
+             */
+            Tuple *reordered_R = (Tuple *) arena->allocate(R_numOfTuples * sizeof(Tuple));
+
+            /* We start reordering the relational array 'relR'
+             *
+             * Case a job scheduler does not exist (we do it serially)
+             */
+            if(jobScheduler == NULL)
             {
-                /* We retrieve the value of the current tuple */
-                unsigned long long currentItem = *((unsigned long long *) R_table[i].getItem());
+                for(i = 0; i < R_numOfTuples; i++)
+                {
+                    /* We retrieve the value of the current tuple */
+                    unsigned long long currentItem = *((unsigned long long *) R_table[i].getItem());
 
-                /* We hash that value with bit reduction hashing */
-                unsigned int hash_value = bitReductionHash(currentItem, bitsNumForHashing);
+                    /* We hash that value with the hash function of the join */
+                    unsigned int hash_value = partitionHash(currentItem,
+                        bitsNumForHashing, hashFunction);
 
-                /* According to its hash value and the amount of previous
-                * items that have been hashed to the same bucket, we
-                * insert the current item to the reordered array of 'relR'
-                */
-                reordered_R[prefixSum_R[hash_value] + elementsCounter[hash_value]] = R_table[i];
+                    /* According to its hash value and the amount of previous
+                    * items that have been hashed to the same bucket, we
+                    * insert the current item to the reordered array of 'relR'
+                    */
+                    new (&reordered_R[prefixSum_R[hash_value] + elementsCounter[hash_value]]) Tuple(R_table[i]);
 
-                /* We increase the amount of inserted items in this bucket by 1 */
-                elementsCounter[hash_value]++;
+                    /* We increase the amount of inserted items in this bucket by 1 */
+                    elementsCounter[hash_value]++;
+                }
             }
-        }
 
-        /* Case a job scheduler exists (we do it in parallel) */
+            /* Case a job scheduler exists (we do it in parallel) */
 
-        else
-        {
-            parallelMethodForTupleReordering(
-                R_table,
-                reordered_R,
-                R_numOfTuples,
-                prefixSum_R,
-                elementsCounter
-            );
-        }
+            else
+            {
+                parallelMethodForTupleReordering(
+                    R_table,
+                    reordered_R,
+                    R_numOfTuples,
+                    prefixSum_R,
+                    elementsCounter
+                );
+            }
 
-        /* We assign the reordered array to 'relR' and discard the previous array */
-        memcpy(relR->getTuples(), reordered_R, R_numOfTuples * sizeof(Tuple));
-        delete[] reordered_R;
+            /* We assign the reordered array to 'relR' and discard the previous array */
+            memcpy(relR->getTuples(), reordered_R, R_numOfTuples * sizeof(Tuple));
+        }
 
         /* We reset the contents of 'elementsCounter' to zero,
          * because we want to repeat the process for 'relS'
@@ -1588,47 +2634,61 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         for(i = 0; i < S_histogramSize; i++)
             elementsCounter[i] = 0;
 
-        /* We start reordering the relational array 'relS'
-         *
-         * Case a job scheduler does not exist (we do it serially)
+        /* If 'relS' consists of the tuples of a cached build side,
+         * its tuples are already in the order of their buckets
          */
-        if(jobScheduler == NULL)
+        if(cachedS == NULL)
         {
-            for(i = 0; i < S_numOfTuples; i++)
+            /* We allocate a new array with the same size as the
+             * relational array 'relS' in the scratch arena. Its memory
+             * is raw, so every tuple is copy-constructed in its position
+             * when it is scattered. Tuples own nothing, so they are never
+             * destroyed and the arena simply frees their memory.
+             */
+            Tuple *reordered_S = (Tuple *) arena->allocate(S_numOfTuples * sizeof(Tuple));
+
+            /* We start reordering the relational array 'relS'
+             *
+             * Case a job scheduler does not exist (we do it serially)
+             */
+            if(jobScheduler == NULL)
             {
-                /* We retrieve the value of the current tuple */
-                unsigned long long currentItem = *((unsigned long long *) S_table[i].getItem());
+                for(i = 0; i < S_numOfTuples; i++)
+                {
+                    /* We retrieve the value of the current tuple */
+                    unsigned long long currentItem = *((unsigned long long *) S_table[i].getItem());
 
-                /* We hash that value with bit reduction hashing */
-                unsigned int hash_value = bitReductionHash(currentItem, bitsNumForHashing);
+                    /* We hash that value with the hash function of the join */
+                    unsigned int hash_value = partitionHash(currentItem,
+                        bitsNumForHashing, hashFunction);
 
-                /* According to its hash value and the amount of previous
-                * items that have been hashed to the same bucket, we
-                * insert the current item to the reordered array of 'relS'
-                */
-                reordered_S[prefixSum_S[hash_value] + elementsCounter[hash_value]] = S_table[i];
+                    /* According to its hash value and the amount of previous
+                    * items that have been hashed to the same bucket, we
+                    * insert the current item to the reordered array of 'relS'
+                    */
+                    new (&reordered_S[prefixSum_S[hash_value] + elementsCounter[hash_value]]) Tuple(S_table[i]);
 
-                /* We increase the amount of inserted items in this bucket by 1 */
-                elementsCounter[hash_value]++;
+                    /* We increase the amount of inserted items in this bucket by 1 */
+                    elementsCounter[hash_value]++;
+                }
             }
-        }
 
-        /* Case a job scheduler exists (we do it in parallel) */
+            /* Case a job scheduler exists (we do it in parallel) */
 
-        else
-        {
-            parallelMethodForTupleReordering(
-                S_table,
-                reordered_S,
-                S_numOfTuples,
-                prefixSum_S,
-                elementsCounter
-            );
-        }
+            else
+            {
+                parallelMethodForTupleReordering(
+                    S_table,
+                    reordered_S,
+                    S_numOfTuples,
+                    prefixSum_S,
+                    elementsCounter
+                );
+            }
 
-        /* We assign the reordered array to 'relS' and discard the previous array */
-        memcpy(relS->getTuples(), reordered_S, S_numOfTuples * sizeof(Tuple));
-        delete[] reordered_S;
+            /* We assign the reordered array to 'relS' and discard the previous array */
+            memcpy(relS->getTuples(), reordered_S, S_numOfTuples * sizeof(Tuple));
+        }
 
         /* We create the list that will be storing all the contents
          * of the result. We are using a list because we do not know
@@ -1650,7 +2710,10 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
         for(i = 0; i < histogramSize; i++)
             resultsHaveBeenDeposited[i] = false;
 
-        /* Now we will examine if each bucket needs further partition */
+        /* Now we will examine if each bucket needs further partition. We
+         * count the buckets that do, so we can prepare their sub-joins.
+         */
+        unsigned int subjoinsNum = 0;
 
         for(i = 0; i < histogramSize; i++)
         {
@@ -1662,9 +2725,37 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
                 continue;
             }
 
-            /* Case partition is required for the current bucket */
-
+            /* Case partition is required for the current bucket. Its result
+             * will be deposited by its sub-join, not by the bucket joins.
+             */
             resultsHaveBeenDeposited[i] = true;
+            subjoinsNum++;
+        }
+
+        /* Every bucket that needs further partition is joined by its own
+         * 'PartitionedHashJoin' object (a sub-join). The sub-joins are
+         * independent of each other, so each one becomes a job that runs
+         * concurrently with the other sub-joins and the bucket joins and
+         * deposits its result in its own output buffer.
+         */
+        PartitionedHashJoin **subjoins = new PartitionedHashJoin*[subjoinsNum];
+        RowIdRelation **subjoinResults = new RowIdRelation*[subjoinsNum];
+        Relation **subrelsR = new Relation*[subjoinsNum];
+        Relation **subrelsS = new Relation*[subjoinsNum];
+
+        /* The buckets are reordered in place by the further partition.
+         * The tuples of a cached build side must keep their order, so
+         * we partition a copy of the bucket of a cached relation.
+         */
+        Tuple **bucketCopiesR = new Tuple*[subjoinsNum];
+        Tuple **bucketCopiesS = new Tuple*[subjoinsNum];
+
+        unsigned int subjoin = 0;
+
+        for(i = 0; i < histogramSize; i++)
+        {
+            if(resultsHaveBeenDeposited[i] == false)
+                continue;
 
             /* We will move the pointer far from the base address of
              * the whole relation up to the offset where the current
@@ -1673,73 +2764,68 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
             Tuple *bucket_R = R_table + prefixSum_R[i];
             Tuple *bucket_S = S_table + prefixSum_S[i];
 
+            bucketCopiesR[subjoin] = NULL;
+            bucketCopiesS[subjoin] = NULL;
+
+            if(cachedR != NULL)
+            {
+                bucket_R = bucketCopiesR[subjoin] = new Tuple[R_histogram[i]];
+
+                for(unsigned int j = 0; j < R_histogram[i]; j++)
+                    bucket_R[j] = R_table[prefixSum_R[i] + j];
+            }
+
+            if(cachedS != NULL)
+            {
+                bucket_S = bucketCopiesS[subjoin] = new Tuple[S_histogram[i]];
+
+                for(unsigned int j = 0; j < S_histogram[i]; j++)
+                    bucket_S[j] = S_table[prefixSum_S[i] + j];
+            }
+
             /* We create the two sub-relations that only
              * contain the elements of the current buckets
              */
-            Relation subrelR = Relation(bucket_R, R_histogram[i]);
-            Relation subrelS = Relation(bucket_S, S_histogram[i]);
+            subrelsR[subjoin] = new Relation(bucket_R, R_histogram[i]);
+            subrelsS[subjoin] = new Relation(bucket_S, S_histogram[i]);
 
             /* We will create a new 'PartitionedHashJoin' object that
-             * will perform the 'join' operation between the buckets,
+             * will perform the 'join' operation between the buckets.
+             *
+             * The sub-join runs inside a job, so it must not submit jobs
+             * of its own (the scheduler would wait for the job that is
+             * waiting for it). It executes all its phases serially.
              */
-            PartitionedHashJoin *subjoin = new PartitionedHashJoin(
-                &subrelR,
-                &subrelS,
-                alterBitsNum(bitsNumForHashing),
+            subjoins[subjoin] = new PartitionedHashJoin(
+                subrelsR[subjoin],
+                subrelsS[subjoin],
+                bitsNumForHashing + bitsPerPass,
+                bitsPerPass,
                 showInitialRelations,
                 showAuxiliaryArrays,
                 showHashTable,
                 showSubrelations,
                 showResult,
-                hopscotchBuckets,
                 hopscotchRange,
                 resizableByLoadFactor,
                 loadFactor,
                 maxAllowedSizeModifier,
                 maxPartitionDepth - 1,
-                jobScheduler
+                hashFunction,
+                NULL
             );
 
-            /* Here we perform the 'join' operation between the buckets */
-            RowIdRelation *subjoin_result = subjoin->executeJoin();
-
-            /* Case something went wrong with the 'join' operation above */
-
-            if(subjoin_result == NULL)
-            {
-                std::cout << "A unexpected problem occurred" << std::endl;
-                std::cout << "A bucket could not be processed" << std::endl;
-
-                delete subjoin;
-                continue;
-            }
-
-            /* If this part is reached, the 'join' operation was performed
-             * successfully. We retrieve the result array of the 'join'
-             */
-            RowIdPair *subjoin_array = subjoin_result->getRowIdPairs();
-
-            /* We retrieve the number of elements of the above array */
-            unsigned int subjoin_items = subjoin_result->getNumOfRowIdPairs();
-
-            /* Helper variable for counting */
-            unsigned int j;
-
-            /* We add all the elements of the result to the list */
-
-            for(j = 0; j < subjoin_items; j++)
-            {
-                resultAsList->insertLast(new RowIdPair(subjoin_array[j].
-                    getLeftRowId(), subjoin_array[j].getRightRowId()));
-            }
-
-            /* We free the allocated memory for the result of 'join' */
-            subjoin->freeJoinResult(subjoin_result);
+            subjoinResults[subjoin] = NULL;
+            subjoin++;
+        }
 
-            /* We free the 'PartitionedHashJoin' object we created
-             * to perform the 'join' operation between the buckets
-             */
-            delete subjoin;
+        /* Every pair of buckets that was not partitioned further
+         * is probed with the hash table of its smaller bucket
+         */
+        for(i = 0; i < histogramSize; i++)
+        {
+            if(resultsHaveBeenDeposited[i] == false)
+                recordHashTable(R_histogram[i], S_histogram[i]);
         }
 
         /* We start probing the buckets of the reordered array 'R'
@@ -1750,6 +2836,23 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
          */
         if(jobScheduler == NULL)
         {
+            /* We execute the sub-joins one after the other */
+            for(subjoin = 0; subjoin < subjoinsNum; subjoin++)
+                executeSubjoin(subjoins[subjoin], &subjoinResults[subjoin]);
+
+            /* We write the cross products of the heavy hitters */
+            for(i = 0; i < crossProductsNum; i++)
+            {
+                emitCrossProduct(
+                    crossProducts[i]->outerTuples,
+                    crossProducts[i]->outerTuplesNum,
+                    crossProducts[i]->innerTuples,
+                    crossProducts[i]->innerTuplesNum,
+                    crossProducts[i]->outerIsR,
+                    crossProducts[i]->result
+                );
+            }
+
             /* We skip processing the buckets that have already been
              * processed by the mutlipartitioning algorithm just above.
              */
@@ -1758,7 +2861,8 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
                 if(resultsHaveBeenDeposited[i] == false)
                 {
                     probeRelations(prefixSum_R[i], prefixSum_R[i+1],
-                        prefixSum_S[i], prefixSum_S[i+1], resultAsList);
+                        prefixSum_S[i], prefixSum_S[i+1], resultAsList,
+                        cachedR, cachedS, i);
                 }
             }
 
@@ -1768,7 +2872,8 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
             if(resultsHaveBeenDeposited[histogramSize - 1] == false)
             {
                 probeRelations(prefixSum_R[i], R_numOfTuples,
-                    prefixSum_S[i], S_numOfTuples, resultAsList);
+                    prefixSum_S[i], S_numOfTuples, resultAsList,
+                    cachedR, cachedS, i);
             }
         }
 
@@ -1776,6 +2881,33 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
 
         else
         {
+            /* The sub-joins and the pieces of the cross products are
+             * submitted first, since they are the largest jobs. The
+             * bucket joins are submitted after them and all the jobs
+             * are executed together.
+             */
+            SubjoinJobInput **subjoinJobInputs = new SubjoinJobInput*[subjoinsNum];
+            Job **subjoinJobs = new Job*[subjoinsNum];
+
+            for(subjoin = 0; subjoin < subjoinsNum; subjoin++)
+            {
+                subjoinJobInputs[subjoin] = new SubjoinJobInput(
+                    subjoins[subjoin], &subjoinResults[subjoin]);
+
+                subjoinJobs[subjoin] = new Job(subjoinJob, subjoinJobInputs[subjoin]);
+
+                jobScheduler->submitJob(subjoinJobs[subjoin]);
+            }
+
+            Job **crossProductJobs = new Job*[crossProductsNum];
+
+            for(i = 0; i < crossProductsNum; i++)
+            {
+                crossProductJobs[i] = new Job(crossProductJob, crossProducts[i]);
+
+                jobScheduler->submitJob(crossProductJobs[i]);
+            }
+
             parallelMethodForBucketJoining(
                 relR->getTuples(),
                 relS->getTuples(),
@@ -1787,25 +2919,95 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
                 resultAsList,
                 &resultsHaveBeenDeposited[0]
             );
+
+            /* The jobs read the prefix sums and the reordered tuples, which
+             * are in the scratch arena of this thread and are freed when we
+             * rewind it. The bucket joining has already waited for all the
+             * jobs (so this returns at once), but we wait here ourselves, so
+             * that no job may still read them once we go on to the rewind.
+             */
+            jobScheduler->waitAllTasksFinish();
+
+            /* All the jobs have been completed. We free the
+             * allocated memory for the jobs of the sub-joins.
+             */
+            for(subjoin = 0; subjoin < subjoinsNum; subjoin++)
+            {
+                delete subjoinJobs[subjoin];
+                delete subjoinJobInputs[subjoin];
+            }
+
+            delete[] subjoinJobs;
+            delete[] subjoinJobInputs;
+
+            for(i = 0; i < crossProductsNum; i++)
+                delete crossProductJobs[i];
+
+            delete[] crossProductJobs;
         }
 
-        /* This is the number of row ID pairs of the result */
-        unsigned int numOfItemsInList = resultAsList->getCounter();
+        /* The cross products have been written. We free their inputs
+         * (the tuples of the heavy hitters belong to the relations).
+         */
+        for(i = 0; i < crossProductsNum; i++)
+            delete crossProducts[i];
 
-        /* We create a new array of row ID pairs with size equal to the
-         * size of the list (which is the num of row ID pairs of the result)
+        delete[] crossProducts;
+
+        /* The result consists of the row ID pairs of the list, the row
+         * ID pairs of the output buffers of the sub-joins and the row ID
+         * pairs of the cross products of the heavy hitters
          */
-        RowIdPair *resultArray = new RowIdPair[numOfItemsInList];
+        unsigned long long numOfItemsInList = resultAsList->getCounter();
+        unsigned long long numOfItemsInResult = numOfItemsInList + heavyPairsNum;
+
+        for(subjoin = 0; subjoin < subjoinsNum; subjoin++)
+        {
+            /* Case something went wrong with a sub-join */
+
+            if(subjoinResults[subjoin] == NULL)
+            {
+                std::cout << "A unexpected problem occurred" << std::endl;
+                std::cout << "A bucket could not be processed" << std::endl;
+                continue;
+            }
+
+            numOfItemsInResult += subjoinResults[subjoin]->getNumOfRowIdPairs();
+
+            /* The deepest partitioning of a bucket is the depth of the
+             * join and the hash tables of the bucket belong to the join
+             */
+            JoinStatistics subjoinStatistics = subjoins[subjoin]->getStatistics();
+
+            if(subjoinStatistics.partitionDepth + 1 > statistics.partitionDepth)
+                statistics.partitionDepth = subjoinStatistics.partitionDepth + 1;
+
+            statistics.hashTablesNum += subjoinStatistics.hashTablesNum;
+            statistics.hashTableTuplesNum += subjoinStatistics.hashTableTuplesNum;
+
+            if(subjoinStatistics.largestHashTableSize > statistics.largestHashTableSize)
+                statistics.largestHashTableSize = subjoinStatistics.largestHashTableSize;
+        }
+
+        /* We create a new array of row ID pairs with
+         * size equal to the size of the whole result
+         */
+        RowIdPair *resultArray = new RowIdPair[numOfItemsInResult];
 
         /* We are going to transfer every row
          * ID pair of the list to the array
          */
         Listnode *current = resultAsList->getHead();
 
+        /* Helper variable for counting (the result
+         * may have more pairs than a row ID can count)
+         */
+        unsigned long long pair;
+
         /* As long as we have not transfered all the items from
          * the list to the array, we do the following actions
          */
-        for(i = 0; i < numOfItemsInList; i++)
+        for(pair = 0; pair < numOfItemsInList; pair++)
         {
             /* We retrieve the current row ID pair for transer */
             RowIdPair *current_pair = (RowIdPair *) current->getItem();
@@ -1813,8 +3015,8 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
             /* We transfer the information of the pair we retrieved
              * to the pair of the current position in the array
              */
-            resultArray[i].setLeftRowId(current_pair->getLeftRowId());
-            resultArray[i].setRightRowId(current_pair->getRightRowId());
+            resultArray[pair].setLeftRowId(current_pair->getLeftRowId());
+            resultArray[pair].setRightRowId(current_pair->getRightRowId());
 
             /* We delete the pair of the list */
             delete current_pair;
@@ -1823,20 +3025,64 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
             current = current->getNext();
         }
 
+        /* Then we append the output buffer of every sub-join as a whole */
+        unsigned long long resultPos = numOfItemsInList;
+
+        for(subjoin = 0; subjoin < subjoinsNum; subjoin++)
+        {
+            if(subjoinResults[subjoin] != NULL)
+            {
+                RowIdPair *subjoinArray = subjoinResults[subjoin]->getRowIdPairs();
+                unsigned long long subjoinItems = subjoinResults[subjoin]->getNumOfRowIdPairs();
+
+                for(unsigned long long j = 0; j < subjoinItems; j++)
+                    resultArray[resultPos++] = subjoinArray[j];
+
+                freeJoinResult(subjoinResults[subjoin]);
+            }
+
+            /* We free the sub-join, its sub-relations
+             * and the copies of its cached buckets
+             */
+            delete subjoins[subjoin];
+            delete subrelsR[subjoin];
+            delete subrelsS[subjoin];
+            delete[] bucketCopiesR[subjoin];
+            delete[] bucketCopiesS[subjoin];
+        }
+
+        /* Finally we append the output buffer of the heavy hitters */
+
+        for(pair = 0; pair < heavyPairsNum; pair++)
+            resultArray[resultPos++] = heavyPairs[pair];
+
+        delete[] heavyPairs;
+
+        delete[] subjoins;
+        delete[] subjoinResults;
+        delete[] subrelsR;
+        delete[] subrelsS;
+        delete[] bucketCopiesR;
+        delete[] bucketCopiesS;
+
         /* We initialize the final item we will return.
          * It holds the array of row ID pairs and its size.
          */
-        RowIdRelation *result = new RowIdRelation(resultArray, numOfItemsInList);
+        RowIdRelation *result = new RowIdRelation(resultArray, numOfItemsInResult);
 
         /* We free the allocated memory for the auxiliary list */
         delete resultAsList;
 
-        /* We free the allocated memory for the auxiliary arrays */
-        delete[] elementsCounter;
-        delete[] R_histogram;
-        delete[] S_histogram;
-        delete[] prefixSum_R;
-        delete[] prefixSum_S;
+        /* We free the auxiliary arrays (the histogram of a cached
+         * relation belongs to the cache, so it is not in the arena).
+         *
+         * Every job that reads them (the sub-joins, the cross products
+         * and the bucket batches) must have finished by now. This is
+         * only safe because we waited for the scheduler above, so there
+         * must be no return and no asynchronous job between the
+         * submission of the jobs and that wait.
+         */
+        arena->rewind(arenaMark);
 
         /* We return the final result */
         return result;
@@ -1859,8 +3105,10 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
          */
         probeRelations(0, R_numOfTuples, 0, S_numOfTuples, resultAsList);
 
+        recordHashTable(R_numOfTuples, S_numOfTuples);
+
         /* This is the number of row ID pairs of the result */
-        unsigned int numOfItemsInList = resultAsList->getCounter();
+        unsigned long long numOfItemsInList = resultAsList->getCounter();
 
         /* We create a new array of row ID pairs with size equal to the
          * size of the list (which is the num of row ID pairs of the result)
@@ -1872,13 +3120,15 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
          */
         Listnode *current = resultAsList->getHead();
 
-        /* Helper variable for counting */
-        unsigned int i;
+        /* Helper variable for counting (the result
+         * may have more pairs than a row ID can count)
+         */
+        unsigned long long pair;
 
         /* As long as we have not transfered all the items from
          * the list to the array, we do the following actions
          */
-        for(i = 0; i < numOfItemsInList; i++)
+        for(pair = 0; pair < numOfItemsInList; pair++)
         {
             /* We retrieve the current row ID pair for transer */
             RowIdPair *current_pair = (RowIdPair *) current->getItem();
@@ -1886,8 +3136,8 @@ RowIdRelation *PartitionedHashJoin::executeJoin()
             /* We transfer the information of the pair we retrieved
              * to the pair of the current position in the array
              */
-            resultArray[i].setLeftRowId(current_pair->getLeftRowId());
-            resultArray[i].setRightRowId(current_pair->getRightRowId());
+            resultArray[pair].setLeftRowId(current_pair->getLeftRowId());
+            resultArray[pair].setRightRowId(current_pair->getRightRowId());
 
             /* We delete the pair of the list */
             delete current_pair;
@@ -5,34 +5,107 @@
 #include "RowIdRelation.h"
 #include "PartitionedHashJoinInput.h"
 #include "JobScheduler.h"
+#include "CachedBuildSide.h"
+#include "HashFunctionType.h"
+#include "JoinAlgorithmType.h"
+#include "CacheHierarchy.h"
+#include "ScratchArena.h"
+
+/* The amount of keys of each relation that are sampled to find its heavy hitters */
+#define HEAVY_HITTER_SAMPLE_SIZE 4096
+
+/* The maximum amount of heavy hitters of a join */
+#define MAX_HEAVY_HITTERS 32
+
+/* The amount of bits every deeper partition adds to the bits for hashing
+ * of the previous one when the partitions are not tuned automatically
+ */
+#define DEFAULT_BITS_PER_PASS 2
+
+/* The least amount of buckets per thread a tuned partition creates,
+ * so the threads still have buckets to join when some are larger
+ */
+#define PARTITION_BUCKETS_PER_THREAD 4
+
+/* The amount of keys of each relation that are sampled to choose the hash function */
+#define HASH_FUNCTION_SAMPLE_SIZE 4096
+
+/* A hash function is chosen over a more expensive one if the sum of the squared
+ * sizes of its buckets is at most this many times the smallest such sum
+ */
+#define HASH_FUNCTION_TOLERANCE 1.1
+
+/* The amount of batches of buckets per thread the bucket joins are split
+ * in. The threads take the batches one at a time, the largest first.
+ */
+#define JOIN_BATCHES_PER_THREAD 8
+
+/* What a join operation did while it was executed */
+struct JoinStatistics {
+
+    /* The amount of levels the relations were partitioned in (0 if the
+     * relations fit in the cache and were joined without partitioning)
+     */
+    unsigned int partitionDepth;
+
+    /* The amount of hash tables the buckets were probed with */
+    unsigned int hashTablesNum;
+
+    /* The amount of tuples of the largest and of all the hash tables */
+    unsigned int largestHashTableSize;
+    unsigned long long hashTableTuplesNum;
+
+    /* The amount of keys that were joined as a cross product because
+     * they were too frequent to be split by the partition
+     */
+    unsigned int heavyHittersNum;
+
+    /* The algorithm that executed the join */
+    JoinAlgorithmType algorithm;
+
+    /* A simple constructor for the structure */
+    JoinStatistics() : partitionDepth(0), hashTablesNum(0),
+        largestHashTableSize(0), hashTableTuplesNum(0), heavyHittersNum(0),
+        algorithm(HashJoinAlgorithm) {}
+
+};
 
 class PartitionedHashJoin {
 
 public:
 
-/* Constructor (used by the user) */
+/* Constructor (used by the user)
+ *
+ * If 'cachedR' (or 'cachedS') is given, 'relR' (or 'relS') must consist
+ * of its tuples, which are already partitioned. Then the histogram and
+ * the reordering of that relation are skipped and the hash tables of its
+ * buckets are taken from (or kept in) the cached build side.
+ */
     PartitionedHashJoin(
         Relation *relR,
         Relation *relS,
         PartitionedHashJoinInput *inputStructure,
-        JobScheduler *jobScheduler = NULL);
+        JobScheduler *jobScheduler = NULL,
+        CachedBuildSide *cachedR = NULL,
+        CachedBuildSide *cachedS = NULL);
 
 /* Constructor for subrelations (used by this class only) */
     PartitionedHashJoin(
         Relation *relR,
         Relation *relS,
         unsigned int bitsNumForHashing,
+        unsigned int bitsPerPass,
         bool showInitialRelations,
         bool showAuxiliaryArrays,
         bool showHashTable,
         bool showSubrelations,
         bool showResult,
-        unsigned int hopscotchBuckets,
         unsigned int hopscotchRange,
         bool resizableByLoadFactor,
         double loadFactor,
         double maxAllowedSizeModifier,
         unsigned int maxPartitionDepth,
+        HashFunctionType hashFunction,
         JobScheduler *jobScheduler = NULL);
 
 /* Destructor */
@@ -47,6 +120,12 @@ public:
 /* Getter - Returns the number of included bits for hashing */
     unsigned int getBitsNumForHashing() const;
 
+/* Getter - Returns what the last call of 'executeJoin' did */
+    JoinStatistics getStatistics() const;
+
+/* Getter - Returns the hash function that partitions the relations */
+    HashFunctionType getHashFunction() const;
+
 /* Executes the Partitioned Hash Join Algorithm */
     RowIdRelation *executeJoin();
 
@@ -56,6 +135,53 @@ public:
 /* Frees the result that was returned by 'executeJoin' */
     static void freeJoinResult(RowIdRelation *resultOfExecuteJoin);
 
+/* Hashes a given integer into the value of
+ * its rightmost 'bitsNumForHashing' bits
+ */
+    static unsigned int bitReductionHash(
+        unsigned long long integer,
+        unsigned int bitsNumForHashing
+    );
+
+/* Hashes a given integer into one of the (2 ^ 'bitsNumForHashing')
+ * buckets with the given hash function
+ */
+    static unsigned int partitionHash(
+        unsigned long long integer,
+        unsigned int bitsNumForHashing,
+        HashFunctionType hashFunction
+    );
+
+/* Returns the cheapest hash function that spreads the given sample of keys
+ * in (2 ^ 'bitsNumForHashing') buckets about as evenly as the best one
+ */
+    static HashFunctionType chooseHashFunction(
+        const unsigned long long *keys,
+        unsigned int keysNum,
+        unsigned int bitsNumForHashing
+    );
+
+/* Returns the function that hashes a tuple into its position in the
+ * hash table of its bucket for the given family of hash functions
+ */
+    static unsigned int (*getTupleHash(HashFunctionType hashFunction))(void *);
+
+/* Chooses how many times two relations with the given amounts of tuples
+ * are partitioned and how many bits every partition uses for hashing, so
+ * the buckets fit the usable part of the level-2 cache, there are enough
+ * buckets for the given amount of threads and the buckets every pass
+ * writes to stay within the reach of the TLB
+ */
+    static void tunePartitioning(
+        unsigned long long R_numOfTuples,
+        unsigned long long S_numOfTuples,
+        unsigned int threadsNum,
+        double maxAllowedSizeModifier,
+        unsigned int maxPartitionDepth,
+        unsigned int *bitsPerPass,
+        unsigned int *passesNum
+    );
+
 private:
 
 /* The first relation that takes part in the join operation */
@@ -67,6 +193,14 @@ private:
 /* The amount of included bits to hash the input integer elements */
     unsigned int bitsNumForHashing;
 
+/* The amount of bits every deeper partition adds to 'bitsNumForHashing' */
+    unsigned int bitsPerPass;
+
+/* Determines whether the bits of the partitions are chosen from the sizes
+ * of the relations and the caches of the system when the join is executed
+ */
+    bool autoTunedPartitioning;
+
 /* Indicates whether at least one of the relations 'relR'
  * and 'relS' is a subset of a larger relational array
  */
@@ -100,9 +234,6 @@ private:
  */
     bool showResult;
 
-/* The amount of initial buckets the hash table will have */
-    unsigned int hopscotchBuckets;
-
 /* The initial size of each neighborhood in the hash table */
     unsigned int hopscotchRange;
 
@@ -126,11 +257,35 @@ private:
 /* Determines the maximum depth of partitions */
     unsigned int maxPartitionDepth;
 
+/* The hash function that partitions the relations and places the tuples
+ * of every bucket in its hash table ('AutoHash' until the join chooses it)
+ */
+    HashFunctionType hashFunction;
+
+/* The minimum share of the sampled keys of a relation that a key must
+ * have to be joined as a heavy hitter (zero means it is never done)
+ */
+    double heavyHitterShare;
+
 /* A job scheduler that we will use for parallel
  * execution of the tasks of a join predicate
  */
     JobScheduler *jobScheduler;
 
+/* The already partitioned forms of 'relR' and 'relS'
+ * if they are kept in the build side cache, else 'NULL'
+ */
+    CachedBuildSide *cachedR;
+    CachedBuildSide *cachedS;
+
+/* What the last call of 'executeJoin' did */
+    JoinStatistics statistics;
+
+/* Counts the hash table of a pair of buckets with the given sizes
+ * in the statistics (it is built from the smaller bucket)
+ */
+    void recordHashTable(unsigned int R_bucketSize, unsigned int S_bucketSize);
+
 /* Determines wheter a bucket of the relation 'rerR' or 'relS'
  * needs to be further partitioned to additional buckets
  */
@@ -140,6 +295,55 @@ private:
         unsigned int item_size,
         unsigned int lvl_2_cache_size) const;
 
+/* Finds the keys that have at least the share 'heavyHitterShare' of the
+ * sampled keys of 'relR' or 'relS' and places them sorted in 'heavyKeys'
+ * (which has room for 'MAX_HEAVY_HITTERS' keys). A key is only kept if its
+ * estimated tuples would not fit in a bucket that needs no further
+ * partition for the given cache size. Returns the amount of the keys.
+ */
+    unsigned int detectHeavyHitters(
+        Tuple *R_table,
+        unsigned int R_numOfTuples,
+        Tuple *S_table,
+        unsigned int S_numOfTuples,
+        long lvl_2_cache_size,
+        unsigned long long *heavyKeys) const;
+
+/* Moves the tuples of the given heavy hitters to the end of the relation,
+ * grouped by key in the order of the keys, and points '*heavyTuples' to the
+ * first of them. The amount of tuples and the start of every key there are
+ * placed in 'heavyHistogram' and 'heavyPrefixSum'. The rest of the tuples
+ * keep their order in the start of the relation and their amount is
+ * returned. The relation still holds every one of its tuples exactly once.
+ */
+    static unsigned int separateHeavyHitters(
+        Tuple *relation,
+        unsigned int relationSize,
+        const unsigned long long *heavyKeys,
+        unsigned int heavyKeysNum,
+        Tuple **heavyTuples,
+        unsigned int *heavyHistogram,
+        unsigned int *heavyPrefixSum
+    );
+
+/* Pairs every outer tuple with every inner tuple (all of them have the same
+ * key) and writes the row ID pairs to 'result', one outer tuple after the
+ * other (it is used as the routine of a job)
+ */
+    static void emitCrossProduct(
+        Tuple *outerTuples,
+        unsigned int outerTuplesNum,
+        Tuple *innerTuples,
+        unsigned int innerTuplesNum,
+        bool outerIsR,
+        RowIdPair *result
+    );
+
+/* The routine of a cross product job, which calls 'emitCrossProduct' with the
+ * fields of the given input (a 'CrossProductJobInput')
+ */
+    static void crossProductJob(void *input);
+
 /* Displays in the screen the contents of the initial relations */
     void displayInitialRelations(const char *message) const;
 
@@ -148,19 +352,16 @@ private:
         unsigned int *R_hist, unsigned int *S_hist,
         unsigned int *R_psum, unsigned int *S_psum) const;
 
-/* Hashes a given integer into the value of
- * its rightmost 'bitsNumForHashing' bits
- */
-    static unsigned int bitReductionHash(
-        unsigned long long integer,
-        unsigned int bitsNumForHashing
-    );
-
 /* Given the address of a tuple, it hashes its
  * contents to a non-negative integer value
  */
     static unsigned int hashTuple(void *item);
 
+/* The same as above for the other families of hash functions */
+    static unsigned int hashTupleFibonacci(void *item);
+    static unsigned int hashTupleMurmur(void *item);
+    static unsigned int hashTupleCrc32(void *item);
+
 /* Updates the given histogram with the results of
  * hashing the input relation within the given boundaries
  */
@@ -169,9 +370,15 @@ private:
         Tuple *relation,
         unsigned int relationStartIndex,
         unsigned int relationEndIndex,
-        unsigned int selectedBitsNumForHashing
+        unsigned int selectedBitsNumForHashing,
+        HashFunctionType hashFunction
     );
 
+/* The routine of a histogram job, which calls 'createHistogram' with the
+ * fields of the given input (a 'HistogramJobInput')
+ */
+    static void histogramJob(void *input);
+
 /* Sums the contents of all the partial histograms into one histogram */
     static void sumPartialHistograms(
         unsigned int **partialHistograms,
@@ -188,7 +395,8 @@ private:
         unsigned int histogramSize
     );
 
-/* Reorders the tuples of the given relation.
+/* Reorders the tuples of the given relation. The tuples are copy-constructed
+ * in 'reorderedRelation', so it may be raw memory of the scratch arena.
  *
  * Used by 'parallelMethodForTupleReordering'.
  */
@@ -200,9 +408,15 @@ private:
         unsigned int relationStartIndex,
         unsigned int relationEndIndex,
         unsigned int selectedBitsNumForHashing,
+        HashFunctionType hashFunction,
         pthread_mutex_t *util
     );
 
+/* The routine of a partition job, which calls 'reorderTuples' with the
+ * fields of the given input (a 'PartitionJobInput')
+ */
+    static void partitionJob(void *input);
+
 /* A parallel method to reorder the contents of a relation */
     void parallelMethodForTupleReordering(
         Tuple *relation,
@@ -212,6 +426,46 @@ private:
         unsigned int *elementsCounterOfRel
     );
 
+/* Returns the hash table of a pair of buckets. It is taken from a cached
+ * build side if one of the buckets has its hash table cached. Else it is
+ * built from the smaller bucket and it is kept in the cached build side of
+ * that bucket if there is one. 'builtFromR' tells which bucket the table
+ * contains and 'isCached' whether the table belongs to a cached build side
+ * (so it must not be freed by the caller).
+ */
+    static HashTable *getBucketHashTable(
+        Tuple *R_table,
+        unsigned int R_start_index,
+        unsigned int R_end_index,
+        Tuple *S_table,
+        unsigned int S_start_index,
+        unsigned int S_end_index,
+        CachedBuildSide *R_cache,
+        CachedBuildSide *S_cache,
+        unsigned int bucket,
+        unsigned int hopscotchRange,
+        bool resizableByLoadFactor,
+        double loadFactor,
+        HashFunctionType hashFunction,
+        bool *builtFromR,
+        bool *isCached
+    );
+
+/* Searches the given tuples of one bucket in the hash table of the other
+ * bucket and places the row ID pairs of the matches in 'result'. The row
+ * ID of 'R' is always the left one of a pair ('probeIsR' tells whether the
+ * searched tuples belong to 'R' or to 'S').
+ */
+    static void probeBucket(
+        HashTable *hash_table,
+        Tuple *probeTable,
+        unsigned int start_index,
+        unsigned int end_index,
+        bool probeIsR,
+        HashFunctionType hashFunction,
+        List *result
+    );
+
 /* Joins the two buckets indicated by the 'rank' parameter */
     static void joinBuckets(
         unsigned int rank,
@@ -222,16 +476,63 @@ private:
         unsigned int *leftPrefixSum,
         unsigned int *rightPrefixSum,
         unsigned int bucketsNum,
-        unsigned int hopscotchBuckets,
         unsigned int hopscotchRange,
         bool resizableByLoadFactor,
         double loadFactor,
         pthread_mutex_t *util,
         List *result,
-        bool resultHasAlreadyBeenDeposited
+        CachedBuildSide *leftCache,
+        CachedBuildSide *rightCache,
+        HashFunctionType hashFunction
     );
 
-/* A parallel method to join the buckets of two relations */
+/* Joins the pairs of buckets of the batches that the cursor 'nextBatch'
+ * points to, until no batches are left (it is used as the routine of a
+ * job, so every thread keeps taking batches while it has nothing to do)
+ */
+    static void joinBucketBatches(
+        unsigned int *bucketOrder,
+        unsigned int *batchBounds,
+        unsigned int batchesNum,
+        unsigned int *nextBatch,
+        Tuple *leftRel,
+        Tuple *rightRel,
+        unsigned int leftRelSize,
+        unsigned int rightRelSize,
+        unsigned int *leftPrefixSum,
+        unsigned int *rightPrefixSum,
+        unsigned int bucketsNum,
+        unsigned int hopscotchRange,
+        bool resizableByLoadFactor,
+        double loadFactor,
+        pthread_mutex_t *util,
+        List *result,
+        CachedBuildSide *leftCache,
+        CachedBuildSide *rightCache,
+        HashFunctionType hashFunction
+    );
+
+/* The routine of a join job, which calls 'joinBucketBatches' with the
+ * fields of the given input (a 'JoinJobInput')
+ */
+    static void joinJob(void *input);
+
+/* Executes the given sub-join and deposits its result in the
+ * given output buffer (it is used as the routine of a job)
+ */
+    static void executeSubjoin(PartitionedHashJoin *subjoin,
+        RowIdRelation **result);
+
+/* The routine of a subjoin job, which calls 'executeSubjoin' with the
+ * fields of the given input (a 'SubjoinJobInput')
+ */
+    static void subjoinJob(void *input);
+
+/* A parallel method to join the buckets of two relations. The pairs of
+ * buckets are sorted by their size, the largest first, and grouped in
+ * batches that the threads take dynamically, so that the threads finish
+ * together even if the sizes of the buckets vary a lot.
+ */
     void parallelMethodForBucketJoining(
         Tuple *leftRel,
         Tuple *rightRel,
@@ -248,6 +549,9 @@ private:
  * relations 'S' and 'R'. The four indexes determine the start
  * and the end of the buckets. The end index is not included
  *
+ * If 'R_cache' or 'S_cache' is given, the hash table of the
+ * given bucket is taken from (or kept in) that build side.
+ *
  * The method places the row ID pairs that exist in the buckets
  * and satisfy the join operation in the provided list 'result'
  */
@@ -256,7 +560,10 @@ private:
         unsigned int R_end_index,
         unsigned int S_start_index,
         unsigned int S_end_index,
-        List *result) const;
+        List *result,
+        CachedBuildSide *R_cache = NULL,
+        CachedBuildSide *S_cache = NULL,
+        unsigned int bucket = 0) const;
 
 };
 
@@ -0,0 +1,186 @@
+#include "ScratchArena.h"
+
+/***************
+ * Constructor *
+ ***************/
+
+ScratchArena::ScratchArena()
+{
+    firstChunk = NULL;
+    currentChunk = NULL;
+    offset = 0;
+    capacity = 0;
+    chunkAllocationsNum = 0;
+}
+
+/**************
+ * Destructor *
+ **************/
+
+ScratchArena::~ScratchArena()
+{
+    freeChunks(firstChunk);
+}
+
+/***********************************************************
+ * Frees the given chunk and all the chunks that follow it *
+ ***********************************************************/
+
+void ScratchArena::freeChunks(ScratchChunk *chunk)
+{
+    while(chunk != NULL)
+    {
+        ScratchChunk *next = chunk->next;
+
+        capacity -= chunk->size;
+        delete[] chunk->memory;
+        delete chunk;
+
+        chunk = next;
+    }
+}
+
+/***********************************************************************
+ * Returns the given amount of bytes of the arena. They are freed when *
+ * the arena is rewound to a mark that was taken before the allocation *
+ ***********************************************************************/
+
+void *ScratchArena::allocate(size_t bytes)
+{
+    /* Every allocation keeps the next one aligned */
+    bytes = (bytes + SCRATCH_ALIGNMENT - 1) & ~((size_t) SCRATCH_ALIGNMENT - 1);
+
+    if(bytes == 0)
+        bytes = SCRATCH_ALIGNMENT;
+
+    /* Case the bytes fit in the current chunk */
+    if(currentChunk != NULL && offset + bytes <= currentChunk->size)
+    {
+        void *memory = currentChunk->memory + offset;
+        offset += bytes;
+
+        return memory;
+    }
+
+    /* The chunks after the current one are not used, so the bytes are
+     * taken from the start of the next chunk if they fit there
+     */
+    ScratchChunk *next = (currentChunk != NULL) ? currentChunk->next : firstChunk;
+
+    if(next != NULL && bytes <= next->size)
+    {
+        currentChunk = next;
+        offset = bytes;
+
+        return next->memory;
+    }
+
+    /* Else the unused chunks are too small and they are replaced by a
+     * chunk that at least doubles the arena, so it rarely grows again
+     */
+    freeChunks(next);
+
+    size_t size = (bytes > SCRATCH_CHUNK_SIZE) ? bytes : SCRATCH_CHUNK_SIZE;
+
+    if(size < capacity)
+        size = capacity;
+
+    ScratchChunk *chunk = new ScratchChunk;
+    chunk->memory = new char[size];
+    chunk->size = size;
+    chunk->next = NULL;
+
+    if(currentChunk != NULL)
+        currentChunk->next = chunk;
+
+    else
+        firstChunk = chunk;
+
+    currentChunk = chunk;
+    offset = bytes;
+    capacity += size;
+    chunkAllocationsNum++;
+
+    return chunk->memory;
+}
+
+/*********************************************
+ * Returns the current position of the arena *
+ *********************************************/
+
+ScratchMark ScratchArena::getMark() const
+{
+    ScratchMark mark;
+
+    mark.chunk = currentChunk;
+    mark.offset = offset;
+
+    return mark;
+}
+
+/************************************************************
+ * Frees everything that was allocated after the given mark *
+ ************************************************************/
+
+void ScratchArena::rewind(ScratchMark mark)
+{
+    /* Rewinding to the start of the arena is a reset */
+    if(mark.chunk == NULL)
+    {
+        reset();
+        return;
+    }
+
+    currentChunk = mark.chunk;
+    offset = mark.offset;
+}
+
+/****************************************************
+ * Frees everything that was allocated in the arena *
+ ****************************************************/
+
+void ScratchArena::reset()
+{
+    currentChunk = NULL;
+    offset = 0;
+
+    /* An arena that grew too much for a single large
+     * join does not keep its memory for the next query
+     */
+    if(capacity > MAX_RETAINED_SCRATCH_BYTES)
+    {
+        freeChunks(firstChunk);
+        firstChunk = NULL;
+    }
+}
+
+/**********************************************************
+ * Getter - Returns the amount of bytes of all the chunks *
+ **********************************************************/
+
+size_t ScratchArena::getCapacity() const
+{
+    return capacity;
+}
+
+/************************************************************************
+ * Getter - Returns how many times the arena asked the global allocator *
+ *                             for a chunk                              *
+ ************************************************************************/
+
+unsigned long long ScratchArena::getChunkAllocationsNum() const
+{
+    return chunkAllocationsNum;
+}
+
+/***********************************************************************
+ * Returns the arena of the calling thread, which is created the first *
+ *     time the thread asks for it and freed when the thread exits     *
+ ***********************************************************************/
+
+ScratchArena *ScratchArena::getThreadArena()
+{
+    static thread_local ScratchArena threadArena;
+
+    return &threadArena;
+}
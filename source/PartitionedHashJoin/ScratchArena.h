@@ -0,0 +1,110 @@
+#ifndef _SCRATCH_ARENA_H_
+#define _SCRATCH_ARENA_H_
+
+#include <cstddef>
+
+/* The least amount of bytes of a chunk of a scratch arena */
+#define SCRATCH_CHUNK_SIZE 1048576
+
+/* A reset keeps the chunks of an arena for the next query only if
+ * they have at most this many bytes in total (else they are freed)
+ */
+#define MAX_RETAINED_SCRATCH_BYTES 67108864ULL
+
+/* Every allocation of a scratch arena starts at a multiple of this
+ * many bytes, so any array of the join engine can be placed in it
+ */
+#define SCRATCH_ALIGNMENT 16
+
+/* A block of memory of a scratch arena. The chunks of an
+ * arena form a list in the order they are used.
+ */
+struct ScratchChunk {
+
+    char *memory;
+    size_t size;
+    ScratchChunk *next;
+
+};
+
+/* A position of a scratch arena, which it can be rewound to. A mark
+ * without a chunk is the start of the arena.
+ */
+struct ScratchMark {
+
+    ScratchChunk *chunk;
+    size_t offset;
+
+};
+
+/* A scratch arena, where the join engine places the arrays it only needs
+ * while a join is executed (histograms, prefix sums, reordered tuples).
+ *
+ * An allocation just moves the end of the used memory forward. A join
+ * takes a mark of the arena when it starts and rewinds the arena to that
+ * mark when it finishes, which frees everything it allocated at once.
+ * The chunks stay in the arena, so the following joins of a query (and
+ * the sub-joins of a join) find their memory there and the arena only
+ * asks the global allocator for memory while it grows.
+ *
+ * Every thread has its own arena (see 'getThreadArena'), so no locks are
+ * needed. The memory of an arena may still be read and written by other
+ * threads, as long as that happens before the arena is rewound.
+ */
+class ScratchArena {
+
+private:
+
+/* The first chunk and the chunk allocations currently come from */
+    ScratchChunk *firstChunk;
+    ScratchChunk *currentChunk;
+
+/* The amount of used bytes of the current chunk */
+    size_t offset;
+
+/* The amount of bytes of all the chunks */
+    size_t capacity;
+
+/* How many times the arena asked the global allocator for a chunk */
+    unsigned long long chunkAllocationsNum;
+
+/* Frees the given chunk and all the chunks that follow it */
+    void freeChunks(ScratchChunk *chunk);
+
+public:
+
+/* Constructor & Destructor */
+    ScratchArena();
+    ~ScratchArena();
+
+/* Returns 'bytes' bytes of the arena. They are freed when the arena
+ * is rewound to a mark that was taken before the allocation.
+ */
+    void *allocate(size_t bytes);
+
+/* Returns the current position of the arena */
+    ScratchMark getMark() const;
+
+/* Frees everything that was allocated after the given mark (a mark
+ * of the start of the arena resets it)
+ */
+    void rewind(ScratchMark mark);
+
+/* Frees everything that was allocated in the arena. The chunks are
+ * kept, unless they exceed 'MAX_RETAINED_SCRATCH_BYTES', so the reset
+ * only moves the end of the used memory back to the start.
+ */
+    void reset();
+
+/* Getters */
+    size_t getCapacity() const;
+    unsigned long long getChunkAllocationsNum() const;
+
+/* Returns the arena of the calling thread, which is created the first
+ * time the thread asks for it and freed when the thread exits
+ */
+    static ScratchArena *getThreadArena();
+
+};
+
+#endif
@@ -1,6 +1,24 @@
 #include <iostream>
 #include "PartitionedHashJoinInput.h"
 
+/**************************************************************
+ * The names of the hash functions as they are written in the *
+ *       configuration file (in the order of the enum)        *
+ **************************************************************/
+
+static const char *hashFunctionNames[] = {
+    "bits", "fibonacci", "murmur", "crc32", "auto"
+};
+
+/***************************************************************
+ * The names of the join algorithms as they are written in the *
+ *        configuration file (in the order of the enum)        *
+ ***************************************************************/
+
+static const char *joinAlgorithmNames[] = {
+    "hash", "sortmerge", "array", "auto"
+};
+
 /***************
  * Constructor *
  ***************/
@@ -22,13 +40,43 @@ PartitionedHashJoinInput::PartitionedHashJoinInput(const char *config_file)
         &maxAllowedSizeModifier,
         &maxPartitionDepth
     );
+
+    /* We create the cache of the build sides if it is given some memory */
+    unsigned long long buildSideCacheSize = 0;
+    FileReader::readBuildSideCacheSize(config_file, &buildSideCacheSize);
+
+    buildSideCache = (buildSideCacheSize > 0)
+        ? new BuildSideCache(buildSideCacheSize * 1024 * 1024) : NULL;
+
+    /* We read when the keys of a join input are passed to the other input */
+    sidewaysFilterRatio = 0;
+    FileReader::readSidewaysFilterRatio(config_file, &sidewaysFilterRatio);
+
+    /* We read how frequent a key must be to be joined as a heavy hitter */
+    heavyHitterShare = 0;
+    FileReader::readHeavyHitterShare(config_file, &heavyHitterShare);
+
+    /* We read the hash function that partitions the relations */
+    hashFunction = BitsHash;
+    FileReader::readHashFunction(config_file, &hashFunction);
+
+    /* We read whether the partitions are tuned automatically */
+    autoTunedPartitioning = false;
+    FileReader::readPartitionTuning(config_file, &autoTunedPartitioning);
+
+    /* We read the algorithm that executes the joins */
+    joinAlgorithm = HashJoinAlgorithm;
+    FileReader::readJoinAlgorithm(config_file, &joinAlgorithm);
 }
 
 /**************
  * Destructor *
  **************/
 
-PartitionedHashJoinInput::~PartitionedHashJoinInput() {}
+PartitionedHashJoinInput::~PartitionedHashJoinInput()
+{
+    delete buildSideCache;
+}
 
 /***********************************************
  * Prints the value of each field of the class *
@@ -50,5 +98,12 @@ void PartitionedHashJoinInput::print() const
         << "\nIf the above is true, the load factor is: " << loadFactor
         << "\nPercentage of the usable cache for probing: " << maxAllowedSizeModifier
         << "\nMaximum partition depth of relations: " << maxPartitionDepth
+        << "\nMemory of the build side cache in bytes: "
+        << ((buildSideCache != NULL) ? buildSideCache->getBudgetBytes() : 0)
+        << "\nMinimum ratio of the inputs for sideways filters: " << sidewaysFilterRatio
+        << "\nMinimum share of the rows of a heavy hitter: " << heavyHitterShare
+        << "\nHash function: " << hashFunctionNames[hashFunction]
+        << "\nPartitions are tuned automatically: " << autoTunedPartitioning
+        << "\nJoin algorithm: " << joinAlgorithmNames[joinAlgorithm]
         << "\n" << std::endl;
 }
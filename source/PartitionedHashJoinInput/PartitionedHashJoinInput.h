@@ -2,6 +2,7 @@
 #define _PARTITIONED_HASH_JOIN_INPUT_H_
 
 #include "FileReader.h"
+#include "BuildSideCache.h"
 
 /* A structure that "wraps" all the input parameters
  * for the Partitioned Hash join algorithm
@@ -26,6 +27,39 @@ struct PartitionedHashJoinInput {
     double maxAllowedSizeModifier;
     unsigned int maxPartitionDepth;
 
+/* The cache of the partitioned and hashed columns of the base
+ * tables or 'NULL' if the configuration gives it no memory
+ */
+    BuildSideCache *buildSideCache;
+
+/* The minimum ratio between the rows of the larger and the smaller input
+ * of a hash join for the keys of the smaller input to be passed to the
+ * larger one as a Bloom filter (zero means the keys are never passed)
+ */
+    unsigned int sidewaysFilterRatio;
+
+/* The minimum share of the rows of a join input that a single key must
+ * have for its rows to be joined as a cross product instead of being
+ * partitioned (zero means every key is partitioned)
+ */
+    double heavyHitterShare;
+
+/* The hash function that partitions the relations of the joins ('AutoHash'
+ * means it is chosen for every join from a sample of its keys)
+ */
+    HashFunctionType hashFunction;
+
+/* Determines whether the bits of the partitions of every join are chosen
+ * from the sizes of its relations and the caches of the system instead of
+ * the bits of the configuration file
+ */
+    bool autoTunedPartitioning;
+
+/* The algorithm that executes the joins ('AutoJoinAlgorithm' means the
+ * sort-merge join is used for the joins of already sorted relations)
+ */
+    JoinAlgorithmType joinAlgorithm;
+
 /* Constructor & Destructor */
     PartitionedHashJoinInput(const char *config_file);
     ~PartitionedHashJoinInput();
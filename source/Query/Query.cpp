@@ -255,6 +255,16 @@ unsigned int Query::getRelationInPos(unsigned int pos) const
 	return *((unsigned int *) relations->getItemInPos(pos + 1));
 }
 
+/**********************************************
+ * Appends a predicate that is implied by the *
+ *          predicates of the query           *
+ **********************************************/
+
+void Query::insertPredicate(PredicatesParser *predicate)
+{
+	predicates->insertLast(predicate);
+}
+
 /**************************************************************
  * Prints a query (its relations, predicates and projections) *
  **************************************************************/
@@ -41,6 +41,11 @@ public:
 	/* Returns the relation in the given position */
 	unsigned int getRelationInPos(unsigned int pos) const;
 
+	/* Appends a predicate that is implied by the predicates of the query.
+	 * The query becomes responsible for freeing the predicate.
+	 */
+	void insertPredicate(PredicatesParser *predicate);
+
 	/* Prints a query (its relations, predicates and projections) */
 	void print() const;
 
@@ -0,0 +1,23 @@
+#ifndef _EXPLAIN_MODE_H_
+#define _EXPLAIN_MODE_H_
+
+/* An enumeration with all the ways the plans of the queries may be explained */
+
+enum ExplainMode {
+
+    /* The plans of the queries are not printed */
+    NoExplain,
+
+    /* The filters and the joins of every query are printed in the
+     * order they were executed, along with their estimated rows
+     */
+    PlanExplain,
+
+    /* As above, but every step is also printed with its actual rows,
+     * its time and what its join operation did while it was executed
+     */
+    AnalyzeExplain
+
+};
+
+#endif
@@ -0,0 +1,316 @@
+#include <cstdio>
+#include <cstring>
+#include "QueryExplanation.h"
+
+/*************************
+ * Constructor of a step *
+ *************************/
+
+ExplainedStep::ExplainedStep(double estimatedRows)
+{
+    description[0] = '\0';
+    this->estimatedRows = estimatedRows;
+
+    /* Initially the step has not been measured */
+    actualRows = 0;
+    milliseconds = 0;
+    threadUtilization = 0;
+    precedesReoptimization = false;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+QueryExplanation::QueryExplanation(Query *query, List *tables,
+    ExplainMode mode, JobScheduler *jobScheduler)
+{
+    this->query = query;
+    this->mode = mode;
+    this->jobScheduler = jobScheduler;
+
+    /* Initially no step has been executed */
+    steps = new List();
+    currentStep = NULL;
+
+    /* Every alias is a group of its own with the rows of its table */
+    aliasesNum = query->getRelations()->getCounter();
+    groupOfAlias = new unsigned int[aliasesNum];
+    groupRows = new double[aliasesNum];
+
+    for(unsigned int alias = 0; alias < aliasesNum; alias++)
+    {
+        Table *table = (Table *) tables->getItemInPos(
+            query->getRelationInPos(alias) + 1);
+
+        groupOfAlias[alias] = alias;
+        groupRows[alias] = (double) table->getNumOfTuples();
+    }
+
+    stepStartBusyTime = 0;
+    clock_gettime(CLOCK_MONOTONIC, &queryStart);
+}
+
+/**************
+ * Destructor *
+ **************/
+
+QueryExplanation::~QueryExplanation()
+{
+    steps->traverseFromHead(deleteStep);
+    delete steps;
+
+    delete[] groupOfAlias;
+    delete[] groupRows;
+}
+
+/***********************************************************
+ * Returns the elapsed milliseconds since the given moment *
+ ***********************************************************/
+
+double QueryExplanation::getElapsedMilliseconds(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return ((double) (end.tv_sec - start->tv_sec)) * 1000.0
+        + ((double) (end.tv_nsec - start->tv_nsec)) / 1000000.0;
+}
+
+/****************************************************************
+ * Appends a new step with the given estimated rows and, in the *
+ *             'analyze' mode, starts measuring it              *
+ ****************************************************************/
+
+void QueryExplanation::beginStep(double estimatedRows)
+{
+    currentStep = new ExplainedStep(estimatedRows);
+    steps->insertLast(currentStep);
+
+    if(mode == AnalyzeExplain)
+    {
+        if(jobScheduler != NULL)
+            stepStartBusyTime = jobScheduler->getBusyTime();
+
+        clock_gettime(CLOCK_MONOTONIC, &stepStart);
+    }
+}
+
+/*******************************************************************
+ * Starts a step of the given filters of the same alias, which are *
+ *                        applied together                         *
+ *******************************************************************/
+
+void QueryExplanation::beginFilters(unsigned int filtersNum,
+    PredicatesParser **filters, const double *selectivities)
+{
+    /* Every filter keeps its estimated share of the rows of the alias */
+    unsigned int group = groupOfAlias[filters[0]->getLeftArray()];
+
+    for(unsigned int k = 0; k < filtersNum; k++)
+        groupRows[group] *= selectivities[k];
+
+    beginStep(groupRows[group]);
+
+    /* The filters are printed one after the other */
+    unsigned int length = 0;
+
+    for(unsigned int k = 0; k < filtersNum && length < MAX_STEP_DESCRIPTION_LENGTH; k++)
+    {
+        length += snprintf(currentStep->description + length,
+            MAX_STEP_DESCRIPTION_LENGTH - length, "%s%u.%u%c%u",
+            (k == 0) ? "" : " & ", filters[k]->getLeftArray(),
+            filters[k]->getLeftArrayColumn(), filters[k]->getFilterOperator(),
+            filters[k]->getFilterValue());
+    }
+}
+
+/************************************************************
+ * Starts a step of the given join predicate with the given *
+ *                  estimated selectivity                   *
+ ************************************************************/
+
+void QueryExplanation::beginJoin(PredicatesParser *joinPred,
+    double selectivity, bool isRepeated)
+{
+    unsigned int leftGroup = groupOfAlias[joinPred->getLeftArray()];
+    unsigned int rightGroup = groupOfAlias[joinPred->getRightArray()];
+
+    /* If the same predicate has already been executed, the join
+     * will not remove any rows of the intermediate result
+     */
+    if(!isRepeated)
+    {
+        /* If both aliases already take part in the same intermediate
+         * result, the join only keeps the rows that satisfy it
+         */
+        if(leftGroup == rightGroup)
+            groupRows[leftGroup] *= selectivity;
+
+        /* Else the join combines the rows of the two sides into one result */
+        else
+        {
+            groupRows[leftGroup] *= groupRows[rightGroup] * selectivity;
+
+            for(unsigned int alias = 0; alias < aliasesNum; alias++)
+            {
+                if(groupOfAlias[alias] == rightGroup)
+                    groupOfAlias[alias] = leftGroup;
+            }
+        }
+    }
+
+    beginStep(groupRows[leftGroup]);
+
+    snprintf(currentStep->description, MAX_STEP_DESCRIPTION_LENGTH,
+        "%u.%u=%u.%u", joinPred->getLeftArray(), joinPred->getLeftArrayColumn(),
+        joinPred->getRightArray(), joinPred->getRightArrayColumn());
+}
+
+/***********************************************************
+ * Finishes the current step, given the actual rows of its *
+ *   intermediate result and what its join operation did   *
+ ***********************************************************/
+
+void QueryExplanation::endStep(double actualRows, JoinStatistics joinStatistics)
+{
+    if(currentStep == NULL)
+        return;
+
+    currentStep->actualRows = actualRows;
+    currentStep->joinStatistics = joinStatistics;
+
+    if(mode == AnalyzeExplain)
+    {
+        currentStep->milliseconds = getElapsedMilliseconds(&stepStart);
+
+        /* The threads were utilized for the share of the time of the
+         * step that they spent executing jobs
+         */
+        if((jobScheduler != NULL) && (currentStep->milliseconds > 0))
+        {
+            currentStep->threadUtilization =
+                (jobScheduler->getBusyTime() - stepStartBusyTime) * 1000.0
+                / (currentStep->milliseconds * jobScheduler->getMaxThreads());
+        }
+    }
+
+    currentStep = NULL;
+}
+
+/*******************************************************************
+ * Records that the remaining joins were reordered after the last  *
+ * step. The estimated rows of every alias become its actual rows. *
+ *******************************************************************/
+
+void QueryExplanation::reoptimize(const double *actualRowsOfAliases)
+{
+    if(!steps->isEmpty())
+    {
+        ((ExplainedStep *) steps->getItemInPos(steps->getCounter()))
+            ->precedesReoptimization = true;
+    }
+
+    for(unsigned int alias = 0; alias < aliasesNum; alias++)
+        groupRows[groupOfAlias[alias]] = actualRowsOfAliases[alias];
+}
+
+/***************************************************************************
+ * Getter - Returns the steps of the query in the order they were executed *
+ ***************************************************************************/
+
+List *QueryExplanation::getSteps() const
+{
+    return steps;
+}
+
+/******************************************************
+ * Prints a step - used to traverse the list of steps *
+ ******************************************************/
+
+void QueryExplanation::printStep(void *item)
+{
+    ExplainedStep *step = (ExplainedStep *) item;
+
+    fprintf(stderr, "  %-32s %14.0f\n", step->description, step->estimatedRows);
+
+    if(step->precedesReoptimization)
+        fprintf(stderr, "  (the remaining joins were reordered)\n");
+}
+
+/***************************************************************
+ * Prints a measured step - used to traverse the list of steps *
+ ***************************************************************/
+
+void QueryExplanation::printMeasuredStep(void *item)
+{
+    ExplainedStep *step = (ExplainedStep *) item;
+
+    fprintf(stderr, "  %-32s %14.0f %14.0f %10.3f %5.0f%%",
+        step->description, step->estimatedRows, step->actualRows,
+        step->milliseconds, step->threadUtilization * 100);
+
+    /* Only the steps that were executed with the partitioned hash
+     * join have a partition depth and hash tables
+     */
+    if(step->joinStatistics.hashTablesNum > 0)
+    {
+        fprintf(stderr, " %9u %9u %11u", step->joinStatistics.partitionDepth,
+            step->joinStatistics.hashTablesNum,
+            step->joinStatistics.largestHashTableSize);
+    }
+
+    /* The steps that were executed with the other algorithms have neither */
+    else if(step->joinStatistics.algorithm == SortMergeJoinAlgorithm)
+        fprintf(stderr, " %31s", "sort-merge");
+
+    else if(step->joinStatistics.algorithm == ArrayJoinAlgorithm)
+        fprintf(stderr, " %31s", "array");
+
+    fprintf(stderr, "\n");
+
+    if(step->precedesReoptimization)
+        fprintf(stderr, "  (the remaining joins were reordered)\n");
+}
+
+/*******************************************************
+ * Deletes a step - used to traverse the list of steps *
+ *******************************************************/
+
+void QueryExplanation::deleteStep(void *item)
+{
+    delete (ExplainedStep *) item;
+}
+
+/*******************************************************
+ * Prints the steps of the query in the standard error *
+ *******************************************************/
+
+void QueryExplanation::print() const
+{
+    /* We print the relations of the query, so it can be recognized */
+    fprintf(stderr, "%s (relations", (mode == AnalyzeExplain)
+        ? "EXPLAIN ANALYZE" : "EXPLAIN");
+
+    for(unsigned int alias = 0; alias < aliasesNum; alias++)
+        fprintf(stderr, " %u", query->getRelationInPos(alias));
+
+    fprintf(stderr, ")\n");
+
+    /* We print the steps below the names of their columns */
+    if(mode == AnalyzeExplain)
+    {
+        fprintf(stderr, "  %-32s %14s %14s %10s %6s %9s %9s %11s\n", "step",
+            "estimated", "actual", "ms", "thr", "depth", "tables", "largest");
+
+        steps->printFromHead(printMeasuredStep);
+
+        fprintf(stderr, "  total: %.3f ms\n", getElapsedMilliseconds(&queryStart));
+    }
+
+    else
+    {
+        fprintf(stderr, "  %-32s %14s\n", "step", "estimated");
+        steps->printFromHead(printStep);
+    }
+}
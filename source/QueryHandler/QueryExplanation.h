@@ -0,0 +1,162 @@
+#ifndef _QUERY_EXPLANATION_H_
+#define _QUERY_EXPLANATION_H_
+
+#include <ctime>
+#include "List.h"
+#include "Table.h"
+#include "Query.h"
+#include "PartitionedHashJoin.h"
+#include "JobScheduler.h"
+#include "ExplainMode.h"
+
+/* The maximum length of the printed predicates of a step */
+#define MAX_STEP_DESCRIPTION_LENGTH 128
+
+/* A step of an executed query, which is either a join predicate or
+ * the filters of an alias that were applied together in a single scan
+ */
+class ExplainedStep {
+
+public:
+
+    /* The predicates of the step, like "0.2>3499" or "0.2=1.0" */
+    char description[MAX_STEP_DESCRIPTION_LENGTH];
+
+    /* The rows of the intermediate result of the step as they were
+     * estimated by the optimizer before the query was executed
+     */
+    double estimatedRows;
+
+    /* The actual rows of the intermediate result of the step */
+    double actualRows;
+
+    /* The milliseconds the step took */
+    double milliseconds;
+
+    /* The busy time of the threads divided by their amount and
+     * by the time of the step (a value between 0.0 and 1.0)
+     */
+    double threadUtilization;
+
+    /* What the join operation of the step did (nothing for filters) */
+    JoinStatistics joinStatistics;
+
+    /* Determines whether the remaining joins of the
+     * query were reordered after this step
+     */
+    bool precedesReoptimization;
+
+    /* Constructor */
+    ExplainedStep(double estimatedRows);
+
+};
+
+/* The plan a query was executed with, which is printed in the standard
+ * error (so the results of the queries are not affected) once the query
+ * has been executed.
+ *
+ * Every filter or join is recorded as a step in the order it was executed,
+ * along with the rows the optimizer estimated for it. The estimations of
+ * every step are made from the estimations of the previous steps, like
+ * the optimizer does, until the remaining joins are reordered with the
+ * actual rows of the intermediate results. In the 'analyze' mode every
+ * step is also measured while it is executed.
+ */
+class QueryExplanation {
+
+private:
+
+    /* The explained query */
+    Query *query;
+
+    /* Determines whether the steps are measured */
+    ExplainMode mode;
+
+    /* The job scheduler whose threads execute the joins */
+    JobScheduler *jobScheduler;
+
+    /* The steps of the query in the order they were executed */
+    List *steps;
+
+    /* The step that is currently executed ('NULL' if there is none) */
+    ExplainedStep *currentStep;
+
+    /* The amount of aliases of the query */
+    unsigned int aliasesNum;
+
+    /* The estimated intermediate result every alias takes part in (the
+     * aliases of the same result have the same group) and the estimated
+     * rows of every group
+     */
+    unsigned int *groupOfAlias;
+    double *groupRows;
+
+    /* The moments the query and the current step started */
+    struct timespec queryStart;
+    struct timespec stepStart;
+
+    /* The busy time of the threads when the current step started */
+    double stepStartBusyTime;
+
+    /* Appends a new step with the given estimated rows and, in the
+     * 'analyze' mode, starts measuring it
+     */
+    void beginStep(double estimatedRows);
+
+    /* Returns the elapsed milliseconds since the given moment */
+    static double getElapsedMilliseconds(const struct timespec *start);
+
+    /* Prints a step - used to traverse the list of steps */
+    static void printStep(void *item);
+
+    /* Prints a measured step - used to traverse the list of steps */
+    static void printMeasuredStep(void *item);
+
+    /* Deletes a step - used to traverse the list of steps */
+    static void deleteStep(void *item);
+
+public:
+
+    /* Constructor - Starts the explanation of the given query, whose
+     * aliases initially have the rows of their tables
+     */
+    QueryExplanation(Query *query, List *tables, ExplainMode mode,
+        JobScheduler *jobScheduler);
+
+    /* Destructor */
+    ~QueryExplanation();
+
+    /* Starts a step of the given filters of the same alias, which are
+     * applied together. 'selectivities' has the estimated selectivity
+     * of every filter.
+     */
+    void beginFilters(unsigned int filtersNum, PredicatesParser **filters,
+        const double *selectivities);
+
+    /* Starts a step of the given join predicate with the given estimated
+     * selectivity. 'isRepeated' tells whether an equal predicate has
+     * already been executed, so the join does not remove any rows.
+     */
+    void beginJoin(PredicatesParser *joinPred, double selectivity,
+        bool isRepeated);
+
+    /* Finishes the current step, given the actual rows of its intermediate
+     * result and what its join operation did (nothing for filters)
+     */
+    void endStep(double actualRows,
+        JoinStatistics joinStatistics = JoinStatistics());
+
+    /* Records that the remaining joins were reordered after the last step.
+     * The estimated rows of every alias become the given actual rows.
+     */
+    void reoptimize(const double *actualRowsOfAliases);
+
+    /* Getter - Returns the steps of the query in the order they were executed */
+    List *getSteps() const;
+
+    /* Prints the steps of the query in the standard error */
+    void print() const;
+
+};
+
+#endif
@@ -96,6 +96,53 @@ QueryHandler::QueryHandler(const char *init_file, const char *work_file,
 
     /* We initialize the job scheduler with the amount of available threads */
     jobScheduler = new JobScheduler(numThreads);
+
+    /* We read how many corrections of the estimations will be kept
+     * and the file they are kept in between executions (if any)
+     */
+    unsigned int cardinalityFeedbackSize = 0;
+    cardinalityFeedbackFile = NULL;
+
+    FileReader::readCardinalityFeedback(config_file, &cardinalityFeedbackSize,
+        &cardinalityFeedbackFile);
+
+    /* We create the store of the corrections only if the user wants to use it
+     * and we load the corrections of the previous executions (if there are)
+     */
+    cardinalityFeedback = (cardinalityFeedbackSize > 0)
+        ? new CardinalityFeedback(cardinalityFeedbackSize) : NULL;
+
+    if(cardinalityFeedback != NULL && cardinalityFeedbackFile != NULL)
+        cardinalityFeedback->load(cardinalityFeedbackFile);
+
+    /* We read the maximum amount of join orders that will be cached */
+    unsigned int planCacheSize = 0;
+    FileReader::readPlanCacheSize(config_file, &planCacheSize);
+
+    /* We create the plan cache only if the user wants to use it */
+    planCache = (planCacheSize > 0)
+        ? new PlanCache(tables, planCacheSize, cardinalityFeedback) : NULL;
+
+    /* We read how the cost of the join orders will be estimated */
+    CostModelType costModelType = CardinalityCostModel;
+    FileReader::readCostModel(config_file, &costModelType);
+
+    /* We create the cost model of the joins, measuring the costs
+     * of the operators on the host if the user wants it
+     */
+    costModel = (costModelType != CardinalityCostModel)
+        ? new CostModel(joinParameters) : NULL;
+
+    if(costModelType == CalibratedCostModel)
+        costModel->calibrate();
+
+    /* We read when the remaining joins of a query will be reordered */
+    reoptimizationFactor = 0;
+    FileReader::readReoptimizationFactor(config_file, &reoptimizationFactor);
+
+    /* We read whether the plans of the queries will be printed */
+    explainMode = NoExplain;
+    FileReader::readExplainMode(config_file, &explainMode);
 }
 
 /**************
@@ -117,6 +164,21 @@ QueryHandler::~QueryHandler()
 
     /* We free the allocated memory for the job scheduler */
     delete jobScheduler;
+
+    /* We free the allocated memory for the cached join orders */
+    delete planCache;
+
+    /* We free the allocated memory for the cost model */
+    delete costModel;
+
+    /* We keep the corrections for the following executions (if
+     * the user wants it) and we free the allocated memory for them
+     */
+    if(cardinalityFeedback != NULL && cardinalityFeedbackFile != NULL)
+        cardinalityFeedback->save(cardinalityFeedbackFile);
+
+    delete cardinalityFeedback;
+    free(cardinalityFeedbackFile);
 }
 
 /******************************************************************
@@ -157,6 +219,237 @@ unsigned int QueryHandler::getPriorityOfRelation(List *queryRelations,
     return priority;
 }
 
+/*******************************************************************
+ * Returns the intermediate result the alias at the given position *
+ * of the query takes part in or 'NULL' if there is no such result *
+ *******************************************************************/
+
+IntermediateArray *QueryHandler::getArrayOfAlias(
+    IntermediateRepresentation *intermediateRepresentation,
+    Query *query, unsigned int alias) const
+{
+    /* This is the real position of the relation of the alias */
+    unsigned int relName = query->getRelationInPos(alias);
+
+    /* We search the relation with its priority in the intermediate results */
+    return intermediateRepresentation->relationExists(relName,
+        getPriorityOfRelation(query->getRelations(), relName, alias));
+}
+
+/*****************************************************************
+ * Returns the actual rows of the alias at the given position of *
+ *  the query (of its intermediate result or else of its table)  *
+ *****************************************************************/
+
+double QueryHandler::getRowsOfAlias(
+    IntermediateRepresentation *intermediateRepresentation,
+    Query *query, unsigned int alias) const
+{
+    /* We retrieve the intermediate result of the alias */
+    IntermediateArray *array = getArrayOfAlias(intermediateRepresentation,
+        query, alias);
+
+    /* If the alias takes part in an intermediate result,
+     * its rows are the rows of that result
+     */
+    if(array != NULL)
+        return (double) array->getRowsNum();
+
+    /* Else the rows of the alias are the tuples of its table */
+    Table *table = (Table *) tables->getItemInPos(
+        query->getRelationInPos(alias) + 1);
+
+    return (double) table->getNumOfTuples();
+}
+
+/********************************************************************
+ * Returns 'true' if the join predicate is equal to an executed one *
+ ********************************************************************/
+
+bool QueryHandler::isExecutedJoin(PredicatesParser *joinPred, List *executedJoins)
+{
+    Listnode *currentNode = executedJoins->getHead();
+
+    while(currentNode != NULL)
+    {
+        PredicatesParser *executedPred = (PredicatesParser *)
+            currentNode->getItem();
+
+        if(joinPred->equals(executedPred))
+            return true;
+
+        currentNode = currentNode->getNext();
+    }
+
+    return false;
+}
+
+/******************************************************************
+ * Returns the query optimizer of the query, which is created the *
+ *                    first time it is needed                     *
+ ******************************************************************/
+
+QueryOptimizer *QueryHandler::getQueryOptimizer(Query *query,
+    QueryOptimizer **queryOptimizer) const
+{
+    if(*queryOptimizer == NULL)
+    {
+        *queryOptimizer = new QueryOptimizer(tables, query, costModel,
+            cardinalityFeedback);
+    }
+
+    return *queryOptimizer;
+}
+
+/*********************************************************************
+ * Returns the estimated selectivity of the join predicate, which is *
+ * taken from the cached order of the predicates (if any) before the *
+ *              query optimizer of the query is created              *
+ *********************************************************************/
+
+double QueryHandler::getJoinSelectivity(Query *query,
+    QueryOptimizer **queryOptimizer, PredicatesParser *joinPred,
+    List *cachedOrder, const double *cachedSelectivities) const
+{
+    /* If there is no query optimizer yet, we search the
+     * predicate in the cached order to find its selectivity
+     */
+    if(*queryOptimizer == NULL && cachedSelectivities != NULL)
+    {
+        unsigned int pos = 0;
+
+        for(Listnode *current = cachedOrder->getHead(); current != NULL;
+            current = current->getNext(), pos++)
+        {
+            if(current->getItem() == joinPred)
+                return cachedSelectivities[pos];
+        }
+    }
+
+    /* Else the query optimizer estimates the selectivity */
+    return getQueryOptimizer(query, queryOptimizer)->getJoinSelectivity(joinPred);
+}
+
+/*************************************************************
+ *  Returns the estimated rows of the join predicate, given  *
+ * its estimated selectivity and the estimated rows of every *
+ *             alias before the join is executed             *
+ *************************************************************/
+
+double QueryHandler::estimateRowsOfJoin(
+    IntermediateRepresentation *intermediateRepresentation,
+    Query *query, double selectivity,
+    PredicatesParser *joinPred, List *executedJoins,
+    const double *estimatedRows) const
+{
+    /* We retrieve the aliases of the two sides of the join */
+    unsigned int leftAlias = joinPred->getLeftArray();
+    unsigned int rightAlias = joinPred->getRightArray();
+
+    /* If the same predicate has already been executed, the join
+     * will not remove any rows of the intermediate result
+     */
+    if(isExecutedJoin(joinPred, executedJoins))
+        return estimatedRows[leftAlias];
+
+    /* We retrieve the intermediate results of the two aliases */
+    IntermediateArray *leftResult = getArrayOfAlias(intermediateRepresentation,
+        query, leftAlias);
+
+    IntermediateArray *rightResult = getArrayOfAlias(intermediateRepresentation,
+        query, rightAlias);
+
+    /* If both aliases already take part in the same intermediate result,
+     * the join only keeps the rows of that result that satisfy it
+     */
+    if((leftAlias == rightAlias)
+    || ((leftResult != NULL) && (leftResult == rightResult)))
+    {
+        return estimatedRows[leftAlias] * selectivity;
+    }
+
+    /* Else the join combines the rows of the two sides */
+    return estimatedRows[leftAlias] * estimatedRows[rightAlias] * selectivity;
+}
+
+/***********************************************************************
+ * Returns the remaining join predicates in the order that is cheapest *
+ *   for the actual rows of the intermediate results produced so far   *
+ ***********************************************************************/
+
+List *QueryHandler::reoptimizeRemainingJoins(
+    IntermediateRepresentation *intermediateRepresentation,
+    Query *query, QueryOptimizer *queryOptimizer,
+    Listnode *firstRemainingNode, List *executedJoins,
+    double *estimatedRows) const
+{
+    /* We retrieve the amount of aliases of the query */
+    unsigned int aliasesNum = query->getRelations()->getCounter();
+
+    /* Every intermediate result becomes a single group of the join
+     * enumeration and every alias that does not take part in an
+     * intermediate result becomes a group of its own
+     */
+    unsigned int *groupOfAlias = new unsigned int[aliasesNum];
+    double *groupRows = new double[aliasesNum];
+    IntermediateArray **groupResults = new IntermediateArray*[aliasesNum];
+    unsigned int groupsNum = 0;
+    unsigned int alias, group;
+
+    for(alias = 0; alias < aliasesNum; alias++)
+    {
+        /* We retrieve the intermediate result of the alias */
+        IntermediateArray *result = getArrayOfAlias(
+            intermediateRepresentation, query, alias);
+
+        /* We search for an earlier alias of the same intermediate result */
+        for(group = 0; group < groupsNum; group++)
+        {
+            if((result != NULL) && (groupResults[group] == result))
+                break;
+        }
+
+        /* If there is no such alias, we create a new group */
+        if(group == groupsNum)
+        {
+            groupResults[group] = result;
+            groupRows[group] = getRowsOfAlias(intermediateRepresentation,
+                query, alias);
+            groupsNum++;
+        }
+
+        /* The estimated rows of the alias become its actual rows */
+        groupOfAlias[alias] = group;
+        estimatedRows[alias] = groupRows[group];
+    }
+
+    /* We gather the remaining predicates of the current order.
+     *
+     * The filters are always placed before the joins, so
+     * all the remaining predicates are join predicates.
+     */
+    List remainingJoins = List();
+    Listnode *currentNode = firstRemainingNode;
+
+    while(currentNode != NULL)
+    {
+        remainingJoins.insertLast(currentNode->getItem());
+        currentNode = currentNode->getNext();
+    }
+
+    /* We enumerate the join trees of the groups */
+    List *result = queryOptimizer->reoptimizeJoinsOrder(&remainingJoins,
+        executedJoins, groupOfAlias, groupRows, groupsNum);
+
+    /* We free the allocated memory for the groups */
+    delete[] groupOfAlias;
+    delete[] groupRows;
+    delete[] groupResults;
+
+    /* We return the new order of the remaining joins */
+    return result;
+}
+
 /*************************************************************************
  * Addresses a single query and prints the result in the standard output *
  *************************************************************************/
@@ -167,14 +460,91 @@ void QueryHandler::addressSingleQuery(Query *query)
     IntermediateRepresentation intermediateRepresentation =
     IntermediateRepresentation(tables, joinParameters, jobScheduler);
 
-    /* We create a query optimizer for this query */
-    QueryOptimizer queryOptimizer = QueryOptimizer(tables, query);
-
     /* We retrieve the list of the relations taking part in the query */
     List *queryRels = query->getRelations();
 
-    /* We retrieve the predicates in the order that was estimated most optimal */
-    List *optimalPredicatesOrder = queryOptimizer.getOptimalPredicatesOrder();
+    /* If the user wants it, we record the steps of the query
+     * while it is executed, so we can print its plan
+     */
+    QueryExplanation *explanation = (explainMode != NoExplain)
+        ? new QueryExplanation(query, tables, explainMode, jobScheduler) : NULL;
+
+    /* We append to the query the filters and the joins that are implied by
+     * its equi-joins, before its shape is looked up in the plan cache
+     */
+    QueryOptimizer::inferImpliedPredicates(query);
+
+    /* If a previous query had the same shape and similar selectivities,
+     * we reuse the order of predicates that was chosen for that query.
+     * The estimated selectivities of the predicates of that query are
+     * kept with the order, so the joins can be compared with their
+     * estimations without optimizing the query again.
+     */
+    double *cachedSelectivities = NULL;
+
+    List *optimalPredicatesOrder = (planCache != NULL) ?
+        planCache->getPredicatesOrder(query, &cachedSelectivities) : NULL;
+
+    /* The query optimizer is only created when the query is not found in
+     * the cache or an estimation is needed that was not kept with the
+     * cached order (see 'getQueryOptimizer')
+     */
+    QueryOptimizer *queryOptimizer = NULL;
+
+    /* If the order was not found in the cache, we retrieve the
+     * predicates in the order that was estimated most optimal
+     */
+    if(optimalPredicatesOrder == NULL)
+    {
+        optimalPredicatesOrder = getQueryOptimizer(query, &queryOptimizer)->
+            getOptimalPredicatesOrder();
+
+        /* We keep the order for the following queries of the same shape.
+         * If the remaining joins may be reordered, we also keep the
+         * estimated selectivities that the joins are compared with.
+         */
+        if(planCache != NULL)
+        {
+            double *selectivities = NULL;
+
+            if(reoptimizationFactor > 0)
+            {
+                selectivities = new double[optimalPredicatesOrder->getCounter()];
+                unsigned int pos = 0;
+
+                for(Listnode *current = optimalPredicatesOrder->getHead();
+                    current != NULL; current = current->getNext(), pos++)
+                {
+                    PredicatesParser *pred = (PredicatesParser *) current->getItem();
+
+                    selectivities[pos] = pred->hasConstant()
+                        ? queryOptimizer->getFilterSelectivity(pred)
+                        : queryOptimizer->getJoinSelectivity(pred);
+                }
+            }
+
+            planCache->insertPredicatesOrder(query, optimalPredicatesOrder,
+                selectivities);
+
+            delete[] selectivities;
+        }
+    }
+
+    /* The estimated rows of the intermediate result of every alias, which
+     * are compared with the actual rows after every join. They are set to
+     * the actual rows once the filters have been applied.
+     */
+    unsigned int aliasesNum = queryRels->getCounter();
+    double *estimatedRows = NULL;
+
+    /* The join predicates that have been executed so far */
+    List executedJoins = List();
+
+    /* The actual rows of every alias before each join, which are used
+     * to estimate the rows of the join for the cardinality feedback
+     */
+    double *actualRows = (cardinalityFeedback != NULL)
+        ? new double[aliasesNum] : NULL;
 
     /* We will start traversing the list of predicates from the head */
     Listnode *currentNodeOfPredicate = optimalPredicatesOrder->getHead();
@@ -226,6 +596,65 @@ void QueryHandler::addressSingleQuery(Query *query)
             /* This is the suggested column for 'JOIN' of the right array */
             unsigned int rightArrayColumn = currentPredicate->getRightArrayColumn();
 
+            /* If the remaining joins may be reordered, we estimate the
+             * rows of the join before it is executed
+             */
+            double estimatedJoinRows = 0;
+
+            if(reoptimizationFactor > 0)
+            {
+                /* Before the first join, the estimated rows of every
+                 * alias are its actual rows after the filters
+                 */
+                if(estimatedRows == NULL)
+                {
+                    estimatedRows = new double[aliasesNum];
+
+                    for(unsigned int alias = 0; alias < aliasesNum; alias++)
+                        estimatedRows[alias] = getRowsOfAlias(
+                            &intermediateRepresentation, query, alias);
+                }
+
+                estimatedJoinRows = estimateRowsOfJoin(
+                    &intermediateRepresentation, query,
+                    getJoinSelectivity(query, &queryOptimizer, currentPredicate,
+                    optimalPredicatesOrder, cachedSelectivities),
+                    currentPredicate, &executedJoins, estimatedRows);
+            }
+
+            /* If the estimations are corrected by feedback, we estimate the
+             * rows of the join from the actual rows of its inputs. A join
+             * equal to an executed one or between columns of the same alias
+             * is not estimated by the optimizer, so it is not observed.
+             */
+            bool observeJoin = (cardinalityFeedback != NULL)
+                && (leftArrayNotation != rightArrayNotation)
+                && !isExecutedJoin(currentPredicate, &executedJoins);
+
+            double observedEstimatedRows = 0;
+
+            if(observeJoin)
+            {
+                for(unsigned int alias = 0; alias < aliasesNum; alias++)
+                    actualRows[alias] = getRowsOfAlias(
+                        &intermediateRepresentation, query, alias);
+
+                observedEstimatedRows = estimateRowsOfJoin(
+                    &intermediateRepresentation, query,
+                    getQueryOptimizer(query, &queryOptimizer)->
+                    getJoinSelectivity(currentPredicate),
+                    currentPredicate, &executedJoins, actualRows);
+            }
+
+            /* We explain the join with its estimated selectivity */
+            if(explanation != NULL)
+            {
+                explanation->beginJoin(currentPredicate,
+                    getQueryOptimizer(query, &queryOptimizer)->
+                    getJoinSelectivity(currentPredicate),
+                    isExecutedJoin(currentPredicate, &executedJoins));
+            }
+
             /* We execute the 'JOIN' between the two relations */
             intermediateRepresentation.executeJoin(
                 leftArray,
@@ -234,6 +663,89 @@ void QueryHandler::addressSingleQuery(Query *query)
                 rightArray,
                 rightArrayColumn,
                 getPriorityOfRelation(queryRels, rightArray, rightArrayNotation));
+
+            /* We keep the join among the executed ones */
+            executedJoins.insertLast(currentPredicate);
+
+            /* We explain what the join did */
+            if(explanation != NULL)
+            {
+                IntermediateArray *joinResult = getArrayOfAlias(
+                    &intermediateRepresentation, query, leftArrayNotation);
+
+                explanation->endStep((double) joinResult->getRowsNum(),
+                    joinResult->getLastJoinStatistics());
+            }
+
+            /* We record how far off the estimation of the join was */
+            if(observeJoin)
+            {
+                cardinalityFeedback->recordJoin(leftArray, leftArrayColumn,
+                    rightArray, rightArrayColumn, observedEstimatedRows,
+                    getRowsOfAlias(&intermediateRepresentation, query,
+                    leftArrayNotation));
+            }
+
+            /* If there are more joins to be executed, we compare
+             * the actual rows of the join with its estimated rows
+             */
+            if((reoptimizationFactor > 0)
+            && (currentNodeOfPredicate->getNext() != NULL))
+            {
+                /* We retrieve the intermediate result of the join */
+                IntermediateArray *joinResult = getArrayOfAlias(
+                    &intermediateRepresentation, query, leftArrayNotation);
+
+                /* Every alias of the result has the estimated rows of the join */
+                for(unsigned int alias = 0; alias < aliasesNum; alias++)
+                {
+                    if(getArrayOfAlias(&intermediateRepresentation,
+                        query, alias) == joinResult)
+                    {
+                        estimatedRows[alias] = estimatedJoinRows;
+                    }
+                }
+
+                /* We consider at least 1 row on both sides,
+                 * so that empty results can be compared
+                 */
+                double actualRows = getRowsOfAlias(&intermediateRepresentation,
+                    query, leftArrayNotation);
+
+                if(actualRows < 1) actualRows = 1;
+                if(estimatedJoinRows < 1) estimatedJoinRows = 1;
+
+                /* If the estimation is off by more than the given factor,
+                 * the remaining joins are reordered with the actual rows
+                 * of the intermediate results that have been produced
+                 */
+                if((actualRows > estimatedJoinRows * reoptimizationFactor)
+                || (estimatedJoinRows > actualRows * reoptimizationFactor))
+                {
+                    List *remainingOrder = reoptimizeRemainingJoins(
+                        &intermediateRepresentation, query,
+                        getQueryOptimizer(query, &queryOptimizer),
+                        currentNodeOfPredicate->getNext(), &executedJoins,
+                        estimatedRows);
+
+                    /* The following steps are estimated from the actual rows */
+                    if(explanation != NULL)
+                        explanation->reoptimize(estimatedRows);
+
+                    /* The new order replaces the old one. The query
+                     * optimizer estimates the joins of the new order.
+                     */
+                    delete optimalPredicatesOrder;
+                    optimalPredicatesOrder = remainingOrder;
+
+                    delete[] cachedSelectivities;
+                    cachedSelectivities = NULL;
+
+                    /* We proceed to the first join of the new order */
+                    currentNodeOfPredicate = optimalPredicatesOrder->getHead();
+                    continue;
+                }
+            }
         }
 
         else
@@ -248,22 +760,107 @@ void QueryHandler::addressSingleQuery(Query *query)
              */
             unsigned int leftArray = query->getRelationInPos(leftArrayNotation);
 
-            /* This is the suggested column of the left array for the predicate */
-            unsigned int leftArrayColumn = currentPredicate->getLeftArrayColumn();
+            /* The filters of the same relation that follow this one in the
+             * order are applied together with it in a single scan. We find
+             * the last of them.
+             */
+            Listnode *lastNodeOfFilters = currentNodeOfPredicate;
+            unsigned int filtersNum = 1;
+
+            while(lastNodeOfFilters->getNext() != NULL)
+            {
+                PredicatesParser *nextPredicate = (PredicatesParser *)
+                    lastNodeOfFilters->getNext()->getItem();
 
-            /* We retrieve the constant integer value that will filter the table */
-            unsigned int filterValue = currentPredicate->getFilterValue();
+                if(!nextPredicate->hasConstant()
+                || nextPredicate->getLeftArray() != leftArrayNotation)
+                    break;
 
-            /* We retrieve the operator of the predicate ('<', '>', '=') */
-            char filterOperator = currentPredicate->getFilterOperator();
+                lastNodeOfFilters = lastNodeOfFilters->getNext();
+                filtersNum++;
+            }
+
+            /* We retrieve the columns, the constant integer values and the
+             * operators ('<', '>', '=') of the filters in their order
+             */
+            unsigned int filterColumns[filtersNum];
+            unsigned int filterValues[filtersNum];
+            char filterOperators[filtersNum];
+            PredicatesParser *filters[filtersNum];
 
-            /* We apply the filter on the given relation */
-            intermediateRepresentation.executeFilter(
+            Listnode *filterNode = currentNodeOfPredicate;
+
+            for(unsigned int k = 0; k < filtersNum; k++)
+            {
+                filters[k] = (PredicatesParser *) filterNode->getItem();
+                filterColumns[k] = filters[k]->getLeftArrayColumn();
+                filterValues[k] = filters[k]->getFilterValue();
+                filterOperators[k] = filters[k]->getFilterOperator();
+
+                filterNode = filterNode->getNext();
+            }
+
+            /* The amount of rows that satisfy the first k+1 filters */
+            unsigned long long passedNums[filtersNum];
+
+            /* If the estimations are corrected by feedback, we will estimate
+             * the rows of every filter from the actual rows of its input
+             */
+            double inputRows = 0;
+
+            if(cardinalityFeedback != NULL)
+                inputRows = getRowsOfAlias(&intermediateRepresentation, query,
+                    leftArrayNotation);
+
+            /* We explain the filters with their estimated selectivities */
+            if(explanation != NULL)
+            {
+                double filterSelectivities[filtersNum];
+
+                for(unsigned int k = 0; k < filtersNum; k++)
+                    filterSelectivities[k] = getQueryOptimizer(query,
+                        &queryOptimizer)->getFilterSelectivity(filters[k]);
+
+                explanation->beginFilters(filtersNum, filters, filterSelectivities);
+            }
+
+            /* We apply the filters on the given relation */
+            intermediateRepresentation.executeFilters(
                 leftArray,
-                leftArrayColumn,
                 getPriorityOfRelation(queryRels, leftArray, leftArrayNotation),
-                filterValue,
-                filterOperator);
+                filtersNum,
+                filterColumns,
+                filterValues,
+                filterOperators,
+                passedNums);
+
+            /* We explain how many rows passed the filters */
+            if(explanation != NULL)
+                explanation->endStep(getRowsOfAlias(&intermediateRepresentation,
+                    query, leftArrayNotation));
+
+            /* We record how far off the estimation of every filter was. The
+             * input of every filter is the output of the previous one and
+             * its rows are estimated with the selectivity of the filter,
+             * which is the estimation its correction multiplies.
+             */
+            if(cardinalityFeedback != NULL)
+            {
+                for(unsigned int k = 0; k < filtersNum; k++)
+                {
+                    double filterInputRows = (k == 0) ? inputRows
+                        : (double) passedNums[k - 1];
+
+                    cardinalityFeedback->recordFilter(leftArray,
+                        filterColumns[k], filterOperators[k], filterInputRows
+                        * getQueryOptimizer(query, &queryOptimizer)->
+                        getFilterSelectivity(filters[k]),
+                        (double) passedNums[k]);
+                }
+            }
+
+            /* We proceed from the last of the applied filters */
+            currentNodeOfPredicate = lastNodeOfFilters;
         }
 
         /* We have finished addressing the current predicate.
@@ -277,7 +874,15 @@ void QueryHandler::addressSingleQuery(Query *query)
      *
      * We free the allocated memory for that list.
      */
-    queryOptimizer.deleteOptimalPredicatesOrder(optimalPredicatesOrder);
+    delete optimalPredicatesOrder;
+
+    /* We free the allocated memory for the query
+     * optimizer and the estimations (if any)
+     */
+    delete queryOptimizer;
+    delete[] cachedSelectivities;
+    delete[] estimatedRows;
+    delete[] actualRows;
 
     /* Now we will traverse the projections of
      * the query to compute the suggested sums
@@ -321,6 +926,19 @@ void QueryHandler::addressSingleQuery(Query *query)
      * We print a new line to escape the line of the printed results.
      */
     std::cout << std::endl;
+
+    /* We print the plan of the query (if the user wants it) */
+    if(explanation != NULL)
+    {
+        explanation->print();
+        delete explanation;
+    }
+
+    /* Every join of the query has freed its auxiliary arrays in the
+     * scratch arena of this thread. We reset the arena, so the next
+     * query starts from the beginning of the memory it keeps.
+     */
+    ScratchArena::getThreadArena()->reset();
 }
 
 /**********************************************************
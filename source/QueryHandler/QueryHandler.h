@@ -4,6 +4,8 @@
 #include "PartitionedHashJoinInput.h"
 #include "IntermediateRepresentation.h"
 #include "QueryOptimizer.h"
+#include "PlanCache.h"
+#include "QueryExplanation.h"
 
 /* A class that stores the input relations (tables) and
  * the input queries split in batches. The class contains
@@ -27,10 +29,93 @@ private:
      */
     JobScheduler *jobScheduler;
 
+    /* The join orders of the previous queries, which are reused by the
+     * following queries of the same shape ('NULL' if they are not kept)
+     */
+    PlanCache *planCache;
+
+    /* The model that estimates the time of the joins of every query
+     * ('NULL' if the joins are compared by the tuples they produce)
+     */
+    CostModel *costModel;
+
+    /* The factor by which the actual rows of an intermediate result may
+     * differ from its estimated rows before the remaining joins of the
+     * query are reordered (0 if the initial order is always kept)
+     */
+    double reoptimizationFactor;
+
+    /* The corrections of the estimations of the optimizer, which are learned
+     * from the actual rows of the executed predicates ('NULL' if unused)
+     */
+    CardinalityFeedback *cardinalityFeedback;
+
+    /* The file the corrections are kept in between
+     * executions ('NULL' if they are not kept)
+     */
+    char *cardinalityFeedbackFile;
+
+    /* Determines whether the plans of the queries are printed and how */
+    ExplainMode explainMode;
+
     /* Returns the priority of the relation at the specified position */
     unsigned int getPriorityOfRelation(List *queryRelations,
         unsigned int relName, unsigned int relPosInQuery) const;
 
+    /* Returns the intermediate result the alias at the given position of
+     * the query takes part in or 'NULL' if it has not been filtered or
+     * joined yet
+     */
+    IntermediateArray *getArrayOfAlias(
+        IntermediateRepresentation *intermediateRepresentation,
+        Query *query, unsigned int alias) const;
+
+    /* Returns the actual rows of the alias at the given position of the query,
+     * which are the rows of its intermediate result or of its table
+     */
+    double getRowsOfAlias(
+        IntermediateRepresentation *intermediateRepresentation,
+        Query *query, unsigned int alias) const;
+
+    /* Returns 'true' if the join predicate is equal to an executed one */
+    static bool isExecutedJoin(PredicatesParser *joinPred, List *executedJoins);
+
+    /* Returns the query optimizer of the query, which is created the first
+     * time it is needed (so the query may never need one if its order of
+     * predicates was found in the plan cache)
+     */
+    QueryOptimizer *getQueryOptimizer(Query *query,
+        QueryOptimizer **queryOptimizer) const;
+
+    /* Returns the estimated selectivity of the join predicate. Before the
+     * query optimizer of the query is created, the selectivity is taken
+     * from the given selectivities of the cached order of the predicates
+     * (if any), so the query optimizer is not created just for it.
+     */
+    double getJoinSelectivity(Query *query, QueryOptimizer **queryOptimizer,
+        PredicatesParser *joinPred, List *cachedOrder,
+        const double *cachedSelectivities) const;
+
+    /* Returns the estimated rows of the join predicate, given its estimated
+     * selectivity and the estimated rows of every alias before the join
+     */
+    double estimateRowsOfJoin(
+        IntermediateRepresentation *intermediateRepresentation,
+        Query *query, double selectivity,
+        PredicatesParser *joinPred, List *executedJoins,
+        const double *estimatedRows) const;
+
+    /* Returns the remaining join predicates (starting from the given node)
+     * in the order that is cheapest for the actual rows of the intermediate
+     * results that have been produced so far. The estimated rows of every
+     * alias are reset to its actual rows.
+     */
+    List *reoptimizeRemainingJoins(
+        IntermediateRepresentation *intermediateRepresentation,
+        Query *query, QueryOptimizer *queryOptimizer,
+        Listnode *firstRemainingNode, List *executedJoins,
+        double *estimatedRows) const;
+
     /* Addresses a single query and prints the result in the standard output */
     void addressSingleQuery(Query *query);
 
@@ -0,0 +1,462 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include "CardinalityFeedback.h"
+
+/***************************************************************
+ * The maximum length of the shape of a single predicate, like *
+ *             "F12.3<" or "J12.3=14.0" for a join             *
+ ***************************************************************/
+
+#define MAX_KEY_LENGTH 64
+
+/****************************
+ * Constructor of the entry *
+ ****************************/
+
+FeedbackEntry::FeedbackEntry(char *key)
+{
+    this->key = key;
+
+    /* Initially the estimations are not corrected */
+    logCorrection = 0;
+    observationsNum = 0;
+    correctionBucket = 0;
+}
+
+/***************************
+ * Destructor of the entry *
+ ***************************/
+
+FeedbackEntry::~FeedbackEntry()
+{
+    delete[] key;
+}
+
+/************************************
+ * Compares two keys of corrections *
+ *          alphabetically          *
+ ************************************/
+
+int CardinalityFeedback::compareKeys(void *key1, void *key2)
+{
+    int result = strcmp((char *) key1, (char *) key2);
+
+    if(result > 0)
+        return 1;
+
+    if(result < 0)
+        return -1;
+
+    return 0;
+}
+
+/*******************************************
+ * Compares two entries by their addresses *
+ *******************************************/
+
+int CardinalityFeedback::compareEntries(void *entry1, void *entry2)
+{
+    return (entry1 == entry2) ? 0 : 1;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+CardinalityFeedback::CardinalityFeedback(unsigned int maxEntriesNum)
+{
+    this->maxEntriesNum = maxEntriesNum;
+
+    /* Initially no correction is kept */
+    entries = new RedBlackTree();
+    observationOrder = new List();
+
+    version = 0;
+
+    pthread_mutex_init(&mutex, NULL);
+}
+
+/**************
+ * Destructor *
+ **************/
+
+CardinalityFeedback::~CardinalityFeedback()
+{
+    /* We free every entry and then the structures themselves */
+    while(!observationOrder->isEmpty())
+    {
+        delete (FeedbackEntry *) observationOrder->getHead()->getItem();
+        observationOrder->removeFront();
+    }
+
+    delete observationOrder;
+    delete entries;
+
+    pthread_mutex_destroy(&mutex);
+}
+
+/**************************************************
+ * Returns the power of 2 of the given correction *
+ **************************************************/
+
+long CardinalityFeedback::getCorrectionBucket(double logCorrection)
+{
+    return (long) floor(logCorrection / log(2.0));
+}
+
+/*************************************************************
+ * Creates the shape of a filter from its base table, column *
+ *     and operator (it must be deleted with 'delete[]')     *
+ *************************************************************/
+
+char *CardinalityFeedback::createFilterKey(unsigned int table,
+    unsigned int column, char filterOperator)
+{
+    char *key = new char[MAX_KEY_LENGTH];
+    snprintf(key, MAX_KEY_LENGTH, "F%u.%u%c", table, column, filterOperator);
+
+    return key;
+}
+
+/****************************************************************
+ * Creates the shape of a join from its base tables and columns *
+ *    in a sorted order (it must be deleted with 'delete[]')    *
+ ****************************************************************/
+
+char *CardinalityFeedback::createJoinKey(unsigned int leftTable,
+    unsigned int leftColumn, unsigned int rightTable, unsigned int rightColumn)
+{
+    char *key = new char[MAX_KEY_LENGTH];
+
+    /* We place the smaller side first, so the order of the sides does not matter */
+    if(rightTable < leftTable || (rightTable == leftTable && rightColumn < leftColumn))
+    {
+        snprintf(key, MAX_KEY_LENGTH, "J%u.%u=%u.%u",
+            rightTable, rightColumn, leftTable, leftColumn);
+    }
+
+    else
+    {
+        snprintf(key, MAX_KEY_LENGTH, "J%u.%u=%u.%u",
+            leftTable, leftColumn, rightTable, rightColumn);
+    }
+
+    return key;
+}
+
+/************************************************************
+ * Returns the kept entry of the given shape or 'NULL' (the *
+ *           mutex must be locked by the caller)            *
+ ************************************************************/
+
+FeedbackEntry *CardinalityFeedback::searchEntry(const char *key) const
+{
+    return (FeedbackEntry *) entries->searchItem((void *) key, compareKeys);
+}
+
+/*********************************************************************
+ * Keeps the given entry as the most recently observed one, evicting *
+ * the least recently observed ones if the store is full (the mutex  *
+ *                   must be locked by the caller)                   *
+ *********************************************************************/
+
+void CardinalityFeedback::insertEntry(FeedbackEntry *entry)
+{
+    while(observationOrder->getCounter() >= maxEntriesNum)
+        removeEntry((FeedbackEntry *) observationOrder->getHead()->getItem());
+
+    entries->insert(entry, entry->key, compareKeys);
+    observationOrder->insertLast(entry);
+}
+
+/************************************************************
+ * Removes the given entry from the store and frees it (the *
+ *           mutex must be locked by the caller)            *
+ ************************************************************/
+
+void CardinalityFeedback::removeEntry(FeedbackEntry *entry)
+{
+    /* If the correction was large enough to affect the
+     * join orders, the orders that used it are outdated
+     */
+    if(entry->correctionBucket != 0)
+        version++;
+
+    entries->remove(entry->key, compareKeys);
+    observationOrder->removeKeyNode(entry, compareEntries);
+
+    delete entry;
+}
+
+/*******************************************************************
+ * Returns the correction of the given shape (1 if it is not kept) *
+ *******************************************************************/
+
+double CardinalityFeedback::getCorrection(const char *key)
+{
+    double logCorrection = 0;
+
+    pthread_mutex_lock(&mutex);
+
+    FeedbackEntry *entry = searchEntry(key);
+
+    if(entry != NULL)
+        logCorrection = entry->logCorrection;
+
+    pthread_mutex_unlock(&mutex);
+
+    return exp(logCorrection);
+}
+
+/*************************************************************
+ * Moves the correction of the given shape towards the ratio *
+ *        between the given actual and estimated rows        *
+ *************************************************************/
+
+void CardinalityFeedback::record(const char *key, double estimatedRows,
+    double actualRows)
+{
+    if(maxEntriesNum == 0)
+        return;
+
+    /* We consider at least 1 row on both sides,
+     * so that empty results can be compared
+     */
+    if(estimatedRows < 1) estimatedRows = 1;
+    if(actualRows < 1) actualRows = 1;
+
+    /* The remaining error of the estimation, which was
+     * made with the current correction of the shape
+     */
+    double logError = log(actualRows / estimatedRows);
+
+    pthread_mutex_lock(&mutex);
+
+    FeedbackEntry *entry = searchEntry(key);
+
+    /* If the shape is observed for the first time, we create its entry */
+    if(entry == NULL)
+    {
+        char *entryKey = new char[strlen(key) + 1];
+        strcpy(entryKey, key);
+
+        entry = new FeedbackEntry(entryKey);
+        insertEntry(entry);
+    }
+
+    /* Else the shape becomes the most recently observed one */
+    else
+    {
+        observationOrder->removeKeyNode(entry, compareEntries);
+        observationOrder->insertLast(entry);
+    }
+
+    /* The correction moves towards the actual rows by the
+     * weight of the observation among the latest ones
+     */
+    if(entry->observationsNum < FEEDBACK_HISTORY)
+        entry->observationsNum++;
+
+    entry->logCorrection += logError / entry->observationsNum;
+
+    /* The correction is kept in reasonable bounds */
+    double maxLogCorrection = log(MAX_FEEDBACK_CORRECTION);
+
+    if(entry->logCorrection > maxLogCorrection)
+        entry->logCorrection = maxLogCorrection;
+
+    if(entry->logCorrection < -maxLogCorrection)
+        entry->logCorrection = -maxLogCorrection;
+
+    /* If the correction changed by a power of 2, the
+     * join orders estimated with it are outdated
+     */
+    long correctionBucket = getCorrectionBucket(entry->logCorrection);
+
+    if(correctionBucket != entry->correctionBucket)
+    {
+        entry->correctionBucket = correctionBucket;
+        version++;
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/**********************************************************
+ * Returns the factor the estimated rows of a filter with *
+ *    the given column and operator are multiplied by     *
+ **********************************************************/
+
+double CardinalityFeedback::getFilterCorrection(unsigned int table,
+    unsigned int column, char filterOperator)
+{
+    char *key = createFilterKey(table, column, filterOperator);
+    double correction = getCorrection(key);
+    delete[] key;
+
+    return correction;
+}
+
+/***************************************************
+ * Returns the factor the estimated rows of a join *
+ *   between the given columns are multiplied by   *
+ ***************************************************/
+
+double CardinalityFeedback::getJoinCorrection(unsigned int leftTable,
+    unsigned int leftColumn, unsigned int rightTable, unsigned int rightColumn)
+{
+    char *key = createJoinKey(leftTable, leftColumn, rightTable, rightColumn);
+    double correction = getCorrection(key);
+    delete[] key;
+
+    return correction;
+}
+
+/*****************************************************************
+ * Records the actual rows of an executed filter, given the rows *
+ * that were estimated with the current correction of the filter *
+ *****************************************************************/
+
+void CardinalityFeedback::recordFilter(unsigned int table, unsigned int column,
+    char filterOperator, double estimatedRows, double actualRows)
+{
+    char *key = createFilterKey(table, column, filterOperator);
+    record(key, estimatedRows, actualRows);
+    delete[] key;
+}
+
+/***************************************************************
+ * Records the actual rows of an executed join, given the rows *
+ * that were estimated with the current correction of the join *
+ ***************************************************************/
+
+void CardinalityFeedback::recordJoin(unsigned int leftTable,
+    unsigned int leftColumn, unsigned int rightTable, unsigned int rightColumn,
+    double estimatedRows, double actualRows)
+{
+    char *key = createJoinKey(leftTable, leftColumn, rightTable, rightColumn);
+    record(key, estimatedRows, actualRows);
+    delete[] key;
+}
+
+/***************************************************
+ * Getter - Returns the amount of kept corrections *
+ ***************************************************/
+
+unsigned int CardinalityFeedback::getEntriesNum()
+{
+    pthread_mutex_lock(&mutex);
+    unsigned int entriesNum = observationOrder->getCounter();
+    pthread_mutex_unlock(&mutex);
+
+    return entriesNum;
+}
+
+/*******************************************************
+ * Getter - Returns a number that changes every time a *
+ *         correction changes by a power of 2          *
+ *******************************************************/
+
+unsigned long long CardinalityFeedback::getVersion()
+{
+    pthread_mutex_lock(&mutex);
+    unsigned long long result = version;
+    pthread_mutex_unlock(&mutex);
+
+    return result;
+}
+
+/*******************************************************************
+ * Loads the corrections from the given text file. Returns 'false' *
+ * if the file could not be opened (for example in the first run)  *
+ *******************************************************************/
+
+bool CardinalityFeedback::load(const char *feedbackFile)
+{
+    FILE *file = fopen(feedbackFile, "r");
+
+    if(file == NULL)
+        return false;
+
+    /* Every line of the file is a shape, the logarithm of its
+     * correction and the amount of times it has been observed
+     */
+    char key[MAX_KEY_LENGTH];
+    double logCorrection;
+    unsigned int observationsNum;
+
+    pthread_mutex_lock(&mutex);
+
+    while(fscanf(file, "%63s %lf %u", key, &logCorrection, &observationsNum) == 3)
+    {
+        /* A shape that is already kept is replaced */
+        FeedbackEntry *entry = searchEntry(key);
+
+        if(entry != NULL)
+            removeEntry(entry);
+
+        char *entryKey = new char[strlen(key) + 1];
+        strcpy(entryKey, key);
+
+        entry = new FeedbackEntry(entryKey);
+        entry->logCorrection = logCorrection;
+        entry->observationsNum = (observationsNum < FEEDBACK_HISTORY)
+            ? observationsNum : FEEDBACK_HISTORY;
+        entry->correctionBucket = getCorrectionBucket(logCorrection);
+
+        if(maxEntriesNum > 0)
+            insertEntry(entry);
+
+        else
+            delete entry;
+    }
+
+    /* The join orders estimated before the corrections are outdated */
+    version++;
+
+    pthread_mutex_unlock(&mutex);
+
+    fclose(file);
+
+    return true;
+}
+
+/************************************************************************
+ * Saves the corrections to the given text file, from the least to the  *
+ * most recently observed one. Returns 'false' if the file could not be *
+ *                               created                                *
+ ************************************************************************/
+
+bool CardinalityFeedback::save(const char *feedbackFile)
+{
+    FILE *file = fopen(feedbackFile, "w");
+
+    if(file == NULL)
+    {
+        printf("Error creating \"%s\"\n", feedbackFile);
+        perror("fopen");
+        return false;
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    /* The least recently observed corrections are written first,
+     * so they are the first to be evicted after they are loaded
+     */
+    for(Listnode *current = observationOrder->getHead(); current != NULL;
+        current = current->getNext())
+    {
+        FeedbackEntry *entry = (FeedbackEntry *) current->getItem();
+
+        fprintf(file, "%s %.17g %u\n", entry->key, entry->logCorrection,
+            entry->observationsNum);
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    fclose(file);
+
+    return true;
+}
@@ -0,0 +1,174 @@
+#ifndef _CARDINALITY_FEEDBACK_H_
+#define _CARDINALITY_FEEDBACK_H_
+
+#include <pthread.h>
+#include "List.h"
+#include "RedBlackTree.h"
+
+/* The amount of most recent observations a correction is averaged over */
+#define FEEDBACK_HISTORY 8
+
+/* The largest factor a correction may change an estimation by */
+#define MAX_FEEDBACK_CORRECTION 1000000.0
+
+/* The correction of the estimations of a predicate shape */
+class FeedbackEntry {
+
+public:
+
+    /* The shape of the predicate (see 'CardinalityFeedback') */
+    char *key;
+
+    /* The natural logarithm of the factor the estimated rows of
+     * the predicates of this shape are multiplied by
+     */
+    double logCorrection;
+
+    /* The amount of times predicates of this shape have been observed */
+    unsigned int observationsNum;
+
+    /* The power of 2 of the correction the last time it
+     * changed the version of the feedback (see 'getVersion')
+     */
+    long correctionBucket;
+
+    /* Constructor & Destructor */
+    FeedbackEntry(char *key);
+    ~FeedbackEntry();
+
+};
+
+/* Keeps the ratio between the actual and the estimated rows of the filters
+ * and the joins that have been executed, so that the query optimizer can
+ * correct its estimations for the following queries.
+ *
+ * The shape of a filter is its base table, its column and its operator
+ * (without its constant), so every column gets its own selectivity
+ * correction for every operator. The shape of a join is the two base
+ * tables and columns it joins (in a sorted order), so every pair of
+ * joined columns gets its own fan-out correction.
+ *
+ * Every observation moves the correction of its shape towards the ratio
+ * between the actual rows and the rows that were estimated with the
+ * current correction, averaged over the last few observations. When the
+ * store is full, the least recently observed shape is evicted. The
+ * corrections may be saved to and loaded from a text file, so they are
+ * kept between the executions of the program.
+ */
+class CardinalityFeedback {
+
+private:
+
+    /* The corrections, keyed by the shape of their predicates */
+    RedBlackTree *entries;
+
+    /* The corrections from the least to the most recently observed */
+    List *observationOrder;
+
+    /* The maximum amount of corrections that are kept */
+    unsigned int maxEntriesNum;
+
+    /* Increases every time a correction changes by a power of 2 */
+    unsigned long long version;
+
+    /* Guards the corrections, so many queries can use them at once */
+    pthread_mutex_t mutex;
+
+    /* Returns the correction of the given shape (1 if it is not kept) */
+    double getCorrection(const char *key);
+
+    /* Moves the correction of the given shape towards the
+     * ratio between the given actual and estimated rows
+     */
+    void record(const char *key, double estimatedRows, double actualRows);
+
+    /* Returns the kept entry of the given shape or
+     * 'NULL' (the mutex must be locked by the caller)
+     */
+    FeedbackEntry *searchEntry(const char *key) const;
+
+    /* Keeps the given entry as the most recently observed one, evicting
+     * the least recently observed ones if the store is full (the mutex
+     * must be locked by the caller)
+     */
+    void insertEntry(FeedbackEntry *entry);
+
+    /* Removes the given entry from the store and frees it
+     * (the mutex must be locked by the caller)
+     */
+    void removeEntry(FeedbackEntry *entry);
+
+    /* Returns the power of 2 of the given correction */
+    static long getCorrectionBucket(double logCorrection);
+
+    /* Creates the shapes of the predicates. The returned keys
+     * must be deleted with 'delete[]' after use.
+     */
+    static char *createFilterKey(unsigned int table, unsigned int column,
+        char filterOperator);
+
+    static char *createJoinKey(unsigned int leftTable, unsigned int leftColumn,
+        unsigned int rightTable, unsigned int rightColumn);
+
+    /* Compares two keys of corrections alphabetically */
+    static int compareKeys(void *key1, void *key2);
+
+    /* Compares two entries by their addresses */
+    static int compareEntries(void *entry1, void *entry2);
+
+public:
+
+    /* Constructor - Creates a store of at most 'maxEntriesNum' corrections */
+    CardinalityFeedback(unsigned int maxEntriesNum);
+
+    /* Destructor */
+    ~CardinalityFeedback();
+
+    /* Returns the factor the estimated rows of a filter
+     * with the given column and operator are multiplied by
+     */
+    double getFilterCorrection(unsigned int table, unsigned int column,
+        char filterOperator);
+
+    /* Returns the factor the estimated rows of a join
+     * between the given columns are multiplied by
+     */
+    double getJoinCorrection(unsigned int leftTable, unsigned int leftColumn,
+        unsigned int rightTable, unsigned int rightColumn);
+
+    /* Records the actual rows of an executed filter, given the rows
+     * that were estimated with the current correction of the filter
+     */
+    void recordFilter(unsigned int table, unsigned int column,
+        char filterOperator, double estimatedRows, double actualRows);
+
+    /* Records the actual rows of an executed join, given the rows
+     * that were estimated with the current correction of the join
+     */
+    void recordJoin(unsigned int leftTable, unsigned int leftColumn,
+        unsigned int rightTable, unsigned int rightColumn,
+        double estimatedRows, double actualRows);
+
+    /* Getter - Returns the amount of kept corrections */
+    unsigned int getEntriesNum();
+
+    /* Getter - Returns a number that changes every time a correction changes
+     * by a power of 2, so the join orders estimated with older corrections
+     * can be recognized
+     */
+    unsigned long long getVersion();
+
+    /* Loads the corrections from the given text file. Returns 'false'
+     * if the file could not be opened (for example in the first run).
+     */
+    bool load(const char *feedbackFile);
+
+    /* Saves the corrections to the given text file, from the least to the
+     * most recently observed one. Returns 'false' if the file could not be
+     * created.
+     */
+    bool save(const char *feedbackFile);
+
+};
+
+#endif
@@ -1,12 +1,6 @@
 #include <iostream>
 #include "ColumnIdentity.h"
 
-/***********************************************************
- * A variable that produces an ID for each column identity *
- ***********************************************************/
-
-unsigned int ColumnIdentity::idCounter = 0;
-
 /**************************************************
  * Prints a neighbor (which is a column identity) *
  **************************************************/
@@ -52,6 +46,7 @@ void ColumnIdentity::contextBetweenPredicates()
  ***************/
 
 ColumnIdentity::ColumnIdentity(
+    unsigned int id,
     unsigned int tableName,
     unsigned int tableColumn,
     unsigned int realTableName,
@@ -63,9 +58,13 @@ ColumnIdentity::ColumnIdentity(
     this->realTableName = realTableName;
     this->columnStats = columnStats;
 
-    /* We produce a new ID and assign it to the column identity */
-    idCounter++;
-    id = idCounter;
+    /* The ID is produced by the optimizer of the query, so the
+     * optimizers of different queries do not share any counter
+     */
+    this->id = id;
+
+    /* Until the joins are examined, the column is only equal to itself */
+    equivalenceClass = id;
 
     /* We initialize the list of neighbors and neighbor predicates */
     neighbors = new List();
@@ -85,6 +84,7 @@ ColumnIdentity::ColumnIdentity(
      */
     this->tableName = tableName;
     this->tableColumn = tableColumn;
+    equivalenceClass = 0;
 
     /* We need to initialize the list of neighbors
      * and neighbor predicates because the destructor
@@ -178,6 +178,24 @@ void ColumnIdentity::setColumnStats(ColumnStatistics *newStats)
     columnStats = newStats;
 }
 
+/*****************************************************************
+ * Getter - Returns the equivalence class of the column identity *
+ *****************************************************************/
+
+unsigned int ColumnIdentity::getEquivalenceClass() const
+{
+    return equivalenceClass;
+}
+
+/*****************************************************************
+ * Setter - Changes the equivalence class of the column identity *
+ *****************************************************************/
+
+void ColumnIdentity::setEquivalenceClass(unsigned int equivalenceClass)
+{
+    this->equivalenceClass = equivalenceClass;
+}
+
 /*************************************************
  * Inserts a new neighbor along with the related *
  *   join predicate to the lists of the class    *
@@ -241,12 +259,3 @@ int ColumnIdentity::compare(ColumnIdentity *other) const
     /* Case this table is greater than the other */
     return 1;
 }
-
-/********************************************
- * Resets the counter of column IDs to zero *
- ********************************************/
-
-void ColumnIdentity::resetIdCounter()
-{
-    idCounter = 0;
-}
@@ -30,8 +30,10 @@ private:
     /* A list of predicates that are assossiacted with each neighbor */
     List *neighborPredicates;
 
-    /* A variable that produces an ID for each column identity */
-    static unsigned int idCounter;
+    /* The ID of a column of the same equivalence class, which consists
+     * of all the columns that are equal through the join predicates
+     */
+    unsigned int equivalenceClass;
 
     /* Prints a neighbor (which is a column identity) */
     static void printNeighbor(void *item);
@@ -51,8 +53,11 @@ private:
 
 public:
 
-    /* Constructor */
+    /* Constructor - The given ID must be unique among
+     * the column identities of the same query
+     */
     ColumnIdentity(
+        unsigned int id,
         unsigned int tableName,
         unsigned int tableColumn,
         unsigned int realTableName,
@@ -96,6 +101,12 @@ public:
     /* Setter - Updates the stats of the column identity */
     void setColumnStats(ColumnStatistics *newStats);
 
+    /* Getter - Returns the equivalence class of the column identity */
+    unsigned int getEquivalenceClass() const;
+
+    /* Setter - Changes the equivalence class of the column identity */
+    void setEquivalenceClass(unsigned int equivalenceClass);
+
     /* Inserts a new neighbor along with the related
      * join predicate to the lists of the class
      */
@@ -108,9 +119,6 @@ public:
     /* Compares the column identity to another column identities */
     int compare(ColumnIdentity *other) const;
 
-    /* Resets the counter of column IDs to zero */
-    static void resetIdCounter();
-
 };
 
 #endif
@@ -9,7 +9,8 @@ ColumnSubset::ColumnSubset(
     ColumnIdentity *firstColId,
     ColumnIdentity *neighborOfFirst,
     PredicatesParser *predBetweenTheTwo,
-    ColumnStatistics *subsetStats)
+    ColumnStatistics *subsetStats,
+    double joinCost)
 {
     /* We initialize the list of columns */
     columnIdentities = new List();
@@ -23,11 +24,12 @@ ColumnSubset::ColumnSubset(
     /* We initialize the statistics of the subset */
     this->subsetStats = subsetStats;
 
-    /* We initialize the cost to the estimated
-     * number of tuples of the intermediate result
-     * of join between the two given columns
+    /* We initialize the cost to the given cost of the join between the
+     * two given columns or else to the estimated number of tuples of
+     * the intermediate result of that join
      */
-    totalCost = subsetStats->getElementsNum();
+    totalCost = (joinCost >= 0) ? (unsigned long long) joinCost
+        : subsetStats->getElementsNum();
 }
 
 /***************
@@ -38,7 +40,8 @@ ColumnSubset::ColumnSubset(
     ColumnSubset *existingSubset,
     ColumnIdentity *nextColId,
     PredicatesParser *predBetweenLastAndNext,
-    ColumnStatistics *newStats)
+    ColumnStatistics *newStats,
+    double joinCost)
 {
     /* We initialize the list of columns */
     columnIdentities = new List();
@@ -54,9 +57,11 @@ ColumnSubset::ColumnSubset(
     this->subsetStats = newStats;
 
     /* The cost of the new subset is the cost of the previously existing subset plus
-     * the cost of the intermediate result of join between the subset and 'nextColId'
+     * the cost of the join between the subset and 'nextColId', which is the given
+     * cost or else the estimated number of tuples of its intermediate result
      */
-    totalCost = existingSubset->totalCost + newStats->getElementsNum();
+    totalCost = existingSubset->totalCost + ((joinCost >= 0)
+        ? (unsigned long long) joinCost : newStats->getElementsNum());
 }
 
 /**************
@@ -18,7 +18,9 @@ private:
      */
     ColumnStatistics *subsetStats;
 
-    /* The number of tuples of the intermediate result */
+    /* The estimated cost of all the joins that produce the
+     * intermediate result (by default, the sum of their tuples)
+     */
     unsigned long long totalCost;
 
     /* Returns 'true' if the given column identity exists in the subset */
@@ -26,20 +28,26 @@ private:
 
 public:
 
-    /* Constructor */
+    /* Constructor - The cost of the join between the two columns is
+     * the amount of tuples it produces, unless another cost is given
+     */
     ColumnSubset(
         ColumnIdentity *firstColId,
         ColumnIdentity *neighborOfFirst,
         PredicatesParser *predBetweenTheTwo,
-        ColumnStatistics *subsetStats
+        ColumnStatistics *subsetStats,
+        double joinCost = -1
     );
 
-    /* Constructor */
+    /* Constructor - The cost of the join between the subset and the column
+     * is the amount of tuples it produces, unless another cost is given
+     */
     ColumnSubset(
         ColumnSubset *existingSubset,
         ColumnIdentity *nextColId,
         PredicatesParser *predBetweenLastAndNext,
-        ColumnStatistics *newStats
+        ColumnStatistics *newStats,
+        double joinCost = -1
     );
 
     /* Destructor */
@@ -0,0 +1,556 @@
+#include <iostream>
+#include "CostModel.h"
+#include "PartitionedHashJoin.h"
+#include "RowIdPair.h"
+
+/* The default costs per tuple of the operators in nanoseconds */
+#define DEFAULT_SCAN_COST 2.0
+#define DEFAULT_FILTER_COST 2.0
+#define DEFAULT_PARTITION_COST 10.0
+#define DEFAULT_BUILD_COST 60.0
+#define DEFAULT_PROBE_COST 80.0
+#define DEFAULT_MATERIALIZE_COST 40.0
+
+/* The default cost of creating a hash table in nanoseconds */
+#define DEFAULT_HASH_TABLE_COST 10000.0
+
+/**************************************************
+ * Compares the user data of two tuples, which is *
+ *        an integer in both of the tuples        *
+ **************************************************/
+
+static int compareTupleIntegers(void *item1, void *item2)
+{
+    unsigned long long integer1 = *((unsigned long long *) ((Tuple *) item1)->getItem());
+    unsigned long long integer2 = *((unsigned long long *) ((Tuple *) item2)->getItem());
+
+    if(integer1 > integer2)
+        return 1;
+
+    if(integer1 < integer2)
+        return -1;
+
+    return 0;
+}
+
+/******************************************************
+ * Hashes a tuple like the partitioned hash join does *
+ ******************************************************/
+
+static unsigned int hashTupleInteger(void *item)
+{
+    return (unsigned int) *((unsigned long long *) ((Tuple *) item)->getItem());
+}
+
+/*******************************************
+ * Frees the allocated memory for the pair *
+ *******************************************/
+
+static void deleteRowIdPair(void *item)
+{
+    delete (RowIdPair *) item;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+CostModel::CostModel(PartitionedHashJoinInput *joinParameters, long lvl2CacheSize)
+{
+    /* We start with the default costs per tuple of the operators */
+    scanCostPerTuple = DEFAULT_SCAN_COST;
+    filterCostPerTuple = DEFAULT_FILTER_COST;
+    partitionCostPerTuple = DEFAULT_PARTITION_COST;
+    buildCostPerTuple = DEFAULT_BUILD_COST;
+    probeCostPerTuple = DEFAULT_PROBE_COST;
+    materializeCostPerTuple = DEFAULT_MATERIALIZE_COST;
+    hashTableCost = DEFAULT_HASH_TABLE_COST;
+
+    /* We keep the parameters of the joins that affect their cost */
+    bitsNumForHashing = joinParameters->bitsNumForHashing;
+    bitsPerPass = DEFAULT_BITS_PER_PASS;
+
+    /* The tuned partitions depend on the sizes of the inputs, which are
+     * only estimated, so we assume every partition uses as many bits as
+     * the TLB can reach
+     */
+    if(joinParameters->autoTunedPartitioning)
+    {
+        bitsNumForHashing = CacheHierarchy::getInstance()->getMaxBitsPerPass();
+        bitsPerPass = bitsNumForHashing;
+    }
+    maxPartitionDepth = joinParameters->maxPartitionDepth;
+    hopscotchRange = joinParameters->hopscotchRange;
+    resizableByLoadFactor = joinParameters->resizableByLoadFactor;
+    loadFactor = joinParameters->loadFactor;
+
+    /* If the size of the level-2 cache is not given, we take it
+     * from the system like the partitioned hash join does
+     */
+    if(lvl2CacheSize <= 0)
+        lvl2CacheSize = CacheHierarchy::getInstance()->getLvl2CacheSize();
+
+    /* A relation needs no partition if its tuples fit
+     * the part of the cache that may be used
+     */
+    maxTuplesWithoutPartition = ((double) lvl2CacheSize)
+        * joinParameters->maxAllowedSizeModifier / sizeof(Tuple);
+}
+
+/**************
+ * Destructor *
+ **************/
+
+CostModel::~CostModel() {}
+
+/**********************************************************
+ * Returns the elapsed nanoseconds since the given moment *
+ **********************************************************/
+
+double CostModel::getElapsedNanoseconds(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return ((double) (end.tv_sec - start->tv_sec)) * 1000000000.0
+        + ((double) (end.tv_nsec - start->tv_nsec));
+}
+
+/*************************************************************
+ * Measures the cost per tuple of every operator on the host *
+ *************************************************************/
+
+void CostModel::calibrate()
+{
+    /* Helper variables for counting */
+    unsigned int i, round, bucket;
+
+    /* The integers of the relation are distinct, so every
+     * probe finds exactly one tuple in the hash table
+     */
+    unsigned long long *integers = new unsigned long long[CALIBRATION_TUPLES];
+
+    for(i = 0; i < CALIBRATION_TUPLES; i++)
+        integers[i] = (i * 2654435761ULL) % 4294967291ULL;
+
+    /* The relation, its partitioned form and the selected row IDs */
+    Tuple *tuples = new Tuple[CALIBRATION_TUPLES];
+    Tuple *partitionedTuples = new Tuple[CALIBRATION_TUPLES];
+    unsigned int *selectedRowIds = new unsigned int[CALIBRATION_TUPLES];
+
+    /* The histogram and the prefix sum of the partition */
+    unsigned int bucketsNum = 1U << bitsNumForHashing;
+    unsigned int *histogram = new unsigned int[bucketsNum];
+    unsigned int *prefixSum = new unsigned int[bucketsNum];
+
+    /* The hash table of every bucket */
+    HashTable **hashTables = new HashTable *[bucketsNum];
+
+    /* The fastest time of each operator among all the rounds */
+    double scanTime = -1, filterTime = -1, partitionTime = -1;
+    double buildTime = -1, probeTime = -1, materializeTime = -1, tablesTime = -1;
+    double elapsed;
+
+    struct timespec start;
+
+    /* We measure each operator a few times and keep the fastest
+     * time, so the first touches of the memory are not measured
+     */
+    for(round = 0; round < CALIBRATION_ROUNDS; round++)
+    {
+        /* Scan: Every row of a column is read in a tuple */
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(i = 0; i < CALIBRATION_TUPLES; i++)
+        {
+            tuples[i].setItem(&integers[i]);
+            tuples[i].setRowId(i);
+        }
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(scanTime < 0 || elapsed < scanTime)
+            scanTime = elapsed;
+
+        /* Filter: The row IDs of the rows that satisfy a filter are kept */
+        unsigned int selectedNum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(i = 0; i < CALIBRATION_TUPLES; i++)
+        {
+            if(integers[i] < 2147483648ULL)
+                selectedRowIds[selectedNum++] = i;
+        }
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(filterTime < 0 || elapsed < filterTime)
+            filterTime = elapsed;
+
+        /* Partition: The histogram of the tuples is built and
+         * then every tuple is moved to the position of its bucket
+         */
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(i = 0; i < bucketsNum; i++)
+            histogram[i] = 0;
+
+        for(i = 0; i < CALIBRATION_TUPLES; i++)
+            histogram[PartitionedHashJoin::bitReductionHash(integers[i], bitsNumForHashing)]++;
+
+        prefixSum[0] = 0;
+
+        for(i = 1; i < bucketsNum; i++)
+            prefixSum[i] = prefixSum[i - 1] + histogram[i - 1];
+
+        for(i = 0; i < CALIBRATION_TUPLES; i++)
+        {
+            bucket = PartitionedHashJoin::bitReductionHash(
+                integers[i], bitsNumForHashing);
+
+            partitionedTuples[prefixSum[bucket]++] = tuples[i];
+        }
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(partitionTime < 0 || elapsed < partitionTime)
+            partitionTime = elapsed;
+
+        /* Like in the partitioned hash join, a hash table with exactly
+         * enough buckets for its tuples is created for every bucket of
+         * the partition. We measure the creation of the tables apart from
+         * the insertions, because it only depends on the amount of tuples.
+         */
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(bucket = 0; bucket < bucketsNum; bucket++)
+        {
+            hashTables[bucket] = new HashTable(
+                HashTable::getExactSize(histogram[bucket], loadFactor),
+                resizableByLoadFactor, loadFactor, hopscotchRange);
+        }
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(tablesTime < 0 || elapsed < tablesTime)
+            tablesTime = elapsed;
+
+        /* Build: The tuples of every bucket are inserted in its hash table.
+         * After the partition, the prefix sum of each bucket points to the
+         * end of the bucket.
+         */
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(bucket = 0; bucket < bucketsNum; bucket++)
+        {
+            for(i = prefixSum[bucket] - histogram[bucket]; i < prefixSum[bucket]; i++)
+            {
+                hashTables[bucket]->insert(&partitionedTuples[i],
+                    &partitionedTuples[i], hashTupleInteger, compareTupleIntegers);
+            }
+        }
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(buildTime < 0 || elapsed < buildTime)
+            buildTime = elapsed;
+
+        /* Probe: Every tuple is searched in the hash table of its bucket */
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(bucket = 0; bucket < bucketsNum; bucket++)
+        {
+            for(i = prefixSum[bucket] - histogram[bucket]; i < prefixSum[bucket]; i++)
+            {
+                List *matchingKeys = hashTables[bucket]->bulkSearchKeys(
+                    &partitionedTuples[i], hashTupleInteger, compareTupleIntegers);
+
+                HashTable::terminateBulkSearchList(matchingKeys);
+            }
+        }
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(probeTime < 0 || elapsed < probeTime)
+            probeTime = elapsed;
+
+        for(bucket = 0; bucket < bucketsNum; bucket++)
+            delete hashTables[bucket];
+
+        /* Materialize: A pair of row IDs is kept for every result */
+        List *result = new List();
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for(i = 0; i < CALIBRATION_TUPLES; i++)
+            result->insertLast(new RowIdPair(i, partitionedTuples[i].getRowId()));
+
+        elapsed = getElapsedNanoseconds(&start);
+
+        if(materializeTime < 0 || elapsed < materializeTime)
+            materializeTime = elapsed;
+
+        result->traverseFromHead(deleteRowIdPair);
+        delete result;
+    }
+
+    /* We free the allocated memory for the calibration */
+    delete[] hashTables;
+    delete[] prefixSum;
+    delete[] histogram;
+    delete[] selectedRowIds;
+    delete[] partitionedTuples;
+    delete[] tuples;
+    delete[] integers;
+
+    /* The cost per tuple of each operator is its fastest time per tuple */
+    setCostsPerTuple(
+        scanTime / CALIBRATION_TUPLES,
+        filterTime / CALIBRATION_TUPLES,
+        partitionTime / CALIBRATION_TUPLES,
+        buildTime / CALIBRATION_TUPLES,
+        probeTime / CALIBRATION_TUPLES,
+        materializeTime / CALIBRATION_TUPLES
+    );
+
+    hashTableCost = tablesTime / bucketsNum;
+}
+
+/*************************************************************
+ * Setter - Changes the costs per tuple of all the operators *
+ *************************************************************/
+
+void CostModel::setCostsPerTuple(double scanCost, double filterCost,
+    double partitionCost, double buildCost, double probeCost,
+    double materializeCost)
+{
+    scanCostPerTuple = scanCost;
+    filterCostPerTuple = filterCost;
+    partitionCostPerTuple = partitionCost;
+    buildCostPerTuple = buildCost;
+    probeCostPerTuple = probeCost;
+    materializeCostPerTuple = materializeCost;
+}
+
+/********************************************
+ * Getter - Returns the scan cost per tuple *
+ ********************************************/
+
+double CostModel::getScanCostPerTuple() const
+{
+    return scanCostPerTuple;
+}
+
+/**********************************************
+ * Getter - Returns the filter cost per tuple *
+ **********************************************/
+
+double CostModel::getFilterCostPerTuple() const
+{
+    return filterCostPerTuple;
+}
+
+/*************************************************
+ * Getter - Returns the partition cost per tuple *
+ *************************************************/
+
+double CostModel::getPartitionCostPerTuple() const
+{
+    return partitionCostPerTuple;
+}
+
+/*********************************************
+ * Getter - Returns the build cost per tuple *
+ *********************************************/
+
+double CostModel::getBuildCostPerTuple() const
+{
+    return buildCostPerTuple;
+}
+
+/*********************************************
+ * Getter - Returns the probe cost per tuple *
+ *********************************************/
+
+double CostModel::getProbeCostPerTuple() const
+{
+    return probeCostPerTuple;
+}
+
+/***************************************************
+ * Getter - Returns the materialize cost per tuple *
+ ***************************************************/
+
+double CostModel::getMaterializeCostPerTuple() const
+{
+    return materializeCostPerTuple;
+}
+
+/********************************************************************
+ * Setter - Changes the cost of creating the hash table of a bucket *
+ ********************************************************************/
+
+void CostModel::setHashTableCost(double hashTableCost)
+{
+    this->hashTableCost = hashTableCost;
+}
+
+/********************************************************************
+ * Getter - Returns the cost of creating the hash table of a bucket *
+ ********************************************************************/
+
+double CostModel::getHashTableCost() const
+{
+    return hashTableCost;
+}
+
+/***************************************************************
+ * Returns how many times the partitioned hash join partitions *
+ *         two inputs with the given amounts of tuples         *
+ ***************************************************************/
+
+unsigned int CostModel::getPartitionPasses(double leftTuples,
+    double rightTuples) const
+{
+    /* The inputs are partitioned as long as the larger of their buckets
+     * does not fit the cache and the maximum depth is not reached
+     */
+    double largestBucket = (leftTuples > rightTuples) ? leftTuples : rightTuples;
+    unsigned int bitsNum = bitsNumForHashing;
+    unsigned int passes = 0;
+
+    while(passes < maxPartitionDepth && largestBucket > maxTuplesWithoutPartition)
+    {
+        largestBucket /= (double) (1ULL << bitsNum);
+        passes++;
+
+        /* Like the partitioned hash join, every deeper partition
+         * splits each bucket with 'bitsPerPass' more bits
+         */
+        bitsNum = bitsPerPass;
+    }
+
+    return passes;
+}
+
+/*********************************************************
+ * Returns the amount of buckets the inputs are split in *
+ *         after the given amount of partitions          *
+ *********************************************************/
+
+double CostModel::getBucketsNum(unsigned int passes) const
+{
+    double bucketsNum = 1;
+    unsigned int bitsNum = bitsNumForHashing;
+
+    /* Every partition splits each bucket in as many buckets as the
+     * values of its bits for hashing (the deeper partitions only add
+     * 'bitsPerPass' bits to the bits of the previous one)
+     */
+    for(unsigned int i = 0; i < passes; i++)
+    {
+        bucketsNum *= (double) (1ULL << bitsNum);
+        bitsNum = bitsPerPass;
+    }
+
+    return bucketsNum;
+}
+
+/******************************************************
+ * Returns the cost of reading the tuples of a column *
+ ******************************************************/
+
+double CostModel::estimateScanCost(double tuples) const
+{
+    return tuples * scanCostPerTuple;
+}
+
+/*******************************************************
+ * Returns the cost of applying a filter to the tuples *
+ *******************************************************/
+
+double CostModel::estimateFilterCost(double tuples) const
+{
+    return tuples * filterCostPerTuple;
+}
+
+/*********************************************************
+ * Returns the cost of partitioning the tuples the given *
+ *                    amount of times                    *
+ *********************************************************/
+
+double CostModel::estimatePartitionCost(double tuples, unsigned int passes) const
+{
+    return tuples * passes * partitionCostPerTuple;
+}
+
+/*************************************************************
+ * Returns the cost of building a hash table from the tuples *
+ *************************************************************/
+
+double CostModel::estimateBuildCost(double tuples, double hashTablesNum) const
+{
+    return hashTablesNum * hashTableCost + tuples * buildCostPerTuple;
+}
+
+/********************************************************
+ * Returns the cost of probing a hash table with tuples *
+ ********************************************************/
+
+double CostModel::estimateProbeCost(double tuples) const
+{
+    return tuples * probeCostPerTuple;
+}
+
+/**********************************************************
+ * Returns the cost of keeping the row IDs of the results *
+ **********************************************************/
+
+double CostModel::estimateMaterializeCost(double tuples) const
+{
+    return tuples * materializeCostPerTuple;
+}
+
+/*********************************************************
+ * Returns the estimated cost of reading a relation with *
+ *       the given tuples and applying its filters       *
+ *********************************************************/
+
+double CostModel::estimateRelationCost(double tuples, unsigned int filtersNum) const
+{
+    return estimateScanCost(tuples) + filtersNum * estimateFilterCost(tuples);
+}
+
+/*********************************************************
+ * Returns the estimated cost of a hash join between two *
+ *    inputs that produces the given amount of tuples    *
+ *********************************************************/
+
+double CostModel::estimateJoinCost(double leftTuples, double rightTuples,
+    double resultTuples) const
+{
+    /* The hash table is built from the smaller input
+     * and it is probed with the tuples of the larger one
+     */
+    double buildTuples = (leftTuples < rightTuples) ? leftTuples : rightTuples;
+    double probeTuples = (leftTuples < rightTuples) ? rightTuples : leftTuples;
+
+    /* Both inputs are read in tuples and partitioned
+     * the same amount of times before the hash tables
+     * of their buckets are built and probed
+     */
+    unsigned int passes = getPartitionPasses(leftTuples, rightTuples);
+
+    /* A hash table is created for every bucket of the smaller input,
+     * but no input has more non-empty buckets than tuples
+     */
+    double hashTablesNum = getBucketsNum(passes);
+
+    if(hashTablesNum > buildTuples)
+        hashTablesNum = (buildTuples > 1) ? buildTuples : 1;
+
+    return estimateScanCost(leftTuples + rightTuples)
+        + estimatePartitionCost(leftTuples + rightTuples, passes)
+        + estimateBuildCost(buildTuples, hashTablesNum)
+        + estimateProbeCost(probeTuples)
+        + estimateMaterializeCost(resultTuples);
+}
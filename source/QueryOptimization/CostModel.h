@@ -0,0 +1,125 @@
+#ifndef _COST_MODEL_H_
+#define _COST_MODEL_H_
+
+#include <ctime>
+#include "PartitionedHashJoinInput.h"
+#include "CostModelType.h"
+
+/* The amount of tuples each operator processes in the calibration */
+#define CALIBRATION_TUPLES 16384
+
+/* The amount of times each operator is measured in the calibration */
+#define CALIBRATION_ROUNDS 3
+
+/* Estimates the time (in nanoseconds) a plan needs to be executed.
+ *
+ * Every operator that takes part in a join order has its own formula,
+ * which is the amount of tuples it processes multiplied by its cost per
+ * tuple. A hash join between two inputs reads both of them in tuples,
+ * partitions both of them as many times as the partitioned hash join
+ * would (which depends on whether the larger input fits the part of the
+ * level-2 cache that may be used and on the maximum partition depth),
+ * creates a hash table for every bucket, builds the hash tables from the
+ * smaller input, probes them with the larger one and materializes the
+ * pairs of row IDs of the result.
+ *
+ * The costs per tuple have default values, may be set by the user or
+ * may be measured on the host by running every operator on a small
+ * relation with the same structures the partitioned hash join uses.
+ */
+class CostModel {
+
+private:
+
+    /* The costs per tuple of every operator in nanoseconds */
+    double scanCostPerTuple;
+    double filterCostPerTuple;
+    double partitionCostPerTuple;
+    double buildCostPerTuple;
+    double probeCostPerTuple;
+    double materializeCostPerTuple;
+
+    /* The cost of creating the (empty) hash table of a bucket */
+    double hashTableCost;
+
+    /* The maximum amount of tuples a relation may have
+     * so that it does not need to be partitioned
+     */
+    double maxTuplesWithoutPartition;
+
+    /* The parameters of the partitioned hash join */
+    unsigned int bitsNumForHashing;
+    unsigned int bitsPerPass;
+    unsigned int maxPartitionDepth;
+    unsigned int hopscotchRange;
+    bool resizableByLoadFactor;
+    double loadFactor;
+
+    /* Returns the elapsed nanoseconds since the given moment */
+    static double getElapsedNanoseconds(const struct timespec *start);
+
+public:
+
+    /* Constructor - Creates a model with the default costs per tuple for
+     * joins with the given parameters. If the size of the level-2 cache
+     * is not given, it is read from the system.
+     */
+    CostModel(PartitionedHashJoinInput *joinParameters, long lvl2CacheSize = 0);
+
+    /* Destructor */
+    ~CostModel();
+
+    /* Measures the cost per tuple of every operator on the host */
+    void calibrate();
+
+    /* Setter - Changes the costs per tuple of all the operators */
+    void setCostsPerTuple(double scanCost, double filterCost,
+        double partitionCost, double buildCost, double probeCost,
+        double materializeCost);
+
+    /* Setter - Changes the cost of creating the hash table of a bucket */
+    void setHashTableCost(double hashTableCost);
+
+    /* Getters - Return the cost per tuple of each operator */
+    double getScanCostPerTuple() const;
+    double getFilterCostPerTuple() const;
+    double getPartitionCostPerTuple() const;
+    double getBuildCostPerTuple() const;
+    double getProbeCostPerTuple() const;
+    double getMaterializeCostPerTuple() const;
+
+    /* Getter - Returns the cost of creating the hash table of a bucket */
+    double getHashTableCost() const;
+
+    /* Returns how many times the partitioned hash join partitions
+     * two inputs with the given amounts of tuples
+     */
+    unsigned int getPartitionPasses(double leftTuples, double rightTuples) const;
+
+    /* Returns the amount of buckets the inputs are
+     * split in after the given amount of partitions
+     */
+    double getBucketsNum(unsigned int passes) const;
+
+    /* The formulas of the operators, given the tuples they process */
+    double estimateScanCost(double tuples) const;
+    double estimateFilterCost(double tuples) const;
+    double estimatePartitionCost(double tuples, unsigned int passes) const;
+    double estimateBuildCost(double tuples, double hashTablesNum = 1) const;
+    double estimateProbeCost(double tuples) const;
+    double estimateMaterializeCost(double tuples) const;
+
+    /* Returns the estimated cost of reading a relation
+     * with the given tuples and applying its filters
+     */
+    double estimateRelationCost(double tuples, unsigned int filtersNum) const;
+
+    /* Returns the estimated cost of a hash join between two
+     * inputs that produces the given amount of tuples
+     */
+    double estimateJoinCost(double leftTuples, double rightTuples,
+        double resultTuples) const;
+
+};
+
+#endif
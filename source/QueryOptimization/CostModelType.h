@@ -0,0 +1,26 @@
+#ifndef _COST_MODEL_TYPE_H_
+#define _COST_MODEL_TYPE_H_
+
+/* An enumeration with all the ways the cost of a join order may be estimated */
+
+enum CostModelType {
+
+    /* The cost of a join order is the sum of the estimated
+     * tuples of all the intermediate results it produces
+     */
+    CardinalityCostModel,
+
+    /* The cost of a join order is the estimated time of the scans, the
+     * filters, the partitions, the builds, the probes and the
+     * materializations it performs with default costs per tuple
+     */
+    OperatorCostModel,
+
+    /* As above, but the costs per tuple of the operators are
+     * measured on the host when the program starts
+     */
+    CalibratedCostModel
+
+};
+
+#endif
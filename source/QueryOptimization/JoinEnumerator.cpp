@@ -0,0 +1,530 @@
+#include <iostream>
+#include "JoinEnumerator.h"
+
+/***************************************************
+ * Returns the mask of the relation with the alias *
+ ***************************************************/
+
+static unsigned long long relationMask(unsigned int relation)
+{
+    return 1ULL << relation;
+}
+
+/*************************************************************
+ * Returns the relations with an alias smaller than or equal *
+ *               to the alias of the relation                *
+ *************************************************************/
+
+static unsigned long long relationsUpTo(unsigned int relation)
+{
+    return (relationMask(relation) << 1) - 1;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+JoinEnumerator::JoinEnumerator(unsigned int relationsNum,
+    unsigned int maxPredicatesNum, const CostModel *costModel)
+{
+    /* Helper variable for counting */
+    unsigned long long i;
+
+    /* We store the amount of relations and initially they have no neighbors */
+    this->relationsNum = relationsNum;
+    neighbors = new unsigned long long[relationsNum];
+    relationSizes = new double[relationsNum];
+    relationCosts = new double[relationsNum];
+
+    for(i = 0; i < relationsNum; i++)
+    {
+        neighbors[i] = 0;
+        relationSizes[i] = 0;
+        relationCosts[i] = 0;
+    }
+
+    /* We keep the model that will estimate the cost of each join */
+    this->costModel = costModel;
+
+    /* We allocate space for the predicates that will be inserted */
+    this->maxPredicatesNum = maxPredicatesNum;
+    predicatesNum = 0;
+    predicates = new PredicatesParser *[maxPredicatesNum];
+    selectivities = new double[maxPredicatesNum];
+    equivalenceClasses = new unsigned int[maxPredicatesNum];
+    predicateLeftRelations = new unsigned int[maxPredicatesNum];
+    predicateRightRelations = new unsigned int[maxPredicatesNum];
+
+    /* Initially every alias is a relation by itself */
+    relationOfAlias = NULL;
+    aliasesNum = 0;
+
+    /* There is one entry in the tables of the best plans for every subset
+     * of the relations. Initially no subset of relations has a plan.
+     */
+    unsigned long long setsNum = relationMask(relationsNum);
+
+    planSizes = new double[setsNum];
+    planCosts = new double[setsNum];
+    planLeftSets = new unsigned long long[setsNum];
+
+    for(i = 0; i < setsNum; i++)
+    {
+        planSizes[i] = 0;
+        planCosts[i] = -1;
+        planLeftSets[i] = 0;
+    }
+}
+
+/**************
+ * Destructor *
+ **************/
+
+JoinEnumerator::~JoinEnumerator()
+{
+    delete[] planLeftSets;
+    delete[] planCosts;
+    delete[] planSizes;
+    delete[] relationOfAlias;
+    delete[] predicateRightRelations;
+    delete[] predicateLeftRelations;
+    delete[] equivalenceClasses;
+    delete[] selectivities;
+    delete[] predicates;
+    delete[] relationCosts;
+    delete[] relationSizes;
+    delete[] neighbors;
+}
+
+/****************************************************************
+ * Setter - Sets the estimated amount of tuples of the relation *
+ ****************************************************************/
+
+void JoinEnumerator::setRelationSize(unsigned int relation, double relationSize)
+{
+    relationSizes[relation] = relationSize;
+}
+
+/**************************************************************************
+ * Setter - Sets the estimated cost of reading and filtering the relation *
+ **************************************************************************/
+
+void JoinEnumerator::setRelationCost(unsigned int relation, double relationCost)
+{
+    relationCosts[relation] = relationCost;
+}
+
+/**************************************************************************
+ * Setter - Makes each alias of the query belong to the given relation of *
+ *  the enumerator, so the aliases that have already been joined in the   *
+ *   same intermediate result form a single relation. It must be called   *
+ *                    before any predicate is inserted                    *
+ **************************************************************************/
+
+void JoinEnumerator::setRelationsOfAliases(unsigned int aliasesNum,
+    const unsigned int *relationOfAlias)
+{
+    delete[] this->relationOfAlias;
+
+    this->aliasesNum = aliasesNum;
+    this->relationOfAlias = new unsigned int[aliasesNum];
+
+    for(unsigned int i = 0; i < aliasesNum; i++)
+        this->relationOfAlias[i] = relationOfAlias[i];
+}
+
+/***************************************************************
+ * Returns the relation of the enumerator the alias belongs to *
+ ***************************************************************/
+
+unsigned int JoinEnumerator::getRelationOfAlias(unsigned int alias) const
+{
+    if(relationOfAlias == NULL || alias >= aliasesNum)
+        return alias;
+
+    return relationOfAlias[alias];
+}
+
+/************************************************************************
+ * Inserts a join predicate with its estimated selectivity. A predicate *
+ * between two columns of the same relation is applied to the relation  *
+ *             before it is joined with any other relation              *
+ ************************************************************************/
+
+void JoinEnumerator::insertPredicate(PredicatesParser *predicate,
+    double selectivity, unsigned int equivalenceClass)
+{
+    /* If there is no space for another predicate, we inform the user */
+    if(predicatesNum == maxPredicatesNum)
+    {
+        std::cout << "JoinEnumerator: Cannot insert more than "
+            << maxPredicatesNum << " predicates" << std::endl;
+
+        return;
+    }
+
+    /* We find the relations the two aliases of the predicate belong to */
+    unsigned int leftArray = getRelationOfAlias(predicate->getLeftArray());
+    unsigned int rightArray = getRelationOfAlias(predicate->getRightArray());
+
+    predicates[predicatesNum] = predicate;
+    selectivities[predicatesNum] = selectivity;
+    equivalenceClasses[predicatesNum] = equivalenceClass;
+    predicateLeftRelations[predicatesNum] = leftArray;
+    predicateRightRelations[predicatesNum] = rightArray;
+    predicatesNum++;
+
+    /* The two relations of the predicate become neighbors of each other */
+    if(leftArray != rightArray)
+    {
+        neighbors[leftArray] |= relationMask(rightArray);
+        neighbors[rightArray] |= relationMask(leftArray);
+    }
+}
+
+/***********************************************************************
+ * Returns the relations that are neighbors of any relation of the set *
+ ***********************************************************************/
+
+unsigned long long JoinEnumerator::getNeighborhood(unsigned long long relations) const
+{
+    unsigned long long neighborhood = 0;
+    unsigned long long remaining = relations;
+
+    /* We visit each relation of the set by its lowest set bit */
+    while(remaining != 0)
+    {
+        neighborhood |= neighbors[__builtin_ctzll(remaining)];
+        remaining &= remaining - 1;
+    }
+
+    /* The relations of the set are not neighbors of the set */
+    return neighborhood & ~relations;
+}
+
+/******************************************************************
+ * Returns 'true' if the inserted predicate at the given position *
+ *    joins a relation of one set with a relation of the other    *
+ ******************************************************************/
+
+bool JoinEnumerator::connectsSets(unsigned int predicate,
+    unsigned long long leftRelations, unsigned long long rightRelations) const
+{
+    unsigned long long leftMask = relationMask(predicateLeftRelations[predicate]);
+    unsigned long long rightMask = relationMask(predicateRightRelations[predicate]);
+
+    /* The predicate connects the two sets if each of its
+     * relations belongs to a different one of the sets
+     */
+    return ((leftMask & leftRelations) && (rightMask & rightRelations))
+        || ((leftMask & rightRelations) && (rightMask & leftRelations));
+}
+
+/*******************************************************
+ * Returns the product of the selectivities of all the *
+ *  predicates that connect the two sets of relations  *
+ *          (only one per equivalence class)           *
+ *******************************************************/
+
+double JoinEnumerator::getSelectivity(unsigned long long leftRelations,
+    unsigned long long rightRelations) const
+{
+    double selectivity = 1;
+
+    for(unsigned int i = 0; i < predicatesNum; i++)
+    {
+        if(!connectsSets(i, leftRelations, rightRelations))
+            continue;
+
+        /* If a more selective predicate of the same equivalence class (or an
+         * earlier one that is as selective) also connects the two sets, this
+         * predicate is implied by it and does not reduce the result further
+         */
+        bool implied = false;
+
+        for(unsigned int j = 0; j < predicatesNum && !implied; j++)
+        {
+            if(j == i || equivalenceClasses[i] == NO_EQUIVALENCE_CLASS
+            || equivalenceClasses[j] != equivalenceClasses[i])
+                continue;
+
+            if((selectivities[j] < selectivities[i]
+            || (selectivities[j] == selectivities[i] && j < i))
+            && connectsSets(j, leftRelations, rightRelations))
+                implied = true;
+        }
+
+        if(!implied)
+            selectivity *= selectivities[i];
+    }
+
+    return selectivity;
+}
+
+/**************************************************************
+ * Recursively enumerates the connected subgraphs that extend *
+ *  the given subgraph with neighbors that do not belong to   *
+ *                   the excluded relations                   *
+ **************************************************************/
+
+void JoinEnumerator::enumerateSubgraphs(unsigned long long subgraph,
+    unsigned long long excluded)
+{
+    /* We find the neighbors that may extend the subgraph */
+    unsigned long long neighborhood = getNeighborhood(subgraph) & ~excluded;
+
+    if(neighborhood == 0)
+        return;
+
+    /* Every non-empty subset of the neighbors extends the subgraph
+     * to a new connected subgraph. We visit the subsets in increasing
+     * order of their masks with the 'subset = (subset - set) & set' trick.
+     */
+    unsigned long long subset = 0;
+
+    while((subset = (subset - neighborhood) & neighborhood) != 0)
+        emitSubgraph(subgraph | subset);
+
+    /* Then we extend each new subgraph further, excluding all the
+     * current neighbors so that no subgraph is produced twice
+     */
+    while((subset = (subset - neighborhood) & neighborhood) != 0)
+        enumerateSubgraphs(subgraph | subset, excluded | neighborhood);
+}
+
+/****************************************************************
+ * Enumerates the connected complements of a connected subgraph *
+ ****************************************************************/
+
+void JoinEnumerator::emitSubgraph(unsigned long long subgraph)
+{
+    /* The complements may only consist of relations with an alias greater
+     * than the smallest alias of the subgraph, else each pair of subgraph
+     * and complement would also be produced in the reverse order
+     */
+    unsigned long long excluded = subgraph | relationsUpTo(__builtin_ctzll(subgraph));
+    unsigned long long neighborhood = getNeighborhood(subgraph) & ~excluded;
+
+    /* Each neighbor starts a complement, from the greatest alias to the smallest */
+    for(int relation = relationsNum - 1; relation >= 0; relation--)
+    {
+        unsigned long long complement = relationMask(relation);
+
+        if((complement & neighborhood) == 0)
+            continue;
+
+        emitSubgraphAndComplement(subgraph, complement);
+
+        /* The neighbors with smaller aliases have been (or will be) used to
+         * start their own complements, so they are excluded from this one
+         */
+        enumerateComplements(subgraph, complement,
+            excluded | (neighborhood & relationsUpTo(relation)));
+    }
+}
+
+/************************************************************
+ * Recursively enumerates the connected complements of the  *
+ * subgraph that extend the given complement with neighbors *
+ *                  that are not excluded                   *
+ ************************************************************/
+
+void JoinEnumerator::enumerateComplements(unsigned long long subgraph,
+    unsigned long long complement, unsigned long long excluded)
+{
+    /* We find the neighbors that may extend the complement */
+    unsigned long long neighborhood = getNeighborhood(complement) & ~excluded;
+
+    if(neighborhood == 0)
+        return;
+
+    /* Every non-empty subset of the neighbors extends the complement to a
+     * new connected complement, which is still connected to the subgraph
+     */
+    unsigned long long subset = 0;
+
+    while((subset = (subset - neighborhood) & neighborhood) != 0)
+        emitSubgraphAndComplement(subgraph, complement | subset);
+
+    /* Then we extend each new complement further */
+    while((subset = (subset - neighborhood) & neighborhood) != 0)
+        enumerateComplements(subgraph, complement | subset, excluded | neighborhood);
+}
+
+/*****************************************************************
+ * Compares the plan that joins the subgraph with its complement *
+ *  to the best plan of their union and keeps the cheapest one   *
+ *****************************************************************/
+
+void JoinEnumerator::emitSubgraphAndComplement(unsigned long long subgraph,
+    unsigned long long complement)
+{
+    unsigned long long relations = subgraph | complement;
+
+    /* We estimate the tuples of the join of the two sets */
+    double size = planSizes[subgraph] * planSizes[complement]
+        * getSelectivity(subgraph, complement);
+
+    /* The cost is the cost of both subtrees plus the cost of the new join,
+     * which is the new intermediate result if there is no cost model
+     */
+    double cost = planCosts[subgraph] + planCosts[complement] + ((costModel != NULL)
+        ? costModel->estimateJoinCost(planSizes[subgraph], planSizes[complement], size)
+        : size);
+
+    /* We keep the new plan if it is the first or the cheapest one */
+    if(planCosts[relations] < 0 || cost < planCosts[relations])
+    {
+        planSizes[relations] = size;
+        planCosts[relations] = cost;
+        planLeftSets[relations] = subgraph;
+    }
+}
+
+/***********************************************************
+ * Finds the best plan of every connected set of relations *
+ ***********************************************************/
+
+void JoinEnumerator::enumerate()
+{
+    /* The plan of a single relation is the relation itself, after the
+     * predicates between its own columns have been applied to it, and
+     * its cost is the cost of reading and filtering the relation
+     */
+    for(unsigned int relation = 0; relation < relationsNum; relation++)
+    {
+        unsigned long long mask = relationMask(relation);
+        double size = relationSizes[relation];
+
+        for(unsigned int i = 0; i < predicatesNum; i++)
+        {
+            if(predicateLeftRelations[i] == relation && predicateRightRelations[i] == relation)
+            {
+                size *= selectivities[i];
+            }
+        }
+
+        planSizes[mask] = size;
+        planCosts[mask] = relationCosts[relation];
+        planLeftSets[mask] = 0;
+    }
+
+    /* We start from each relation, from the greatest alias to the smallest,
+     * and enumerate the connected subgraphs that contain it and relations
+     * with greater aliases only. This order guarantees that the best plans
+     * of both parts of a pair are final before the pair is considered.
+     */
+    for(int relation = relationsNum - 1; relation >= 0; relation--)
+    {
+        emitSubgraph(relationMask(relation));
+        enumerateSubgraphs(relationMask(relation), relationsUpTo(relation));
+    }
+}
+
+/**********************************************************************
+ * Appends to the 'result' the predicates of the best plan of the set *
+ **********************************************************************/
+
+void JoinEnumerator::appendPlanPredicates(unsigned long long relations,
+    List *result) const
+{
+    unsigned int i;
+
+    /* Case the set consists of a single relation.
+     *
+     * We append the predicates between its own columns.
+     */
+    if(planLeftSets[relations] == 0)
+    {
+        unsigned int relation = __builtin_ctzll(relations);
+
+        for(i = 0; i < predicatesNum; i++)
+        {
+            if(predicateLeftRelations[i] == relation && predicateRightRelations[i] == relation)
+            {
+                result->insertLast(predicates[i]);
+            }
+        }
+
+        return;
+    }
+
+    /* Else we append the predicates of each subtree, so each subtree
+     * is built in an intermediate array of its own, and then the
+     * predicates that join the two subtrees together
+     */
+    unsigned long long leftRelations = planLeftSets[relations];
+    unsigned long long rightRelations = relations & ~leftRelations;
+
+    appendPlanPredicates(leftRelations, result);
+    appendPlanPredicates(rightRelations, result);
+
+    for(i = 0; i < predicatesNum; i++)
+    {
+        unsigned long long leftMask = relationMask(predicateLeftRelations[i]);
+        unsigned long long rightMask = relationMask(predicateRightRelations[i]);
+
+        if(((leftMask & leftRelations) && (rightMask & rightRelations))
+        || ((leftMask & rightRelations) && (rightMask & leftRelations)))
+        {
+            result->insertLast(predicates[i]);
+        }
+    }
+}
+
+/**************************************************************************
+ * Appends to the 'result' the inserted join predicates in the order they *
+ *  must be executed for the best plan of all the relations. If the join  *
+ *   graph is not connected, the best plans of the connected components   *
+ *                    are appended one after the other                    *
+ **************************************************************************/
+
+void JoinEnumerator::getJoinsOrder(List *result) const
+{
+    unsigned long long remaining = relationMask(relationsNum) - 1;
+
+    while(remaining != 0)
+    {
+        /* We grow the connected component of the
+         * remaining relation with the smallest alias
+         */
+        unsigned long long component = remaining & (~remaining + 1);
+        unsigned long long neighborhood;
+
+        while((neighborhood = getNeighborhood(component)) != 0)
+            component |= neighborhood;
+
+        /* We append the predicates of the best plan of the component */
+        appendPlanPredicates(component, result);
+
+        remaining &= ~component;
+    }
+}
+
+/**************************************************************************
+ * Returns the estimated cost of the best plan of the set of relations or *
+ *          a negative value if the relations are not connected           *
+ **************************************************************************/
+
+double JoinEnumerator::getPlanCost(unsigned long long relations) const
+{
+    return planCosts[relations];
+}
+
+/*************************************************************************
+ * Returns the estimated tuples of the best plan of the set of relations *
+ *************************************************************************/
+
+double JoinEnumerator::getPlanSize(unsigned long long relations) const
+{
+    return planSizes[relations];
+}
+
+/*************************************************************************
+ * Returns the relations of the left subtree of the best plan of the set *
+ *************************************************************************/
+
+unsigned long long JoinEnumerator::getPlanLeftSet(unsigned long long relations) const
+{
+    return planLeftSets[relations];
+}
@@ -0,0 +1,198 @@
+#ifndef _JOIN_ENUMERATOR_H_
+#define _JOIN_ENUMERATOR_H_
+
+#include "List.h"
+#include "PredicatesParser.h"
+#include "CostModel.h"
+
+/* The maximum amount of relations of a query for which the join orders are
+ * enumerated by the 'JoinEnumerator'. Its table of best plans has one entry
+ * for every subset of the relations, so it grows exponentially.
+ */
+#define MAX_ENUMERATED_RELATIONS 16
+
+/* The equivalence class of a join predicate whose columns
+ * are not known to be equal to the columns of any other
+ */
+#define NO_EQUIVALENCE_CLASS 0
+
+/* Finds the join tree (left-deep or bushy) of a query with the lowest
+ * estimated cost with the DPccp dynamic programming algorithm.
+ *
+ * Every set of relations is represented by a 64-bit mask, where bit 'i'
+ * is the relation with alias 'i'. Many aliases may also be treated as a
+ * single relation, when they have already been joined together. The best
+ * plan of each set is stored in flat tables indexed by the mask of the set.
+ * Only pairs of connected subgraphs with connected complements are
+ * enumerated, so no cartesian product is ever considered and no pair is
+ * considered twice.
+ *
+ * The join predicates between columns of the same equivalence class (all
+ * equal to each other) are not independent. When many of them connect two
+ * sets of relations, only the most selective one reduces the result.
+ *
+ * If no cost model is given, the cost of a plan is the sum of the estimated
+ * tuples of all the intermediate results it produces (the relations
+ * themselves cost 0). Else it is the estimated time of reading and filtering
+ * the relations and of all the hash joins of the plan.
+ */
+class JoinEnumerator {
+
+private:
+
+    /* The amount of relations taking part in the query */
+    unsigned int relationsNum;
+
+    /* The neighbors of each relation in the join graph as a mask */
+    unsigned long long *neighbors;
+
+    /* The estimated amount of tuples of each relation after the filters */
+    double *relationSizes;
+
+    /* The estimated cost of reading and filtering each relation */
+    double *relationCosts;
+
+    /* The model that estimates the cost of every join or 'NULL' if
+     * the cost of a join is the amount of tuples it produces
+     */
+    const CostModel *costModel;
+
+    /* The join predicates that were inserted in the enumerator */
+    PredicatesParser **predicates;
+
+    /* The estimated selectivity of each inserted join predicate */
+    double *selectivities;
+
+    /* The equivalence class of the columns of each inserted join predicate */
+    unsigned int *equivalenceClasses;
+
+    /* The relations of the left and the right side of each inserted predicate */
+    unsigned int *predicateLeftRelations;
+    unsigned int *predicateRightRelations;
+
+    /* The relation of each alias of the query or 'NULL' if
+     * every alias is a relation of the enumerator by itself
+     */
+    unsigned int *relationOfAlias;
+
+    /* The amount of aliases in 'relationOfAlias' */
+    unsigned int aliasesNum;
+
+    /* The amount of inserted join predicates and the maximum amount */
+    unsigned int predicatesNum;
+    unsigned int maxPredicatesNum;
+
+    /* The estimated tuples of the best plan of each set of relations */
+    double *planSizes;
+
+    /* The estimated cost of the best plan of each set of
+     * relations or a negative value if it has no plan yet
+     */
+    double *planCosts;
+
+    /* The relations of the left subtree of the best plan of each set of
+     * relations (the right subtree has the rest of them). It is 0 for
+     * the sets which consist of a single relation.
+     */
+    unsigned long long *planLeftSets;
+
+    /* Returns the relation of the enumerator the alias belongs to */
+    unsigned int getRelationOfAlias(unsigned int alias) const;
+
+    /* Returns the relations that are neighbors of any relation of the set */
+    unsigned long long getNeighborhood(unsigned long long relations) const;
+
+    /* Returns 'true' if the inserted predicate at the given position
+     * joins a relation of one set with a relation of the other
+     */
+    bool connectsSets(unsigned int predicate, unsigned long long leftRelations,
+        unsigned long long rightRelations) const;
+
+    /* Returns the product of the selectivities of all the predicates
+     * that connect the two sets of relations (one per equivalence class)
+     */
+    double getSelectivity(unsigned long long leftRelations,
+        unsigned long long rightRelations) const;
+
+    /* Recursively enumerates the connected subgraphs that extend the given
+     * subgraph with neighbors that do not belong to the excluded relations
+     */
+    void enumerateSubgraphs(unsigned long long subgraph,
+        unsigned long long excluded);
+
+    /* Enumerates the connected complements of a connected subgraph */
+    void emitSubgraph(unsigned long long subgraph);
+
+    /* Recursively enumerates the connected complements of the subgraph that
+     * extend the given complement with neighbors that are not excluded
+     */
+    void enumerateComplements(unsigned long long subgraph,
+        unsigned long long complement, unsigned long long excluded);
+
+    /* Compares the plan that joins the subgraph with its complement
+     * to the best plan of their union and keeps the cheapest one
+     */
+    void emitSubgraphAndComplement(unsigned long long subgraph,
+        unsigned long long complement);
+
+    /* Appends to the 'result' the predicates of the best plan of the set */
+    void appendPlanPredicates(unsigned long long relations, List *result) const;
+
+public:
+
+    /* Constructor - Creates an enumerator for the given amount of relations
+     * (at most 'MAX_ENUMERATED_RELATIONS') and join predicates, which
+     * estimates the costs of the joins with the given cost model
+     */
+    JoinEnumerator(unsigned int relationsNum, unsigned int maxPredicatesNum,
+        const CostModel *costModel = NULL);
+
+    /* Destructor */
+    ~JoinEnumerator();
+
+    /* Setter - Sets the estimated amount of tuples of the relation */
+    void setRelationSize(unsigned int relation, double relationSize);
+
+    /* Setter - Sets the estimated cost of reading and filtering the relation */
+    void setRelationCost(unsigned int relation, double relationCost);
+
+    /* Setter - Makes each alias of the query belong to the given relation
+     * of the enumerator, so the aliases that have already been joined in
+     * the same intermediate result form a single relation. It must be
+     * called before any predicate is inserted.
+     */
+    void setRelationsOfAliases(unsigned int aliasesNum,
+        const unsigned int *relationOfAlias);
+
+    /* Inserts a join predicate with its estimated selectivity and the
+     * equivalence class of its columns. A predicate between two columns
+     * of the same relation is applied to the relation before it is joined
+     * with any other relation.
+     */
+    void insertPredicate(PredicatesParser *predicate, double selectivity,
+        unsigned int equivalenceClass = NO_EQUIVALENCE_CLASS);
+
+    /* Finds the best plan of every connected set of relations */
+    void enumerate();
+
+    /* Appends to the 'result' the inserted join predicates in the order they
+     * must be executed for the best plan of all the relations. If the join
+     * graph is not connected, the best plans of the connected components
+     * are appended one after the other.
+     */
+    void getJoinsOrder(List *result) const;
+
+    /* Returns the estimated cost of the best plan of the set of relations
+     * or a negative value if the relations are not connected
+     */
+    double getPlanCost(unsigned long long relations) const;
+
+    /* Returns the estimated tuples of the best plan of the set of relations */
+    double getPlanSize(unsigned long long relations) const;
+
+    /* Returns the relations of the left subtree of the best plan of the set */
+    unsigned long long getPlanLeftSet(unsigned long long relations) const;
+
+};
+
+#endif
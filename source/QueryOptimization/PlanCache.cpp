@@ -0,0 +1,518 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include "PlanCache.h"
+#include "Table.h"
+
+/***************************************************************
+ * The maximum length of the shape of a single predicate, like *
+ *           "12.3=14.0" or "12.3<#17" for a filter            *
+ ***************************************************************/
+
+#define MAX_TOKEN_LENGTH 64
+
+/***************************
+ * Constructor of the plan *
+ ***************************/
+
+CachedPlan::CachedPlan(char *key, unsigned int predicatesNum,
+    unsigned long long statisticsVersion)
+{
+    this->key = key;
+    this->predicatesNum = predicatesNum;
+    this->statisticsVersion = statisticsVersion;
+
+    predicatePositions = new unsigned int[predicatesNum];
+    selectivities = NULL;
+}
+
+/**************************
+ * Destructor of the plan *
+ **************************/
+
+CachedPlan::~CachedPlan()
+{
+    delete[] predicatePositions;
+    delete[] selectivities;
+    delete[] key;
+}
+
+/*************************************
+ * Compares two keys of cached plans *
+ *          alphabetically           *
+ *************************************/
+
+int PlanCache::compareKeys(void *key1, void *key2)
+{
+    int result = strcmp((char *) key1, (char *) key2);
+
+    if(result > 0)
+        return 1;
+
+    if(result < 0)
+        return -1;
+
+    return 0;
+}
+
+/************************************************
+ * Compares two cached plans by their addresses *
+ ************************************************/
+
+int PlanCache::comparePlans(void *plan1, void *plan2)
+{
+    return (plan1 == plan2) ? 0 : 1;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+PlanCache::PlanCache(List *tables, unsigned int maxPlansNum,
+    CardinalityFeedback *feedback)
+{
+    this->tables = tables;
+    this->maxPlansNum = maxPlansNum;
+    this->feedback = feedback;
+
+    /* Initially no plan is cached */
+    plans = new RedBlackTree();
+    insertionOrder = new List();
+
+    hitsNum = 0;
+    missesNum = 0;
+
+    pthread_mutex_init(&mutex, NULL);
+}
+
+/**************
+ * Destructor *
+ **************/
+
+PlanCache::~PlanCache()
+{
+    /* We free every cached plan and then the structures themselves */
+    while(!insertionOrder->isEmpty())
+    {
+        delete (CachedPlan *) insertionOrder->getHead()->getItem();
+        insertionOrder->removeFront();
+    }
+
+    delete insertionOrder;
+    delete plans;
+
+    pthread_mutex_destroy(&mutex);
+}
+
+/*******************************************************************
+ * Returns the estimated fraction of the elements of a column with *
+ *  the given statistics that satisfy the filter, using the min &  *
+ *  max element and the amount of distinct elements of the column  *
+ *******************************************************************/
+
+double PlanCache::estimateFilterSelectivity(ColumnStatistics *stats,
+    char filterOperator, unsigned int filterValue)
+{
+    double l = stats->getMinElement();
+    double u = stats->getMaxElement();
+    double d = stats->getDistinctElementsNum();
+    double k = filterValue;
+
+    /* An empty column satisfies no filter */
+    if(stats->getElementsNum() == 0 || d == 0)
+        return 0;
+
+    switch(filterOperator)
+    {
+        /* Each distinct element is assumed to appear equally often */
+        case '=':
+            return (k < l || k > u) ? 0 : 1 / d;
+
+        /* The elements are assumed to be uniformly spread in [l, u] */
+        case '<':
+            if(k <= l)
+                return 0;
+
+            return (k > u) ? 1 : (k - l) / (u - l + 1);
+
+        case '>':
+            if(k >= u)
+                return 0;
+
+            return (k < l) ? 1 : (u - k) / (u - l + 1);
+
+        default:
+            return 1;
+    }
+}
+
+/***************************************************************
+ *  Returns the bucket of the selectivity. A zero selectivity  *
+ * has bucket 0 and each next bucket covers selectivities half *
+ *                  as large as the last one                   *
+ ***************************************************************/
+
+unsigned int PlanCache::getSelectivityBucket(double selectivity)
+{
+    if(selectivity <= 0)
+        return 0;
+
+    if(selectivity >= 1)
+        return 1;
+
+    /* The selectivities in (1/2, 1] have bucket 1, those in (1/4, 1/2]
+     * have bucket 2 and so on, up to a bucket for the tiniest ones
+     */
+    double bucket = 1 + floor(-log2(selectivity));
+
+    return (bucket > 64) ? 64 : (unsigned int) bucket;
+}
+
+/*************************************************************************
+ * Creates the shape of the query. The position of each predicate in the *
+ *   query is stored in 'normalizedPositions' in the sorted order. The   *
+ *        returned key must be deleted with 'delete[]' after use         *
+ *************************************************************************/
+
+char *PlanCache::createKey(Query *query, unsigned int *normalizedPositions) const
+{
+    List *relations = query->getRelations();
+    List *predicates = query->getPredicates();
+    unsigned int relationsNum = relations->getCounter();
+    unsigned int predicatesNum = predicates->getCounter();
+
+    /* Helper variables for counting */
+    unsigned int i, j;
+
+    /* We create the shape of each predicate */
+    char (*tokens)[MAX_TOKEN_LENGTH] = new char[predicatesNum][MAX_TOKEN_LENGTH];
+
+    Listnode *currentNode = predicates->getHead();
+
+    for(i = 0; i < predicatesNum; i++)
+    {
+        PredicatesParser *pred = (PredicatesParser *) currentNode->getItem();
+
+        unsigned int leftArray = pred->getLeftArray();
+        unsigned int leftColumn = pred->getLeftArrayColumn();
+
+        /* Case the predicate is a filter.
+         *
+         * Its constant is replaced by the bucket of its selectivity.
+         */
+        if(pred->hasConstant())
+        {
+            unsigned int realTable = *((unsigned int *) relations->getItemInPos(leftArray + 1));
+            Table *table = (Table *) tables->getItemInPos(realTable + 1);
+
+            double selectivity = estimateFilterSelectivity(
+                table->getColumnStatistics()[leftColumn],
+                pred->getFilterOperator(), pred->getFilterValue());
+
+            snprintf(tokens[i], MAX_TOKEN_LENGTH, "%u.%u%c#%u", leftArray, leftColumn,
+                pred->getFilterOperator(), getSelectivityBucket(selectivity));
+        }
+
+        /* Case the predicate is a join.
+         *
+         * We place the smaller side first, so the order of the sides does not matter.
+         */
+        else
+        {
+            unsigned int rightArray = pred->getRightArray();
+            unsigned int rightColumn = pred->getRightArrayColumn();
+
+            if(rightArray < leftArray || (rightArray == leftArray && rightColumn < leftColumn))
+            {
+                snprintf(tokens[i], MAX_TOKEN_LENGTH, "%u.%u=%u.%u",
+                    rightArray, rightColumn, leftArray, leftColumn);
+            }
+
+            else
+            {
+                snprintf(tokens[i], MAX_TOKEN_LENGTH, "%u.%u=%u.%u",
+                    leftArray, leftColumn, rightArray, rightColumn);
+            }
+        }
+
+        normalizedPositions[i] = i;
+        currentNode = currentNode->getNext();
+    }
+
+    /* We sort the positions of the predicates by their shapes (insertion
+     * sort, since a query has few predicates), keeping equal shapes in
+     * their order in the query
+     */
+    for(i = 1; i < predicatesNum; i++)
+    {
+        unsigned int position = normalizedPositions[i];
+
+        for(j = i; j > 0 && strcmp(tokens[normalizedPositions[j - 1]], tokens[position]) > 0; j--)
+            normalizedPositions[j] = normalizedPositions[j - 1];
+
+        normalizedPositions[j] = position;
+    }
+
+    /* The key is the real names of the relations followed by the sorted predicates */
+    unsigned int keyLength = (relationsNum + 1) * 12 + predicatesNum * (MAX_TOKEN_LENGTH + 1) + 1;
+    char *key = new char[keyLength];
+    unsigned int length = 0;
+
+    for(i = 0; i < relationsNum; i++)
+    {
+        length += snprintf(key + length, keyLength - length, "%u ",
+            *((unsigned int *) relations->getItemInPos(i + 1)));
+    }
+
+    length += snprintf(key + length, keyLength - length, "|");
+
+    for(i = 0; i < predicatesNum; i++)
+    {
+        length += snprintf(key + length, keyLength - length, "%s&",
+            tokens[normalizedPositions[i]]);
+    }
+
+    delete[] tokens;
+
+    return key;
+}
+
+/*****************************************************
+ * Returns the sum of the statistics versions of the *
+ * relations of the query and the version of the     *
+ *               cardinality feedback                *
+ *****************************************************/
+
+unsigned long long PlanCache::getStatisticsVersion(Query *query) const
+{
+    /* The versions only increase, so the sum changes if any of them changes */
+    unsigned long long version = 0;
+
+    List *relations = query->getRelations();
+
+    for(Listnode *current = relations->getHead(); current != NULL; current = current->getNext())
+    {
+        unsigned int realTable = *((unsigned int *) current->getItem());
+        version += ((Table *) tables->getItemInPos(realTable + 1))->getStatisticsVersion();
+    }
+
+    /* The join orders also depend on the corrections of the estimations */
+    if(feedback != NULL)
+        version += feedback->getVersion();
+
+    return version;
+}
+
+/******************************************************
+ * Removes the given plan from the cache and frees it *
+ ******************************************************/
+
+void PlanCache::removePlan(CachedPlan *plan)
+{
+    plans->remove(plan->key, compareKeys);
+    insertionOrder->removeKeyNode(plan, comparePlans);
+
+    delete plan;
+}
+
+/**************************************************************************
+ * Returns the predicates of the query in the order of the cached plan of *
+ * its shape or 'NULL' if there is no such plan with current statistics.  *
+ *  The returned list must be deleted with 'delete' after use. A copy of  *
+ *  the selectivities of the plan (if any) is stored in 'selectivities'   *
+ **************************************************************************/
+
+List *PlanCache::getPredicatesOrder(Query *query, double **selectivities)
+{
+    List *predicates = query->getPredicates();
+
+    /* We find the shape of the query and the versions of its statistics */
+    unsigned int *normalizedPositions = new unsigned int[predicates->getCounter()];
+    char *key = createKey(query, normalizedPositions);
+    unsigned long long statisticsVersion = getStatisticsVersion(query);
+
+    List *result = NULL;
+
+    if(selectivities != NULL)
+        *selectivities = NULL;
+
+    pthread_mutex_lock(&mutex);
+
+    CachedPlan *plan = (CachedPlan *) plans->searchItem(key, compareKeys);
+
+    /* If the plan was estimated with older statistics, it is not valid anymore */
+    if(plan != NULL && plan->statisticsVersion != statisticsVersion)
+    {
+        removePlan(plan);
+        plan = NULL;
+    }
+
+    /* We place the predicates of the query in the order of the plan */
+    if(plan != NULL)
+    {
+        result = new List();
+
+        for(unsigned int i = 0; i < plan->predicatesNum; i++)
+        {
+            unsigned int position = normalizedPositions[plan->predicatePositions[i]];
+            result->insertLast(predicates->getItemInPos(position + 1));
+        }
+
+        /* We copy the selectivities, because the plan may be dropped
+         * by another query while this one is still being executed
+         */
+        if(selectivities != NULL && plan->selectivities != NULL)
+        {
+            *selectivities = new double[plan->predicatesNum];
+
+            for(unsigned int i = 0; i < plan->predicatesNum; i++)
+                (*selectivities)[i] = plan->selectivities[i];
+        }
+
+        hitsNum++;
+    }
+
+    else
+    {
+        missesNum++;
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    delete[] key;
+    delete[] normalizedPositions;
+
+    return result;
+}
+
+/********************************************************************
+ *   Keeps the given order of the predicates of the query for the   *
+ * following queries with the same shape (replacing any older one), *
+ *  along with the given estimated selectivities of its predicates  *
+ ********************************************************************/
+
+void PlanCache::insertPredicatesOrder(Query *query, List *predicatesOrder,
+    const double *selectivities)
+{
+    if(maxPlansNum == 0)
+        return;
+
+    List *predicates = query->getPredicates();
+    unsigned int predicatesNum = predicates->getCounter();
+
+    /* The order must consist of predicates of the query. It may skip some
+     * of them (like the redundant filters and the implied joins that the
+     * query optimizer does not execute).
+     */
+    unsigned int orderLength = predicatesOrder->getCounter();
+
+    if(orderLength > predicatesNum)
+        return;
+
+    /* We find the shape of the query and the versions of its statistics */
+    unsigned int *normalizedPositions = new unsigned int[predicatesNum];
+    char *key = createKey(query, normalizedPositions);
+
+    CachedPlan *plan = new CachedPlan(key, orderLength, getStatisticsVersion(query));
+
+    /* We store each predicate of the order as its position in the sorted predicates */
+    unsigned int i = 0;
+
+    for(Listnode *current = predicatesOrder->getHead(); current != NULL; current = current->getNext())
+    {
+        /* We find the position of the predicate in the query */
+        unsigned int position = 0;
+        Listnode *queryNode = predicates->getHead();
+
+        while(queryNode != NULL && queryNode->getItem() != current->getItem())
+        {
+            queryNode = queryNode->getNext();
+            position++;
+        }
+
+        /* Then we find that position among the sorted positions */
+        unsigned int normalized = 0;
+
+        while(normalized < predicatesNum && normalizedPositions[normalized] != position)
+            normalized++;
+
+        /* If the predicate does not belong to the query, we do not cache the order */
+        if(normalized == predicatesNum)
+        {
+            delete plan;
+            delete[] normalizedPositions;
+            return;
+        }
+
+        plan->predicatePositions[i] = normalized;
+        i++;
+    }
+
+    delete[] normalizedPositions;
+
+    /* We keep the selectivities of the predicates in the same order */
+    if(selectivities != NULL)
+    {
+        plan->selectivities = new double[orderLength];
+
+        for(i = 0; i < orderLength; i++)
+            plan->selectivities[i] = selectivities[i];
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    /* We replace any plan with the same shape */
+    CachedPlan *existingPlan = (CachedPlan *) plans->searchItem(key, compareKeys);
+
+    if(existingPlan != NULL)
+        removePlan(existingPlan);
+
+    /* We evict the oldest plans if the cache is full */
+    while(insertionOrder->getCounter() >= maxPlansNum)
+        removePlan((CachedPlan *) insertionOrder->getHead()->getItem());
+
+    plans->insert(plan, plan->key, compareKeys);
+    insertionOrder->insertLast(plan);
+
+    pthread_mutex_unlock(&mutex);
+}
+
+/***********************************************
+ * Getter - Returns the amount of cached plans *
+ ***********************************************/
+
+unsigned int PlanCache::getPlansNum()
+{
+    pthread_mutex_lock(&mutex);
+    unsigned int plansNum = insertionOrder->getCounter();
+    pthread_mutex_unlock(&mutex);
+
+    return plansNum;
+}
+
+/*******************************************************************
+ * Getter - Returns the amount of queries that found a cached plan *
+ *******************************************************************/
+
+unsigned long long PlanCache::getHitsNum()
+{
+    pthread_mutex_lock(&mutex);
+    unsigned long long result = hitsNum;
+    pthread_mutex_unlock(&mutex);
+
+    return result;
+}
+
+/**************************************************************************
+ * Getter - Returns the amount of queries that did not find a cached plan *
+ **************************************************************************/
+
+unsigned long long PlanCache::getMissesNum()
+{
+    pthread_mutex_lock(&mutex);
+    unsigned long long result = missesNum;
+    pthread_mutex_unlock(&mutex);
+
+    return result;
+}
@@ -0,0 +1,150 @@
+#ifndef _PLAN_CACHE_H_
+#define _PLAN_CACHE_H_
+
+#include <pthread.h>
+#include "List.h"
+#include "Query.h"
+#include "RedBlackTree.h"
+#include "ColumnStatistics.h"
+#include "CardinalityFeedback.h"
+
+/* The join order that was chosen for a query template */
+class CachedPlan {
+
+public:
+
+    /* The normalized shape of the query template (see 'PlanCache') */
+    char *key;
+
+    /* The order of the predicates, where each predicate is
+     * given by its position in the normalized query
+     */
+    unsigned int *predicatePositions;
+
+    /* The amount of predicates of the order (which may skip
+     * the predicates of the query that are not executed)
+     */
+    unsigned int predicatesNum;
+
+    /* The estimated selectivity of every predicate of the order for the
+     * query the plan was chosen for ('NULL' if they were not given)
+     */
+    double *selectivities;
+
+    /* The version of the statistics the join order was estimated with */
+    unsigned long long statisticsVersion;
+
+    /* Constructor & Destructor */
+    CachedPlan(char *key, unsigned int predicatesNum,
+        unsigned long long statisticsVersion);
+    ~CachedPlan();
+
+};
+
+/* A cache of join orders keyed by the normalized shape of the queries.
+ *
+ * The shape of a query consists of its relations, its join predicates and
+ * the columns and operators of its filters without their constants. The
+ * predicates are sorted, so their order in the query does not matter.
+ * Instead of its constant, each filter contributes to the shape the bucket
+ * of its estimated selectivity, where every bucket covers selectivities
+ * that differ up to a factor of 2. So a query reuses the join order of a
+ * previous query with the same shape whose filters are about as selective.
+ *
+ * A cached join order is dropped once the statistics of any relation of
+ * the query or the corrections of the cardinality feedback (if any) change.
+ * When the cache is full, the oldest entry is evicted.
+ */
+class PlanCache {
+
+private:
+
+    /* The input tables, whose statistics are used for the estimations */
+    List *tables;
+
+    /* The corrections the join orders are estimated with ('NULL' if none) */
+    CardinalityFeedback *feedback;
+
+    /* The cached plans, keyed by the shape of their queries */
+    RedBlackTree *plans;
+
+    /* The cached plans in the order they were inserted */
+    List *insertionOrder;
+
+    /* The maximum amount of cached plans */
+    unsigned int maxPlansNum;
+
+    /* The amount of queries that found or did not find a plan */
+    unsigned long long hitsNum;
+    unsigned long long missesNum;
+
+    /* Guards the cached plans, so many queries can use the cache at once */
+    pthread_mutex_t mutex;
+
+    /* Creates the shape of the query. The position of each predicate in
+     * the query is stored in 'normalizedPositions' in the sorted order.
+     * The returned key must be deleted with 'delete[]' after use.
+     */
+    char *createKey(Query *query, unsigned int *normalizedPositions) const;
+
+    /* Returns the sum of the statistics versions of the relations
+     * of the query and the version of the cardinality feedback
+     */
+    unsigned long long getStatisticsVersion(Query *query) const;
+
+    /* Removes the given plan from the cache and frees it */
+    void removePlan(CachedPlan *plan);
+
+    /* Compares two keys of cached plans alphabetically */
+    static int compareKeys(void *key1, void *key2);
+
+    /* Compares two cached plans by their addresses */
+    static int comparePlans(void *plan1, void *plan2);
+
+public:
+
+    /* Constructor - Creates a cache of at most 'maxPlansNum' plans, which
+     * are dropped once the given cardinality feedback (if any) changes
+     */
+    PlanCache(List *tables, unsigned int maxPlansNum,
+        CardinalityFeedback *feedback = NULL);
+
+    /* Destructor */
+    ~PlanCache();
+
+    /* Returns the predicates of the query in the order of the cached plan of
+     * its shape or 'NULL' if there is no such plan with current statistics.
+     * The returned list must be deleted with 'delete' after use. If the plan
+     * has selectivities and 'selectivities' is not 'NULL', a copy of them in
+     * the order of the predicates is stored there, which must be deleted
+     * with 'delete[]' after use (else 'NULL' is stored there).
+     */
+    List *getPredicatesOrder(Query *query, double **selectivities = NULL);
+
+    /* Keeps the given order of the predicates of the query for the following
+     * queries with the same shape (replacing any older one), along with the
+     * estimated selectivities of the predicates in that order (if given)
+     */
+    void insertPredicatesOrder(Query *query, List *predicatesOrder,
+        const double *selectivities = NULL);
+
+    /* Getters */
+    unsigned int getPlansNum();
+    unsigned long long getHitsNum();
+    unsigned long long getMissesNum();
+
+    /* Returns the estimated fraction of the elements of a column with the
+     * given statistics that satisfy the filter, using the min & max element
+     * and the amount of distinct elements of the column
+     */
+    static double estimateFilterSelectivity(ColumnStatistics *stats,
+        char filterOperator, unsigned int filterValue);
+
+    /* Returns the bucket of the selectivity. A zero selectivity has bucket 0
+     * and each next bucket covers selectivities half as large as the last one
+     */
+    static unsigned int getSelectivityBucket(double selectivity);
+
+};
+
+#endif
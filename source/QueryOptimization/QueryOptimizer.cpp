@@ -1,20 +1,7 @@
 #include <iostream>
 #include <cmath>
 #include "QueryOptimizer.h"
-
-/******************************************************************
- * An auxiliary static list that stores all the column identities *
- * that need to be filtered due to the initial filter predicates  *
- ******************************************************************/
-
-static List *colIdsForParsing;
-
-/******************************************************************
- *  An auxiliary static list that stores the best column subsets  *
- * of a specific group of Binary Heaps for building the rest tree *
- ******************************************************************/
-
-static List *subsetsForParsing;
+#include "PlanCache.h"
 
 /*****************************************************************
  * Auxiliary function to identify the greater between two values *
@@ -34,6 +21,53 @@ static unsigned int min(unsigned int a, unsigned int b)
     return (a < b) ? a : b;
 }
 
+/*******************************************************************
+ * Auxiliary function that returns the representative of the class *
+ *  of an element in a forest of classes (given by their parents)  *
+ *******************************************************************/
+
+static unsigned int findClass(unsigned int *parents, unsigned int element)
+{
+    while(parents[element] != element)
+    {
+        /* We shorten the path for the following searches */
+        parents[element] = parents[parents[element]];
+        element = parents[element];
+    }
+
+    return element;
+}
+
+/**********************************************************************
+ * Auxiliary function that returns the position of a column among the *
+ * given columns, appending it if it does not exist (the position is  *
+ *       also its own class in the forest of classes initially)       *
+ **********************************************************************/
+
+static unsigned int findColumn(unsigned int alias, unsigned int column,
+    unsigned int *aliases, unsigned int *columns, unsigned int *parents,
+    unsigned int *columnsNum, bool append)
+{
+    unsigned int i;
+
+    for(i = 0; i < (*columnsNum); i++)
+    {
+        if(aliases[i] == alias && columns[i] == column)
+            return i;
+    }
+
+    /* If the column must not be appended, we return the amount of columns */
+    if(!append)
+        return i;
+
+    aliases[i] = alias;
+    columns[i] = column;
+    parents[i] = i;
+    (*columnsNum)++;
+
+    return i;
+}
+
 /**********************************************************************
  * Given the list of relations taking part in the query and an alias, *
  *  we return the real name of the relation that has the given alias  *
@@ -56,22 +90,25 @@ ColumnStatistics *QueryOptimizer::getInitialStats(List *tables,
     return table->getColumnStatistics()[columnName];
 }
 
-/**********************************************************************
- * Places all the column identities of a structure in the static list *
- **********************************************************************/
+/***********************************************************
+ * Places all the column identities of a structure in the  *
+ * helper list that is given as the context of a traversal *
+ ***********************************************************/
 
-void QueryOptimizer::placeColIdsInList(void *item, void *key)
+void QueryOptimizer::placeColIdsInList(void *item, void *key, void *context)
 {
     ColumnIdentity *colId = (ColumnIdentity *) item;
+    List *colIdsForParsing = (List *) context;
     colIdsForParsing->insertLast(colId);
 }
 
 /**********************************************************************
  * Used to traverse a group of Binary Heaps of subsets and places the *
- *   subset in the root of each binary heap in a static helper list   *
+ * subset in the root of each binary heap in the helper list that is  *
+ *               given as the context of the traversal                *
  **********************************************************************/
 
-void QueryOptimizer::placeSubsetsInList(void *item, void *key)
+void QueryOptimizer::placeSubsetsInList(void *item, void *key, void *context)
 {
     /* First we cast the item to its original type */
     BinaryHeap *subsetsHeap = (BinaryHeap *) item;
@@ -79,7 +116,8 @@ void QueryOptimizer::placeSubsetsInList(void *item, void *key)
     /* We retrieve the best order of all the orders in the heap */
     ColumnSubset *bestOrder = (ColumnSubset *) subsetsHeap->getHighestPriorityItem();
 
-    /* We insert the above best order in the list of subsets */
+    /* We insert the above best order in the given list of subsets */
+    List *subsetsForParsing = (List *) context;
     subsetsForParsing->insertLast(bestOrder);
 }
 
@@ -205,6 +243,61 @@ void QueryOptimizer::placeDuplicatesAtEnd(List *result, List *joins)
     result->append(&toBeAppended);
 }
 
+/**********************************************************
+ * Returns 'true' if every tuple that satisfies the first *
+ *     filter predicate also satisfies the second one     *
+ **********************************************************/
+
+bool QueryOptimizer::impliesFilter(PredicatesParser *filter, PredicatesParser *other)
+{
+    /* Filters of different columns do not imply each other */
+    if(filter->getLeftArray() != other->getLeftArray()
+    || filter->getLeftArrayColumn() != other->getLeftArrayColumn())
+        return false;
+
+    unsigned int value = filter->getFilterValue();
+    unsigned int otherValue = other->getFilterValue();
+    char otherOperator = other->getFilterOperator();
+
+    switch(filter->getFilterOperator())
+    {
+        /* A single value satisfies the other filter if it is in its range */
+        case '=':
+            return (otherOperator == '=' && value == otherValue)
+                || (otherOperator == '<' && value < otherValue)
+                || (otherOperator == '>' && value > otherValue);
+
+        /* A range implies the ranges that contain it */
+        case '<':
+            return (otherOperator == '<' && value <= otherValue);
+
+        case '>':
+            return (otherOperator == '>' && value >= otherValue);
+
+        default:
+            return false;
+    }
+}
+
+/******************************************************************
+ * Returns 'true' if a predicate of the list equals the given one *
+ ******************************************************************/
+
+bool QueryOptimizer::containsPredicate(List *predicates, PredicatesParser *predicate)
+{
+    Listnode *currentNode = predicates->getHead();
+
+    while(currentNode != NULL)
+    {
+        if(predicate->equals((PredicatesParser *) currentNode->getItem()))
+            return true;
+
+        currentNode = currentNode->getNext();
+    }
+
+    return false;
+}
+
 /************************************************************
  *              Compares two column identities              *
  *                                                          *
@@ -566,9 +659,9 @@ void QueryOptimizer::insertRelInTree(unsigned int tableAlias,
     ColumnStatistics *columnStats = getInitialStats(
         tables, realTable, tableColumn);
 
-    /* We create a new identity */
+    /* We create a new identity with the next ID of the query */
     ColumnIdentity *columnId = new ColumnIdentity(
-        tableAlias, tableColumn, realTable, columnStats);
+        columnIdsNum + 1, tableAlias, tableColumn, realTable, columnStats);
 
     /* This variable will indicate whether or not the column
      * identity was inserted successfully in the tree
@@ -594,6 +687,9 @@ void QueryOptimizer::insertRelInTree(unsigned int tableAlias,
     /* Case the column was inserted successfully in the tree */
     else
     {
+        /* The ID of the new identity is now taken */
+        columnIdsNum++;
+
         if(createdColumnIdentity != NULL)
             (*createdColumnIdentity) = columnId;
     }
@@ -676,18 +772,19 @@ void QueryOptimizer::filterColumnIdentityAndTheRestInSameTable(
      * Here we create the new stats.
      */
     unsigned int prev_fA, new_fA;
-    prev_fA = colId->getColumnStats()->getElementsNum();
+    ColumnStatistics *prevStats = colId->getColumnStats();
+    prev_fA = prevStats->getElementsNum();
     updateStatsOfTargetedColumnByFilter(colId, filterOperator, filterValue);
     new_fA = colId->getColumnStats()->getElementsNum();
 
     /* We insert the identity in the list of identities with renewed stats */
-    colIdsWithRenewedStats->insertLast(colId);
+    insertInRenewedStats(colId, prevStats);
 
-    /* We initialize the static helper list */
-    colIdsForParsing = new List();
+    /* We initialize the helper list */
+    List *colIdsForParsing = new List();
 
     /* We place all the column identities of the group in the helper list */
-    columnsGroupInSameTable->traverse(Inorder, placeColIdsInList);
+    columnsGroupInSameTable->traverse(Inorder, placeColIdsInList, colIdsForParsing);
 
     /* We will traverse the list from the head to the tail */
     Listnode *currentNode = colIdsForParsing->getHead();
@@ -706,21 +803,44 @@ void QueryOptimizer::filterColumnIdentityAndTheRestInSameTable(
         if(currentColId != colId)
         {
             /* We update the stats of the non-targeted identity */
+            prevStats = currentColId->getColumnStats();
             updateStatsOfNonTargetedColumnByFilter(currentColId,
                 filterOperator, filterValue, prev_fA, new_fA);
 
             /* We insert the identity in the list of identities with renewed stats */
-            colIdsWithRenewedStats->insertLast(currentColId);
+            insertInRenewedStats(currentColId, prevStats);
         }
 
         /* We proceed to the next node */
         currentNode = currentNode->getNext();
     }
 
-    /* We delete the static helper list */
+    /* We delete the helper list */
     delete colIdsForParsing;
 }
 
+/*******************************************************************
+ * Keeps the given column identity in the list of identities with  *
+ * renewed stats. If its stats had already been renewed by another *
+ *  filter of the same table, the given previous stats are freed   *
+ *******************************************************************/
+
+void QueryOptimizer::insertInRenewedStats(ColumnIdentity *colId,
+    ColumnStatistics *prevStats)
+{
+    /* The initial stats belong to the table, but the stats of an earlier
+     * filter belong to this optimizer and nothing refers to them anymore
+     */
+    bool alreadyRenewed = false;
+    colIdsWithRenewedStats->removeKeyNode(colId, compareColumnIdentities,
+        &alreadyRenewed);
+
+    if(alreadyRenewed)
+        delete prevStats;
+
+    colIdsWithRenewedStats->insertLast(colId);
+}
+
 /******************************************************************
  * Applies the given filter to the given targeted column identity *
  ******************************************************************/
@@ -764,34 +884,13 @@ void QueryOptimizer::updateStatsOfTargetedColumnByFilter(
             Table *tableOfColId = (Table *) tables->
                 getItemInPos(1 + colId->getRealTableName());
 
-            /* We retrieve the number of rows of the table */
-            unsigned long long tuplesNum = tableOfColId->
-                getNumOfTuples(), i;
-
             /* We retrieve the column of the identity */
             unsigned int column = colId->getTableColumn();
 
-            /* Initially we consider the filter value does not exist */
-            bool exists = false;
-
-            /* We store the address of the table with
-             * all the contents to a seperate variable
+            /* We search for the element in the column. The table
+             * searches the packed elements if it is compressed.
              */
-            unsigned long long **tableContents = tableOfColId->getTable();
-
-            /* We start searching for the element linearly */
-            for(i = 0; i < tuplesNum; i++)
-            {
-                /* Case we found the element in this iteration
-                 *
-                 * We set the flag to 'true' and break the 'for' loop
-                 */
-                if(tableContents[column][i] == filterValue)
-                {
-                    exists = true;
-                    break;
-                }
-            }
+            bool exists = tableOfColId->containsValue(column, filterValue);
 
             /* We update 'f' and 'd' as suggested (case
              * the filter value exists in the table)
@@ -916,6 +1015,26 @@ void QueryOptimizer::updateStatsOfTargetedColumnByFilter(
         }
     }
 
+    /* If previous queries have shown how far off the estimations of such
+     * filters are, we estimate the amount of elements with the corrected
+     * selectivity of the filter. The corrections are learned from that
+     * selectivity, so they must multiply that one and no other estimate.
+     * A filter that is known to select nothing still selects nothing.
+     */
+    if(feedback != NULL && f > 0)
+    {
+        double correctedElementsNum = round(prev_f * getFilterSelectivity(
+            colId->getRealTableName(), colId->getTableColumn(),
+            filterOperator, filterValue));
+
+        f = (correctedElementsNum > prev_f) ? prev_f
+            : (unsigned int) correctedElementsNum;
+
+        /* The distinct elements cannot be more than the elements */
+        if(d > f) d = f;
+        if(d == 0 && f > 0) d = 1;
+    }
+
     ColumnStatistics *newStats = new ColumnStatistics(l, u, f, d);
     colId->setColumnStats(newStats);
 }
@@ -1115,12 +1234,25 @@ void QueryOptimizer::updateStatsOfJoinTreeAndColumnByJoin(
  * Constructor *
  ***************/
 
-QueryOptimizer::QueryOptimizer(List *tables, Query *query)
+QueryOptimizer::QueryOptimizer(List *tables, Query *query,
+    const CostModel *costModel, CardinalityFeedback *feedback)
 {
     /* We assign the given tables and query to the fields of the class */
     this->tables = tables;
     this->query = query;
 
+    /* We keep the model that will estimate the cost of each join */
+    this->costModel = costModel;
+
+    /* We keep the corrections of the estimations (if any) */
+    this->feedback = feedback;
+
+    /* No column identity has been created yet */
+    columnIdsNum = 0;
+
+    /* The filters have not been applied to the stats yet */
+    filtersApplied = false;
+
     /* We initialize the tree as a (2,3)-Tree */
     columnIdentitiesTree = new B_Tree(3);
 
@@ -1290,6 +1422,14 @@ QueryOptimizer::QueryOptimizer(List *tables, Query *query)
         /* We proceed to the next node */
         currentNode = currentNode->getNext();
     }
+
+    /* A filter that is implied by another filter of the same
+     * column removes no more tuples, so it is not executed
+     */
+    removeRedundantFilters();
+
+    /* We find which columns are equal to each other through the joins */
+    computeEquivalenceClasses();
 }
 
 /**************
@@ -1313,19 +1453,22 @@ QueryOptimizer::~QueryOptimizer()
     /* We free the allocated memory for the B-Tree */
     columnIdentitiesTree->traverse(Postorder, deleteColumnIdentity);
     delete columnIdentitiesTree;
-
-    /* We reset the counter of IDs for the next query */
-    ColumnIdentity::resetIdCounter();
 }
 
-/****************************************************************************
- * Returns a list of predicates in the order that is estimated most optimal *
- ****************************************************************************/
+/**********************************************************************
+ * Estimates the stats of the column identities after all the filters *
+ *        of the query (it has no effect after the first call)        *
+ **********************************************************************/
 
-List *QueryOptimizer::getOptimalPredicatesOrder()
+void QueryOptimizer::applyFilters()
 {
-    /* This is the list of the final result that we will return */
-    List *result = new List();
+    /* The filters change the stats of the column identities,
+     * so they must not be applied more than once
+     */
+    if(filtersApplied)
+        return;
+
+    filtersApplied = true;
 
     /* We will start traversing the list of filter predicates */
     Listnode *currentNode = filterPreds->getHead();
@@ -1385,23 +1528,399 @@ List *QueryOptimizer::getOptimalPredicatesOrder()
         /* We proceed to the next node */
         currentNode = currentNode->getNext();
     }
+}
+
+/****************************************************************************
+ * Returns a list of predicates in the order that is estimated most optimal *
+ ****************************************************************************/
+
+List *QueryOptimizer::getOptimalPredicatesOrder()
+{
+    /* This is the list of the final result that we will return */
+    List *result = new List();
+
+    /* We estimate the stats of the columns after the filters */
+    applyFilters();
 
     /* We place in the result list all the filter predicates first.
      * It's most optimal to have those executed first rather than
-     * any join predicate. The order of the filter predicates does
-     * not matter so much. We take their default order in the query.
+     * any join predicate. The filters of each relation are placed
+     * together, from the most to the least selective one, so they
+     * are applied with a single scan of the relation.
      */
-    result->append(filterPreds);
+    getOptimalFiltersOrder(result);
 
     /* Then we append to the result list all the join predicates in
      * the most optimal order with the 'getOptimalJoinsOrder' operation.
      */
     getOptimalJoinsOrder(result);
 
+    /* The joins between columns that have already been made equal by
+     * the previous joins of the order (like duplicate joins or the last
+     * join of a cycle in the same equivalence class) are not executed
+     */
+    removeImpliedJoins(result);
+
     /* We return the final result */
     return result;
 }
 
+/**************************************************************************
+ * Appends to the 'result' all the filter predicates grouped by relation, *
+ *     from the most to the least selective filter of every relation      *
+ **************************************************************************/
+
+void QueryOptimizer::getOptimalFiltersOrder(List *result) const
+{
+    /* The filters that have not been placed in the result yet */
+    List remainingFilters;
+    remainingFilters.append(filterPreds);
+
+    while(!remainingFilters.isEmpty())
+    {
+        /* The relations are placed in the order of their first filter */
+        PredicatesParser *firstFilter = (PredicatesParser *)
+            remainingFilters.getHead()->getItem();
+
+        unsigned int relation = firstFilter->getLeftArray();
+
+        /* We move the filters of the relation to the result one by one,
+         * each time picking the one that should be applied first
+         */
+        while(true)
+        {
+            PredicatesParser *bestFilter = NULL;
+            double bestSelectivity = 0;
+            unsigned int bestPos = 0, pos = 1;
+
+            for(Listnode *current = remainingFilters.getHead(); current != NULL;
+                current = current->getNext(), pos++)
+            {
+                PredicatesParser *currentFilter = (PredicatesParser *) current->getItem();
+
+                if(currentFilter->getLeftArray() != relation)
+                    continue;
+
+                double selectivity = getFilterSelectivity(currentFilter);
+
+                if(bestFilter == NULL || precedesFilter(currentFilter,
+                    selectivity, bestFilter, bestSelectivity))
+                {
+                    bestFilter = currentFilter;
+                    bestSelectivity = selectivity;
+                    bestPos = pos;
+                }
+            }
+
+            /* All the filters of the relation have been placed */
+            if(bestFilter == NULL)
+                break;
+
+            result->insertLast(bestFilter);
+            remainingFilters.removePos(bestPos);
+        }
+    }
+}
+
+/******************************************************************
+ * Returns 'true' if the first filter predicate should be applied *
+ *           before the second one of the same relation           *
+ ******************************************************************/
+
+bool QueryOptimizer::precedesFilter(PredicatesParser *filter, double selectivity,
+    PredicatesParser *other, double otherSelectivity) const
+{
+    /* The filter that keeps fewer rows leaves less work to the next ones */
+    if(selectivity != otherSelectivity)
+        return selectivity < otherSelectivity;
+
+    /* On a tie, an equality filter comes first, since the first filter of a
+     * relation may be answered by the secondary index of its column without
+     * scanning the relation, which is always the case for equality filters
+     */
+    return filter->getFilterOperator() == '='
+        && other->getFilterOperator() != '=';
+}
+
+/*************************************************************************
+ *  Appends to the predicates of the query the ones that are implied by  *
+ * the equivalence classes of its join columns, which are the filters of *
+ * every column on the other columns of its class and the joins between  *
+ *  every two columns of the same class. Returns the amount of appended  *
+ *                              predicates                               *
+ *************************************************************************/
+
+unsigned int QueryOptimizer::inferImpliedPredicates(Query *query)
+{
+    List *predicates = query->getPredicates();
+    unsigned int predicatesNum = predicates->getCounter();
+    unsigned int insertedNum = 0;
+
+    /* Every join predicate has at most two distinct columns. The columns
+     * form a forest, where the columns of each tree are equal to each other.
+     */
+    unsigned int *aliases = new unsigned int[2 * predicatesNum + 1];
+    unsigned int *columns = new unsigned int[2 * predicatesNum + 1];
+    unsigned int *parents = new unsigned int[2 * predicatesNum + 1];
+    unsigned int columnsNum = 0;
+    unsigned int i, j;
+
+    /* A buffer where the string of every implied predicate is created */
+    char predicateString[64];
+
+    /* Every join predicate merges the classes of its two columns */
+    Listnode *currentNode = predicates->getHead();
+
+    while(currentNode != NULL)
+    {
+        PredicatesParser *currentPred = (PredicatesParser *) currentNode->getItem();
+
+        if(!currentPred->hasConstant())
+        {
+            unsigned int left = findColumn(currentPred->getLeftArray(),
+                currentPred->getLeftArrayColumn(), aliases, columns, parents,
+                &columnsNum, true);
+
+            unsigned int right = findColumn(currentPred->getRightArray(),
+                currentPred->getRightArrayColumn(), aliases, columns, parents,
+                &columnsNum, true);
+
+            parents[findClass(parents, left)] = findClass(parents, right);
+        }
+
+        currentNode = currentNode->getNext();
+    }
+
+    /* Every filter of the query is also applied to the other columns of its
+     * class. Only the initial predicates are examined, since the appended
+     * filters would only imply filters that have already been appended.
+     */
+    currentNode = predicates->getHead();
+
+    for(i = 0; i < predicatesNum; i++)
+    {
+        PredicatesParser *currentPred = (PredicatesParser *) currentNode->getItem();
+        currentNode = currentNode->getNext();
+
+        if(!currentPred->hasConstant())
+            continue;
+
+        unsigned int filtered = findColumn(currentPred->getLeftArray(),
+            currentPred->getLeftArrayColumn(), aliases, columns, parents,
+            &columnsNum, false);
+
+        /* If the column is not joined with any other, nothing is implied */
+        if(filtered == columnsNum)
+            continue;
+
+        for(j = 0; j < columnsNum; j++)
+        {
+            if(j == filtered || findClass(parents, j) != findClass(parents, filtered))
+                continue;
+
+            snprintf(predicateString, sizeof(predicateString), "%u.%u%c%u",
+                aliases[j], columns[j], currentPred->getFilterOperator(),
+                currentPred->getFilterValue());
+
+            PredicatesParser *impliedPred = new PredicatesParser(predicateString);
+
+            if(containsPredicate(predicates, impliedPred))
+                delete impliedPred;
+
+            else
+            {
+                query->insertPredicate(impliedPred);
+                insertedNum++;
+            }
+        }
+    }
+
+    /* Every two columns of the same class are also joined, so the join
+     * orders may join them directly instead of through the other columns
+     */
+    for(i = 0; i < columnsNum; i++)
+    {
+        for(j = i + 1; j < columnsNum; j++)
+        {
+            if(findClass(parents, i) != findClass(parents, j))
+                continue;
+
+            snprintf(predicateString, sizeof(predicateString), "%u.%u=%u.%u",
+                aliases[i], columns[i], aliases[j], columns[j]);
+
+            PredicatesParser *impliedPred = new PredicatesParser(predicateString);
+
+            if(containsPredicate(predicates, impliedPred))
+                delete impliedPred;
+
+            else
+            {
+                query->insertPredicate(impliedPred);
+                insertedNum++;
+            }
+        }
+    }
+
+    delete[] aliases;
+    delete[] columns;
+    delete[] parents;
+
+    return insertedNum;
+}
+
+/**************************************************************
+ * Gives every column identity the same equivalence class as  *
+ * all the columns it is equal to through the join predicates *
+ **************************************************************/
+
+void QueryOptimizer::computeEquivalenceClasses()
+{
+    /* We place all the column identities in a list for a linear traversal */
+    List colIds = List();
+    columnIdentitiesTree->traverse(Preorder, placeColIdsInList, &colIds);
+
+    /* Every column takes the smallest class among its neighbors, until
+     * no class changes. Then all the columns that are connected through
+     * join predicates have the smallest ID among them as their class.
+     */
+    bool changed = true;
+
+    while(changed)
+    {
+        changed = false;
+
+        for(Listnode *current = colIds.getHead(); current != NULL; current = current->getNext())
+        {
+            ColumnIdentity *colId = (ColumnIdentity *) current->getItem();
+            Listnode *neighborNode = colId->getNeighbors()->getHead();
+
+            while(neighborNode != NULL)
+            {
+                ColumnIdentity *neighbor = (ColumnIdentity *) neighborNode->getItem();
+
+                if(neighbor->getEquivalenceClass() < colId->getEquivalenceClass())
+                {
+                    colId->setEquivalenceClass(neighbor->getEquivalenceClass());
+                    changed = true;
+                }
+
+                neighborNode = neighborNode->getNext();
+            }
+        }
+    }
+}
+
+/**********************************************************************
+ * Returns the equivalence class of the columns of the join predicate *
+ **********************************************************************/
+
+unsigned int QueryOptimizer::getEquivalenceClass(PredicatesParser *joinPred) const
+{
+    ColumnIdentity *leftColId = searchColumnIdentity(
+        joinPred->getLeftArray(), joinPred->getLeftArrayColumn());
+
+    return (leftColId != NULL) ? leftColId->getEquivalenceClass()
+        : NO_EQUIVALENCE_CLASS;
+}
+
+/**********************************************************
+ *  Removes from the filter predicates the ones that are  *
+ * implied by another filter predicate of the same column *
+ **********************************************************/
+
+void QueryOptimizer::removeRedundantFilters()
+{
+    List *necessaryFilters = new List();
+    unsigned int position = 0;
+
+    for(Listnode *current = filterPreds->getHead(); current != NULL; current = current->getNext())
+    {
+        PredicatesParser *filter = (PredicatesParser *) current->getItem();
+        bool redundant = false;
+        unsigned int otherPosition = 0;
+
+        /* A filter is redundant if another filter implies it. Of two filters
+         * that imply each other (like duplicates) only the first one is kept.
+         */
+        for(Listnode *other = filterPreds->getHead(); other != NULL && !redundant; other = other->getNext())
+        {
+            PredicatesParser *otherFilter = (PredicatesParser *) other->getItem();
+
+            if(other != current && impliesFilter(otherFilter, filter)
+            && (!impliesFilter(filter, otherFilter) || otherPosition < position))
+                redundant = true;
+
+            otherPosition++;
+        }
+
+        if(!redundant)
+            necessaryFilters->insertLast(filter);
+
+        position++;
+    }
+
+    delete filterPreds;
+    filterPreds = necessaryFilters;
+}
+
+/****************************************************************************
+ * Removes from the 'result' the join predicates whose columns have already *
+ *     been made equal by the previous join predicates of the 'result'      *
+ ****************************************************************************/
+
+void QueryOptimizer::removeImpliedJoins(List *result) const
+{
+    /* The columns of the joins that have been kept form a forest, where
+     * the columns of each tree have been made equal to each other
+     */
+    unsigned int *parents = new unsigned int[columnIdsNum + 1];
+
+    for(unsigned int id = 0; id <= columnIdsNum; id++)
+        parents[id] = id;
+
+    unsigned int position = 1;
+
+    while(position <= result->getCounter())
+    {
+        PredicatesParser *currentPred = (PredicatesParser *) result->getItemInPos(position);
+
+        /* The filters are always kept */
+        if(currentPred->hasConstant())
+        {
+            position++;
+            continue;
+        }
+
+        ColumnIdentity *leftColId = searchColumnIdentity(
+            currentPred->getLeftArray(), currentPred->getLeftArrayColumn());
+
+        ColumnIdentity *rightColId = searchColumnIdentity(
+            currentPred->getRightArray(), currentPred->getRightArrayColumn());
+
+        if(leftColId == NULL || rightColId == NULL)
+        {
+            position++;
+            continue;
+        }
+
+        unsigned int leftClass = findClass(parents, leftColId->getId());
+        unsigned int rightClass = findClass(parents, rightColId->getId());
+
+        /* If the columns are already equal, the join removes no tuples */
+        if(leftClass == rightClass)
+            result->removePos(position);
+
+        /* Else the join makes the columns of the two trees equal */
+        else
+        {
+            parents[leftClass] = rightClass;
+            position++;
+        }
+    }
+
+    delete[] parents;
+}
+
 /****************************************
  * Appends to the 'result' all the join *
  * predicates in the most optimal order *
@@ -1413,14 +1932,24 @@ void QueryOptimizer::getOptimalJoinsOrder(List *result)
     if(joinPreds->getCounter() == 0)
         return;
 
+    /* If the query has few enough relations, we enumerate all the connected
+     * join trees with the 'JoinEnumerator', which is much faster than the
+     * search among subsets of columns below and also considers bushy trees
+     */
+    if(query->getRelations()->getCounter() <= MAX_ENUMERATED_RELATIONS)
+    {
+        enumerateJoinsOrder(result);
+        return;
+    }
+
     /* We initialize the tree of the subsets we will create */
     subsetsTree = new InvertedIndex();
 
     /* We place all the column identities in a
      * list temporarily for a linear traversal
      */
-    colIdsForParsing = new List();
-    columnIdentitiesTree->traverse(Preorder, placeColIdsInList);
+    List *colIdsForParsing = new List();
+    columnIdentitiesTree->traverse(Preorder, placeColIdsInList, colIdsForParsing);
 
     /* We will traverse the list of columns from the head */
     Listnode *currentNode = colIdsForParsing->getHead();
@@ -1464,9 +1993,11 @@ void QueryOptimizer::getOptimalJoinsOrder(List *result)
             updateStatsOfColumnsByJoin(colId, neighborColId,
                 neighborPred, &statsAfterJoin);
 
-            /* We create a new subset */
+            /* We create a new subset with the estimated cost of the join */
             ColumnSubset *newSubset = new ColumnSubset(
-                colId, neighborColId, neighborPred, statsAfterJoin
+                colId, neighborColId, neighborPred, statsAfterJoin,
+                estimateJoinCost(colId->getColumnStats(),
+                    neighborColId->getColumnStats(), statsAfterJoin)
             );
 
             /* We search for group #2 in the tree, since
@@ -1569,8 +2100,8 @@ void QueryOptimizer::getOptimalJoinsOrder(List *result)
             break;
 
         /* We place the best ordering of each combination of the group in a list */
-        subsetsForParsing = new List();
-        nextGroup->traverse(Inorder, placeSubsetsInList);
+        List *subsetsForParsing = new List();
+        nextGroup->traverse(Inorder, placeSubsetsInList, subsetsForParsing);
 
         /* We will traverse the list of subsets from the head */
         Listnode *currentNode = subsetsForParsing->getHead();
@@ -1617,7 +2148,9 @@ void QueryOptimizer::getOptimalJoinsOrder(List *result)
                  * end, while also passing the new stats to the contructor
                  */
                 ColumnSubset *newSubset = new ColumnSubset(
-                    currentSubset, neighborColId, neighborPred, statsAfterJoin
+                    currentSubset, neighborColId, neighborPred, statsAfterJoin,
+                    estimateJoinCost(currentSubset->getSubsetStats(),
+                        neighborColId->getColumnStats(), statsAfterJoin)
                 );
 
                 /* We search for the next group in the tree */
@@ -1735,8 +2268,8 @@ void QueryOptimizer::getOptimalJoinsOrder(List *result)
             searchIndexKey(&nextGroupId, compareUnsignedIntegers);
 
         /* We place the best ordering of each combination of the group in a list */
-        subsetsForParsing = new List();
-        nextLargestCombinationsGroup->traverse(Preorder, placeSubsetsInList);
+        List *subsetsForParsing = new List();
+        nextLargestCombinationsGroup->traverse(Preorder, placeSubsetsInList, subsetsForParsing);
 
         /* We will traverse the list of best orders of this group */
         Listnode *currentNode = subsetsForParsing->getHead();
@@ -1782,6 +2315,350 @@ void QueryOptimizer::getOptimalJoinsOrder(List *result)
     delete subsetsTree;
 }
 
+/*************************************************************************
+ *  Appends to the 'result' all the join predicates in the order of the  *
+ * cheapest (left-deep or bushy) join tree found by the 'JoinEnumerator' *
+ *************************************************************************/
+
+void QueryOptimizer::enumerateJoinsOrder(List *result)
+{
+    /* We keep each join predicate once. The duplicates will be placed at the
+     * end of the result, so they do not affect the estimations of the joins.
+     */
+    List distinctJoinPreds = List();
+    Listnode *currentNode = joinPreds->getHead();
+
+    while(currentNode != NULL)
+    {
+        PredicatesParser *currentPred = (PredicatesParser *) currentNode->getItem();
+        List currentPredList = List();
+        currentPredList.insertLast(currentPred);
+
+        if(areForeignSets(&distinctJoinPreds, &currentPredList))
+            distinctJoinPreds.insertLast(currentPred);
+
+        currentNode = currentNode->getNext();
+    }
+
+    /* We create an enumerator with one vertex for each relation of the query */
+    unsigned int relationsNum = query->getRelations()->getCounter();
+
+    JoinEnumerator enumerator = JoinEnumerator(
+        relationsNum, distinctJoinPreds.getCounter(), costModel);
+
+    /* If there is a cost model, every relation costs the time to read its
+     * tuples and apply its filters. These costs are the same for every plan,
+     * but they make the cost of the best plan the time of the whole query.
+     */
+    for(unsigned int alias = 0; alias < relationsNum; alias++)
+    {
+        if(costModel == NULL)
+            break;
+
+        Table *table = (Table *) tables->getItemInPos(
+            getRealTableName(query->getRelations(), alias) + 1);
+
+        /* We count the filters of the relation */
+        unsigned int filtersNum = 0;
+        currentNode = filterPreds->getHead();
+
+        while(currentNode != NULL)
+        {
+            if(((PredicatesParser *) currentNode->getItem())->getLeftArray() == alias)
+                filtersNum++;
+
+            currentNode = currentNode->getNext();
+        }
+
+        enumerator.setRelationCost(alias, costModel->estimateRelationCost(
+            table->getNumOfTuples(), filtersNum));
+    }
+
+    /* We will traverse the distinct join predicates from the head */
+    currentNode = distinctJoinPreds.getHead();
+
+    while(currentNode != NULL)
+    {
+        /* We retrieve the predicate stored in the current node */
+        PredicatesParser *currentPred = (PredicatesParser *) currentNode->getItem();
+
+        /* We retrieve the column identities of both sides of the predicate */
+        ColumnIdentity *leftColId = searchColumnIdentity(
+            currentPred->getLeftArray(), currentPred->getLeftArrayColumn());
+
+        ColumnIdentity *rightColId = searchColumnIdentity(
+            currentPred->getRightArray(), currentPred->getRightArrayColumn());
+
+        if(leftColId != NULL && rightColId != NULL)
+        {
+            /* The filters have already changed the stats of every column of
+             * a relation to the estimated amount of tuples of the relation
+             */
+            enumerator.setRelationSize(currentPred->getLeftArray(),
+                leftColId->getColumnStats()->getElementsNum());
+
+            enumerator.setRelationSize(currentPred->getRightArray(),
+                rightColId->getColumnStats()->getElementsNum());
+
+            /* We insert the predicate with its estimated selectivity
+             * and the equivalence class of its columns
+             */
+            enumerator.insertPredicate(currentPred,
+                getJoinSelectivity(currentPred), getEquivalenceClass(currentPred));
+        }
+
+        /* We proceed to the next node */
+        currentNode = currentNode->getNext();
+    }
+
+    /* We find the best plan and append its join predicates to the result */
+    enumerator.enumerate();
+    enumerator.getJoinsOrder(result);
+
+    /* We place the duplicate joins at the end
+     * to cut off as many results as possible
+     */
+    placeDuplicatesAtEnd(result, joinPreds);
+}
+
+/**************************************************************************
+ * Returns the estimated fraction of the pairs of tuples that satisfy the *
+ *    join predicate, after the filters of the query have been applied    *
+ **************************************************************************/
+
+double QueryOptimizer::getJoinSelectivity(PredicatesParser *joinPred)
+{
+    /* The selectivity depends on the stats after the filters */
+    applyFilters();
+
+    ColumnIdentity *leftColId = searchColumnIdentity(
+        joinPred->getLeftArray(), joinPred->getLeftArrayColumn());
+
+    ColumnIdentity *rightColId = searchColumnIdentity(
+        joinPred->getRightArray(), joinPred->getRightArrayColumn());
+
+    /* If the columns are not part of the query, we cannot estimate anything */
+    if(leftColId == NULL || rightColId == NULL)
+        return 1;
+
+    double selectivity = estimateJoinSelectivity(leftColId, rightColId);
+
+    /* If previous queries have shown how far off the estimations of joins
+     * between the same columns are, we correct the estimated selectivity
+     */
+    if(feedback != NULL && leftColId != rightColId)
+    {
+        selectivity *= feedback->getJoinCorrection(
+            leftColId->getRealTableName(), leftColId->getTableColumn(),
+            rightColId->getRealTableName(), rightColId->getTableColumn());
+    }
+
+    return (selectivity > 1) ? 1 : selectivity;
+}
+
+/*********************************************************************
+ * Returns the estimated fraction of the tuples of its relation that *
+ *   satisfy the filter predicate, regardless of the other filters   *
+ *********************************************************************/
+
+double QueryOptimizer::getFilterSelectivity(PredicatesParser *filterPred) const
+{
+    /* We retrieve the base table and the column of the filter */
+    unsigned int realTable = getRealTableName(query->getRelations(),
+        filterPred->getLeftArray());
+
+    return getFilterSelectivity(realTable, filterPred->getLeftArrayColumn(),
+        filterPred->getFilterOperator(), filterPred->getFilterValue());
+}
+
+/************************************************************************
+ * Returns the estimated fraction of the tuples of the given base table *
+ *    that satisfy the given filter on its column, regardless of the    *
+ *                            other filters                             *
+ ************************************************************************/
+
+double QueryOptimizer::getFilterSelectivity(unsigned int realTable,
+    unsigned int column, char filterOperator, unsigned int filterValue) const
+{
+    /* We estimate the selectivity from the initial stats of the column */
+    double selectivity = PlanCache::estimateFilterSelectivity(
+        getInitialStats(tables, realTable, column),
+        filterOperator, filterValue);
+
+    /* If previous queries have shown how far off the estimations of such
+     * filters are, we correct the estimated selectivity
+     */
+    if(feedback != NULL)
+    {
+        selectivity *= feedback->getFilterCorrection(realTable, column,
+            filterOperator);
+    }
+
+    return (selectivity > 1) ? 1 : selectivity;
+}
+
+/**************************************************************************
+ * Returns the remaining join predicates of the query in the order of the *
+ *   cheapest join tree, given that the aliases of the same group have    *
+ * already been joined in an intermediate result with the given amount of *
+ *  rows. The predicates that are equal to an executed one are placed at  *
+ *         the end. The returned list must be deleted after use.          *
+ **************************************************************************/
+
+List *QueryOptimizer::reoptimizeJoinsOrder(
+    List *remainingJoins,
+    List *executedJoins,
+    const unsigned int *groupOfAlias,
+    const double *groupRows,
+    unsigned int groupsNum)
+{
+    List *result = new List();
+
+    /* If there are too many groups to enumerate their join
+     * trees, we keep the remaining predicates in their order
+     */
+    if(groupsNum > MAX_ENUMERATED_RELATIONS)
+    {
+        result->append(remainingJoins);
+        return result;
+    }
+
+    /* We keep each remaining predicate once and only if it has not been
+     * executed already. The rest are placed at the end of the result,
+     * because they do not cut off any more tuples.
+     */
+    List distinctJoinPreds = List();
+    List repeatedJoinPreds = List();
+    Listnode *currentNode = remainingJoins->getHead();
+
+    while(currentNode != NULL)
+    {
+        PredicatesParser *currentPred = (PredicatesParser *) currentNode->getItem();
+        List currentPredList = List();
+        currentPredList.insertLast(currentPred);
+
+        if(areForeignSets(&distinctJoinPreds, &currentPredList)
+        && areForeignSets(executedJoins, &currentPredList))
+        {
+            distinctJoinPreds.insertLast(currentPred);
+        }
+
+        else
+            repeatedJoinPreds.insertLast(currentPred);
+
+        currentNode = currentNode->getNext();
+    }
+
+    /* We create an enumerator with one vertex for each group, where
+     * each group costs nothing more, since it has been built already
+     */
+    JoinEnumerator enumerator = JoinEnumerator(
+        groupsNum, distinctJoinPreds.getCounter(), costModel);
+
+    enumerator.setRelationsOfAliases(query->getRelations()->getCounter(),
+        groupOfAlias);
+
+    for(unsigned int group = 0; group < groupsNum; group++)
+        enumerator.setRelationSize(group, groupRows[group]);
+
+    /* We insert every distinct predicate with its estimated selectivity */
+    currentNode = distinctJoinPreds.getHead();
+
+    while(currentNode != NULL)
+    {
+        PredicatesParser *currentPred = (PredicatesParser *) currentNode->getItem();
+        enumerator.insertPredicate(currentPred, getJoinSelectivity(currentPred),
+            getEquivalenceClass(currentPred));
+        currentNode = currentNode->getNext();
+    }
+
+    /* We find the best plan and append its join predicates to the result */
+    enumerator.enumerate();
+    enumerator.getJoinsOrder(result);
+
+    /* The repeated predicates are placed at the end */
+    result->append(&repeatedJoinPreds);
+
+    return result;
+}
+
+/****************************************************************************
+ * Returns the estimated cost of the join between two inputs with the given *
+ *       statistics that produces a result with the given statistics        *
+ ****************************************************************************/
+
+double QueryOptimizer::estimateJoinCost(ColumnStatistics *leftStats,
+    ColumnStatistics *rightStats, ColumnStatistics *resultStats) const
+{
+    /* Without a cost model, the cost is the amount of tuples of the result */
+    if(costModel == NULL)
+        return resultStats->getElementsNum();
+
+    return costModel->estimateJoinCost(leftStats->getElementsNum(),
+        rightStats->getElementsNum(), resultStats->getElementsNum());
+}
+
+/***********************************************************************
+ * Returns the column identity with the given attributes from the tree *
+ ***********************************************************************/
+
+ColumnIdentity *QueryOptimizer::searchColumnIdentity(unsigned int tableAlias,
+    unsigned int tableColumn) const
+{
+    /* We create a dummy identity to search the real
+     * one with the same attributes in the tree
+     */
+    ColumnIdentity dummyColId = ColumnIdentity(tableAlias, tableColumn);
+    ColumnIdentity *colId;
+
+    if(!columnIdentitiesTree->searchAndRetrieve(&dummyColId,
+        compareColumnIdentities, (void **) &colId))
+    {
+        std::cout << "Could not find the relation {" << tableAlias
+            << "." << tableColumn << "} in the tree" << std::endl;
+
+        return NULL;
+    }
+
+    return colId;
+}
+
+/************************************************************
+ *   Estimates the fraction of the pairs of tuples of the   *
+ * two columns that satisfy the join predicate between them *
+ ************************************************************/
+
+double QueryOptimizer::estimateJoinSelectivity(
+    ColumnIdentity *leftColId,
+    ColumnIdentity *rightColId)
+{
+    /* A column joined with itself is satisfied by every tuple */
+    if(leftColId == rightColId)
+        return 1;
+
+    ColumnStatistics *leftStats = leftColId->getColumnStats();
+    ColumnStatistics *rightStats = rightColId->getColumnStats();
+
+    /* As in 'updateStatsOfColumnsByJoin', only the common range of
+     * values of the two columns can produce results, and each pair
+     * is assumed to match with probability '1 / (u - l + 1)'. The
+     * values are 64-bit, so we do not narrow them with 'max'/'min'.
+     */
+    unsigned long long l = leftStats->getMinElement();
+    unsigned long long u = leftStats->getMaxElement();
+
+    if(rightStats->getMinElement() > l)
+        l = rightStats->getMinElement();
+
+    if(rightStats->getMaxElement() < u)
+        u = rightStats->getMaxElement();
+
+    if(u < l)
+        return 0;
+
+    return 1.0 / ((double) u - (double) l + 1.0);
+}
+
 /****************************************************************************
  * Frees the allocated memory for the result of 'getOptimalPredicatesOrder' *
  ****************************************************************************/
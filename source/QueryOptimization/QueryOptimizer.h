@@ -6,20 +6,69 @@
 #include "InvertedIndex.h"
 #include "BinaryHeap.h"
 #include "B_Tree.h"
+#include "JoinEnumerator.h"
+#include "CardinalityFeedback.h"
 
 class QueryOptimizer {
 
 public:
 
-    /* Constructor */
-    QueryOptimizer(List *tables, Query *query);
+    /* Constructor - The joins are compared by the estimated tuples they
+     * produce, unless a cost model that estimates their time is given.
+     * If a cardinality feedback is given, the estimations of the filters
+     * and the joins are corrected with the actual rows of previous queries.
+     */
+    QueryOptimizer(List *tables, Query *query, const CostModel *costModel = NULL,
+        CardinalityFeedback *feedback = NULL);
 
     /* Destructor */
     ~QueryOptimizer();
 
-    /* Returns a list of predicates in the order that is estimated most optimal */
+    /* Returns a list of predicates in the order that is estimated most
+     * optimal. The filters that are implied by other filters of the same
+     * column and the joins that are implied by the previous joins of the
+     * order (through the equivalence classes of their columns) are left out.
+     */
     List *getOptimalPredicatesOrder();
 
+    /* Appends to the predicates of the query the ones that are implied by
+     * the equivalence classes of its join columns, which are the filters of
+     * every column on the other columns of its class and the joins between
+     * every two columns of the same class. Returns the amount of predicates
+     * that were appended (0 if the query already has all of them).
+     */
+    static unsigned int inferImpliedPredicates(Query *query);
+
+    /* Estimates the stats of the column identities after all the
+     * filters of the query (it has no effect after the first call)
+     */
+    void applyFilters();
+
+    /* Returns the estimated fraction of the tuples of its relation that
+     * satisfy the filter predicate, regardless of the other filters
+     */
+    double getFilterSelectivity(PredicatesParser *filterPred) const;
+
+    /* Returns the estimated fraction of the pairs of tuples that satisfy
+     * the join predicate, after the filters of the query have been applied
+     */
+    double getJoinSelectivity(PredicatesParser *joinPred);
+
+    /* Returns the remaining join predicates of the query in the order of the
+     * cheapest join tree, given that the aliases with the same group in
+     * 'groupOfAlias' have already been joined in an intermediate result
+     * with the rows given in 'groupRows' (every alias that has not been
+     * joined yet is a group by itself). The predicates that are equal to
+     * an executed one are placed at the end. The returned list must be
+     * deleted with 'delete' after use.
+     */
+    List *reoptimizeJoinsOrder(
+        List *remainingJoins,
+        List *executedJoins,
+        const unsigned int *groupOfAlias,
+        const double *groupRows,
+        unsigned int groupsNum);
+
     /* Frees the allocated memory for the result of 'getOptimalPredicatesOrder' */
     void deleteOptimalPredicatesOrder(List *optimalPredicatesOrder) const;
 
@@ -48,6 +97,25 @@ private:
     /* A list of all the filter predicates of the query */
     List *filterPreds;
 
+    /* The model that estimates the cost of every join or 'NULL' if
+     * the cost of a join is the amount of tuples it produces
+     */
+    const CostModel *costModel;
+
+    /* The corrections of the estimations that were learned from the
+     * actual rows of previous queries or 'NULL' if there are none
+     */
+    CardinalityFeedback *feedback;
+
+    /* The amount of column identities created for the query, which is
+     * also the ID of the most recent one. Every optimizer has its own
+     * counter, so many queries can be optimized at the same time.
+     */
+    unsigned int columnIdsNum;
+
+    /* Whether the filters of the query have changed the stats of the columns */
+    bool filtersApplied;
+
     /* A tree storing each initial column taking part in the query */
     B_Tree *columnIdentitiesTree;
 
@@ -88,6 +156,19 @@ private:
         char filterOperator,
         unsigned int filterValue);
 
+    /* Keeps the given column identity in the list of identities with
+     * renewed stats. If its stats had already been renewed by another
+     * filter of the same table, the given previous stats are freed.
+     */
+    void insertInRenewedStats(ColumnIdentity *colId, ColumnStatistics *prevStats);
+
+    /* Returns the estimated fraction of the tuples of the given base table
+     * that satisfy the given filter on its column, regardless of the other
+     * filters. The estimation is corrected with the feedback (if any).
+     */
+    double getFilterSelectivity(unsigned int realTable, unsigned int column,
+        char filterOperator, unsigned int filterValue) const;
+
     /* Applies the given filter to the given targeted column identity */
     void updateStatsOfTargetedColumnByFilter(
         ColumnIdentity *colId,
@@ -128,6 +209,59 @@ private:
      */
     void getOptimalJoinsOrder(List *result);
 
+    /* Appends to the 'result' all the filter predicates grouped by their
+     * relation, so the filters of a relation are applied with a single scan.
+     * The filters of each relation are placed from the most to the least
+     * selective one, with equality filters before range filters on a tie.
+     */
+    void getOptimalFiltersOrder(List *result) const;
+
+    /* Returns 'true' if the first filter predicate should
+     * be applied before the second one of the same relation
+     */
+    bool precedesFilter(PredicatesParser *filter, double selectivity,
+        PredicatesParser *other, double otherSelectivity) const;
+
+    /* Gives every column identity the same equivalence class as all
+     * the columns it is equal to through the join predicates
+     */
+    void computeEquivalenceClasses();
+
+    /* Returns the equivalence class of the columns of the join predicate */
+    unsigned int getEquivalenceClass(PredicatesParser *joinPred) const;
+
+    /* Removes from the filter predicates the ones that are
+     * implied by another filter predicate of the same column
+     */
+    void removeRedundantFilters();
+
+    /* Removes from the 'result' the join predicates whose columns have already
+     * been made equal by the previous join predicates of the 'result'
+     */
+    void removeImpliedJoins(List *result) const;
+
+    /* Appends to the 'result' all the join predicates in the order of the
+     * cheapest (left-deep or bushy) join tree found by the 'JoinEnumerator'
+     */
+    void enumerateJoinsOrder(List *result);
+
+    /* Returns the estimated cost of the join between two inputs with the given
+     * statistics that produces a result with the given statistics
+     */
+    double estimateJoinCost(ColumnStatistics *leftStats,
+        ColumnStatistics *rightStats, ColumnStatistics *resultStats) const;
+
+    /* Returns the column identity with the given attributes from the tree */
+    ColumnIdentity *searchColumnIdentity(unsigned int tableAlias,
+        unsigned int tableColumn) const;
+
+    /* Estimates the fraction of the pairs of tuples of the two
+     * columns that satisfy the join predicate between them
+     */
+    static double estimateJoinSelectivity(
+        ColumnIdentity *leftColId,
+        ColumnIdentity *rightColId);
+
     /* Given the list of relations taking part in the query and an alias,
      * we return the real name of the relation that has the given alias
      */
@@ -139,13 +273,16 @@ private:
     static ColumnStatistics *getInitialStats(List *tables,
         unsigned int realTableName, unsigned int columnName);
 
-    /* Places all the column identities of a structure in the static list */
-    static void placeColIdsInList(void *item, void *key);
+    /* Places all the column identities of a structure in the
+     * helper list that is given as the context of the traversal
+     */
+    static void placeColIdsInList(void *item, void *key, void *context);
 
     /* Used to traverse a group of Binary Heaps of subsets and places the
-     * subset in the root of each binary heap in a static helper list
+     * subset in the root of each binary heap in the helper list that is
+     * given as the context of the traversal
      */
-    static void placeSubsetsInList(void *item, void *key);
+    static void placeSubsetsInList(void *item, void *key, void *context);
 
     /* Compares two lists of predicates and returns 'true' if the two
      * lists have no common predicate, else even if 1 predicate of one
@@ -158,6 +295,14 @@ private:
      */
     static void placeDuplicatesAtEnd(List *result, List *joins);
 
+    /* Returns 'true' if every tuple that satisfies the first
+     * filter predicate also satisfies the second one
+     */
+    static bool impliesFilter(PredicatesParser *filter, PredicatesParser *other);
+
+    /* Returns 'true' if a predicate of the list equals the given one */
+    static bool containsPredicate(List *predicates, PredicatesParser *predicate);
+
     /* Compares two column identities
      *
      * - Returns 1 if the first one is greater than the second
@@ -5,7 +5,7 @@
  * Constructor & Destructor *
  ****************************/
 
-Relation::Relation(Tuple *tuples, unsigned int numOfTuples)
+Relation::Relation(Tuple *tuples, unsigned long long numOfTuples)
 {
 	this->tuples = tuples;
 	this->numOfTuples = numOfTuples;
@@ -26,7 +26,7 @@ Tuple *Relation::getTuples() const
  * Getter - Returns the amount of tuples in the array *
  ******************************************************/
 
-unsigned int Relation::getNumOfTuples() const
+unsigned long long Relation::getNumOfTuples() const
 {
 	return numOfTuples;
 }
@@ -44,7 +44,7 @@ void Relation::setTuples(Tuple *newTuples)
  * Setter - Updates the amount of tuples in the array *
  ******************************************************/
 
-void Relation::setNumOfTuples(unsigned int newNumOfTuples)
+void Relation::setNumOfTuples(unsigned long long newNumOfTuples)
 {
     numOfTuples = newNumOfTuples;
 }
@@ -53,7 +53,7 @@ void Relation::setNumOfTuples(unsigned int newNumOfTuples)
  * Returns the size in bytes of the relation *
  *********************************************/
 
-unsigned int Relation::getSize() const
+unsigned long long Relation::getSize() const
 {
     return numOfTuples * sizeof(Tuple);
 }
@@ -66,7 +66,7 @@ void Relation::print(void (*visitTuple)(void *, unsigned int),
     void (*contextBetweenTuples)()) const
 {
     /* Auxiliary variable used for counting */
-    unsigned int i;
+    unsigned long long i;
 
     /* If a no-null 'contextBetweenTuples' operation has been
      * given to print context between the tuples, we call it now
@@ -15,25 +15,27 @@ private:
 /* The array of tuples (always in the heap) */
 	Tuple *tuples;
 
-/* The amount of tuples in the array */
-	unsigned int numOfTuples;
+/* The amount of tuples in the array (the row IDs of the tuples are 32-bit,
+ * but the amount of tuples is not bounded by them)
+ */
+	unsigned long long numOfTuples;
 
 public:
 
 /* Constructor & Destructor */
-	Relation(Tuple *tuples = NULL, unsigned int numOfTuples = 0);
+	Relation(Tuple *tuples = NULL, unsigned long long numOfTuples = 0);
 	~Relation();
 
 /* Getters */
 	Tuple *getTuples() const;
-	unsigned int getNumOfTuples() const;
+	unsigned long long getNumOfTuples() const;
 
 /* Setters */
 	void setTuples(Tuple *newTuples);
-	void setNumOfTuples(unsigned int newNumOfTuples);
+	void setNumOfTuples(unsigned long long newNumOfTuples);
 
 /* Returns the size in bytes of the relation */
-	unsigned int getSize() const;
+	unsigned long long getSize() const;
 
 /* Prints all the tuples of the relation */
 	void print(void (*visitTuple)(void *, unsigned int),
@@ -6,7 +6,7 @@
  ***************/
 
 RowIdRelation::RowIdRelation(RowIdPair *rowIdPairs,
-    unsigned int numOfRowIdPairs)
+    unsigned long long numOfRowIdPairs)
 {
     this->rowIdPairs = rowIdPairs;
     this->numOfRowIdPairs = numOfRowIdPairs;
@@ -31,7 +31,7 @@ RowIdPair *RowIdRelation::getRowIdPairs() const
  * Getter - Returns the number of row ID pairs in the array *
  ************************************************************/
 
-unsigned int RowIdRelation::getNumOfRowIdPairs() const
+unsigned long long RowIdRelation::getNumOfRowIdPairs() const
 {
     return numOfRowIdPairs;
 }
@@ -44,7 +44,7 @@ void RowIdRelation::print(void (*visitRowIdPair)(unsigned int, unsigned int),
     void (*contextBetweenRowIdPairs)()) const
 {
     /* Auxiliary variable used for counting */
-    unsigned int i;
+    unsigned long long i;
 
     /* If a no-null 'contextBetweenRowIdPairs' operation has been
      * given to print context between the pairs, we call it now
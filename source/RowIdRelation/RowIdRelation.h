@@ -10,14 +10,16 @@ private:
 /* The array of row ID pairs (always in the heap) */
     RowIdPair *rowIdPairs;
 
-/* The number of row ID pairs in the array */
-    unsigned int numOfRowIdPairs;
+/* The number of row ID pairs in the array (a join may produce more
+ * pairs than a 32-bit row ID can count)
+ */
+    unsigned long long numOfRowIdPairs;
 
 public:
 
 /* Constructor */
     RowIdRelation(RowIdPair *rowIdPairs = NULL,
-        unsigned int numOfRowIdPairs = 0);
+        unsigned long long numOfRowIdPairs = 0);
 
 /* Destructor */
     ~RowIdRelation();
@@ -26,7 +28,7 @@ public:
     RowIdPair *getRowIdPairs() const;
 
 /* Getter - Returns the number of row ID pairs in the array */
-    unsigned int getNumOfRowIdPairs() const;
+    unsigned long long getNumOfRowIdPairs() const;
 
 /* Prints all the row ID pairs of the relation */
 	void print(void (*visitRowIdPair)(unsigned int, unsigned int),
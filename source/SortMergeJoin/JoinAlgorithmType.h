@@ -0,0 +1,29 @@
+#ifndef _JOIN_ALGORITHM_TYPE_H_
+#define _JOIN_ALGORITHM_TYPE_H_
+
+/* An enumeration with all the algorithms that may execute a join predicate */
+
+enum JoinAlgorithmType {
+
+    /* The Partitioned Hash Join Algorithm */
+    HashJoinAlgorithm,
+
+    /* The Sort-Merge Join Algorithm */
+    SortMergeJoinAlgorithm,
+
+    /* The Array Join Algorithm, if the keys of one of the relations of the
+     * join are dense enough to index an array (else the Partitioned Hash
+     * Join Algorithm)
+     */
+    ArrayJoinAlgorithm,
+
+    /* The Array Join Algorithm if the statistics of a joined column show
+     * dense keys, else the Sort-Merge Join Algorithm if both relations of
+     * the join are (nearly) sorted by their keys, else the Partitioned
+     * Hash Join Algorithm
+     */
+    AutoJoinAlgorithm
+
+};
+
+#endif
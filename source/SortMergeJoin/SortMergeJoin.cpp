@@ -0,0 +1,612 @@
+#include <cstdio>
+#include <cstring>
+#include "SortMergeJoin.h"
+
+/****************************************************************
+ * Returns the position of the first of the given sorted tuples *
+ *             whose key is not smaller than 'key'              *
+ ****************************************************************/
+
+static unsigned int lowerBound(SortedTuple *tuples, unsigned int tuplesNum,
+    unsigned long long key)
+{
+    unsigned int low = 0, high = tuplesNum;
+
+    while(low < high)
+    {
+        unsigned int middle = low + (high - low) / 2;
+
+        if(tuples[middle].key < key)
+            low = middle + 1;
+
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/****************************************************************
+ * Returns the position of the first of the given sorted tuples *
+ *                whose key is larger than 'key'                *
+ ****************************************************************/
+
+static unsigned int upperBound(SortedTuple *tuples, unsigned int tuplesNum,
+    unsigned long long key)
+{
+    unsigned int low = 0, high = tuplesNum;
+
+    while(low < high)
+    {
+        unsigned int middle = low + (high - low) / 2;
+
+        if(tuples[middle].key <= key)
+            low = middle + 1;
+
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/*******************************************************************
+ * Returns the amount of bits that are needed to represent 'value' *
+ *******************************************************************/
+
+static unsigned int significantBits(unsigned long long value)
+{
+    unsigned int bits = 0;
+
+    while(value != 0)
+    {
+        value >>= 1;
+        bits++;
+    }
+
+    return bits;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+SortMergeJoin::SortMergeJoin(Relation *relR, Relation *relS,
+    JobScheduler *jobScheduler)
+{
+    this->relR = relR;
+    this->relS = relS;
+    this->jobScheduler = jobScheduler;
+}
+
+/**************
+ * Destructor *
+ **************/
+
+SortMergeJoin::~SortMergeJoin()
+{
+
+}
+
+/************************************************************
+ * Getter - Returns what the last call of 'executeJoin' did *
+ ************************************************************/
+
+JoinStatistics SortMergeJoin::getStatistics() const
+{
+    return statistics;
+}
+
+/********************************************************************
+ * Returns the share of a sample of the pairs of adjacent tuples of *
+ *          the relation whose keys are in ascending order          *
+ ********************************************************************/
+
+double SortMergeJoin::getSortedness(Relation *relation)
+{
+    Tuple *tuples = relation->getTuples();
+    unsigned int tuplesNum = relation->getNumOfTuples();
+
+    /* A relation with at most one tuple is always sorted */
+    if(tuplesNum < 2)
+        return 1.0;
+
+    /* We examine evenly spaced pairs of adjacent tuples */
+    unsigned int pairsNum = tuplesNum - 1;
+    unsigned int sampledNum = (pairsNum < SORTEDNESS_SAMPLE_SIZE)
+        ? pairsNum : SORTEDNESS_SAMPLE_SIZE;
+    unsigned int step = pairsNum / sampledNum;
+    unsigned int ascendingNum = 0;
+
+    for(unsigned int i = 0; i < sampledNum; i++)
+    {
+        unsigned int pos = i * step;
+
+        if(*((unsigned long long *) tuples[pos].getItem())
+            <= *((unsigned long long *) tuples[pos + 1].getItem()))
+        {
+            ascendingNum++;
+        }
+    }
+
+    return ((double) ascendingNum) / ((double) sampledNum);
+}
+
+/*******************************************************************
+ * Copies the keys and the row IDs of the given relation and finds *
+ *    the smallest and the largest key and whether the keys are    *
+ *                         already sorted                          *
+ *******************************************************************/
+
+SortedTuple *SortMergeJoin::copyTuples(Relation *relation,
+    unsigned long long *minKey, unsigned long long *maxKey, bool *isSorted)
+{
+    Tuple *tuples = relation->getTuples();
+    unsigned int tuplesNum = relation->getNumOfTuples();
+    SortedTuple *copies = new SortedTuple[tuplesNum];
+
+    *minKey = ~0ULL;
+    *maxKey = 0;
+    *isSorted = true;
+
+    for(unsigned int i = 0; i < tuplesNum; i++)
+    {
+        copies[i].key = *((unsigned long long *) tuples[i].getItem());
+        copies[i].rowId = tuples[i].getRowId();
+
+        if(copies[i].key < *minKey)
+            *minKey = copies[i].key;
+
+        if(copies[i].key > *maxKey)
+            *maxKey = copies[i].key;
+
+        if(i > 0 && copies[i].key < copies[i - 1].key)
+            *isSorted = false;
+    }
+
+    return copies;
+}
+
+/*******************************************************************
+ * Sorts the given tuples by the rightmost 'bitsNum' bits of their *
+ *  keys minus 'minKey' (it is also used as the routine of a job)  *
+ *******************************************************************/
+
+void SortMergeJoin::sortRange(SortedTuple *tuples, SortedTuple *buffer,
+    unsigned int tuplesNum, unsigned long long minKey, unsigned int bitsNum)
+{
+    unsigned int i;
+
+    /* A few tuples are sorted faster with insertion sort */
+    if(tuplesNum <= INSERTION_SORT_THRESHOLD)
+    {
+        for(i = 1; i < tuplesNum; i++)
+        {
+            SortedTuple current = tuples[i];
+            unsigned int j = i;
+
+            while(j > 0 && tuples[j - 1].key > current.key)
+            {
+                tuples[j] = tuples[j - 1];
+                j--;
+            }
+
+            tuples[j] = current;
+        }
+
+        return;
+    }
+
+    /* Else every pass of the radix sort moves the tuples from one
+     * array to the other, stably sorted by the next digit of the keys
+     */
+    const unsigned int digitsNum = 1 << SORT_RADIX_BITS;
+    const unsigned long long digitMask = digitsNum - 1;
+
+    SortedTuple *source = tuples;
+    SortedTuple *target = buffer;
+    unsigned int counts[digitsNum];
+
+    for(unsigned int shift = 0; shift < bitsNum; shift += SORT_RADIX_BITS)
+    {
+        memset(counts, 0, sizeof(counts));
+
+        for(i = 0; i < tuplesNum; i++)
+            counts[((source[i].key - minKey) >> shift) & digitMask]++;
+
+        /* If every tuple has the same digit, the pass would not move them */
+        if(counts[((source[0].key - minKey) >> shift) & digitMask] == tuplesNum)
+            continue;
+
+        /* The counts become the positions where every digit starts */
+        unsigned int position = 0;
+
+        for(unsigned int digit = 0; digit < digitsNum; digit++)
+        {
+            unsigned int count = counts[digit];
+            counts[digit] = position;
+            position += count;
+        }
+
+        for(i = 0; i < tuplesNum; i++)
+            target[counts[((source[i].key - minKey) >> shift) & digitMask]++] = source[i];
+
+        SortedTuple *temp = source;
+        source = target;
+        target = temp;
+    }
+
+    /* The sorted tuples must end up in the given array */
+    if(source != tuples)
+        memcpy(tuples, source, tuplesNum * sizeof(SortedTuple));
+}
+
+/******************************************************
+ * The routine of a sort job, which calls 'sortRange' *
+ *         with the fields of the given input         *
+ ******************************************************/
+
+void SortMergeJoin::sortJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    SortJobInput *sortJobInput = (SortJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    sortRange(
+        sortJobInput->tuples,
+        sortJobInput->buffer,
+        sortJobInput->tuplesNum,
+        sortJobInput->minKey,
+        sortJobInput->bitsNum
+    );
+}
+
+/**************************************************************
+ * Sorts the given tuples by their keys and returns the array *
+ *     ('tuples' or 'buffer') where they ended up sorted      *
+ **************************************************************/
+
+SortedTuple *SortMergeJoin::sortTuples(SortedTuple *tuples, SortedTuple *buffer,
+    unsigned int tuplesNum, unsigned long long minKey,
+    unsigned long long maxKey) const
+{
+    /* The keys minus the smallest one have at most this many bits */
+    unsigned int bitsNum = (tuplesNum > 0) ? significantBits(maxKey - minKey) : 0;
+
+    /* If a single digit covers the keys, a single sort is enough */
+    if(bitsNum <= SORT_RADIX_BITS || tuplesNum <= INSERTION_SORT_THRESHOLD)
+    {
+        sortRange(tuples, buffer, tuplesNum, minKey, bitsNum);
+        return tuples;
+    }
+
+    /* Else we scatter the tuples in the buffer by the leftmost digit of
+     * their keys, so every range of the buffer can be sorted on its own
+     * by the rest of the bits (and fits in the caches more easily)
+     */
+    const unsigned int digitsNum = 1 << SORT_RADIX_BITS;
+    unsigned int restBitsNum = bitsNum - SORT_RADIX_BITS;
+    unsigned int i, counts[digitsNum], starts[digitsNum + 1];
+
+    memset(counts, 0, sizeof(counts));
+
+    for(i = 0; i < tuplesNum; i++)
+        counts[(tuples[i].key - minKey) >> restBitsNum]++;
+
+    starts[0] = 0;
+
+    for(unsigned int digit = 0; digit < digitsNum; digit++)
+    {
+        starts[digit + 1] = starts[digit] + counts[digit];
+        counts[digit] = starts[digit];
+    }
+
+    for(i = 0; i < tuplesNum; i++)
+        buffer[counts[(tuples[i].key - minKey) >> restBitsNum]++] = tuples[i];
+
+    /* Without a job scheduler we sort the ranges one after the other */
+    if(jobScheduler == NULL)
+    {
+        for(unsigned int digit = 0; digit < digitsNum; digit++)
+        {
+            sortRange(&buffer[starts[digit]], &tuples[starts[digit]],
+                starts[digit + 1] - starts[digit], minKey, restBitsNum);
+        }
+
+        return buffer;
+    }
+
+    /* Else every non-empty range is sorted by a job. The original
+     * array is used as the buffer of the passes of every range.
+     */
+    SortJobInput *sortJobInputs[digitsNum];
+    Job *sortJobs[digitsNum];
+    unsigned int jobsNum = 0;
+
+    for(unsigned int digit = 0; digit < digitsNum; digit++)
+    {
+        if(starts[digit + 1] == starts[digit])
+            continue;
+
+        sortJobInputs[jobsNum] = new SortJobInput(&buffer[starts[digit]],
+            &tuples[starts[digit]], starts[digit + 1] - starts[digit],
+            minKey, restBitsNum);
+
+        sortJobs[jobsNum] = new Job(sortJob, sortJobInputs[jobsNum]);
+
+        jobScheduler->submitJob(sortJobs[jobsNum]);
+        jobsNum++;
+    }
+
+    /* We request the scheduler to execute all jobs and
+     * then sleep until all the jobs have been finished
+     */
+    jobScheduler->executeAllJobs();
+    jobScheduler->waitAllTasksFinish();
+
+    for(i = 0; i < jobsNum; i++)
+    {
+        delete sortJobs[i];
+        delete sortJobInputs[i];
+    }
+
+    return buffer;
+}
+
+/*******************************************************************
+ * Merges the given sorted ranges of 'R' and 'S' into row ID pairs *
+ *    and deposits them in the given output buffer (it is also     *
+ *                  used as the routine of a job)                  *
+ *******************************************************************/
+
+void SortMergeJoin::mergeRanges(SortedTuple *R_tuples, unsigned int R_tuplesNum,
+    SortedTuple *S_tuples, unsigned int S_tuplesNum, RowIdRelation **result)
+{
+    /* The pairs are appended to an array that doubles when it is full */
+    unsigned long long capacity = MIN_MERGE_RESULT_CAPACITY;
+    unsigned long long pairsNum = 0;
+    RowIdPair *pairs = new RowIdPair[capacity];
+
+    unsigned int r = 0, s = 0;
+
+    while(r < R_tuplesNum && s < S_tuplesNum)
+    {
+        if(R_tuples[r].key < S_tuples[s].key)
+        {
+            r++;
+            continue;
+        }
+
+        if(R_tuples[r].key > S_tuples[s].key)
+        {
+            s++;
+            continue;
+        }
+
+        /* We find the runs of both ranges with the common key */
+        unsigned long long key = R_tuples[r].key;
+        unsigned int R_runEnd = r + 1, S_runEnd = s + 1;
+
+        while(R_runEnd < R_tuplesNum && R_tuples[R_runEnd].key == key)
+            R_runEnd++;
+
+        while(S_runEnd < S_tuplesNum && S_tuples[S_runEnd].key == key)
+            S_runEnd++;
+
+        /* Every tuple of one run is paired with every tuple of the other */
+        unsigned long long runPairsNum = ((unsigned long long) (R_runEnd - r))
+            * (S_runEnd - s);
+
+        while(pairsNum + runPairsNum > capacity)
+        {
+            RowIdPair *largerPairs = new RowIdPair[2 * capacity];
+
+            for(unsigned long long i = 0; i < pairsNum; i++)
+                largerPairs[i] = pairs[i];
+
+            delete[] pairs;
+
+            pairs = largerPairs;
+            capacity *= 2;
+        }
+
+        for(unsigned int i = r; i < R_runEnd; i++)
+        {
+            for(unsigned int j = s; j < S_runEnd; j++)
+                pairs[pairsNum++] = RowIdPair(R_tuples[i].rowId, S_tuples[j].rowId);
+        }
+
+        r = R_runEnd;
+        s = S_runEnd;
+    }
+
+    *result = new RowIdRelation(pairs, pairsNum);
+}
+
+/*********************************************************
+ * The routine of a merge job, which calls 'mergeRanges' *
+ *          with the fields of the given input           *
+ *********************************************************/
+
+void SortMergeJoin::mergeJob(void *input)
+{
+    /* We recover the input of the job from the generic pointer */
+    MergeJobInput *mergeJobInput = (MergeJobInput *) input;
+
+    /* We execute the routine of the job with its input */
+    mergeRanges(
+        mergeJobInput->R_tuples,
+        mergeJobInput->R_tuplesNum,
+        mergeJobInput->S_tuples,
+        mergeJobInput->S_tuplesNum,
+        mergeJobInput->result
+    );
+}
+
+/*******************************************************************
+ * Merges the sorted tuples of both relations into row ID pairs by *
+ *  splitting 'R' in ranges of different keys that are merged by   *
+ *                         different jobs                          *
+ *******************************************************************/
+
+RowIdRelation *SortMergeJoin::mergeTuples(SortedTuple *R_tuples,
+    unsigned int R_tuplesNum, SortedTuple *S_tuples, unsigned int S_tuplesNum) const
+{
+    RowIdRelation *result;
+
+    /* Without a job scheduler the relations are merged at once */
+    if(jobScheduler == NULL || R_tuplesNum == 0 || S_tuplesNum == 0)
+    {
+        mergeRanges(R_tuples, R_tuplesNum, S_tuples, S_tuplesNum, &result);
+        return result;
+    }
+
+    /* We split 'R' in a few ranges per thread. A range never ends in the
+     * middle of a run of equal keys, so the ranges of 'S' that have the
+     * same keys as them do not overlap.
+     */
+    unsigned int rangesNum = jobScheduler->getMaxThreads() * MERGE_RANGES_PER_THREAD;
+
+    if(rangesNum > R_tuplesNum)
+        rangesNum = R_tuplesNum;
+
+    unsigned int *R_starts = new unsigned int[rangesNum + 1];
+    unsigned int i, actualRangesNum = 0;
+
+    R_starts[0] = 0;
+
+    for(i = 1; i < rangesNum; i++)
+    {
+        unsigned int start = (unsigned int) (((unsigned long long) i * R_tuplesNum) / rangesNum);
+
+        if(start <= R_starts[actualRangesNum])
+            continue;
+
+        start = upperBound(R_tuples, R_tuplesNum, R_tuples[start - 1].key);
+
+        if(start >= R_tuplesNum)
+            break;
+
+        if(start > R_starts[actualRangesNum])
+            R_starts[++actualRangesNum] = start;
+    }
+
+    R_starts[++actualRangesNum] = R_tuplesNum;
+
+    /* Every range of 'R' is merged with the range of 'S' between its
+     * smallest and its largest key by a job with its own output buffer
+     */
+    RowIdRelation **results = new RowIdRelation*[actualRangesNum];
+    MergeJobInput **mergeJobInputs = new MergeJobInput*[actualRangesNum];
+    Job **mergeJobs = new Job*[actualRangesNum];
+
+    for(i = 0; i < actualRangesNum; i++)
+    {
+        unsigned int R_start = R_starts[i], R_end = R_starts[i + 1];
+        unsigned int S_start = lowerBound(S_tuples, S_tuplesNum, R_tuples[R_start].key);
+        unsigned int S_end = upperBound(S_tuples, S_tuplesNum, R_tuples[R_end - 1].key);
+
+        mergeJobInputs[i] = new MergeJobInput(&R_tuples[R_start], R_end - R_start,
+            &S_tuples[S_start], S_end - S_start, &results[i]);
+
+        mergeJobs[i] = new Job(mergeJob, mergeJobInputs[i]);
+
+        jobScheduler->submitJob(mergeJobs[i]);
+    }
+
+    jobScheduler->executeAllJobs();
+    jobScheduler->waitAllTasksFinish();
+
+    /* We concatenate the output buffers in the order of the ranges */
+    unsigned long long pairsNum = 0;
+
+    for(i = 0; i < actualRangesNum; i++)
+        pairsNum += results[i]->getNumOfRowIdPairs();
+
+    RowIdPair *pairs = new RowIdPair[pairsNum];
+    unsigned long long position = 0;
+
+    for(i = 0; i < actualRangesNum; i++)
+    {
+        RowIdPair *rangePairs = results[i]->getRowIdPairs();
+        unsigned long long rangePairsNum = results[i]->getNumOfRowIdPairs();
+
+        for(unsigned long long j = 0; j < rangePairsNum; j++)
+            pairs[position++] = rangePairs[j];
+
+        freeJoinResult(results[i]);
+        delete mergeJobs[i];
+        delete mergeJobInputs[i];
+    }
+
+    delete[] results;
+    delete[] mergeJobInputs;
+    delete[] mergeJobs;
+    delete[] R_starts;
+
+    return new RowIdRelation(pairs, pairsNum);
+}
+
+/******************************************
+ * Executes the Sort-Merge Join Algorithm *
+ ******************************************/
+
+RowIdRelation *SortMergeJoin::executeJoin()
+{
+    /* Nothing has been done by this call yet */
+    statistics = JoinStatistics();
+    statistics.algorithm = SortMergeJoinAlgorithm;
+
+    /* We copy the keys of both relations next to their row IDs */
+    unsigned long long R_minKey, R_maxKey, S_minKey, S_maxKey;
+    bool R_isSorted, S_isSorted;
+
+    SortedTuple *R_tuples = copyTuples(relR, &R_minKey, &R_maxKey, &R_isSorted);
+    SortedTuple *S_tuples = copyTuples(relS, &S_minKey, &S_maxKey, &S_isSorted);
+
+    unsigned int R_tuplesNum = relR->getNumOfTuples();
+    unsigned int S_tuplesNum = relS->getNumOfTuples();
+
+    /* Only the relations that are not already sorted are sorted */
+    if(!R_isSorted)
+    {
+        SortedTuple *R_buffer = new SortedTuple[R_tuplesNum];
+        SortedTuple *R_sorted = sortTuples(R_tuples, R_buffer, R_tuplesNum,
+            R_minKey, R_maxKey);
+
+        /* We keep the array where the tuples ended up sorted */
+        delete[] ((R_sorted == R_tuples) ? R_buffer : R_tuples);
+        R_tuples = R_sorted;
+    }
+
+    if(!S_isSorted)
+    {
+        SortedTuple *S_buffer = new SortedTuple[S_tuplesNum];
+        SortedTuple *S_sorted = sortTuples(S_tuples, S_buffer, S_tuplesNum,
+            S_minKey, S_maxKey);
+
+        delete[] ((S_sorted == S_tuples) ? S_buffer : S_tuples);
+        S_tuples = S_sorted;
+    }
+
+    /* We merge the sorted relations */
+    RowIdRelation *result = mergeTuples(R_tuples, R_tuplesNum, S_tuples, S_tuplesNum);
+
+    delete[] R_tuples;
+    delete[] S_tuples;
+
+    return result;
+}
+
+/*****************************************************
+ * Frees the result that was returned by executeJoin *
+ *****************************************************/
+
+void SortMergeJoin::freeJoinResult(RowIdRelation *resultOfExecuteJoin)
+{
+    if(resultOfExecuteJoin != NULL)
+    {
+        delete[] resultOfExecuteJoin->getRowIdPairs();
+        delete resultOfExecuteJoin;
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef _SORT_MERGE_JOIN_H_
+#define _SORT_MERGE_JOIN_H_
+
+#include "Relation.h"
+#include "RowIdRelation.h"
+#include "JobScheduler.h"
+#include "PartitionedHashJoin.h"
+
+/* The amount of bits of the key every pass of the radix sort sorts by */
+#define SORT_RADIX_BITS 8
+
+/* Ranges with at most this many tuples are sorted with insertion sort */
+#define INSERTION_SORT_THRESHOLD 32
+
+/* The amount of evenly spaced pairs of adjacent tuples that are
+ * examined to estimate how sorted a relation is
+ */
+#define SORTEDNESS_SAMPLE_SIZE 4096
+
+/* A relation is considered nearly sorted if at least this share of the
+ * sampled pairs of adjacent tuples has its keys in ascending order
+ */
+#define MIN_SORTED_SHARE 0.95
+
+/* The amount of ranges of 'R' that are merged by different jobs per thread */
+#define MERGE_RANGES_PER_THREAD 4
+
+/* The least amount of row ID pairs a merge job makes room for */
+#define MIN_MERGE_RESULT_CAPACITY 1024
+
+/* The key of a tuple copied next to its row ID, so the sort and the
+ * merge read the keys sequentially instead of through the tuples
+ */
+struct SortedTuple {
+
+    unsigned long long key;
+    unsigned int rowId;
+
+};
+
+/* The Sort-Merge Join Algorithm, an alternative to the Partitioned Hash
+ * Join Algorithm with the same result for relations that are already
+ * (or nearly) sorted by their keys, like base tables clustered by the
+ * joined column.
+ *
+ * The keys of each relation are copied next to their row IDs. A relation
+ * that is already sorted is not sorted again. Any other relation is split
+ * in up to 2 ^ 'SORT_RADIX_BITS' ranges by the leftmost bits of its keys
+ * (after the smallest key is subtracted) and every range is sorted with
+ * a least significant digit radix sort by the rest of the bits. Then the
+ * sorted tuples of 'R' are split in ranges of different keys and every
+ * range is merged with the tuples of 'S' that have the same keys. The
+ * ranges are sorted and merged by the threads of the job scheduler.
+ */
+class SortMergeJoin {
+
+private:
+
+/* The relations that take part in the join operation */
+    Relation *relR;
+    Relation *relS;
+
+/* A job scheduler that we will use for parallel execution
+ * of the sorts and the merges ('NULL' to execute them serially)
+ */
+    JobScheduler *jobScheduler;
+
+/* What the last call of 'executeJoin' did */
+    JoinStatistics statistics;
+
+/* Copies the keys and the row IDs of the given relation and finds the
+ * smallest and the largest key and whether the keys are already sorted
+ */
+    static SortedTuple *copyTuples(Relation *relation, unsigned long long *minKey,
+        unsigned long long *maxKey, bool *isSorted);
+
+/* Sorts the given tuples by their keys. Returns the sorted tuples, which
+ * are either the given array or 'buffer' (the other one may be freed).
+ */
+    SortedTuple *sortTuples(SortedTuple *tuples, SortedTuple *buffer,
+        unsigned int tuplesNum, unsigned long long minKey,
+        unsigned long long maxKey) const;
+
+/* Merges the sorted tuples of both relations into row ID pairs */
+    RowIdRelation *mergeTuples(SortedTuple *R_tuples, unsigned int R_tuplesNum,
+        SortedTuple *S_tuples, unsigned int S_tuplesNum) const;
+
+public:
+
+/* Constructor */
+    SortMergeJoin(Relation *relR, Relation *relS, JobScheduler *jobScheduler = NULL);
+
+/* Destructor */
+    ~SortMergeJoin();
+
+/* Getter - Returns what the last call of 'executeJoin' did */
+    JoinStatistics getStatistics() const;
+
+/* Executes the Sort-Merge Join Algorithm. The result has the same row ID
+ * pairs as the result of the Partitioned Hash Join Algorithm (the row ID
+ * of 'R' is the left one) and it is freed with 'freeJoinResult'.
+ */
+    RowIdRelation *executeJoin();
+
+/* Frees the result that was returned by 'executeJoin' */
+    static void freeJoinResult(RowIdRelation *resultOfExecuteJoin);
+
+/* Returns the share (between 0.0 and 1.0) of a sample of the pairs of
+ * adjacent tuples of the relation whose keys are in ascending order
+ */
+    static double getSortedness(Relation *relation);
+
+/* Sorts the given tuples by the rightmost 'bitsNum' bits of their keys
+ * minus 'minKey' (the rest of the bits must be equal), using 'buffer'
+ * (of the same size) for the passes. The tuples end up in 'tuples'.
+ *
+ * Used by the sort jobs.
+ */
+    static void sortRange(SortedTuple *tuples, SortedTuple *buffer,
+        unsigned int tuplesNum, unsigned long long minKey, unsigned int bitsNum);
+
+/* The routine of a sort job, which calls 'sortRange' with the
+ * fields of the given input (a 'SortJobInput')
+ */
+    static void sortJob(void *input);
+
+/* Merges the given sorted ranges of 'R' and 'S' into row ID pairs, which
+ * are deposited in the given output buffer.
+ *
+ * Used by the merge jobs.
+ */
+    static void mergeRanges(SortedTuple *R_tuples, unsigned int R_tuplesNum,
+        SortedTuple *S_tuples, unsigned int S_tuplesNum, RowIdRelation **result);
+
+/* The routine of a merge job, which calls 'mergeRanges' with the
+ * fields of the given input (a 'MergeJobInput')
+ */
+    static void mergeJob(void *input);
+
+};
+
+#endif
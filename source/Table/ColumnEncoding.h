@@ -0,0 +1,24 @@
+#ifndef _COLUMN_ENCODING_H_
+#define _COLUMN_ENCODING_H_
+
+/* An enumeration with all the ways a compressed column may be encoded */
+
+enum ColumnEncoding {
+
+	/* Frame-Of-Reference: The minimum element of the column is
+	 * subtracted from every element and the differences are
+	 * stored with as few bits as the greatest difference needs
+	 */
+	FrameOfReference,
+
+	/* Dictionary: The distinct elements of the column are stored
+	 * sorted in a dictionary and each row stores the position of its
+	 * element in the dictionary with as few bits as the position of
+	 * the last dictionary entry needs. Since the dictionary is sorted,
+	 * comparing positions is the same as comparing the elements.
+	 */
+	Dictionary
+
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "ColumnIndex.h"
+
+/* A row of the column along with its element (used to sort the rows) */
+struct IndexEntry {
+    unsigned long long element;
+    unsigned int rowId;
+};
+
+/******************************************************************
+ * Compares two entries by their element and then by their row ID *
+ ******************************************************************/
+
+static int compareIndexEntries(const void *item1, const void *item2)
+{
+    const IndexEntry *entry1 = (const IndexEntry *) item1;
+    const IndexEntry *entry2 = (const IndexEntry *) item2;
+
+    if(entry1->element != entry2->element)
+        return (entry1->element < entry2->element) ? -1 : 1;
+
+    if(entry1->rowId != entry2->rowId)
+        return (entry1->rowId < entry2->rowId) ? -1 : 1;
+
+    return 0;
+}
+
+/********************************************************************
+ * Returns the position of the first sorted element that is greater *
+ * than or equal to the given element (or strictly greater than the *
+ *               given element if 'strict' is 'true')               *
+ ********************************************************************/
+
+static unsigned long long searchSorted(const unsigned long long *sortedElements,
+    unsigned long long size, unsigned long long element, bool strict)
+{
+    /* We perform binary search in the range [low, high) */
+    unsigned long long low = 0, high = size;
+
+    while(low < high)
+    {
+        unsigned long long middle = low + (high - low) / 2;
+
+        if(sortedElements[middle] < element || (strict && sortedElements[middle] == element))
+            low = middle + 1;
+
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+ColumnIndex::ColumnIndex(const unsigned long long *column, unsigned long long size)
+{
+    /* Auxiliary variables (used for counting) */
+    unsigned long long i, j;
+
+    /* We store the amount of rows of the column */
+    this->size = size;
+
+    /* We pair every row with its element and we sort the pairs */
+
+    IndexEntry *entries = new IndexEntry[size];
+
+    for(i = 0; i < size; i++)
+    {
+        entries[i].element = column[i];
+        entries[i].rowId = i;
+    }
+
+    qsort(entries, size, sizeof(IndexEntry), compareIndexEntries);
+
+    /* We split the sorted pairs to the permutation of row IDs and the
+     * sorted elements, while we count the distinct elements of the column
+     */
+    sortedRowIds = new unsigned int[size];
+    sortedElements = new unsigned long long[size];
+
+    unsigned long long distinctsNum = 0;
+
+    for(i = 0; i < size; i++)
+    {
+        sortedRowIds[i] = entries[i].rowId;
+        sortedElements[i] = entries[i].element;
+
+        if(i == 0 || entries[i].element != entries[i - 1].element)
+            distinctsNum++;
+    }
+
+    delete[] entries;
+
+    /* The hash index has at least twice as many slots as the distinct
+     * elements, so the probing sequences remain short
+     */
+    slotsNum = 1;
+
+    while(slotsNum < 2 * distinctsNum)
+        slotsNum <<= 1;
+
+    slotElements = new unsigned long long[slotsNum];
+    slotRunStarts = new unsigned long long[slotsNum];
+    slotRunEnds = new unsigned long long[slotsNum];
+    memset(slotRunEnds, 0, slotsNum * sizeof(unsigned long long));
+
+    /* We insert every run of equal elements of the permutation in the index */
+
+    for(i = 0; i < size; i = j)
+    {
+        /* We find where the run of the current element ends */
+        for(j = i + 1; j < size && sortedElements[j] == sortedElements[i]; j++);
+
+        /* We store the run in the slot of its element */
+        unsigned long long slot = findSlot(sortedElements[i]);
+
+        slotElements[slot] = sortedElements[i];
+        slotRunStarts[slot] = i;
+        slotRunEnds[slot] = j;
+    }
+}
+
+/**************
+ * Destructor *
+ **************/
+
+ColumnIndex::~ColumnIndex()
+{
+    delete[] sortedRowIds;
+    delete[] sortedElements;
+    delete[] slotElements;
+    delete[] slotRunStarts;
+    delete[] slotRunEnds;
+}
+
+/**************************************************************
+ * Returns the slot of the hash index where the given element *
+ *    is stored or the empty slot where it would be stored    *
+ **************************************************************/
+
+unsigned long long ColumnIndex::findSlot(unsigned long long element) const
+{
+    /* We scramble the bits of the element to pick its first slot */
+    unsigned long long slot = (element * 0x9E3779B97F4A7C15ULL) & (slotsNum - 1);
+
+    /* We probe the next slots until we find the element or an empty slot */
+    while(slotRunEnds[slot] != 0 && slotElements[slot] != element)
+        slot = (slot + 1) & (slotsNum - 1);
+
+    return slot;
+}
+
+/*************************************************************
+ * Getter - Returns the amount of rows of the indexed column *
+ *************************************************************/
+
+unsigned long long ColumnIndex::getSize() const
+{
+    return size;
+}
+
+/**************************************************
+ * Returns the amount of bytes the index occupies *
+ **************************************************/
+
+unsigned long long ColumnIndex::getMemoryBytes() const
+{
+    return size * (sizeof(unsigned int) + sizeof(unsigned long long))
+        + slotsNum * 3 * sizeof(unsigned long long);
+}
+
+/*********************************************************************
+ * Points 'rowIds' to the sorted row IDs whose element satisfies the *
+ *       range filter and returns the amount of those row IDs        *
+ *********************************************************************/
+
+unsigned long long ColumnIndex::rangeLookup(
+    char filterOperator,
+    unsigned long long filterValue,
+    const unsigned int **rowIds) const
+{
+    /* Case of '<' - The satisfying rows are the ones
+     * before the first element that is not smaller
+     */
+    if(filterOperator == '<')
+    {
+        (*rowIds) = sortedRowIds;
+        return searchSorted(sortedElements, size, filterValue, false);
+    }
+
+    /* Case of '>' - The satisfying rows are the ones
+     * after the last element that is smaller or equal
+     */
+    if(filterOperator == '>')
+    {
+        unsigned long long firstGreater = searchSorted(sortedElements,
+            size, filterValue, true);
+
+        (*rowIds) = sortedRowIds + firstGreater;
+        return size - firstGreater;
+    }
+
+    /* Case of '=' - The hash index is used */
+    return equalityLookup(filterValue, rowIds);
+}
+
+/************************************************************************
+ * Points 'rowIds' to the (ascending) row IDs whose element is equal to *
+ *      the given element and returns the amount of those row IDs       *
+ ************************************************************************/
+
+unsigned long long ColumnIndex::equalityLookup(
+    unsigned long long element,
+    const unsigned int **rowIds) const
+{
+    /* We find the slot of the element in the hash index */
+    unsigned long long slot = findSlot(element);
+
+    /* If the slot is empty, the element does not exist in the column */
+    if(slotRunEnds[slot] == 0)
+    {
+        (*rowIds) = NULL;
+        return 0;
+    }
+
+    /* Else the rows of the element are the run of the slot */
+    (*rowIds) = sortedRowIds + slotRunStarts[slot];
+    return slotRunEnds[slot] - slotRunStarts[slot];
+}
@@ -0,0 +1,75 @@
+#ifndef _COLUMN_INDEX_H_
+#define _COLUMN_INDEX_H_
+
+/* A secondary index on a column of a table. It is built once and it is
+ * kept in the table, so all the queries of a workload may use it.
+ *
+ * The index consists of:
+ *
+ * 1) The row IDs of the column sorted by their element (ties are broken
+ *    by the row ID). The rows that satisfy a range filter ('<' or '>')
+ *    are a consecutive part of this permutation.
+ *
+ * 2) A hash index that maps every distinct element of the column to the
+ *    consecutive part of the permutation with the rows of that element.
+ *    It is used by equality filters and index nested-loop joins.
+ */
+class ColumnIndex {
+
+private:
+
+    /* The amount of rows of the indexed column */
+    unsigned long long size;
+
+    /* The row IDs of the column sorted by their element */
+    unsigned int *sortedRowIds;
+
+    /* The elements of the column in the order of 'sortedRowIds' */
+    unsigned long long *sortedElements;
+
+    /* The amount of slots of the hash index (a power of two) */
+    unsigned long long slotsNum;
+
+    /* The distinct element stored in each slot of the hash index */
+    unsigned long long *slotElements;
+
+    /* The part [runStart, runEnd) of the permutation with the rows of the
+     * element of each slot. A slot with 'runEnd' equal to zero is empty.
+     */
+    unsigned long long *slotRunStarts;
+    unsigned long long *slotRunEnds;
+
+    /* Returns the slot of the hash index where the given element
+     * is stored or the empty slot where it would be stored
+     */
+    unsigned long long findSlot(unsigned long long element) const;
+
+public:
+
+    /* Constructor - Builds the index of the given column */
+    ColumnIndex(const unsigned long long *column, unsigned long long size);
+
+    /* Destructor */
+    ~ColumnIndex();
+
+    /* Getter - Returns the amount of rows of the indexed column */
+    unsigned long long getSize() const;
+
+    /* Returns the amount of bytes the index occupies */
+    unsigned long long getMemoryBytes() const;
+
+    /* Points 'rowIds' to the sorted row IDs whose element satisfies the
+     * range filter ('<' or '>') and returns the amount of those row IDs
+     */
+    unsigned long long rangeLookup(char filterOperator, unsigned long long filterValue,
+        const unsigned int **rowIds) const;
+
+    /* Points 'rowIds' to the (ascending) row IDs whose element is equal to
+     * the given element and returns the amount of those row IDs
+     */
+    unsigned long long equalityLookup(unsigned long long element,
+        const unsigned int **rowIds) const;
+
+};
+
+#endif
@@ -0,0 +1,601 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "CompressedColumn.h"
+
+/*****************************************************************
+ * Returns the amount of bits needed to represent the given code *
+ *****************************************************************/
+
+static unsigned int bitsNeeded(unsigned long long code)
+{
+    /* Auxiliary variable that will be storing the amount of bits */
+    unsigned int bits = 0;
+
+    /* We shift the code to the right until nothing is left of it */
+
+    while(code != 0)
+    {
+        bits++;
+        code >>= 1;
+    }
+
+    return bits;
+}
+
+/*****************************************************************
+ * Compares two elements of a dictionary (used for sorting them) *
+ *****************************************************************/
+
+static int compareDictionaryElements(const void *item1, const void *item2)
+{
+    unsigned long long element1 = *((const unsigned long long *) item1);
+    unsigned long long element2 = *((const unsigned long long *) item2);
+
+    if(element1 < element2)
+        return -1;
+
+    if(element1 > element2)
+        return 1;
+
+    return 0;
+}
+
+/**********************************************************************
+ * Returns the position of the first element of the sorted dictionary *
+ *   that is greater than or equal to the given value (lower bound)   *
+ **********************************************************************/
+
+static unsigned long long lowerBound(unsigned long long *dictionary,
+    unsigned long long dictionarySize, unsigned long long value)
+{
+    /* We perform binary search in the range [low, high) */
+    unsigned long long low = 0, high = dictionarySize;
+
+    while(low < high)
+    {
+        unsigned long long middle = low + (high - low) / 2;
+
+        if(dictionary[middle] < value)
+            low = middle + 1;
+
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/***************
+ * Constructor *
+ ***************/
+
+CompressedColumn::CompressedColumn(
+    unsigned long long *column,
+    unsigned long long size,
+    unsigned long long maxDictionarySize)
+{
+    /* Auxiliary variable (used for counting) */
+    unsigned long long i;
+
+    /* We initialize the fields of the class that do not depend on the data */
+    this->size = size;
+    this->dictionary = NULL;
+    this->dictionarySize = 0;
+
+    /* We find the min & max element of the column */
+    unsigned long long minElement = (size == 0) ? 0 : column[0];
+    unsigned long long maxElement = minElement;
+
+    for(i = 1; i < size; i++)
+    {
+        if(column[i] < minElement)
+            minElement = column[i];
+
+        if(column[i] > maxElement)
+            maxElement = column[i];
+    }
+
+    /* The bits each code needs with Frame-Of-Reference encoding */
+    unsigned int frameOfReferenceBits = bitsNeeded(maxElement - minElement);
+
+    /* We will try to gather the distinct elements of the column in a hash
+     * set with open addressing. The set has at least twice as many slots as
+     * the maximum allowed dictionary size, so it never becomes too crowded.
+     * If more distinct elements are found than the dictionary may hold, we
+     * give up and the column is encoded with Frame-Of-Reference.
+     */
+    bool dictionaryFits = (maxDictionarySize > 0 && frameOfReferenceBits > 1);
+
+    if(dictionaryFits)
+    {
+        /* The amount of slots of the set (a power of two) */
+        unsigned long long slotsNum = 1;
+
+        while(slotsNum < 2 * maxDictionarySize)
+            slotsNum <<= 1;
+
+        /* The elements of the set and which slots are occupied */
+        unsigned long long *slots = new unsigned long long[slotsNum];
+        bool *occupied = new bool[slotsNum];
+        memset(occupied, 0, slotsNum * sizeof(bool));
+
+        /* The distinct elements found so far */
+        unsigned long long *distinctElements = new unsigned long long[maxDictionarySize];
+        unsigned long long distinctsNum = 0;
+
+        for(i = 0; i < size && dictionaryFits; i++)
+        {
+            /* We scramble the bits of the element to pick its slot */
+            unsigned long long slot = (column[i] * 0x9E3779B97F4A7C15ULL) & (slotsNum - 1);
+
+            /* We probe the next slots until we find the element or an empty slot */
+            while(occupied[slot] && slots[slot] != column[i])
+                slot = (slot + 1) & (slotsNum - 1);
+
+            /* If the element was found, it is not a new distinct element */
+            if(occupied[slot])
+                continue;
+
+            /* If the dictionary is full, the column does not fit in it */
+            if(distinctsNum == maxDictionarySize)
+            {
+                dictionaryFits = false;
+                break;
+            }
+
+            /* We insert the new distinct element in the set */
+            occupied[slot] = true;
+            slots[slot] = column[i];
+            distinctElements[distinctsNum++] = column[i];
+        }
+
+        /* We free the hash set, we do not need it anymore */
+        delete[] occupied;
+        delete[] slots;
+
+        /* The dictionary is worth it only if its codes need fewer bits */
+        if(dictionaryFits && bitsNeeded(distinctsNum - 1) < frameOfReferenceBits)
+        {
+            /* We sort the distinct elements to form the dictionary */
+            qsort(distinctElements, distinctsNum, sizeof(unsigned long long),
+                compareDictionaryElements);
+
+            dictionary = new unsigned long long[distinctsNum];
+            memcpy(dictionary, distinctElements, distinctsNum * sizeof(unsigned long long));
+            dictionarySize = distinctsNum;
+        }
+
+        delete[] distinctElements;
+    }
+
+    /* We set the encoding parameters depending on the chosen encoding */
+
+    if(dictionary != NULL)
+    {
+        encoding = Dictionary;
+        base = 0;
+        maxCode = dictionarySize - 1;
+    }
+
+    else
+    {
+        encoding = FrameOfReference;
+        base = minElement;
+        maxCode = maxElement - minElement;
+    }
+
+    bitWidth = bitsNeeded(maxCode);
+
+    /* We allocate the packed words. We reserve one extra word,
+     * so the code of the last row can always be read with two
+     * consecutive words, even if it does not cross a word.
+     */
+    unsigned long long wordsNum = (size * bitWidth + 63) / 64 + 1;
+    packedCodes = new unsigned long long[wordsNum];
+    memset(packedCodes, 0, wordsNum * sizeof(unsigned long long));
+
+    /* We pack the code of every row after the code of the previous row */
+
+    for(i = 0; i < size; i++)
+    {
+        /* We find the code of the current row */
+        unsigned long long code = (encoding == Dictionary)
+            ? lowerBound(dictionary, dictionarySize, column[i])
+            : column[i] - base;
+
+        /* The bit where the code of the row starts */
+        unsigned long long bitPos = i * bitWidth;
+        unsigned long long word = bitPos >> 6;
+        unsigned int offset = bitPos & 63;
+
+        /* We place the low bits of the code in the current word */
+        packedCodes[word] |= code << offset;
+
+        /* If the code crosses the word, the rest bits go to the next word */
+        if(offset + bitWidth > 64)
+            packedCodes[word + 1] |= code >> (64 - offset);
+    }
+}
+
+/**************
+ * Destructor *
+ **************/
+
+CompressedColumn::~CompressedColumn()
+{
+    delete[] packedCodes;
+
+    if(dictionary != NULL)
+        delete[] dictionary;
+}
+
+/*********************************************
+ * Returns the code stored for the given row *
+ *********************************************/
+
+unsigned long long CompressedColumn::extractCode(unsigned long long row) const
+{
+    /* The bit where the code of the row starts */
+    unsigned long long bitPos = row * bitWidth;
+    unsigned long long word = bitPos >> 6;
+    unsigned int offset = bitPos & 63;
+
+    /* We read the low bits of the code from the current word */
+    unsigned long long code = packedCodes[word] >> offset;
+
+    /* If the code crosses the word, we read the rest bits from the next word */
+    if(offset + bitWidth > 64)
+        code |= packedCodes[word + 1] << (64 - offset);
+
+    /* We keep only the bits of the code */
+    if(bitWidth < 64)
+        code &= (1ULL << bitWidth) - 1;
+
+    return code;
+}
+
+/*********************************************************************
+ * Translates a code back to the element of the column it represents *
+ *********************************************************************/
+
+unsigned long long CompressedColumn::decode(unsigned long long code) const
+{
+    if(encoding == Dictionary)
+        return dictionary[code];
+
+    return base + code;
+}
+
+/*************************************************************************
+ * Translates the given filter to the range [lowCode, highCode] of codes *
+ * that satisfy it. Returns 'false' if no code can satisfy the filter    *
+ *************************************************************************/
+
+bool CompressedColumn::filterToCodeRange(
+    char filterOperator,
+    unsigned long long filterValue,
+    unsigned long long *lowCode,
+    unsigned long long *highCode) const
+{
+    /* An empty column has no codes at all */
+    if(size == 0)
+        return false;
+
+    /* Case of Dictionary encoding - We search the filter value in the
+     * dictionary. The codes of all the elements smaller than the value
+     * are smaller than the position returned by the search.
+     */
+    if(encoding == Dictionary)
+    {
+        unsigned long long pos = lowerBound(dictionary, dictionarySize, filterValue);
+        bool found = (pos < dictionarySize && dictionary[pos] == filterValue);
+
+        switch(filterOperator)
+        {
+            /* The elements smaller than the value have codes [0, pos-1] */
+
+            case '<':
+            {
+                if(pos == 0)
+                    return false;
+
+                (*lowCode) = 0;
+                (*highCode) = pos - 1;
+                return true;
+            }
+
+            /* The elements greater than the value start after
+             * the value itself (if it is in the dictionary)
+             */
+            case '>':
+            {
+                unsigned long long firstGreater = found ? pos + 1 : pos;
+
+                if(firstGreater >= dictionarySize)
+                    return false;
+
+                (*lowCode) = firstGreater;
+                (*highCode) = maxCode;
+                return true;
+            }
+
+            /* Only the code of the value itself satisfies the filter */
+
+            case '=':
+            {
+                if(!found)
+                    return false;
+
+                (*lowCode) = pos;
+                (*highCode) = pos;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Case of Frame-Of-Reference encoding - The codes are the
+     * elements minus the base, so we subtract the base from the value
+     */
+    switch(filterOperator)
+    {
+        case '<':
+        {
+            if(filterValue <= base)
+                return false;
+
+            (*lowCode) = 0;
+            (*highCode) = (filterValue - base - 1 < maxCode)
+                ? filterValue - base - 1 : maxCode;
+            return true;
+        }
+
+        case '>':
+        {
+            if(filterValue < base)
+            {
+                (*lowCode) = 0;
+                (*highCode) = maxCode;
+                return true;
+            }
+
+            if(filterValue - base >= maxCode)
+                return false;
+
+            (*lowCode) = filterValue - base + 1;
+            (*highCode) = maxCode;
+            return true;
+        }
+
+        case '=':
+        {
+            if(filterValue < base || filterValue - base > maxCode)
+                return false;
+
+            (*lowCode) = filterValue - base;
+            (*highCode) = filterValue - base;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************
+ * Getter - Returns the way the elements of the column are encoded *
+ *******************************************************************/
+
+ColumnEncoding CompressedColumn::getEncoding() const
+{
+    return encoding;
+}
+
+/*****************************************************
+ * Getter - Returns the amount of rows of the column *
+ *****************************************************/
+
+unsigned long long CompressedColumn::getSize() const
+{
+    return size;
+}
+
+/***********************************************************
+ * Getter - Returns the amount of bits of each packed code *
+ ***********************************************************/
+
+unsigned int CompressedColumn::getBitWidth() const
+{
+    return bitWidth;
+}
+
+/**************************************************************
+ * Returns the amount of bytes the compressed column occupies *
+ **************************************************************/
+
+unsigned long long CompressedColumn::getCompressedBytes() const
+{
+    return ((size * bitWidth + 63) / 64 + 1) * sizeof(unsigned long long)
+        + dictionarySize * sizeof(unsigned long long);
+}
+
+/******************************************************
+ * Returns the element of the column in the given row *
+ ******************************************************/
+
+unsigned long long CompressedColumn::getValue(unsigned long long row) const
+{
+    return decode(extractCode(row));
+}
+
+/****************************************************************
+ * Decodes the elements of the given rows to the 'result' array *
+ ****************************************************************/
+
+void CompressedColumn::gather(
+    const unsigned int *rowIds,
+    unsigned long long rowsNum,
+    unsigned long long *result) const
+{
+    /* Auxiliary variable (used for counting) */
+    unsigned long long i;
+
+    /* Case we decode specific rows of the column */
+
+    if(rowIds != NULL)
+    {
+        for(i = 0; i < rowsNum; i++)
+            result[i] = decode(extractCode(rowIds[i]));
+
+        return;
+    }
+
+    /* Case we decode the first 'rowsNum' rows of the column */
+
+    for(i = 0; i < rowsNum; i++)
+        result[i] = decode(extractCode(i));
+}
+
+/******************************************************************
+ * Stores in 'result' the offsets of the given rows whose element *
+ *   satisfies the filter and returns the amount of those rows    *
+ ******************************************************************/
+
+unsigned long long CompressedColumn::filter(
+    char filterOperator,
+    unsigned long long filterValue,
+    const unsigned int *rowIds,
+    unsigned long long rowsNum,
+    unsigned int *result) const
+{
+    /* We translate the filter to a range of codes. If no code
+     * can satisfy the filter, there is no row to examine at all.
+     */
+    unsigned long long lowCode, highCode;
+
+    if(!filterToCodeRange(filterOperator, filterValue, &lowCode, &highCode))
+        return 0;
+
+    /* The width of the range of codes that satisfy the filter */
+    unsigned long long rangeWidth = highCode - lowCode;
+
+    /* Auxiliary variables (used for counting) */
+    unsigned long long i, matchesNum = 0;
+
+    /* We compare only the packed codes of the rows. A code is in the range
+     * [lowCode, highCode] if the (unsigned) difference 'code - lowCode' does
+     * not exceed the width of the range. This way a single comparison
+     * is performed for every row, no matter the filter operator.
+     */
+    if(rowIds != NULL)
+    {
+        for(i = 0; i < rowsNum; i++)
+        {
+            if(extractCode(rowIds[i]) - lowCode <= rangeWidth)
+                result[matchesNum++] = i;
+        }
+    }
+
+    else
+    {
+        for(i = 0; i < rowsNum; i++)
+        {
+            if(extractCode(i) - lowCode <= rangeWidth)
+                result[matchesNum++] = i;
+        }
+    }
+
+    return matchesNum;
+}
+
+/*********************************************************************
+ * Stores in 'result' the IDs of the rows in [fromRow, toRow) whose  *
+ * element satisfies the filter and returns the amount of those rows *
+ *********************************************************************/
+
+unsigned long long CompressedColumn::filterRange(
+    char filterOperator,
+    unsigned long long filterValue,
+    unsigned long long fromRow,
+    unsigned long long toRow,
+    unsigned int *result) const
+{
+    /* We translate the filter to a range of codes (see 'filter') */
+    unsigned long long lowCode, highCode;
+
+    if(!filterToCodeRange(filterOperator, filterValue, &lowCode, &highCode))
+        return 0;
+
+    unsigned long long rangeWidth = highCode - lowCode;
+    unsigned long long i, matchesNum = 0;
+
+    /* We compare the packed codes of the rows of the range */
+
+    for(i = fromRow; i < toRow; i++)
+    {
+        if(extractCode(i) - lowCode <= rangeWidth)
+            result[matchesNum++] = i;
+    }
+
+    return matchesNum;
+}
+
+/*****************************************************
+ * Returns the sum of the elements of the given rows *
+ *****************************************************/
+
+unsigned long long CompressedColumn::sum(
+    const unsigned int *rowIds,
+    unsigned long long rowsNum) const
+{
+    /* Auxiliary variables (used for counting and summing) */
+    unsigned long long i, codesSum = 0;
+
+    /* Case of Dictionary encoding - We sum the dictionary entries */
+
+    if(encoding == Dictionary)
+    {
+        for(i = 0; i < rowsNum; i++)
+            codesSum += dictionary[extractCode((rowIds != NULL) ? rowIds[i] : i)];
+
+        return codesSum;
+    }
+
+    /* Case of Frame-Of-Reference encoding - We sum the codes and we add
+     * the base once for every row. The 64-bit sum wraps around exactly
+     * like the sum of the decoded elements would.
+     */
+    for(i = 0; i < rowsNum; i++)
+        codesSum += extractCode((rowIds != NULL) ? rowIds[i] : i);
+
+    return codesSum + rowsNum * base;
+}
+
+/************************************************************
+ * Returns 'true' if the given element exists in the column *
+ ************************************************************/
+
+bool CompressedColumn::contains(unsigned long long value) const
+{
+    /* Every element of the dictionary exists in the column */
+    if(encoding == Dictionary)
+    {
+        unsigned long long pos = lowerBound(dictionary, dictionarySize, value);
+        return (pos < dictionarySize && dictionary[pos] == value);
+    }
+
+    /* Else we search the code of the value among the codes of the rows */
+    if(size == 0 || value < base || value - base > maxCode)
+        return false;
+
+    unsigned long long code = value - base, i;
+
+    for(i = 0; i < size; i++)
+    {
+        if(extractCode(i) == code)
+            return true;
+    }
+
+    return false;
+}
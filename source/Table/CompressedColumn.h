@@ -0,0 +1,116 @@
+#ifndef _COMPRESSED_COLUMN_H_
+#define _COMPRESSED_COLUMN_H_
+
+#include "ColumnEncoding.h"
+
+/* A column of a table stored in a compressed form. Each row of the
+ * column is represented by a code of 'bitWidth' bits and all the
+ * codes are packed one after the other in an array of 64-bit words.
+ *
+ * The filter, gather and sum operations of the class work directly on
+ * the packed codes. The filter value is translated once to a range of
+ * codes, so the rows are filtered without decoding their elements.
+ */
+class CompressedColumn {
+
+private:
+
+    /* The way the elements of the column are encoded */
+    ColumnEncoding encoding;
+
+    /* The amount of rows of the column */
+    unsigned long long size;
+
+    /* The element that is subtracted from every element
+     * of the column in case of Frame-Of-Reference encoding
+     */
+    unsigned long long base;
+
+    /* The amount of bits of each packed code */
+    unsigned int bitWidth;
+
+    /* The greatest code that appears in the column */
+    unsigned long long maxCode;
+
+    /* The codes of all the rows, packed in 64-bit words */
+    unsigned long long *packedCodes;
+
+    /* The sorted distinct elements of the column (Dictionary encoding) */
+    unsigned long long *dictionary;
+
+    /* The amount of entries of the dictionary */
+    unsigned long long dictionarySize;
+
+    /* Returns the code stored for the given row */
+    unsigned long long extractCode(unsigned long long row) const;
+
+    /* Translates a code back to the element of the column it represents */
+    unsigned long long decode(unsigned long long code) const;
+
+    /* Translates the given filter to the range [lowCode, highCode] of codes
+     * that satisfy it. Returns 'false' if no code can satisfy the filter.
+     */
+    bool filterToCodeRange(char filterOperator, unsigned long long filterValue,
+        unsigned long long *lowCode, unsigned long long *highCode) const;
+
+public:
+
+    /* Constructor - Compresses the given column. Dictionary encoding is
+     * chosen if the column has at most 'maxDictionarySize' distinct
+     * elements and the dictionary codes need fewer bits than the
+     * Frame-Of-Reference codes. Else Frame-Of-Reference is chosen.
+     */
+    CompressedColumn(unsigned long long *column, unsigned long long size,
+        unsigned long long maxDictionarySize);
+
+    /* Destructor */
+    ~CompressedColumn();
+
+    /* Getter - Returns the way the elements of the column are encoded */
+    ColumnEncoding getEncoding() const;
+
+    /* Getter - Returns the amount of rows of the column */
+    unsigned long long getSize() const;
+
+    /* Getter - Returns the amount of bits of each packed code */
+    unsigned int getBitWidth() const;
+
+    /* Returns the amount of bytes the compressed column occupies */
+    unsigned long long getCompressedBytes() const;
+
+    /* Returns the element of the column in the given row */
+    unsigned long long getValue(unsigned long long row) const;
+
+    /* Decodes the elements of the given rows to the 'result' array. If
+     * 'rowIds' is NULL, the rows 0, 1, ..., rowsNum - 1 are decoded.
+     */
+    void gather(const unsigned int *rowIds, unsigned long long rowsNum,
+        unsigned long long *result) const;
+
+    /* Stores in 'result' the offsets (in 'rowIds') of the given rows whose
+     * element satisfies the filter and returns the amount of them. If
+     * 'rowIds' is NULL, the rows 0, 1, ..., rowsNum - 1 are examined, so
+     * the offsets are the row IDs themselves.
+     */
+    unsigned long long filter(char filterOperator, unsigned long long filterValue,
+        const unsigned int *rowIds, unsigned long long rowsNum,
+        unsigned int *result) const;
+
+    /* Stores in 'result' the IDs of the rows in [fromRow, toRow) whose
+     * element satisfies the filter and returns the amount of those rows
+     */
+    unsigned long long filterRange(char filterOperator, unsigned long long filterValue,
+        unsigned long long fromRow, unsigned long long toRow,
+        unsigned int *result) const;
+
+    /* Returns the sum of the elements of the given rows. If 'rowIds'
+     * is NULL, the rows 0, 1, ..., rowsNum - 1 are summed.
+     */
+    unsigned long long sum(const unsigned int *rowIds, unsigned long long rowsNum) const;
+
+    /* Returns 'true' if the given element exists in the column */
+    bool contains(unsigned long long value) const;
+
+};
+
+#endif
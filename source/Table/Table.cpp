@@ -1,18 +1,93 @@
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
+#include <climits>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include "Table.h"
 
+/******************************************************************
+ * Translates the given filter to the range [low, high] of values *
+ *  that satisfy it. Returns 'false' if no value can satisfy it   *
+ ******************************************************************/
+
+static bool filterToRange(char filterOperator, unsigned long long filterValue,
+    unsigned long long *low, unsigned long long *high)
+{
+    switch(filterOperator)
+    {
+        /* The values smaller than the filter value satisfy '<' */
+
+        case '<':
+        {
+            if(filterValue == 0)
+                return false;
+
+            (*low) = 0;
+            (*high) = filterValue - 1;
+            return true;
+        }
+
+        /* The values greater than the filter value satisfy '>' */
+
+        case '>':
+        {
+            if(filterValue == ULLONG_MAX)
+                return false;
+
+            (*low) = filterValue + 1;
+            (*high) = ULLONG_MAX;
+            return true;
+        }
+
+        /* Only the filter value itself satisfies '=' */
+
+        case '=':
+        {
+            (*low) = filterValue;
+            (*high) = filterValue;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /***************
  * Constructor *
  ***************/
 
-Table::Table(const char *binary_filename, unsigned int maxBitmapSize)
+Table::Table(
+    const char *binary_filename,
+    unsigned int maxBitmapSize,
+    StatisticsSampling sampling,
+    unsigned long long sampleSize,
+    unsigned long long blockSize,
+    bool refineInBackground)
 {
+    /* We store the maximum bitmap size, because a background
+     * refinement of the statistics may need it later
+     */
+    this->maxBitmapSize = maxBitmapSize;
+
+    /* No statistics have been computed from samples yet */
+    sampledColumnStatistics = NULL;
+    refinementStarted = false;
+    statisticsVersion = 0;
+
+    /* The table is not compressed when it is loaded */
+    compressedColumns = NULL;
+
+    /* No zone maps exist when the table is loaded */
+    zoneMaps = NULL;
+
+    /* No indexes exist when the table is loaded */
+    columnIndexes = NULL;
+    buildIndexesOnFirstUse = false;
+    pthread_mutex_init(&indexesMutex, NULL);
+
     /* We open the binary input file */
 
     int fd = open(binary_filename, O_RDONLY);
@@ -133,8 +208,39 @@ Table::Table(const char *binary_filename, unsigned int maxBitmapSize)
 
     columnStatistics = new ColumnStatistics *[numColumns];
 
-    for(i = 0; i < numColumns; i++)
-        columnStatistics[i] = new ColumnStatistics(table[i], numTuples, maxBitmapSize);
+    /* If sampling has been requested and the table has more rows than
+     * the sample, the statistics are computed from a sample of each column
+     */
+    if(sampling != NoSampling && numTuples > sampleSize)
+    {
+        for(i = 0; i < numColumns; i++)
+            columnStatistics[i] = new ColumnStatistics(table[i], numTuples,
+                maxBitmapSize, sampling, sampleSize, blockSize);
+
+        /* We remember which statistics are estimations */
+        sampledColumnStatistics = columnStatistics;
+
+        /* If requested, we start a thread that will replace the
+         * estimations with the exact statistics in the background
+         */
+        if(refineInBackground)
+        {
+            if(pthread_create(&refinementThread, NULL, refineStatistics, this) == 0)
+                refinementStarted = true;
+
+            else
+                std::cout << "Could not start the refinement of the statistics of "
+                    << binary_filename << std::endl;
+        }
+    }
+
+    /* Else the statistics are computed by visiting every row of each column */
+
+    else
+    {
+        for(i = 0; i < numColumns; i++)
+            columnStatistics[i] = new ColumnStatistics(table[i], numTuples, maxBitmapSize);
+    }
 }
 
 /**************
@@ -146,16 +252,65 @@ Table::~Table()
     /* Auxiliary variable used for counting */
     unsigned long long i;
 
+    /* If the statistics are being refined, we wait for the refinement
+     * to end, because the thread is reading the columns of the table
+     */
+    waitStatisticsRefinement();
+
     /* We delete the column statistics of each column */
 
     for(i = 0; i < numColumns; i++)
         delete columnStatistics[i];
 
+    /* If the sampled statistics have been replaced by the
+     * refined statistics, we delete the sampled ones as well
+     */
+    if(sampledColumnStatistics != NULL && sampledColumnStatistics != columnStatistics)
+    {
+        for(i = 0; i < numColumns; i++)
+            delete sampledColumnStatistics[i];
+
+        delete[] sampledColumnStatistics;
+    }
+
     /* We delete the array of column statistics for each column */
     delete[] columnStatistics;
 
-    /* We delete all the contents of the table */
+    /* We delete the secondary indexes (if any have been built) */
+
+    if(columnIndexes != NULL)
+    {
+        for(i = 0; i < numColumns; i++)
+            delete columnIndexes[i];
+
+        delete[] columnIndexes;
+    }
+
+    pthread_mutex_destroy(&indexesMutex);
+
+    /* We delete the zone maps (if they have been built) */
+
+    if(zoneMaps != NULL)
+    {
+        for(i = 0; i < numColumns; i++)
+            delete zoneMaps[i];
+
+        delete[] zoneMaps;
+    }
+
+    /* We delete the compressed columns (if the table has been compressed) */
 
+    if(compressedColumns != NULL)
+    {
+        for(i = 0; i < numColumns; i++)
+            delete compressedColumns[i];
+
+        delete[] compressedColumns;
+    }
+
+    /* We delete all the contents of the table
+     * (these are NULL if the table is compressed)
+     */
     for(i = 0; i < numColumns; i++)
         delete[] table[i];
 
@@ -196,7 +351,546 @@ unsigned long long **Table::getTable() const
 
 ColumnStatistics **Table::getColumnStatistics() const
 {
-    return columnStatistics;
+    /* The array may be replaced at any time by the refinement thread,
+     * so we read the pointer to the array atomically
+     */
+    return __atomic_load_n(&columnStatistics, __ATOMIC_ACQUIRE);
+}
+
+/********************************************************************
+ * Returns 'true' if any of the current statistics is an estimation *
+ ********************************************************************/
+
+bool Table::hasSampledStatistics() const
+{
+    return sampledColumnStatistics != NULL
+        && sampledColumnStatistics == getColumnStatistics();
+}
+
+/*********************************************************************
+ *  Returns a number that changes every time the statistics of the   *
+ * table change, so the users of the statistics can tell if they are *
+ *                             outdated                              *
+ *********************************************************************/
+
+unsigned int Table::getStatisticsVersion() const
+{
+    return __atomic_load_n(&statisticsVersion, __ATOMIC_ACQUIRE);
+}
+
+/********************************************************************
+ * Blocks until the background refinement of the statistics is over *
+ ********************************************************************/
+
+void Table::waitStatisticsRefinement()
+{
+    /* If no refinement is taking place, there is nothing to wait for */
+    if(!refinementStarted)
+        return;
+
+    /* We wait for the refinement thread to finish */
+    pthread_join(refinementThread, NULL);
+
+    /* The refinement is over */
+    refinementStarted = false;
+}
+
+/*******************************************************************
+ * The routine of the thread that computes the exact statistics of *
+ *   every column and then replaces the sampled ones with them     *
+ *******************************************************************/
+
+void *Table::refineStatistics(void *table)
+{
+    /* We retrieve the table whose statistics will be refined */
+    Table *tableToRefine = (Table *) table;
+
+    /* Auxiliary variable used for counting */
+    unsigned long long i;
+
+    /* We compute the exact statistics of every column in a new array */
+
+    ColumnStatistics **refinedStatistics =
+        new ColumnStatistics *[tableToRefine->numColumns];
+
+    for(i = 0; i < tableToRefine->numColumns; i++)
+        refinedStatistics[i] = new ColumnStatistics(tableToRefine->table[i],
+            tableToRefine->numTuples, tableToRefine->maxBitmapSize);
+
+    /* We replace the sampled statistics with the refined ones in a single
+     * atomic step. The sampled statistics are not deleted here, because an
+     * optimizer may be using them right now. They will be deleted along
+     * with the table.
+     */
+    __atomic_store_n(&tableToRefine->columnStatistics, refinedStatistics,
+        __ATOMIC_RELEASE);
+
+    /* The statistics of the table have now changed */
+    __atomic_add_fetch(&tableToRefine->statisticsVersion, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/***************************************************************************
+ * Compresses every column of the table and frees the uncompressed columns *
+ ***************************************************************************/
+
+void Table::compress(unsigned long long maxDictionarySize)
+{
+    /* If the table is already compressed, there is nothing to do */
+    if(compressedColumns != NULL)
+        return;
+
+    /* The refinement of the statistics reads the uncompressed
+     * columns, so we have to wait for it before we free them
+     */
+    waitStatisticsRefinement();
+
+    /* Auxiliary variable used for counting */
+    unsigned long long i;
+
+    /* We compress each column and free its uncompressed form */
+
+    compressedColumns = new CompressedColumn *[numColumns];
+
+    for(i = 0; i < numColumns; i++)
+    {
+        compressedColumns[i] = new CompressedColumn(table[i], numTuples, maxDictionarySize);
+
+        delete[] table[i];
+        table[i] = NULL;
+    }
+}
+
+/*************************************************************
+ * Returns 'true' if the columns of the table are compressed *
+ *************************************************************/
+
+bool Table::isCompressed() const
+{
+    return compressedColumns != NULL;
+}
+
+/************************************************************************
+ * Computes the min & max element of every block of rows of each column *
+ ************************************************************************/
+
+void Table::buildZoneMaps(unsigned long long blockSize)
+{
+    /* If the zone maps have already been built, there is nothing to do */
+    if(zoneMaps != NULL)
+        return;
+
+    /* Auxiliary variables used for counting */
+    unsigned long long i, block;
+
+    /* The elements of each block are copied here, so the zone maps
+     * can be built no matter if the table is compressed or not
+     */
+    zoneMaps = new ZoneMap *[numColumns];
+
+    for(i = 0; i < numColumns; i++)
+    {
+        /* We create the zone map of the current column */
+        zoneMaps[i] = new ZoneMap(blockSize, numTuples);
+
+        unsigned long long actualBlockSize = zoneMaps[i]->getBlockSize();
+        unsigned long long *blockElements = new unsigned long long[actualBlockSize];
+
+        /* We compute the range of every block of the column */
+
+        for(block = 0; block < zoneMaps[i]->getBlocksNum(); block++)
+        {
+            /* The first row of the block and the amount of its rows */
+            unsigned long long fromRow = block * actualBlockSize;
+            unsigned long long rowsOfBlock = (numTuples - fromRow < actualBlockSize)
+                ? numTuples - fromRow : actualBlockSize;
+
+            /* We read the elements of the block and we find their range */
+
+            if(compressedColumns != NULL)
+            {
+                for(unsigned long long j = 0; j < rowsOfBlock; j++)
+                    blockElements[j] = compressedColumns[i]->getValue(fromRow + j);
+
+                zoneMaps[i]->setBlockElements(block, blockElements, rowsOfBlock);
+            }
+
+            else
+                zoneMaps[i]->setBlockElements(block, table[i] + fromRow, rowsOfBlock);
+        }
+
+        delete[] blockElements;
+    }
+}
+
+/***************************************************************
+ * Getter - Returns the zone map of the given column (or NULL) *
+ ***************************************************************/
+
+ZoneMap *Table::getZoneMap(unsigned long long column) const
+{
+    if(zoneMaps == NULL)
+        return NULL;
+
+    return zoneMaps[column];
+}
+
+/********************************************************************
+ * Determines whether the index of a column is built the first time *
+ *               it is requested by 'getColumnIndex'                *
+ ********************************************************************/
+
+void Table::setBuildIndexesOnFirstUse(bool buildIndexesOnFirstUse)
+{
+    this->buildIndexesOnFirstUse = buildIndexesOnFirstUse;
+}
+
+/*************************************************************************
+ * Builds the secondary index of the given column (if it does not exist) *
+ *************************************************************************/
+
+void Table::buildColumnIndex(unsigned long long column)
+{
+    /* We lock the indexes, so no other thread builds the same index */
+    pthread_mutex_lock(&indexesMutex);
+
+    /* If no index has been built yet, we create the array of indexes */
+
+    if(columnIndexes == NULL)
+    {
+        columnIndexes = new ColumnIndex *[numColumns];
+
+        for(unsigned long long i = 0; i < numColumns; i++)
+            columnIndexes[i] = NULL;
+    }
+
+    /* If the column has no index yet, we build it now */
+
+    if(columnIndexes[column] == NULL)
+    {
+        /* The index is built from the uncompressed elements of the column */
+        unsigned long long *elements = new unsigned long long[numTuples];
+        gatherColumn(column, NULL, numTuples, elements);
+
+        columnIndexes[column] = new ColumnIndex(elements, numTuples);
+
+        delete[] elements;
+    }
+
+    pthread_mutex_unlock(&indexesMutex);
+}
+
+/*******************************************************
+ * Returns the secondary index of the given column. It *
+ *   is built now if indexes are built on first use    *
+ *******************************************************/
+
+ColumnIndex *Table::getColumnIndex(unsigned long long column)
+{
+    /* If the index of the column exists, we return it */
+
+    pthread_mutex_lock(&indexesMutex);
+
+    ColumnIndex *index = (columnIndexes != NULL) ? columnIndexes[column] : NULL;
+
+    pthread_mutex_unlock(&indexesMutex);
+
+    if(index != NULL)
+        return index;
+
+    /* If indexes are not built on first use, the column has no index */
+    if(!buildIndexesOnFirstUse)
+        return NULL;
+
+    /* Else we build the index of the column and return it */
+    buildColumnIndex(column);
+
+    return columnIndexes[column];
+}
+
+/************************************************************
+ * Returns the element of the given column in the given row *
+ ************************************************************/
+
+unsigned long long Table::getValue(unsigned long long column, unsigned long long row) const
+{
+    if(compressedColumns != NULL)
+        return compressedColumns[column]->getValue(row);
+
+    return table[column][row];
+}
+
+/***********************************************************************
+ * Copies the elements of the given rows of a column to 'result' array *
+ ***********************************************************************/
+
+void Table::gatherColumn(
+    unsigned long long column,
+    const unsigned int *rowIds,
+    unsigned long long rowsNum,
+    unsigned long long *result) const
+{
+    /* If the table is compressed, the column decodes the elements itself */
+    if(compressedColumns != NULL)
+    {
+        compressedColumns[column]->gather(rowIds, rowsNum, result);
+        return;
+    }
+
+    /* Else we copy the elements from the uncompressed column */
+
+    unsigned long long i;
+
+    if(rowIds == NULL)
+    {
+        memcpy(result, table[column], rowsNum * sizeof(unsigned long long));
+        return;
+    }
+
+    for(i = 0; i < rowsNum; i++)
+        result[i] = table[column][rowIds[i]];
+}
+
+/*********************************************************************
+ * Stores in 'result' the offsets of the given rows whose element in *
+ *  the column satisfies the filter and returns the amount of them   *
+ *********************************************************************/
+
+unsigned long long Table::filterColumn(
+    unsigned long long column,
+    char filterOperator,
+    unsigned long long filterValue,
+    const unsigned int *rowIds,
+    unsigned long long rowsNum,
+    unsigned int *result) const
+{
+    /* We translate the filter to a range of values. Then every element
+     * is examined with a single comparison (see 'CompressedColumn')
+     */
+    unsigned long long low, high;
+
+    if(!filterToRange(filterOperator, filterValue, &low, &high))
+        return 0;
+
+    unsigned long long i, matchesNum = 0;
+
+    /* Case specific rows are examined - The zone maps cannot help here,
+     * since the rows are not consecutive, so each row is examined
+     */
+    if(rowIds != NULL)
+    {
+        /* If the table is compressed, the column filters its packed codes */
+        if(compressedColumns != NULL)
+            return compressedColumns[column]->filter(filterOperator,
+                filterValue, rowIds, rowsNum, result);
+
+        unsigned long long rangeWidth = high - low;
+        unsigned long long *columnData = table[column];
+
+        for(i = 0; i < rowsNum; i++)
+        {
+            if(columnData[rowIds[i]] - low <= rangeWidth)
+                result[matchesNum++] = i;
+        }
+
+        return matchesNum;
+    }
+
+    /* Case the rows 0, 1, ..., rowsNum - 1 are examined without zone maps */
+
+    if(zoneMaps == NULL)
+        return filterRows(column, filterOperator, filterValue,
+            low, high, 0, rowsNum, result);
+
+    /* Else we examine the rows block by block with the help of the zone map */
+
+    ZoneMap *zoneMap = zoneMaps[column];
+    unsigned long long blockSize = zoneMap->getBlockSize();
+    unsigned long long block;
+
+    for(block = 0; block * blockSize < rowsNum; block++)
+    {
+        /* The first row of the block and the row after its last row */
+        unsigned long long fromRow = block * blockSize;
+        unsigned long long toRow = (rowsNum - fromRow < blockSize)
+            ? rowsNum : fromRow + blockSize;
+
+        /* If no element of the block can satisfy the filter, we skip it */
+        if(!zoneMap->mayOverlap(block, low, high))
+            continue;
+
+        /* If every element of the block satisfies the filter,
+         * all its rows are inserted without examining them
+         */
+        if(zoneMap->isContainedIn(block, low, high))
+        {
+            for(i = fromRow; i < toRow; i++)
+                result[matchesNum++] = i;
+
+            continue;
+        }
+
+        /* Else we examine every row of the block */
+        matchesNum += filterRows(column, filterOperator, filterValue,
+            low, high, fromRow, toRow, result + matchesNum);
+    }
+
+    return matchesNum;
+}
+
+/**************************************************************
+ * Stores in 'result' the IDs of the rows in [fromRow, toRow) *
+ *  whose element in the column is in the range [low, high]   *
+ **************************************************************/
+
+unsigned long long Table::filterRows(
+    unsigned long long column,
+    char filterOperator,
+    unsigned long long filterValue,
+    unsigned long long low,
+    unsigned long long high,
+    unsigned long long fromRow,
+    unsigned long long toRow,
+    unsigned int *result) const
+{
+    /* If the table is compressed, the column filters its packed codes */
+    if(compressedColumns != NULL)
+        return compressedColumns[column]->filterRange(filterOperator,
+            filterValue, fromRow, toRow, result);
+
+    /* Else we compare the uncompressed elements of the rows */
+
+    unsigned long long rangeWidth = high - low;
+    unsigned long long *columnData = table[column];
+    unsigned long long i, matchesNum = 0;
+
+    for(i = fromRow; i < toRow; i++)
+    {
+        if(columnData[i] - low <= rangeWidth)
+            result[matchesNum++] = i;
+    }
+
+    return matchesNum;
+}
+
+/******************************************************************
+ * Stores in 'result' the offsets (in 'rowIds') of the given rows *
+ *  whose elements satisfy all the given filters and returns the  *
+ *                      amount of those rows                      *
+ ******************************************************************/
+
+unsigned long long Table::filterColumns(
+    unsigned int filtersNum,
+    const unsigned long long *columns,
+    const char *filterOperators,
+    const unsigned long long *filterValues,
+    const unsigned int *rowIds,
+    unsigned long long rowsNum,
+    unsigned int *result,
+    unsigned long long *passedNums) const
+{
+    if(filtersNum == 0)
+        return 0;
+
+    /* The first filter examines all the given rows with its own kernel */
+    unsigned long long matchesNum = filterColumn(columns[0], filterOperators[0],
+        filterValues[0], rowIds, rowsNum, result);
+
+    if(passedNums != NULL)
+    {
+        passedNums[0] = matchesNum;
+
+        for(unsigned int k = 1; k < filtersNum; k++)
+            passedNums[k] = 0;
+    }
+
+    if(filtersNum == 1 || matchesNum == 0)
+        return matchesNum;
+
+    /* We translate the rest of the filters to ranges of values. A filter
+     * that no value can satisfy leaves no rows after it.
+     */
+    unsigned long long lows[filtersNum], rangeWidths[filtersNum];
+    unsigned int k, satisfiableNum = 1;
+
+    while(satisfiableNum < filtersNum && filterToRange(filterOperators[satisfiableNum],
+        filterValues[satisfiableNum], &lows[satisfiableNum], &rangeWidths[satisfiableNum]))
+    {
+        rangeWidths[satisfiableNum] -= lows[satisfiableNum];
+        satisfiableNum++;
+    }
+
+    /* Every row that satisfies the first filter is examined by the rest of
+     * the filters in their order, until one of them is not satisfied. The
+     * offsets of the satisfying rows overwrite the ones examined already.
+     */
+    unsigned long long i, fusedMatchesNum = 0;
+
+    for(i = 0; i < matchesNum; i++)
+    {
+        unsigned long long row = (rowIds != NULL) ? rowIds[result[i]] : result[i];
+
+        for(k = 1; k < satisfiableNum; k++)
+        {
+            if(getValue(columns[k], row) - lows[k] > rangeWidths[k])
+                break;
+
+            if(passedNums != NULL)
+                passedNums[k]++;
+        }
+
+        if(k == filtersNum)
+            result[fusedMatchesNum++] = result[i];
+    }
+
+    return fusedMatchesNum;
+}
+
+/*****************************************************************
+ * Returns the sum of the elements of the given rows of a column *
+ *****************************************************************/
+
+unsigned long long Table::sumColumn(
+    unsigned long long column,
+    const unsigned int *rowIds,
+    unsigned long long rowsNum) const
+{
+    /* If the table is compressed, the column sums its codes */
+    if(compressedColumns != NULL)
+        return compressedColumns[column]->sum(rowIds, rowsNum);
+
+    /* Else we sum the elements of the uncompressed column */
+
+    unsigned long long i, sum = 0;
+
+    for(i = 0; i < rowsNum; i++)
+        sum += table[column][(rowIds != NULL) ? rowIds[i] : i];
+
+    return sum;
+}
+
+/******************************************************************
+ * Returns 'true' if the given element exists in the given column *
+ ******************************************************************/
+
+bool Table::containsValue(unsigned long long column, unsigned long long value) const
+{
+    /* If the table is compressed, the column searches its codes */
+    if(compressedColumns != NULL)
+        return compressedColumns[column]->contains(value);
+
+    /* Else we search the element linearly */
+
+    unsigned long long i;
+
+    for(i = 0; i < numTuples; i++)
+    {
+        if(table[column][i] == value)
+            return true;
+    }
+
+    return false;
 }
 
 /**********************************************
@@ -218,7 +912,7 @@ void Table::print() const
         /* We print the contents of that column */
 
         for(j = 0; j < numTuples; j++)
-            std::cout << table[i][j] << " ";
+            std::cout << getValue(i, j) << " ";
 
         /* We announce the end of the column with a ']' */
         std::cout << "] ";
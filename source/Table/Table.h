@@ -1,8 +1,12 @@
 #ifndef _TABLE_H_
 #define _TABLE_H_
 
+#include <pthread.h>
 #include "List.h"
 #include "ColumnStatistics.h"
+#include "CompressedColumn.h"
+#include "ZoneMap.h"
+#include "ColumnIndex.h"
 
 /* A structure that will be storing the contents of all
  * rows and columns of a relation. Storing "by columns"
@@ -24,10 +28,67 @@ private:
     /* Statistic data stored for each column of the table */
     ColumnStatistics **columnStatistics;
 
+    /* The compressed form of each column. If the table has been
+     * compressed, the uncompressed columns of 'table' are freed
+     * and every access to the data goes through these columns.
+     * Else this is NULL.
+     */
+    CompressedColumn **compressedColumns;
+
+    /* The zone map of each column (NULL if no zone maps have been built) */
+    ZoneMap **zoneMaps;
+
+    /* The secondary index of each column (NULL for a column without one) */
+    ColumnIndex **columnIndexes;
+
+    /* 'true' if the index of a column is built the first time it is requested */
+    bool buildIndexesOnFirstUse;
+
+    /* A mutex that protects the indexes while they are being built */
+    pthread_mutex_t indexesMutex;
+
+    /* Stores in 'result' the IDs of the rows in [fromRow, toRow)
+     * whose element in the column is in the range [low, high]
+     */
+    unsigned long long filterRows(unsigned long long column, char filterOperator,
+        unsigned long long filterValue, unsigned long long low, unsigned long long high,
+        unsigned long long fromRow, unsigned long long toRow, unsigned int *result) const;
+
+    /* The maximum size of the bitmap used to count distinct elements */
+    unsigned int maxBitmapSize;
+
+    /* The statistics computed from samples of the columns. They are kept
+     * here after they have been replaced by the refined statistics, since
+     * an optimizer may still be using them at the moment of the replacement.
+     */
+    ColumnStatistics **sampledColumnStatistics;
+
+    /* Increases by one every time the statistics of the table are replaced */
+    unsigned int statisticsVersion;
+
+    /* The thread that refines the sampled statistics in the background */
+    pthread_t refinementThread;
+
+    /* 'true' if the refinement thread has been started */
+    bool refinementStarted;
+
+    /* The routine of the thread that computes the exact statistics of
+     * every column and then replaces the sampled ones with them
+     */
+    static void *refineStatistics(void *table);
+
 public:
 
-    /* Constructor & Destructor */
-    Table(const char *binary_filename, unsigned int maxBitmapSize = 50000000);
+    /* Constructor & Destructor
+     *
+     * If 'sampling' is not 'NoSampling', the statistics of every column with
+     * more than 'sampleSize' rows are computed from a sample of that column.
+     * If 'refineInBackground' is 'true', a thread is then started to replace
+     * the sampled statistics with the exact ones while the program proceeds.
+     */
+    Table(const char *binary_filename, unsigned int maxBitmapSize = 50000000,
+        StatisticsSampling sampling = NoSampling, unsigned long long sampleSize = 0,
+        unsigned long long blockSize = 0, bool refineInBackground = false);
     ~Table();
 
     /* Getter - Returns the number of rows of the table */
@@ -36,12 +97,101 @@ public:
     /* Getter - Returns the number of columns of the table */
     unsigned long long getNumOfColumns() const;
 
-    /* Getter - Returns a pointer to the table itself */
+    /* Getter - Returns a pointer to the table itself
+     *
+     * If the table has been compressed, the uncompressed columns do
+     * not exist anymore, so the access methods below must be used.
+     */
     unsigned long long **getTable() const;
 
     /* Getter - Returns the array of statistics for each column */
     ColumnStatistics **getColumnStatistics() const;
 
+    /* Returns 'true' if any of the current statistics is an estimation */
+    bool hasSampledStatistics() const;
+
+    /* Returns a number that changes every time the statistics of the table
+     * change, so the users of the statistics can tell if they are outdated
+     */
+    unsigned int getStatisticsVersion() const;
+
+    /* Blocks until the background refinement of the statistics is over */
+    void waitStatisticsRefinement();
+
+    /* Compresses every column of the table (see 'CompressedColumn') and frees
+     * the uncompressed columns. Columns with at most 'maxDictionarySize'
+     * distinct elements may be encoded with a dictionary.
+     */
+    void compress(unsigned long long maxDictionarySize);
+
+    /* Returns 'true' if the columns of the table are compressed */
+    bool isCompressed() const;
+
+    /* Computes the min & max element of every block of 'blockSize' rows of
+     * each column. Then a filter over all the rows of a column skips the
+     * blocks whose range cannot satisfy it (see 'filterColumn').
+     */
+    void buildZoneMaps(unsigned long long blockSize);
+
+    /* Getter - Returns the zone map of the given column (or NULL) */
+    ZoneMap *getZoneMap(unsigned long long column) const;
+
+    /* Determines whether the index of a column is built the first time
+     * it is requested by 'getColumnIndex' (by default it is not built)
+     */
+    void setBuildIndexesOnFirstUse(bool buildIndexesOnFirstUse);
+
+    /* Builds the secondary index of the given column (if it does not exist) */
+    void buildColumnIndex(unsigned long long column);
+
+    /* Returns the secondary index of the given column. If the column has no
+     * index yet, the index is built now if indexes are built on first use,
+     * else NULL is returned.
+     */
+    ColumnIndex *getColumnIndex(unsigned long long column);
+
+    /* Returns the element of the given column in the given row */
+    unsigned long long getValue(unsigned long long column, unsigned long long row) const;
+
+    /* Copies the elements of the given rows of a column to the 'result'
+     * array. If 'rowIds' is NULL, the rows 0, 1, ..., rowsNum - 1 are copied.
+     */
+    void gatherColumn(unsigned long long column, const unsigned int *rowIds,
+        unsigned long long rowsNum, unsigned long long *result) const;
+
+    /* Stores in 'result' the offsets (in 'rowIds') of the given rows whose
+     * element in the column satisfies the filter and returns the amount of
+     * those rows. If 'rowIds' is NULL, the rows 0, 1, ..., rowsNum - 1 are
+     * examined, so the offsets are the row IDs themselves. In that case the
+     * blocks of rows that the zone map of the column excludes are skipped.
+     */
+    unsigned long long filterColumn(unsigned long long column, char filterOperator,
+        unsigned long long filterValue, const unsigned int *rowIds,
+        unsigned long long rowsNum, unsigned int *result) const;
+
+    /* Like 'filterColumn', but the given rows must satisfy all the given
+     * filters. The first filter is applied by 'filterColumn' (so it may use
+     * the zone map and the packed codes of its column) and the rest of the
+     * filters are examined together in a single pass over the rows that
+     * satisfy it, in the given order. If 'passedNums' is not NULL, the
+     * amount of rows that satisfy the first k+1 filters is stored in
+     * 'passedNums[k]' for every filter.
+     */
+    unsigned long long filterColumns(unsigned int filtersNum,
+        const unsigned long long *columns, const char *filterOperators,
+        const unsigned long long *filterValues, const unsigned int *rowIds,
+        unsigned long long rowsNum, unsigned int *result,
+        unsigned long long *passedNums = NULL) const;
+
+    /* Returns the sum of the elements of the given rows of a column. If
+     * 'rowIds' is NULL, the rows 0, 1, ..., rowsNum - 1 are summed.
+     */
+    unsigned long long sumColumn(unsigned long long column,
+        const unsigned int *rowIds, unsigned long long rowsNum) const;
+
+    /* Returns 'true' if the given element exists in the given column */
+    bool containsValue(unsigned long long column, unsigned long long value) const;
+
     /* Prints the information stored in the table */
     void print() const;
 };
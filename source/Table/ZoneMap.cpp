@@ -0,0 +1,124 @@
+#include <iostream>
+#include "ZoneMap.h"
+
+/***************
+ * Constructor *
+ ***************/
+
+ZoneMap::ZoneMap(unsigned long long blockSize, unsigned long long size)
+{
+    /* A block must have at least one row */
+    this->blockSize = (blockSize == 0) ? 1 : blockSize;
+
+    /* We find how many blocks are needed to cover all the rows */
+    blocksNum = (size + this->blockSize - 1) / this->blockSize;
+
+    /* We allocate the ranges of the blocks */
+    minElements = new unsigned long long[blocksNum];
+    maxElements = new unsigned long long[blocksNum];
+}
+
+/**************
+ * Destructor *
+ **************/
+
+ZoneMap::~ZoneMap()
+{
+    delete[] minElements;
+    delete[] maxElements;
+}
+
+/*****************************************************************
+ * Getter - Returns the amount of consecutive rows of each block *
+ *****************************************************************/
+
+unsigned long long ZoneMap::getBlockSize() const
+{
+    return blockSize;
+}
+
+/*****************************************
+ * Getter - Returns the amount of blocks *
+ *****************************************/
+
+unsigned long long ZoneMap::getBlocksNum() const
+{
+    return blocksNum;
+}
+
+/*********************************************************************
+ * Getter - Returns the element with the smallest value in the block *
+ *********************************************************************/
+
+unsigned long long ZoneMap::getMinElement(unsigned long long block) const
+{
+    return minElements[block];
+}
+
+/********************************************************************
+ * Getter - Returns the element with the highest value in the block *
+ ********************************************************************/
+
+unsigned long long ZoneMap::getMaxElement(unsigned long long block) const
+{
+    return maxElements[block];
+}
+
+/***********************************************************
+ * Computes the range of the given block from its elements *
+ ***********************************************************/
+
+void ZoneMap::setBlockElements(
+    unsigned long long block,
+    const unsigned long long *elements,
+    unsigned long long elementsNum)
+{
+    /* Auxiliary variable (used for counting) */
+    unsigned long long i;
+
+    /* We start with the first element as both the min & max */
+    unsigned long long minElement = elements[0];
+    unsigned long long maxElement = elements[0];
+
+    /* We update the min & max with the rest elements of the block */
+
+    for(i = 1; i < elementsNum; i++)
+    {
+        if(elements[i] < minElement)
+            minElement = elements[i];
+
+        if(elements[i] > maxElement)
+            maxElement = elements[i];
+    }
+
+    /* We store the range of the block */
+    minElements[block] = minElement;
+    maxElements[block] = maxElement;
+}
+
+/*********************************************************************
+ * Returns 'true' if some element of the block may be in [low, high] *
+ *********************************************************************/
+
+bool ZoneMap::mayOverlap(
+    unsigned long long block,
+    unsigned long long low,
+    unsigned long long high) const
+{
+    /* The ranges [min, max] and [low, high] overlap
+     * unless one of them ends before the other starts
+     */
+    return !(maxElements[block] < low || minElements[block] > high);
+}
+
+/******************************************************************
+ * Returns 'true' if every element of the block is in [low, high] *
+ ******************************************************************/
+
+bool ZoneMap::isContainedIn(
+    unsigned long long block,
+    unsigned long long low,
+    unsigned long long high) const
+{
+    return (minElements[block] >= low && maxElements[block] <= high);
+}
@@ -0,0 +1,61 @@
+#ifndef _ZONE_MAP_H_
+#define _ZONE_MAP_H_
+
+/* Sub-column metadata of a column of a table. The rows of the column are
+ * divided in blocks of 'blockSize' consecutive rows and the min & max
+ * element of each block are stored. A filter on the column does not need
+ * to visit a block whose range [min, max] cannot satisfy the filter.
+ */
+class ZoneMap {
+
+private:
+
+    /* The amount of consecutive rows of each block */
+    unsigned long long blockSize;
+
+    /* The amount of blocks (the last block may have fewer rows) */
+    unsigned long long blocksNum;
+
+    /* The element with the smallest value in each block */
+    unsigned long long *minElements;
+
+    /* The element with the highest value in each block */
+    unsigned long long *maxElements;
+
+public:
+
+    /* Constructor - Creates the zone map of a column of 'size' rows. The
+     * range of each block is computed later with 'setBlockElements'.
+     */
+    ZoneMap(unsigned long long blockSize, unsigned long long size);
+
+    /* Destructor */
+    ~ZoneMap();
+
+    /* Getter - Returns the amount of consecutive rows of each block */
+    unsigned long long getBlockSize() const;
+
+    /* Getter - Returns the amount of blocks */
+    unsigned long long getBlocksNum() const;
+
+    /* Getter - Returns the element with the smallest value in the block */
+    unsigned long long getMinElement(unsigned long long block) const;
+
+    /* Getter - Returns the element with the highest value in the block */
+    unsigned long long getMaxElement(unsigned long long block) const;
+
+    /* Computes the range of the given block from its 'elementsNum' elements */
+    void setBlockElements(unsigned long long block,
+        const unsigned long long *elements, unsigned long long elementsNum);
+
+    /* Returns 'true' if some element of the block may be in [low, high] */
+    bool mayOverlap(unsigned long long block,
+        unsigned long long low, unsigned long long high) const;
+
+    /* Returns 'true' if every element of the block is in [low, high] */
+    bool isContainedIn(unsigned long long block,
+        unsigned long long low, unsigned long long high) const;
+
+};
+
+#endif
@@ -3,10 +3,18 @@
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <cmath>
+#include <unistd.h>
+#include <sys/wait.h>
 #include "acutest.h"
 #include "QueryHandler.h"
 #include "BinaryHeap.h"
 #include "Query.h"
+#include "BloomFilter.h"
+#include "SortMergeJoin.h"
+#include "ArrayJoin.h"
 
 using namespace std;
 
@@ -295,6 +303,539 @@ void test_reset_and_resize()
     delete b;
 }
 
+void bloomFilterTest()
+{
+    BloomFilter filter(1000);
+
+    for(unsigned long long key = 0; key < 1000; key++)
+        filter.insert(key * 7 + 100);
+
+    TEST_ASSERT(filter.getKeysNum() == 1000);
+    TEST_ASSERT(filter.getMinKey() == 100);
+    TEST_ASSERT(filter.getMaxKey() == 999 * 7 + 100);
+    TEST_ASSERT(filter.getSizeInBytes() >= 1000 * BLOOM_FILTER_BITS_PER_KEY / 8);
+
+    // Every inserted key is found
+    for(unsigned long long key = 0; key < 1000; key++)
+        TEST_ASSERT(filter.mayContain(key * 7 + 100));
+
+    // The keys outside the range of the inserted keys are always rejected
+    TEST_ASSERT(filter.mayContain(99) == false);
+    TEST_ASSERT(filter.mayContain(999 * 7 + 101) == false);
+
+    // Few of the keys inside the range that were not inserted are accepted
+    unsigned long long falsePositivesNum = 0, absentNum = 0;
+
+    for(unsigned long long key = 100; key <= 999 * 7 + 100; key++)
+    {
+        if((key - 100) % 7 == 0)
+            continue;
+
+        absentNum++;
+
+        if(filter.mayContain(key))
+            falsePositivesNum++;
+    }
+
+    TEST_ASSERT(falsePositivesNum * 100 < absentNum);
+
+    // An empty filter rejects every key
+    BloomFilter emptyFilter(0);
+
+    TEST_ASSERT(emptyFilter.mayContain(0) == false);
+    TEST_ASSERT(emptyFilter.mayContain(ULLONG_MAX) == false);
+}
+
+/**************************************************************************
+ *                         Column Statistics Tests                        *
+ **************************************************************************/
+
+void uniformSamplingStatisticsTest()
+{
+    unsigned long long size = 1000000;
+    unsigned long long *column = new unsigned long long[size];
+    unsigned long long i;
+
+    // A column with 1000 distinct values, each repeated 1000 times
+    for(i = 0; i < size; i++)
+        column[i] = (i * 7919) % 1000 + 5;
+
+    ColumnStatistics stats(column, size, 50000000, UniformSampling, 10000, 0);
+
+    TEST_ASSERT(stats.getElementsNum() == size);
+    TEST_ASSERT(stats.getMinElement() >= 5);
+    TEST_ASSERT(stats.getMaxElement() <= 1004);
+    TEST_ASSERT(stats.getDistinctElementsNum() >= 950);
+    TEST_ASSERT(stats.getDistinctElementsNum() <= 1050);
+
+    // A column where every value is unique
+    for(i = 0; i < size; i++)
+        column[i] = i;
+
+    ColumnStatistics uniqueStats(column, size, 50000000, UniformSampling, 10000, 0);
+
+    TEST_ASSERT(uniqueStats.getDistinctElementsNum() >= size - size / 100);
+    TEST_ASSERT(uniqueStats.getDistinctElementsNum() <= size);
+
+    delete[] column;
+}
+
+void blockSamplingStatisticsTest()
+{
+    unsigned long long size = 1000000;
+    unsigned long long *column = new unsigned long long[size];
+    unsigned long long i;
+
+    for(i = 0; i < size; i++)
+        column[i] = size - i;
+
+    ColumnStatistics stats(column, size, 50000000, BlockSampling, 10000, 1000);
+
+    TEST_ASSERT(stats.getElementsNum() == size);
+    TEST_ASSERT(stats.getMinElement() >= 1);
+    TEST_ASSERT(stats.getMaxElement() <= size);
+    TEST_ASSERT(stats.getDistinctElementsNum() >= size - size / 100);
+    TEST_ASSERT(stats.getDistinctElementsNum() <= size);
+
+    // A sample as large as the column yields the exact amount of distincts
+    ColumnStatistics fullStats(column, 5000, 50000000, BlockSampling, 5000, 1000);
+
+    TEST_ASSERT(fullStats.getMinElement() == size - 4999);
+    TEST_ASSERT(fullStats.getMaxElement() == size);
+    TEST_ASSERT(fullStats.getDistinctElementsNum() == 5000);
+
+    delete[] column;
+}
+
+void backgroundRefinementStatisticsTest()
+{
+    Table exact("../input/small/r1");
+    Table sampled("../input/small/r1", 50000000, UniformSampling, 100, 0, true);
+
+    sampled.waitStatisticsRefinement();
+
+    TEST_ASSERT(sampled.hasSampledStatistics() == false);
+
+    // Replacing the sampled statistics changes the version of the statistics
+    TEST_ASSERT(sampled.getStatisticsVersion() == 1);
+    TEST_ASSERT(exact.getStatisticsVersion() == 0);
+
+    ColumnStatistics **exactStats = exact.getColumnStatistics();
+    ColumnStatistics **refinedStats = sampled.getColumnStatistics();
+
+    for(unsigned long long i = 0; i < exact.getNumOfColumns(); i++)
+    {
+        TEST_ASSERT(refinedStats[i]->getMinElement() == exactStats[i]->getMinElement());
+        TEST_ASSERT(refinedStats[i]->getMaxElement() == exactStats[i]->getMaxElement());
+        TEST_ASSERT(refinedStats[i]->getElementsNum() == exactStats[i]->getElementsNum());
+        TEST_ASSERT(refinedStats[i]->getDistinctElementsNum() == exactStats[i]->getDistinctElementsNum());
+    }
+}
+
+/**************************************************************************
+ *                         Compressed Column Tests                        *
+ **************************************************************************/
+
+static void checkCompressedColumn(unsigned long long *column,
+    unsigned long long size, CompressedColumn *compressed)
+{
+    unsigned long long i, j;
+    unsigned long long *decoded = new unsigned long long[size];
+    unsigned int *matches = new unsigned int[size];
+    unsigned int *rowIds = new unsigned int[size / 2];
+
+    // Every element must be decoded back to its original value
+    compressed->gather(NULL, size, decoded);
+
+    for(i = 0; i < size; i++)
+        TEST_ASSERT(decoded[i] == column[i]);
+
+    // Filtering the packed codes must give the same rows as filtering the elements
+    char operators[3] = {'<', '>', '='};
+    unsigned long long filterValues[4] = {0, column[size / 3], column[size / 3] + 1, ULLONG_MAX};
+
+    for(i = 0; i < 3; i++)
+    {
+        for(j = 0; j < 4; j++)
+        {
+            unsigned long long matchesNum = compressed->filter(operators[i],
+                filterValues[j], NULL, size, matches);
+            unsigned long long expectedNum = 0, k;
+
+            for(k = 0; k < size; k++)
+            {
+                bool satisfies = (operators[i] == '<') ? column[k] < filterValues[j]
+                    : (operators[i] == '>') ? column[k] > filterValues[j]
+                    : column[k] == filterValues[j];
+
+                if(satisfies)
+                {
+                    TEST_ASSERT(expectedNum < matchesNum && matches[expectedNum] == k);
+                    expectedNum++;
+                }
+            }
+
+            TEST_ASSERT(matchesNum == expectedNum);
+        }
+    }
+
+    // Gather and sum of specific rows
+    unsigned long long expectedSum = 0;
+
+    for(i = 0; i < size / 2; i++)
+    {
+        rowIds[i] = (i * 7) % size;
+        expectedSum += column[rowIds[i]];
+    }
+
+    compressed->gather(rowIds, size / 2, decoded);
+
+    for(i = 0; i < size / 2; i++)
+        TEST_ASSERT(decoded[i] == column[rowIds[i]]);
+
+    TEST_ASSERT(compressed->sum(rowIds, size / 2) == expectedSum);
+    TEST_ASSERT(compressed->contains(column[size - 1]) == true);
+
+    delete[] rowIds;
+    delete[] matches;
+    delete[] decoded;
+}
+
+void frameOfReferenceCompressionTest()
+{
+    unsigned long long size = 10000, i;
+    unsigned long long *column = new unsigned long long[size];
+
+    // Values in [1000000, 1000000 + 2^17) need 17 bits after subtracting the min
+    for(i = 0; i < size; i++)
+        column[i] = 1000000 + (i * 2654435761ULL) % 131072;
+
+    CompressedColumn compressed(column, size, 16);
+
+    TEST_ASSERT(compressed.getEncoding() == FrameOfReference);
+    TEST_ASSERT(compressed.getBitWidth() <= 17);
+    TEST_ASSERT(compressed.getCompressedBytes() < size * sizeof(unsigned long long) / 3);
+    TEST_ASSERT(compressed.contains(999999) == false);
+
+    checkCompressedColumn(column, size, &compressed);
+
+    delete[] column;
+}
+
+void dictionaryCompressionTest()
+{
+    unsigned long long size = 10000, i;
+    unsigned long long *column = new unsigned long long[size];
+
+    // Only 10 distinct values that are far apart from each other
+    for(i = 0; i < size; i++)
+        column[i] = ((i * 31) % 10) * 1000000007ULL;
+
+    CompressedColumn compressed(column, size, 65536);
+
+    TEST_ASSERT(compressed.getEncoding() == Dictionary);
+    TEST_ASSERT(compressed.getBitWidth() == 4);
+    TEST_ASSERT(compressed.contains(5) == false);
+
+    checkCompressedColumn(column, size, &compressed);
+
+    delete[] column;
+}
+
+void compressedTableTest()
+{
+    Table uncompressed("../input/small/r1");
+    Table compressed("../input/small/r1");
+
+    compressed.compress(65536);
+
+    TEST_ASSERT(compressed.isCompressed() == true);
+
+    unsigned long long rows = uncompressed.getNumOfTuples(), i, j;
+
+    for(i = 0; i < uncompressed.getNumOfColumns(); i++)
+    {
+        for(j = 0; j < rows; j++)
+            TEST_ASSERT(compressed.getValue(i, j) == uncompressed.getTable()[i][j]);
+
+        TEST_ASSERT(compressed.sumColumn(i, NULL, rows) == uncompressed.sumColumn(i, NULL, rows));
+    }
+}
+
+/**************************************************************************
+ *                             Zone Map Tests                             *
+ **************************************************************************/
+
+void zoneMapRangesTest()
+{
+    unsigned long long column[10] = {5, 3, 9, 100, 120, 110, 7, 7, 7, 50};
+    ZoneMap zoneMap(3, 10);
+
+    TEST_ASSERT(zoneMap.getBlocksNum() == 4);
+
+    for(unsigned long long block = 0; block < 4; block++)
+    {
+        unsigned long long rows = (block == 3) ? 1 : 3;
+        zoneMap.setBlockElements(block, column + block * 3, rows);
+    }
+
+    TEST_ASSERT(zoneMap.getMinElement(0) == 3 && zoneMap.getMaxElement(0) == 9);
+    TEST_ASSERT(zoneMap.getMinElement(1) == 100 && zoneMap.getMaxElement(1) == 120);
+    TEST_ASSERT(zoneMap.getMinElement(3) == 50 && zoneMap.getMaxElement(3) == 50);
+
+    TEST_ASSERT(zoneMap.mayOverlap(0, 10, 99) == false);
+    TEST_ASSERT(zoneMap.mayOverlap(1, 10, 99) == false);
+    TEST_ASSERT(zoneMap.mayOverlap(3, 10, 99) == true);
+    TEST_ASSERT(zoneMap.isContainedIn(2, 7, 7) == true);
+    TEST_ASSERT(zoneMap.isContainedIn(1, 101, 200) == false);
+}
+
+void zoneMapFilterTest()
+{
+    Table plain("../input/small/r1");
+    Table withZoneMaps("../input/small/r1");
+    Table compressedWithZoneMaps("../input/small/r1");
+
+    withZoneMaps.buildZoneMaps(64);
+    compressedWithZoneMaps.compress(65536);
+    compressedWithZoneMaps.buildZoneMaps(64);
+
+    unsigned long long rows = plain.getNumOfTuples(), i, j, k;
+    unsigned int *expected = new unsigned int[rows];
+    unsigned int *actual = new unsigned int[rows];
+    char operators[3] = {'<', '>', '='};
+
+    for(i = 0; i < plain.getNumOfColumns(); i++)
+    {
+        ColumnStatistics *stats = plain.getColumnStatistics()[i];
+        unsigned long long filterValues[4] = {stats->getMinElement(), plain.getValue(i, rows / 2),
+            (stats->getMinElement() + stats->getMaxElement()) / 2, stats->getMaxElement()};
+
+        for(j = 0; j < 3; j++)
+        {
+            for(k = 0; k < 4; k++)
+            {
+                unsigned long long expectedNum = plain.filterColumn(i, operators[j],
+                    filterValues[k], NULL, rows, expected);
+
+                unsigned long long actualNum = withZoneMaps.filterColumn(i, operators[j],
+                    filterValues[k], NULL, rows, actual);
+
+                TEST_ASSERT(actualNum == expectedNum);
+                TEST_ASSERT(memcmp(actual, expected, expectedNum * sizeof(unsigned int)) == 0);
+
+                actualNum = compressedWithZoneMaps.filterColumn(i, operators[j],
+                    filterValues[k], NULL, rows, actual);
+
+                TEST_ASSERT(actualNum == expectedNum);
+                TEST_ASSERT(memcmp(actual, expected, expectedNum * sizeof(unsigned int)) == 0);
+            }
+        }
+    }
+
+    delete[] actual;
+    delete[] expected;
+}
+
+void fusedFilterTest()
+{
+    Table plain("../input/small/r1");
+    Table compressedWithZoneMaps("../input/small/r1");
+
+    compressedWithZoneMaps.compress(65536);
+    compressedWithZoneMaps.buildZoneMaps(64);
+
+    unsigned long long rows = plain.getNumOfTuples(), i;
+    unsigned int *expected = new unsigned int[rows];
+    unsigned int *firstMatches = new unsigned int[rows];
+    unsigned int *actual = new unsigned int[rows];
+
+    // Two filters on different columns and one that no value satisfies
+    unsigned long long columns[3] = {0, 1, 1};
+    char operators[3] = {'<', '>', '<'};
+    unsigned long long filterValues[3] = {plain.getValue(0, rows / 2),
+        plain.getValue(1, rows / 3), 0};
+
+    // The rows that satisfy the first two filters one after the other
+    unsigned long long firstNum = plain.filterColumn(columns[0], operators[0],
+        filterValues[0], NULL, rows, firstMatches);
+
+    unsigned long long expectedNum = plain.filterColumn(columns[1], operators[1],
+        filterValues[1], firstMatches, firstNum, expected);
+
+    for(i = 0; i < expectedNum; i++)
+        expected[i] = firstMatches[expected[i]];
+
+    TEST_ASSERT(firstNum > expectedNum);
+
+    // The fused scan finds the same rows on both tables
+    Table *tables[2] = {&plain, &compressedWithZoneMaps};
+    unsigned long long passedNums[3];
+
+    for(unsigned int t = 0; t < 2; t++)
+    {
+        unsigned long long actualNum = tables[t]->filterColumns(2, columns,
+            operators, filterValues, NULL, rows, actual, passedNums);
+
+        TEST_ASSERT(actualNum == expectedNum);
+        TEST_ASSERT(memcmp(actual, expected, expectedNum * sizeof(unsigned int)) == 0);
+        TEST_ASSERT(passedNums[0] == firstNum);
+        TEST_ASSERT(passedNums[1] == expectedNum);
+
+        // No row satisfies a filter that no value can satisfy
+        actualNum = tables[t]->filterColumns(3, columns, operators,
+            filterValues, NULL, rows, actual, passedNums);
+
+        TEST_ASSERT(actualNum == 0);
+        TEST_ASSERT(passedNums[1] == expectedNum);
+        TEST_ASSERT(passedNums[2] == 0);
+    }
+
+    // The fused scan over specific rows returns offsets in the given rows
+    unsigned long long actualNum = plain.filterColumns(1, columns + 1,
+        operators + 1, filterValues + 1, firstMatches, firstNum, actual);
+
+    TEST_ASSERT(actualNum == expectedNum);
+
+    for(i = 0; i < actualNum; i++)
+        TEST_ASSERT(firstMatches[actual[i]] == expected[i]);
+
+    delete[] actual;
+    delete[] firstMatches;
+    delete[] expected;
+}
+
+/**************************************************************************
+ *                           Column Index Tests                           *
+ **************************************************************************/
+
+void columnIndexLookupTest()
+{
+    unsigned long long column[8] = {40, 10, 30, 10, 50, 30, 10, 20};
+    ColumnIndex index(column, 8);
+    const unsigned int *rowIds;
+
+    TEST_ASSERT(index.getSize() == 8);
+
+    // Equality lookups return the rows of the element in ascending order
+    TEST_ASSERT(index.equalityLookup(10, &rowIds) == 3);
+    TEST_ASSERT(rowIds[0] == 1 && rowIds[1] == 3 && rowIds[2] == 6);
+    TEST_ASSERT(index.equalityLookup(30, &rowIds) == 2);
+    TEST_ASSERT(rowIds[0] == 2 && rowIds[1] == 5);
+    TEST_ASSERT(index.equalityLookup(35, &rowIds) == 0);
+
+    // Range lookups return the rows sorted by their element
+    TEST_ASSERT(index.rangeLookup('<', 30, &rowIds) == 4);
+    TEST_ASSERT(rowIds[3] == 7);
+    TEST_ASSERT(index.rangeLookup('>', 30, &rowIds) == 2);
+    TEST_ASSERT(rowIds[0] == 0 && rowIds[1] == 4);
+    TEST_ASSERT(index.rangeLookup('<', 10, &rowIds) == 0);
+    TEST_ASSERT(index.rangeLookup('>', 50, &rowIds) == 0);
+}
+
+static void intermediateArrayChecksum(IntermediateArray *ia,
+    unsigned long long *checksum, unsigned long long *squaresChecksum)
+{
+    List *rowIdArrays = ia->getRowIdArrays();
+    unsigned int relsNum = rowIdArrays->getCounter(), i, j;
+
+    *checksum = 0;
+    *squaresChecksum = 0;
+
+    for(i = 0; i < ia->getRowsNum(); i++)
+    {
+        unsigned long long rowHash = 0;
+
+        for(j = 0; j < relsNum; j++)
+            rowHash = rowHash * 1000003 + ((unsigned int *) rowIdArrays->getItemInPos(j + 1))[i];
+
+        *checksum += rowHash;
+        *squaresChecksum += rowHash * rowHash;
+    }
+}
+
+void indexNestedLoopJoinTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    List *indexedTables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+
+    for(Listnode *node = indexedTables->getHead(); node != NULL; node = node->getNext())
+        ((Table *) node->getItem())->setBuildIndexesOnFirstUse(true);
+
+    // Join of two base tables followed by a join with a foreign table
+    IntermediateArray *ia = new IntermediateArray(4, 0, 1, 3, 1, 2, tables, phji);
+    IntermediateArray *indexedIa = new IntermediateArray(4, 0, 1, 3, 1, 2, indexedTables, phji);
+
+    TEST_ASSERT(ia->getRowsNum() == indexedIa->getRowsNum());
+
+    ia->executeJoinWithForeignRelation(4, 0, 1, 2, 0, 0);
+    indexedIa->executeJoinWithForeignRelation(4, 0, 1, 2, 0, 0);
+
+    unsigned long long checksum, squaresChecksum, indexedChecksum, indexedSquaresChecksum;
+
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+    intermediateArrayChecksum(indexedIa, &indexedChecksum, &indexedSquaresChecksum);
+
+    TEST_ASSERT(ia->getRowsNum() == indexedIa->getRowsNum());
+    TEST_ASSERT(checksum == indexedChecksum);
+    TEST_ASSERT(squaresChecksum == indexedSquaresChecksum);
+
+    delete indexedIa;
+    delete ia;
+
+    // Equality and range filters on a base table
+    char operators[3] = {'=', '<', '>'};
+
+    for(int k = 0; k < 3; k++)
+    {
+        Table *table = (Table *) tables->getItemInPos(1);
+        unsigned int filterValue = (unsigned int) table->getValue(1, table->getNumOfTuples() / 3);
+
+        ia = new IntermediateArray(0, 1, 0, filterValue, operators[k], tables, phji);
+        indexedIa = new IntermediateArray(0, 1, 0, filterValue, operators[k], indexedTables, phji);
+
+        intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+        intermediateArrayChecksum(indexedIa, &indexedChecksum, &indexedSquaresChecksum);
+
+        TEST_ASSERT(ia->getRowsNum() == indexedIa->getRowsNum());
+        TEST_ASSERT(checksum == indexedChecksum);
+        TEST_ASSERT(squaresChecksum == indexedSquaresChecksum);
+
+        delete indexedIa;
+        delete ia;
+    }
+
+    // Several filters of a base table applied with a single scan keep
+    // the same rows as the filters applied one after the other
+    unsigned int filterColumns[2] = {1, 0};
+    unsigned int filterValues[2] = {5000, 4000};
+    char filterOperators[2] = {'<', '>'};
+
+    ia = new IntermediateArray(0, 1, 0, filterValues[0], filterOperators[0], tables, phji);
+    ia->executeFilter(0, 0, 0, filterValues[1], filterOperators[1]);
+
+    indexedIa = new IntermediateArray(0, 0, 2, filterColumns, filterValues,
+        filterOperators, indexedTables, phji);
+
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+    intermediateArrayChecksum(indexedIa, &indexedChecksum, &indexedSquaresChecksum);
+
+    TEST_ASSERT(ia->getRowsNum() == indexedIa->getRowsNum());
+    TEST_ASSERT(checksum == indexedChecksum);
+    TEST_ASSERT(squaresChecksum == indexedSquaresChecksum);
+
+    delete indexedIa;
+    delete ia;
+
+    tables->traverseFromHead(deleteTable);
+    indexedTables->traverseFromHead(deleteTable);
+
+    delete indexedTables;
+    delete tables;
+    delete phji;
+}
+
 /**************************************************************************
  *                            Filereader Test                             *
  **************************************************************************/
@@ -345,6 +886,117 @@ void read_config_test()
     TEST_ASSERT(loadFactor == 0.9);
     TEST_ASSERT(maxAllowedSizeModifier == 0.95);
     TEST_ASSERT(maxPartitionDepth == 2);
+
+    StatisticsSampling sampling;
+    unsigned long long sampleSize;
+    unsigned long long blockSize;
+    bool refineInBackground;
+
+    FileReader::readStatisticsSampling(
+        config_file,
+        &sampling,
+        &sampleSize,
+        &blockSize,
+        &refineInBackground
+    );
+
+    TEST_ASSERT(sampling == NoSampling);
+    TEST_ASSERT(sampleSize == 100000);
+    TEST_ASSERT(blockSize == 1024);
+    TEST_ASSERT(refineInBackground == false);
+
+    bool compressColumns;
+    unsigned long long maxDictionarySize;
+
+    FileReader::readColumnCompression(config_file, &compressColumns, &maxDictionarySize);
+
+    TEST_ASSERT(compressColumns == false);
+    TEST_ASSERT(maxDictionarySize == 65536);
+
+    unsigned long long zoneMapBlockSize;
+
+    FileReader::readZoneMapBlockSize(config_file, &zoneMapBlockSize);
+
+    TEST_ASSERT(zoneMapBlockSize == 4096);
+
+    bool buildIndexesOnFirstUse;
+    char *indexHints = NULL;
+
+    FileReader::readColumnIndexes(config_file, &buildIndexesOnFirstUse, &indexHints);
+
+    TEST_ASSERT(buildIndexesOnFirstUse == false);
+    TEST_ASSERT(indexHints != NULL && strlen(indexHints) == 0);
+
+    free(indexHints);
+
+    unsigned long long buildSideCacheSize = 1;
+
+    FileReader::readBuildSideCacheSize(config_file, &buildSideCacheSize);
+
+    TEST_ASSERT(buildSideCacheSize == 0);
+
+    unsigned int planCacheSize = 0;
+
+    FileReader::readPlanCacheSize(config_file, &planCacheSize);
+
+    TEST_ASSERT(planCacheSize == 256);
+
+    CostModelType costModelType = CardinalityCostModel;
+
+    FileReader::readCostModel(config_file, &costModelType);
+
+    TEST_ASSERT(costModelType == CalibratedCostModel);
+
+    double reoptimizationFactor = 0;
+
+    FileReader::readReoptimizationFactor(config_file, &reoptimizationFactor);
+
+    TEST_ASSERT(reoptimizationFactor == 10);
+
+    unsigned int cardinalityFeedbackSize = 0;
+    char *cardinalityFeedbackFile = NULL;
+
+    FileReader::readCardinalityFeedback(config_file, &cardinalityFeedbackSize,
+        &cardinalityFeedbackFile);
+
+    TEST_ASSERT(cardinalityFeedbackSize == 1024);
+    TEST_ASSERT(cardinalityFeedbackFile == NULL);
+
+    unsigned int sidewaysFilterRatio = 0;
+
+    FileReader::readSidewaysFilterRatio(config_file, &sidewaysFilterRatio);
+
+    TEST_ASSERT(sidewaysFilterRatio == 4);
+
+    ExplainMode explainMode = AnalyzeExplain;
+
+    FileReader::readExplainMode(config_file, &explainMode);
+
+    TEST_ASSERT(explainMode == NoExplain);
+
+    double heavyHitterShare = 0;
+
+    FileReader::readHeavyHitterShare(config_file, &heavyHitterShare);
+
+    TEST_ASSERT(heavyHitterShare == 0.01);
+
+    HashFunctionType hashFunction = BitsHash;
+
+    FileReader::readHashFunction(config_file, &hashFunction);
+
+    TEST_ASSERT(hashFunction == AutoHash);
+
+    bool autoTunedPartitioning = false;
+
+    FileReader::readPartitionTuning(config_file, &autoTunedPartitioning);
+
+    TEST_ASSERT(autoTunedPartitioning == true);
+
+    JoinAlgorithmType joinAlgorithm = HashJoinAlgorithm;
+
+    FileReader::readJoinAlgorithm(config_file, &joinAlgorithm);
+
+    TEST_ASSERT(joinAlgorithm == AutoJoinAlgorithm);
 }
 
 void read_init_file_test()
@@ -519,11 +1171,45 @@ void rehashTest()
     delete ht;
 }
 
-void bulkSearchTest()
+void exactSizeTest()
 {
-    HashTable *ht = new HashTable(16, true, 0.7, 3);
+    // The table is created big enough for all of its elements
+    unsigned int elementsNum = 700;
+    unsigned int bucketsNum = HashTable::getExactSize(elementsNum, 0.7);
 
-    int key_1 = 5;
+    TEST_ASSERT(bucketsNum > 1000);
+    TEST_ASSERT(((double) elementsNum) / ((double) bucketsNum) < 0.7);
+
+    HashTable *ht = new HashTable(bucketsNum, true, 0.7, 4);
+
+    int key[700];
+    for(unsigned int i = 0; i < elementsNum; i++)
+    {
+        key[i] = i * 3;
+        ht->insert(&key[i], &key[i], hash_int, compare_ints);
+    }
+
+    // No rehash happened while the elements were inserted
+    TEST_ASSERT(ht->getBucketsNum() == bucketsNum);
+    TEST_ASSERT(ht->getHopInfoCapacity() == 4);
+
+    // The last element that fits is still found
+    List* found = ht->bulkSearchKeys(&key[elementsNum - 1], hash_int, compare_ints);
+    TEST_ASSERT(found->getCounter() == 1);
+    ht->terminateBulkSearchList(found);
+
+    // An invalid load factor is considered to be 1
+    TEST_ASSERT(HashTable::getExactSize(10, 0.0) == 11);
+    TEST_ASSERT(HashTable::getExactSize(0, 0.7) == 1);
+
+    delete ht;
+}
+
+void bulkSearchTest()
+{
+    HashTable *ht = new HashTable(16, true, 0.7, 3);
+
+    int key_1 = 5;
     ht->insert(&key_1, &key_1, hash_int, compare_ints);
 
     int key_2 = 5;
@@ -1140,46 +1826,1815 @@ void partitionedHashJoinTest()
     
     TEST_ASSERT(compare_results(result, expected) == 1);
 
+    // The small relations are joined with a single hash table
+    // of the smaller relation and without partitioning
+    JoinStatistics statistics = phj.getStatistics();
+    unsigned int smallerSize = (L->getNumOfTuples() < R->getNumOfTuples())
+        ? L->getNumOfTuples() : R->getNumOfTuples();
+
+    TEST_ASSERT(statistics.partitionDepth == 0);
+    TEST_ASSERT(statistics.hashTablesNum == 1);
+    TEST_ASSERT(statistics.largestHashTableSize == smallerSize);
+    TEST_ASSERT(statistics.hashTableTuplesNum == smallerSize);
+
     phj.freeJoinResult(result);
     delete expected;
     delete phji;
     
 }
 
-/**************************************************************************
- *                                  Query                                 *
- **************************************************************************/
+void buildSideCacheTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    PartitionedHashJoinInput *cachedPhji = new PartitionedHashJoinInput("../config.txt");
 
-void predicatesParserTest()
+    delete cachedPhji->buildSideCache;
+    cachedPhji->buildSideCache = new BuildSideCache(1ULL << 30);
+
+    // The joins with cached build sides give the same result, both when
+    // the build sides are created and when they are taken from the cache
+    IntermediateArray *ia = new IntermediateArray(4, 0, 1, 3, 1, 2, tables, phji);
+    ia->executeJoinWithForeignRelation(4, 0, 1, 2, 0, 0);
+
+    unsigned long long checksum, squaresChecksum, cachedChecksum, cachedSquaresChecksum;
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+
+    for(int k = 0; k < 2; k++)
+    {
+        IntermediateArray *cachedIa = new IntermediateArray(4, 0, 1, 3, 1, 2, tables, cachedPhji);
+        cachedIa->executeJoinWithForeignRelation(4, 0, 1, 2, 0, 0);
+
+        intermediateArrayChecksum(cachedIa, &cachedChecksum, &cachedSquaresChecksum);
+
+        TEST_ASSERT(ia->getRowsNum() == cachedIa->getRowsNum());
+        TEST_ASSERT(checksum == cachedChecksum);
+        TEST_ASSERT(squaresChecksum == cachedSquaresChecksum);
+        TEST_ASSERT(cachedPhji->buildSideCache->getEntriesNum() == 3);
+
+        delete cachedIa;
+    }
+
+    delete ia;
+
+    // A cache that fits only one of two columns keeps the most recently used one
+    Table *table = (Table *) tables->getItemInPos(1);
+    unsigned int bits = phji->bitsNumForHashing;
+    unsigned long long columnBytes = CachedBuildSide::estimateMemoryBytes(table->getNumOfTuples(), bits);
+
+    BuildSideCache *cache = new BuildSideCache(columnBytes + columnBytes / 2);
+
+    CachedBuildSide *first = cache->acquire(table, 0, 0, bits);
+    CachedBuildSide *second = cache->acquire(table, 0, 1, bits);
+
+    // Build sides that are in use are never evicted
+    TEST_ASSERT(first != NULL && second != NULL);
+    TEST_ASSERT(cache->getEntriesNum() == 2);
+    TEST_ASSERT(first->getNumOfTuples() == table->getNumOfTuples());
+
+    // The tuples of each bucket hash to that bucket
+    unsigned int *prefixSum = first->getPrefixSum();
+    unsigned int *histogram = first->getHistogram();
+
+    for(unsigned int bucket = 0; bucket < first->getBucketsNum(); bucket++)
+    {
+        for(unsigned int i = prefixSum[bucket]; i < prefixSum[bucket] + histogram[bucket]; i++)
+        {
+            Tuple *tuple = &first->getTuples()[i];
+            unsigned long long element = *((unsigned long long *) tuple->getItem());
+
+            TEST_ASSERT(element == table->getValue(0, tuple->getRowId()));
+            TEST_ASSERT(PartitionedHashJoin::bitReductionHash(element, bits) == bucket);
+        }
+    }
+
+    cache->release(first);
+    TEST_ASSERT(cache->getEntriesNum() == 1);
+
+    cache->release(second);
+    TEST_ASSERT(cache->getEntriesNum() == 1);
+    TEST_ASSERT(cache->getMemoryBytes() <= cache->getBudgetBytes());
+
+    // The column that was kept is taken from the cache
+    TEST_ASSERT(cache->acquire(table, 0, 1, bits) == second);
+    cache->release(second);
+
+    delete cache;
+
+    // A column that does not fit in the budget is not cached at all
+    cache = new BuildSideCache(columnBytes / 2);
+    TEST_ASSERT(cache->acquire(table, 0, 0, bits) == NULL);
+    TEST_ASSERT(cache->getEntriesNum() == 0);
+    delete cache;
+
+    tables->traverseFromHead(deleteTable);
+
+    delete tables;
+    delete cachedPhji;
+    delete phji;
+}
+
+void sidewaysFilterTest()
 {
-    char predicate[10] = "2.0 = 3.4";
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    PartitionedHashJoinInput *filteredPhji = new PartitionedHashJoinInput("../config.txt");
 
-    PredicatesParser pp(predicate);
+    // The smaller input of every join passes its keys to the larger one
+    // whenever the larger one has at least as many tuples
+    phji->sidewaysFilterRatio = 0;
+    filteredPhji->sidewaysFilterRatio = 1;
 
-    TEST_ASSERT(pp.getLeftArray() == 2);
-    TEST_ASSERT(pp.getLeftArrayColumn() == 0);
-    TEST_ASSERT(pp.getRightArray() == 3);
-    TEST_ASSERT(pp.getRightArrayColumn() == 4);
-    TEST_ASSERT(pp.hasConstant() == false);
+    Table *table = (Table *) tables->getItemInPos(1);
+    unsigned int filterValue = (unsigned int) table->getValue(0, table->getNumOfTuples() / 3);
 
-    char predicate1[9] = "1.1 < 69";
-    PredicatesParser pp1(predicate1);
+    unsigned long long checksum, squaresChecksum, filteredChecksum, filteredSquaresChecksum;
 
-    TEST_ASSERT(pp1.getLeftArray() == 1);
-    TEST_ASSERT(pp1.getLeftArrayColumn() == 1);
-    TEST_ASSERT(pp1.getFilterOperator() == '<');
-    TEST_ASSERT(pp1.getFilterValue() == 69);
-    TEST_ASSERT(pp1.hasConstant() == true);
+    // Join of two base tables followed by a join of a filtered
+    // relation with a foreign table and with another array
+    IntermediateArray *ia = new IntermediateArray(4, 0, 1, 3, 1, 2, tables, phji);
+    IntermediateArray *filteredIa = new IntermediateArray(4, 0, 1, 3, 1, 2, tables, filteredPhji);
+
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+    intermediateArrayChecksum(filteredIa, &filteredChecksum, &filteredSquaresChecksum);
+
+    TEST_ASSERT(ia->getRowsNum() == filteredIa->getRowsNum());
+    TEST_ASSERT(checksum == filteredChecksum);
+    TEST_ASSERT(squaresChecksum == filteredSquaresChecksum);
+
+    delete filteredIa;
+    delete ia;
+
+    ia = new IntermediateArray(0, 0, 0, filterValue, '<', tables, phji);
+    filteredIa = new IntermediateArray(0, 0, 0, filterValue, '<', tables, filteredPhji);
+
+    ia->executeJoinWithForeignRelation(0, 0, 0, 3, 2, 1);
+    filteredIa->executeJoinWithForeignRelation(0, 0, 0, 3, 2, 1);
+
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+    intermediateArrayChecksum(filteredIa, &filteredChecksum, &filteredSquaresChecksum);
+
+    TEST_ASSERT(ia->getRowsNum() > 0);
+    TEST_ASSERT(ia->getRowsNum() == filteredIa->getRowsNum());
+    TEST_ASSERT(checksum == filteredChecksum);
+    TEST_ASSERT(squaresChecksum == filteredSquaresChecksum);
+
+    IntermediateArray *other = new IntermediateArray(1, 0, 2, 0, '>', tables, phji);
+    IntermediateArray *filteredOther = new IntermediateArray(1, 0, 2, 0, '>', tables, filteredPhji);
+
+    ia->executeJoinWithRelationOfOtherArray(other, 3, 1, 1, 1, 0, 2);
+    filteredIa->executeJoinWithRelationOfOtherArray(filteredOther, 3, 1, 1, 1, 0, 2);
+
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+    intermediateArrayChecksum(filteredIa, &filteredChecksum, &filteredSquaresChecksum);
+
+    TEST_ASSERT(ia->getRowsNum() == filteredIa->getRowsNum());
+    TEST_ASSERT(checksum == filteredChecksum);
+    TEST_ASSERT(squaresChecksum == filteredSquaresChecksum);
+
+    delete filteredOther;
+    delete other;
+    delete filteredIa;
+    delete ia;
+
+    tables->traverseFromHead(deleteTable);
+
+    delete tables;
+    delete filteredPhji;
+    delete phji;
+}
+
+void parallelSubjoinsTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    PartitionedHashJoinInput *partitionedPhji = new PartitionedHashJoinInput("../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(4);
+
+    // Every bucket is too large for the cache, so the buckets of the
+    // first partition are partitioned again by sub-joins
+    phji->maxPartitionDepth = 0;
+    partitionedPhji->maxPartitionDepth = 2;
+    partitionedPhji->maxAllowedSizeModifier = 0.0001;
+
+    // The keys of the joined columns are dense, so the hash join is forced
+    partitionedPhji->joinAlgorithm = HashJoinAlgorithm;
+
+    unsigned long long checksum, squaresChecksum, partitionedChecksum, partitionedSquaresChecksum;
+
+    IntermediateArray *ia = new IntermediateArray(4, 0, 1, 3, 1, 2, tables, phji);
+    intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+
+    TEST_ASSERT(ia->getLastJoinStatistics().partitionDepth == 0);
+
+    // The sub-joins are executed serially and as jobs of the scheduler
+    for(unsigned int k = 0; k < 2; k++)
+    {
+        IntermediateArray *partitionedIa = new IntermediateArray(4, 0, 1, 3, 1, 2,
+            tables, partitionedPhji, (k == 0) ? NULL : jobScheduler);
+
+        intermediateArrayChecksum(partitionedIa, &partitionedChecksum, &partitionedSquaresChecksum);
 
+        TEST_ASSERT(partitionedIa->getLastJoinStatistics().partitionDepth == 2);
+        TEST_ASSERT(ia->getRowsNum() == partitionedIa->getRowsNum());
+        TEST_ASSERT(checksum == partitionedChecksum);
+        TEST_ASSERT(squaresChecksum == partitionedSquaresChecksum);
+
+        delete partitionedIa;
+    }
+
+    delete ia;
+
+    tables->traverseFromHead(deleteTable);
+
+    delete tables;
+    delete jobScheduler;
+    delete partitionedPhji;
+    delete phji;
 }
 
-void projectionsParserTest()
+static void rowIdRelationChecksum(RowIdRelation *relation,
+    unsigned long long *checksum, unsigned long long *squaresChecksum)
 {
-    char projection[4] = "1.5";
-    ProjectionsParser pp(projection);
+    RowIdPair *pairs = relation->getRowIdPairs();
 
-    TEST_ASSERT(pp.getArray() == 1);
-    TEST_ASSERT(pp.getColumn() == 5);
+    *checksum = 0;
+    *squaresChecksum = 0;
+
+    for(unsigned int i = 0; i < relation->getNumOfRowIdPairs(); i++)
+    {
+        unsigned long long pairHash = ((unsigned long long) pairs[i].getLeftRowId())
+            * 1000003 + pairs[i].getRightRowId();
+
+        *checksum += pairHash;
+        *squaresChecksum += pairHash * pairHash;
+    }
+}
+
+void heavyHittersTest()
+{
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(4);
+
+    // A third of 'R' and a quarter of 'S' have the key 7, while
+    // a fifth of 'S' has the key 11, which 'R' has only once
+    unsigned int R_num = 3000, S_num = 2000, i, j;
+    unsigned long long *R_keys = new unsigned long long[R_num];
+    unsigned long long *S_keys = new unsigned long long[S_num];
+
+    for(i = 0; i < R_num; i++)
+        R_keys[i] = (i % 3 == 0) ? 7 : ((i == 1) ? 11 : i + 100);
+
+    for(i = 0; i < S_num; i++)
+        S_keys[i] = (i % 4 == 0) ? 7 : ((i % 5 == 0) ? 11 : i + 100);
+
+    unsigned long long expectedPairsNum = 0;
+
+    for(i = 0; i < R_num; i++)
+    {
+        for(j = 0; j < S_num; j++)
+            expectedPairsNum += (R_keys[i] == S_keys[j]);
+    }
+
+    // The relations do not fit in the cache, so they are partitioned
+    phji->maxPartitionDepth = 2;
+    phji->maxAllowedSizeModifier = 0.0001;
+
+    unsigned long long checksum = 0, squaresChecksum = 0;
+
+    for(unsigned int k = 0; k < 4; k++)
+    {
+        // The heavy hitters are joined as cross products (serially and
+        // as jobs of the scheduler) or they are partitioned like the rest
+        phji->heavyHitterShare = (k < 2) ? 0 : 0.01;
+        JobScheduler *scheduler = (k % 2 == 0) ? NULL : jobScheduler;
+
+        Tuple *R_tuples = new Tuple[R_num];
+        Tuple *S_tuples = new Tuple[S_num];
+
+        for(i = 0; i < R_num; i++)
+            R_tuples[i] = Tuple(&R_keys[i], i);
+
+        for(i = 0; i < S_num; i++)
+            S_tuples[i] = Tuple(&S_keys[i], i);
+
+        Relation R(R_tuples, R_num);
+        Relation S(S_tuples, S_num);
+
+        PartitionedHashJoin phj(&R, &S, phji, scheduler);
+        RowIdRelation *result = phj.executeJoin();
+
+        unsigned long long currentChecksum, currentSquaresChecksum;
+        rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+        TEST_ASSERT(result->getNumOfRowIdPairs() == expectedPairsNum);
+        TEST_ASSERT(phj.getStatistics().heavyHittersNum == ((k < 2) ? 0 : 2));
+
+        if(k == 0)
+        {
+            checksum = currentChecksum;
+            squaresChecksum = currentSquaresChecksum;
+        }
+
+        TEST_ASSERT(currentChecksum == checksum);
+        TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+        // The arrays of the caller may be reordered by the join, but they
+        // still hold every one of their tuples exactly once
+        bool *R_seen = new bool[R_num]();
+        bool *S_seen = new bool[S_num]();
+
+        for(i = 0; i < R_num; i++)
+        {
+            unsigned int rowId = R_tuples[i].getRowId();
+
+            TEST_ASSERT(rowId < R_num && !R_seen[rowId]);
+            TEST_ASSERT(R_tuples[i].getItem() == &R_keys[rowId]);
+            R_seen[rowId] = true;
+        }
+
+        for(i = 0; i < S_num; i++)
+        {
+            unsigned int rowId = S_tuples[i].getRowId();
+
+            TEST_ASSERT(rowId < S_num && !S_seen[rowId]);
+            TEST_ASSERT(S_tuples[i].getItem() == &S_keys[rowId]);
+            S_seen[rowId] = true;
+        }
+
+        delete[] R_seen;
+        delete[] S_seen;
+
+        phj.freeJoinResult(result);
+
+        delete[] R_tuples;
+        delete[] S_tuples;
+    }
+
+    // Only a key whose tuples do not fit in a bucket is a heavy hitter. A
+    // bucket fits 500 tuples, so the 1000 tuples of the key 7 in 'R' are
+    // separated, while the 400 tuples of the key 11 in 'S' are partitioned.
+    phji->heavyHitterShare = 0.01;
+    phji->maxAllowedSizeModifier = (500.0 * sizeof(Tuple) + 1)
+        / CacheHierarchy::getInstance()->getLvl2CacheSize();
+
+    Tuple *R_tuples = new Tuple[R_num];
+    Tuple *S_tuples = new Tuple[S_num];
+
+    for(i = 0; i < R_num; i++)
+        R_tuples[i] = Tuple(&R_keys[i], i);
+
+    for(i = 0; i < S_num; i++)
+        S_tuples[i] = Tuple(&S_keys[i], i);
+
+    Relation R(R_tuples, R_num);
+    Relation S(S_tuples, S_num);
+
+    PartitionedHashJoin phj(&R, &S, phji);
+    RowIdRelation *result = phj.executeJoin();
+
+    unsigned long long currentChecksum, currentSquaresChecksum;
+    rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+    TEST_ASSERT(phj.getStatistics().heavyHittersNum == 1);
+    TEST_ASSERT(result->getNumOfRowIdPairs() == expectedPairsNum);
+    TEST_ASSERT(currentChecksum == checksum);
+    TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+    phj.freeJoinResult(result);
+
+    delete[] R_tuples;
+    delete[] S_tuples;
+
+    delete[] R_keys;
+    delete[] S_keys;
+    delete jobScheduler;
+    delete phji;
+
+    // The joins of an intermediate array free the items of the tuples they
+    // created, so they must find every tuple in its array after the join.
+    // A few keys of the 6th column of the 8th relation and of its 2nd
+    // column are about 0.1-0.3% of their rows.
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    unsigned long long heavyChecksum, heavySquaresChecksum;
+    unsigned long long heavyRowsNum = 0, rowsNum = 0;
+    unsigned int heavyHittersNum = 0;
+
+    for(unsigned int k = 0; k < 2; k++)
+    {
+        PartitionedHashJoinInput *iaPhji = new PartitionedHashJoinInput("../config.txt");
+
+        delete iaPhji->buildSideCache;
+        iaPhji->buildSideCache = NULL;
+        iaPhji->joinAlgorithm = HashJoinAlgorithm;
+        iaPhji->maxPartitionDepth = 2;
+        iaPhji->maxAllowedSizeModifier = 0.0001;
+        iaPhji->heavyHitterShare = (k == 0) ? 0 : 0.001;
+
+        IntermediateArray *ia = new IntermediateArray(7, 5, 0, 4, 0, 1, tables, iaPhji);
+        heavyHittersNum += ia->getLastJoinStatistics().heavyHittersNum;
+
+        ia->executeJoinWithForeignRelation(7, 1, 0, 1, 0, 2);
+        heavyHittersNum += ia->getLastJoinStatistics().heavyHittersNum;
+
+        if(k == 0)
+        {
+            intermediateArrayChecksum(ia, &checksum, &squaresChecksum);
+            rowsNum = ia->getRowsNum();
+        }
+
+        else
+        {
+            intermediateArrayChecksum(ia, &heavyChecksum, &heavySquaresChecksum);
+            heavyRowsNum = ia->getRowsNum();
+        }
+
+        delete ia;
+        delete iaPhji;
+    }
+
+    TEST_ASSERT(heavyHittersNum > 0);
+    TEST_ASSERT(heavyRowsNum == rowsNum);
+    TEST_ASSERT(heavyChecksum == checksum);
+    TEST_ASSERT(heavySquaresChecksum == squaresChecksum);
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
+}
+
+void bucketBatchesTest()
+{
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+
+    // Two thirds of the keys of 'R' have the same rightmost bits, so
+    // one bucket is much larger than the rest
+    unsigned int R_num = 3000, S_num = 2000, i, j;
+    unsigned long long *R_keys = new unsigned long long[R_num];
+    unsigned long long *S_keys = new unsigned long long[S_num];
+
+    for(i = 0; i < R_num; i++)
+        R_keys[i] = (i % 3 != 0) ? ((unsigned long long) i << 20) : i;
+
+    for(i = 0; i < S_num; i++)
+        S_keys[i] = (i % 2 == 0) ? ((unsigned long long) i << 20) : i;
+
+    unsigned long long expectedPairsNum = 0;
+
+    for(i = 0; i < R_num; i++)
+    {
+        for(j = 0; j < S_num; j++)
+            expectedPairsNum += (R_keys[i] == S_keys[j]);
+    }
+
+    // The relations are partitioned once and the large bucket is not
+    // partitioned again, so every bucket is joined by a batch
+    phji->maxPartitionDepth = 1;
+    phji->maxAllowedSizeModifier = 0.0001;
+    phji->heavyHitterShare = 0;
+    phji->hashFunction = BitsHash;
+
+    unsigned long long checksum = 0, squaresChecksum = 0;
+    unsigned int threadsNums[4] = {0, 1, 3, 8};
+
+    // The buckets are joined serially and by schedulers with a
+    // different amount of threads, which share the same batches
+    for(unsigned int k = 0; k < 4; k++)
+    {
+        JobScheduler *scheduler = (threadsNums[k] == 0) ? NULL
+            : new JobScheduler(threadsNums[k]);
+
+        Tuple *R_tuples = new Tuple[R_num];
+        Tuple *S_tuples = new Tuple[S_num];
+
+        for(i = 0; i < R_num; i++)
+            R_tuples[i] = Tuple(&R_keys[i], i);
+
+        for(i = 0; i < S_num; i++)
+            S_tuples[i] = Tuple(&S_keys[i], i);
+
+        Relation R(R_tuples, R_num);
+        Relation S(S_tuples, S_num);
+
+        PartitionedHashJoin phj(&R, &S, phji, scheduler);
+        RowIdRelation *result = phj.executeJoin();
+
+        unsigned long long currentChecksum, currentSquaresChecksum;
+        rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+        TEST_ASSERT(result->getNumOfRowIdPairs() == expectedPairsNum);
+        TEST_ASSERT(phj.getStatistics().partitionDepth == 1);
+
+        if(k == 0)
+        {
+            checksum = currentChecksum;
+            squaresChecksum = currentSquaresChecksum;
+        }
+
+        TEST_ASSERT(currentChecksum == checksum);
+        TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+        phj.freeJoinResult(result);
+
+        delete[] R_tuples;
+        delete[] S_tuples;
+        delete scheduler;
+    }
+
+    delete[] R_keys;
+    delete[] S_keys;
+    delete phji;
+}
+
+void scratchArenaTest()
+{
+    ScratchArena *arena = new ScratchArena();
+    ScratchMark start = arena->getMark();
+
+    // Every allocation is aligned and the first one creates a chunk
+    char *small = (char *) arena->allocate(10);
+    char *aligned = (char *) arena->allocate(24);
+
+    TEST_ASSERT(((size_t) small) % SCRATCH_ALIGNMENT == 0);
+    TEST_ASSERT(aligned - small == 16);
+    TEST_ASSERT(arena->getChunkAllocationsNum() == 1);
+    TEST_ASSERT(arena->getCapacity() == SCRATCH_CHUNK_SIZE);
+
+    // An allocation that does not fit creates a larger chunk
+    ScratchMark mark = arena->getMark();
+    char *large = (char *) arena->allocate(2 * SCRATCH_CHUNK_SIZE);
+
+    TEST_ASSERT(arena->getChunkAllocationsNum() == 2);
+    TEST_ASSERT(arena->getCapacity() == 3 * SCRATCH_CHUNK_SIZE);
+
+    // Rewinding frees the memory of the later allocations, which the
+    // next allocations find again without a new chunk
+    arena->rewind(mark);
+    TEST_ASSERT(arena->allocate(2 * SCRATCH_CHUNK_SIZE) == large);
+
+    arena->rewind(start);
+    TEST_ASSERT(arena->allocate(10) == small);
+    TEST_ASSERT(arena->getChunkAllocationsNum() == 2);
+
+    delete arena;
+
+    // The joins of the same relations find all their auxiliary arrays
+    // in the arena of the thread after the first one
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    phji->maxPartitionDepth = 2;
+    phji->maxAllowedSizeModifier = 0.0001;
+
+    unsigned int tuplesNum = 5000, i;
+    unsigned long long *keys = new unsigned long long[tuplesNum];
+
+    for(i = 0; i < tuplesNum; i++)
+        keys[i] = (i * 7) % 1000;
+
+    ScratchArena *threadArena = ScratchArena::getThreadArena();
+    unsigned long long chunkAllocationsNum = 0;
+
+    for(unsigned int k = 0; k < 3; k++)
+    {
+        Tuple *R_tuples = new Tuple[tuplesNum];
+        Tuple *S_tuples = new Tuple[tuplesNum];
+
+        for(i = 0; i < tuplesNum; i++)
+        {
+            R_tuples[i] = Tuple(&keys[i], i);
+            S_tuples[i] = Tuple(&keys[tuplesNum - 1 - i], i);
+        }
+
+        Relation R(R_tuples, tuplesNum);
+        Relation S(S_tuples, tuplesNum);
+
+        PartitionedHashJoin phj(&R, &S, phji);
+        RowIdRelation *result = phj.executeJoin();
+
+        TEST_ASSERT(result->getNumOfRowIdPairs() == 25000);
+        TEST_ASSERT(phj.getStatistics().partitionDepth > 0);
+
+        if(k == 0)
+            chunkAllocationsNum = threadArena->getChunkAllocationsNum();
+
+        TEST_ASSERT(threadArena->getChunkAllocationsNum() == chunkAllocationsNum);
+
+        phj.freeJoinResult(result);
+
+        delete[] R_tuples;
+        delete[] S_tuples;
+    }
+
+    threadArena->reset();
+
+    delete[] keys;
+    delete phji;
+}
+
+void wideCountsTest()
+{
+    // The counts of the join pipeline are not truncated to 32 bits
+    // (nothing is allocated, only the counts are examined)
+    unsigned long long count = 5000000000ULL;
+
+    Relation relation(NULL, count);
+
+    TEST_ASSERT(relation.getNumOfTuples() == count);
+    TEST_ASSERT(relation.getSize() == count * sizeof(Tuple));
+
+    relation.setNumOfTuples(count + 1);
+    TEST_ASSERT(relation.getNumOfTuples() == count + 1);
+
+    RowIdRelation result(NULL, count);
+    TEST_ASSERT(result.getNumOfRowIdPairs() == count);
+
+    List list;
+    list.setCounter(count);
+    TEST_ASSERT(list.getCounter() == count);
+    list.setCounter(0);
+
+    // A join of a relation with more tuples than a row ID can address stops
+    // the program instead of wrapping the row IDs (so we join in a child)
+    pid_t pid = fork();
+
+    if(pid == 0)
+    {
+        freopen("/dev/null", "w", stderr);
+
+        PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+        Relation wideRelation(NULL, count);
+        Relation emptyRelation(NULL, 0);
+
+        PartitionedHashJoin phj(&wideRelation, &emptyRelation, phji);
+        phj.executeJoin();
+
+        _exit(0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+}
+
+void hashFunctionsTest()
+{
+    HashFunctionType functions[4] = { BitsHash, FibonacciHash, MurmurHash, Crc32Hash };
+    unsigned int i, f, bits;
+
+    // Every hash function gives one of the (2 ^ bits) buckets
+    for(f = 0; f < 4; f++)
+    {
+        for(bits = 0; bits <= 12; bits++)
+        {
+            for(i = 0; i < 1000; i++)
+            {
+                unsigned long long key = i * 7919ULL + (1ULL << 40);
+                TEST_ASSERT(PartitionedHashJoin::partitionHash(key, bits, functions[f]) < (1U << bits));
+            }
+        }
+    }
+
+    // Sequential keys are spread evenly by their rightmost bits, while keys
+    // with a stride of 256 would all land in one of 256 buckets
+    unsigned int sampleNum = 4096;
+    unsigned long long *sample = new unsigned long long[sampleNum];
+
+    for(i = 0; i < sampleNum; i++)
+        sample[i] = i;
+
+    TEST_ASSERT(PartitionedHashJoin::chooseHashFunction(sample, sampleNum, 8) == BitsHash);
+
+    for(i = 0; i < sampleNum; i++)
+        sample[i] = i * 256ULL;
+
+    TEST_ASSERT(PartitionedHashJoin::chooseHashFunction(sample, sampleNum, 8) != BitsHash);
+
+    delete[] sample;
+
+    // The joins with every hash function give the same result
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(4);
+
+    unsigned int R_num = 3000, S_num = 2000;
+    unsigned long long *R_keys = new unsigned long long[R_num];
+    unsigned long long *S_keys = new unsigned long long[S_num];
+
+    for(i = 0; i < R_num; i++)
+        R_keys[i] = (i % 1500) * 256ULL;
+
+    for(i = 0; i < S_num; i++)
+        S_keys[i] = (i % 1000) * 512ULL;
+
+    // The relations do not fit in the cache, so they are partitioned
+    phji->maxPartitionDepth = 2;
+    phji->maxAllowedSizeModifier = 0.0001;
+    phji->heavyHitterShare = 0;
+
+    unsigned long long checksum = 0, squaresChecksum = 0, pairsNum = 0;
+
+    for(unsigned int k = 0; k < 10; k++)
+    {
+        phji->hashFunction = (k / 2 < 4) ? functions[k / 2] : AutoHash;
+        JobScheduler *scheduler = (k % 2 == 0) ? NULL : jobScheduler;
+
+        Tuple *R_tuples = new Tuple[R_num];
+        Tuple *S_tuples = new Tuple[S_num];
+
+        for(i = 0; i < R_num; i++)
+            R_tuples[i] = Tuple(&R_keys[i], i);
+
+        for(i = 0; i < S_num; i++)
+            S_tuples[i] = Tuple(&S_keys[i], i);
+
+        Relation R(R_tuples, R_num);
+        Relation S(S_tuples, S_num);
+
+        PartitionedHashJoin phj(&R, &S, phji, scheduler);
+        RowIdRelation *result = phj.executeJoin();
+
+        // The automatic choice is made when the join is executed and
+        // it does not keep the rightmost bits of keys with a stride
+        TEST_ASSERT(phj.getHashFunction() != AutoHash);
+
+        if(k >= 8)
+            TEST_ASSERT(phj.getHashFunction() != BitsHash);
+
+        unsigned long long currentChecksum, currentSquaresChecksum;
+        rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+        if(k == 0)
+        {
+            checksum = currentChecksum;
+            squaresChecksum = currentSquaresChecksum;
+            pairsNum = result->getNumOfRowIdPairs();
+        }
+
+        TEST_ASSERT(result->getNumOfRowIdPairs() == pairsNum);
+        TEST_ASSERT(currentChecksum == checksum);
+        TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+        phj.freeJoinResult(result);
+
+        delete[] R_tuples;
+        delete[] S_tuples;
+    }
+
+    // Every key of 'S' that is a multiple of 256 below 1500 * 256 matches
+    // two tuples of 'R', and each such key appears twice in 'S'
+    TEST_ASSERT(pairsNum == 750 * 2 * 2);
+
+    delete[] R_keys;
+    delete[] S_keys;
+    delete jobScheduler;
+    delete phji;
+}
+
+void partitionTuningTest()
+{
+    // Every part of the hierarchy is known, even if the system cannot tell
+    const CacheHierarchy *hierarchy = CacheHierarchy::getInstance();
+
+    TEST_ASSERT(hierarchy->getLvl1CacheSize() > 0);
+    TEST_ASSERT(hierarchy->getLvl2CacheSize() > 0);
+    TEST_ASSERT(hierarchy->getLvl3CacheSize() > 0);
+    TEST_ASSERT(hierarchy->getCacheLineSize() > 0);
+    TEST_ASSERT(hierarchy->getPageSize() > 0);
+
+    // A pass never writes to more buckets than the TLB can reach
+    unsigned int maxBits = hierarchy->getMaxBitsPerPass();
+
+    TEST_ASSERT(maxBits >= 1);
+    TEST_ASSERT(maxBits == 1 || (1U << maxBits) <= hierarchy->getDataTlbEntries());
+
+    unsigned int bitsPerPass, passesNum;
+    unsigned long long capacity = hierarchy->getLvl2CacheSize() / sizeof(Tuple);
+
+    // Relations that fit the cache are not partitioned
+    PartitionedHashJoin::tunePartitioning(100, 200, 4, 1.0, 2, &bitsPerPass, &passesNum);
+
+    TEST_ASSERT(passesNum == 0);
+    TEST_ASSERT(bitsPerPass >= 1 && bitsPerPass <= maxBits);
+
+    // Larger relations are split in buckets that fit the cache
+    unsigned long long R_num = capacity << 10, S_num = capacity;
+    PartitionedHashJoin::tunePartitioning(R_num, S_num, 1, 1.0, 8, &bitsPerPass, &passesNum);
+
+    TEST_ASSERT(passesNum >= 1);
+    TEST_ASSERT(bitsPerPass <= maxBits);
+    TEST_ASSERT((R_num >> (bitsPerPass * passesNum)) <= capacity);
+
+    // The passes never exceed the maximum depth
+    PartitionedHashJoin::tunePartitioning(R_num, S_num, 1, 1.0, 1, &bitsPerPass, &passesNum);
+
+    TEST_ASSERT(passesNum == 1);
+    TEST_ASSERT(bitsPerPass <= maxBits);
+
+    // Every thread is given a few buckets
+    PartitionedHashJoin::tunePartitioning(capacity * 2, 100, 16, 1.0, 8, &bitsPerPass, &passesNum);
+
+    TEST_ASSERT(passesNum >= 1);
+    TEST_ASSERT((1ULL << (bitsPerPass * passesNum)) >= 16 * PARTITION_BUCKETS_PER_THREAD
+        || bitsPerPass == maxBits);
+
+    // The tuned joins give the same result as the joins with static bits
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(4);
+
+    unsigned int tuplesNum = 5000, i;
+    unsigned long long *keys = new unsigned long long[tuplesNum];
+
+    for(i = 0; i < tuplesNum; i++)
+        keys[i] = (i * 7919ULL) % 2500;
+
+    // The relations do not fit in the cache, so they are partitioned
+    phji->maxPartitionDepth = 2;
+    phji->maxAllowedSizeModifier = 0.0001;
+
+    unsigned long long checksum = 0, squaresChecksum = 0, pairsNum = 0;
+
+    for(unsigned int k = 0; k < 4; k++)
+    {
+        phji->autoTunedPartitioning = (k >= 2);
+        JobScheduler *scheduler = (k % 2 == 0) ? NULL : jobScheduler;
+
+        Tuple *R_tuples = new Tuple[tuplesNum];
+        Tuple *S_tuples = new Tuple[tuplesNum];
+
+        for(i = 0; i < tuplesNum; i++)
+        {
+            R_tuples[i] = Tuple(&keys[i], i);
+            S_tuples[i] = Tuple(&keys[tuplesNum - i - 1], i);
+        }
+
+        Relation R(R_tuples, tuplesNum);
+        Relation S(S_tuples, tuplesNum);
+
+        PartitionedHashJoin phj(&R, &S, phji, scheduler);
+        RowIdRelation *result = phj.executeJoin();
+
+        TEST_ASSERT(result != NULL);
+        TEST_ASSERT(phj.getStatistics().partitionDepth >= 1);
+
+        // The tuned joins partition the relations no more times than the
+        // tuned passes
+        if(k >= 2)
+        {
+            TEST_ASSERT(phj.getBitsNumForHashing() <= maxBits);
+
+            PartitionedHashJoin::tunePartitioning(tuplesNum, tuplesNum,
+                (scheduler != NULL) ? scheduler->getMaxThreads() : 1,
+                phji->maxAllowedSizeModifier, phji->maxPartitionDepth,
+                &bitsPerPass, &passesNum);
+
+            TEST_ASSERT(passesNum >= 1);
+            TEST_ASSERT(phj.getStatistics().partitionDepth <= passesNum);
+        }
+
+        unsigned long long currentChecksum, currentSquaresChecksum;
+        rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+        if(k == 0)
+        {
+            checksum = currentChecksum;
+            squaresChecksum = currentSquaresChecksum;
+            pairsNum = result->getNumOfRowIdPairs();
+        }
+
+        TEST_ASSERT(result->getNumOfRowIdPairs() == pairsNum);
+        TEST_ASSERT(currentChecksum == checksum);
+        TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+        phj.freeJoinResult(result);
+
+        delete[] R_tuples;
+        delete[] S_tuples;
+    }
+
+    // Every key appears twice in each relation
+    TEST_ASSERT(pairsNum == 2500 * 2 * 2);
+
+    delete[] keys;
+    delete jobScheduler;
+    delete phji;
+}
+
+void sortMergeJoinTest()
+{
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(4);
+
+    unsigned int tuplesNum = 20000, i;
+    unsigned long long *keys = new unsigned long long[tuplesNum];
+
+    // Sorted, nearly sorted and random keys that span many digits
+    for(unsigned int pattern = 0; pattern < 3; pattern++)
+    {
+        for(i = 0; i < tuplesNum; i++)
+        {
+            keys[i] = (pattern < 2) ? (i / 2) * 1000003ULL
+                : ((i * 2654435761ULL) % 5000) << 28;
+        }
+
+        if(pattern == 1)
+        {
+            for(i = 0; i + 3 < tuplesNum; i += 100)
+            {
+                unsigned long long temp = keys[i + 1];
+                keys[i + 1] = keys[i + 3];
+                keys[i + 3] = temp;
+            }
+        }
+
+        Tuple *R_tuples = new Tuple[tuplesNum];
+        Tuple *S_tuples = new Tuple[tuplesNum];
+
+        for(i = 0; i < tuplesNum; i++)
+        {
+            R_tuples[i] = Tuple(&keys[i], i);
+            S_tuples[i] = Tuple(&keys[i], tuplesNum - i - 1);
+        }
+
+        Relation R(R_tuples, tuplesNum);
+        Relation S(S_tuples, tuplesNum);
+
+        // The sortedness tells the sorted keys from the random ones
+        double sortedness = SortMergeJoin::getSortedness(&R);
+
+        if(pattern == 0) TEST_ASSERT(sortedness == 1.0);
+        if(pattern == 1) TEST_ASSERT(sortedness >= MIN_SORTED_SHARE);
+        if(pattern == 2) TEST_ASSERT(sortedness < MIN_SORTED_SHARE);
+
+        // The partitioned hash join gives the expected result
+        PartitionedHashJoin phj(&R, &S, phji, NULL);
+        RowIdRelation *expected = phj.executeJoin();
+
+        unsigned long long checksum, squaresChecksum;
+        rowIdRelationChecksum(expected, &checksum, &squaresChecksum);
+
+        // The sort-merge join gives the same pairs with or without threads
+        for(unsigned int k = 0; k < 2; k++)
+        {
+            SortMergeJoin smj(&R, &S, (k == 0) ? NULL : jobScheduler);
+            RowIdRelation *result = smj.executeJoin();
+
+            TEST_ASSERT(result != NULL);
+            TEST_ASSERT(smj.getStatistics().algorithm == SortMergeJoinAlgorithm);
+            TEST_ASSERT(result->getNumOfRowIdPairs() == expected->getNumOfRowIdPairs());
+
+            unsigned long long currentChecksum, currentSquaresChecksum;
+            rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+            TEST_ASSERT(currentChecksum == checksum);
+            TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+            SortMergeJoin::freeJoinResult(result);
+        }
+
+        phj.freeJoinResult(expected);
+
+        delete[] R_tuples;
+        delete[] S_tuples;
+    }
+
+    // A join with an empty relation has no pairs
+    Relation empty;
+    Tuple *tuples = new Tuple[tuplesNum];
+
+    for(i = 0; i < tuplesNum; i++)
+        tuples[i] = Tuple(&keys[i], i);
+
+    Relation full(tuples, tuplesNum);
+    SortMergeJoin smj(&empty, &full, jobScheduler);
+    RowIdRelation *result = smj.executeJoin();
+
+    TEST_ASSERT(result->getNumOfRowIdPairs() == 0);
+
+    SortMergeJoin::freeJoinResult(result);
+
+    delete[] tuples;
+    delete[] keys;
+    delete jobScheduler;
+    delete phji;
+}
+
+void arrayJoinTest()
+{
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(4);
+
+    // Keys are dense if their range is small relative to the tuples
+    TEST_ASSERT(ArrayJoin::isDense(100, 199, 100));
+    TEST_ASSERT(ArrayJoin::isDense(5, 5, 1));
+    TEST_ASSERT(!ArrayJoin::isDense(0, 1000, 100));
+    TEST_ASSERT(!ArrayJoin::isDense(0, 10, 0));
+
+    // A dense dimension with a few duplicate keys and a fact relation
+    // whose keys are partly outside the range of the dimension
+    unsigned int dimensionNum = 3000, factNum = 20000, i;
+    unsigned long long *dimensionKeys = new unsigned long long[dimensionNum];
+    unsigned long long *factKeys = new unsigned long long[factNum];
+
+    for(i = 0; i < dimensionNum; i++)
+        dimensionKeys[i] = 1000 + ((i % 10 == 0) ? i / 2 : i);
+
+    for(i = 0; i < factNum; i++)
+        factKeys[i] = (i * 2654435761ULL) % 5000;
+
+    Tuple *dimensionTuples = new Tuple[dimensionNum];
+    Tuple *factTuples = new Tuple[factNum];
+
+    for(i = 0; i < dimensionNum; i++)
+        dimensionTuples[i] = Tuple(&dimensionKeys[i], i);
+
+    for(i = 0; i < factNum; i++)
+        factTuples[i] = Tuple(&factKeys[i], i);
+
+    Relation dimension(dimensionTuples, dimensionNum);
+    Relation fact(factTuples, factNum);
+
+    unsigned long long minKey, maxKey;
+    ArrayJoin::findKeyRange(&dimension, &minKey, &maxKey);
+
+    TEST_ASSERT(minKey == 1000 && maxKey == 3999);
+    TEST_ASSERT(ArrayJoin::isDense(minKey, maxKey, dimensionNum));
+
+    // The array join gives the pairs of the hash join in both orientations
+    for(unsigned int k = 0; k < 4; k++)
+    {
+        bool dimensionIsR = (k < 2);
+        Relation *R = dimensionIsR ? &dimension : &fact;
+        Relation *S = dimensionIsR ? &fact : &dimension;
+
+        PartitionedHashJoin phj(R, S, phji, NULL);
+        RowIdRelation *expected = phj.executeJoin();
+
+        unsigned long long checksum, squaresChecksum;
+        rowIdRelationChecksum(expected, &checksum, &squaresChecksum);
+
+        ArrayJoin aj(R, S, dimensionIsR, minKey, maxKey,
+            (k % 2 == 0) ? NULL : jobScheduler);
+
+        RowIdRelation *result = aj.executeJoin();
+
+        TEST_ASSERT(aj.getStatistics().algorithm == ArrayJoinAlgorithm);
+        TEST_ASSERT(result->getNumOfRowIdPairs() == expected->getNumOfRowIdPairs());
+
+        unsigned long long currentChecksum, currentSquaresChecksum;
+        rowIdRelationChecksum(result, &currentChecksum, &currentSquaresChecksum);
+
+        TEST_ASSERT(currentChecksum == checksum);
+        TEST_ASSERT(currentSquaresChecksum == squaresChecksum);
+
+        ArrayJoin::freeJoinResult(result);
+        phj.freeJoinResult(expected);
+    }
+
+    delete[] dimensionTuples;
+    delete[] factTuples;
+    delete[] dimensionKeys;
+    delete[] factKeys;
+    delete jobScheduler;
+    delete phji;
+}
+
+/**************************************************************************
+ *                                  Query                                 *
+ **************************************************************************/
+
+void predicatesParserTest()
+{
+    char predicate[10] = "2.0 = 3.4";
+
+    PredicatesParser pp(predicate);
+
+    TEST_ASSERT(pp.getLeftArray() == 2);
+    TEST_ASSERT(pp.getLeftArrayColumn() == 0);
+    TEST_ASSERT(pp.getRightArray() == 3);
+    TEST_ASSERT(pp.getRightArrayColumn() == 4);
+    TEST_ASSERT(pp.hasConstant() == false);
+
+    char predicate1[9] = "1.1 < 69";
+    PredicatesParser pp1(predicate1);
+
+    TEST_ASSERT(pp1.getLeftArray() == 1);
+    TEST_ASSERT(pp1.getLeftArrayColumn() == 1);
+    TEST_ASSERT(pp1.getFilterOperator() == '<');
+    TEST_ASSERT(pp1.getFilterValue() == 69);
+    TEST_ASSERT(pp1.hasConstant() == true);
+
+}
+
+void projectionsParserTest()
+{
+    char projection[4] = "1.5";
+    ProjectionsParser pp(projection);
+
+    TEST_ASSERT(pp.getArray() == 1);
+    TEST_ASSERT(pp.getColumn() == 5);
+}
+
+/**************************************************************************
+ *                           Query Optimization                           *
+ **************************************************************************/
+
+void joinEnumeratorTest()
+{
+    char predicate_01[8] = "0.0=1.0";
+    char predicate_12[8] = "1.1=2.0";
+    char predicate_23[8] = "2.1=3.0";
+    char predicate_11[8] = "1.0=1.2";
+
+    PredicatesParser pp_01(predicate_01);
+    PredicatesParser pp_12(predicate_12);
+    PredicatesParser pp_23(predicate_23);
+    PredicatesParser pp_11(predicate_11);
+
+    // A chain 0 - 1 - 2 - 3 where the middle join produces a lot of tuples.
+    // Joining 0 with 1 and 2 with 3 first (a bushy tree) is the cheapest plan
+    JoinEnumerator enumerator(4, 4);
+
+    for(unsigned int i = 0; i < 4; i++)
+        enumerator.setRelationSize(i, 1000);
+
+    enumerator.insertPredicate(&pp_01, 0.000001);
+    enumerator.insertPredicate(&pp_12, 1);
+    enumerator.insertPredicate(&pp_23, 0.000001);
+    enumerator.insertPredicate(&pp_11, 0.5);
+
+    enumerator.enumerate();
+
+    unsigned long long allRelations = 0xF;
+    unsigned long long leftSet = enumerator.getPlanLeftSet(allRelations);
+
+    TEST_ASSERT(leftSet == 0x3 || leftSet == 0xC);
+    TEST_ASSERT(enumerator.getPlanLeftSet(0x2) == 0);
+    TEST_ASSERT(enumerator.getPlanSize(0x2) == 500);
+
+    // The cost is the sum of the tuples of the three intermediate results
+    double size_01 = 1000 * 500 * 0.000001;
+    double size_23 = 1000 * 1000 * 0.000001;
+    double expectedCost = size_01 + size_23 + size_01 * size_23;
+
+    TEST_ASSERT(enumerator.getPlanCost(allRelations) > expectedCost - 0.001);
+    TEST_ASSERT(enumerator.getPlanCost(allRelations) < expectedCost + 0.001);
+
+    // Sets of relations that are not connected have no plan
+    TEST_ASSERT(enumerator.getPlanCost(0x5) < 0);
+
+    // Each subtree is built first and then the predicate that joins them.
+    // The predicate between columns of the same relation comes before any
+    // join of that relation
+    List joinsOrder;
+    enumerator.getJoinsOrder(&joinsOrder);
+
+    TEST_ASSERT(joinsOrder.getCounter() == 4);
+    TEST_ASSERT(joinsOrder.getItemInPos(4) == &pp_12);
+
+    unsigned int pos_01 = 0, pos_23 = 0, pos_11 = 0;
+
+    for(unsigned int pos = 1; pos <= 3; pos++)
+    {
+        void *item = joinsOrder.getItemInPos(pos);
+
+        if(item == &pp_01) pos_01 = pos;
+        if(item == &pp_23) pos_23 = pos;
+        if(item == &pp_11) pos_11 = pos;
+    }
+
+    TEST_ASSERT(pos_01 != 0 && pos_23 != 0 && pos_11 != 0);
+    TEST_ASSERT(pos_11 < pos_01);
+
+    // With a cheap middle join the plan starts from it instead
+    JoinEnumerator leftDeepEnumerator(4, 3);
+
+    for(unsigned int i = 0; i < 4; i++)
+        leftDeepEnumerator.setRelationSize(i, 1000);
+
+    leftDeepEnumerator.insertPredicate(&pp_01, 0.01);
+    leftDeepEnumerator.insertPredicate(&pp_12, 0.000001);
+    leftDeepEnumerator.insertPredicate(&pp_23, 0.01);
+
+    leftDeepEnumerator.enumerate();
+
+    List leftDeepOrder;
+    leftDeepEnumerator.getJoinsOrder(&leftDeepOrder);
+
+    TEST_ASSERT(leftDeepOrder.getCounter() == 3);
+    TEST_ASSERT(leftDeepOrder.getItemInPos(1) == &pp_12);
+
+    // Aliases 0 and 1 have already been joined, so they form a single
+    // relation and only the two remaining joins are enumerated
+    unsigned int relationOfAlias[4] = {0, 0, 1, 2};
+    JoinEnumerator groupEnumerator(3, 2);
+
+    groupEnumerator.setRelationsOfAliases(4, relationOfAlias);
+    groupEnumerator.setRelationSize(0, 100);
+    groupEnumerator.setRelationSize(1, 1000);
+    groupEnumerator.setRelationSize(2, 10);
+
+    groupEnumerator.insertPredicate(&pp_12, 0.01);
+    groupEnumerator.insertPredicate(&pp_23, 0.01);
+
+    groupEnumerator.enumerate();
+
+    TEST_ASSERT(groupEnumerator.getPlanSize(0x3) == 1000);
+    TEST_ASSERT(groupEnumerator.getPlanSize(0x6) == 100);
+    TEST_ASSERT(groupEnumerator.getPlanSize(0x7) == 100);
+
+    List groupOrder;
+    groupEnumerator.getJoinsOrder(&groupOrder);
+
+    TEST_ASSERT(groupOrder.getCounter() == 2);
+    TEST_ASSERT(groupOrder.getItemInPos(1) == &pp_23);
+    TEST_ASSERT(groupOrder.getItemInPos(2) == &pp_12);
+
+    // A cycle of joins between columns of the same equivalence class.
+    // Only the most selective join between two sets of relations cuts
+    // off tuples, the others are implied by the previous joins
+    char predicate_a01[8] = "0.0=1.0";
+    char predicate_a12[8] = "1.0=2.0";
+    char predicate_a02[8] = "0.0=2.0";
+
+    PredicatesParser pp_a01(predicate_a01);
+    PredicatesParser pp_a12(predicate_a12);
+    PredicatesParser pp_a02(predicate_a02);
+
+    JoinEnumerator cycleEnumerator(3, 3);
+
+    for(unsigned int i = 0; i < 3; i++)
+        cycleEnumerator.setRelationSize(i, 100);
+
+    cycleEnumerator.insertPredicate(&pp_a01, 0.01, 1);
+    cycleEnumerator.insertPredicate(&pp_a12, 0.01, 1);
+    cycleEnumerator.insertPredicate(&pp_a02, 0.001, 1);
+
+    cycleEnumerator.enumerate();
+
+    TEST_ASSERT(fabs(cycleEnumerator.getPlanSize(0x7) - 10) < 0.000001);
+}
+
+// The input of each thread of 'queryOptimizerConcurrencyTest'
+struct OptimizerThreadInput {
+    List *tables;
+    Query **queries;
+    List **expectedOrders;
+    unsigned int queriesNum;
+    unsigned int mismatchesNum;
+};
+
+// Optimizes every query a few times and counts the
+// orders that differ from the ones found serially
+static void *optimizeQueries(void *argument)
+{
+    OptimizerThreadInput *input = (OptimizerThreadInput *) argument;
+
+    for(unsigned int round = 0; round < 5; round++)
+    {
+        for(unsigned int i = 0; i < input->queriesNum; i++)
+        {
+            QueryOptimizer optimizer(input->tables, input->queries[i]);
+            List *order = optimizer.getOptimalPredicatesOrder();
+            List *expected = input->expectedOrders[i];
+
+            bool same = (order->getCounter() == expected->getCounter());
+
+            for(Listnode *a = order->getHead(), *b = expected->getHead();
+                same && a != NULL; a = a->getNext(), b = b->getNext())
+            {
+                same = (a->getItem() == b->getItem());
+            }
+
+            if(!same)
+                input->mismatchesNum++;
+
+            optimizer.deleteOptimalPredicatesOrder(order);
+        }
+    }
+
+    return NULL;
+}
+
+void queryOptimizerConcurrencyTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+
+    // We read the first queries of the workload
+    const unsigned int queriesNum = 20;
+    Query *queries[queriesNum];
+    List *expectedOrders[queriesNum];
+
+    std::ifstream work("../input/small/small.work");
+    std::string line;
+    unsigned int readNum = 0;
+
+    while(readNum < queriesNum && std::getline(work, line))
+    {
+        if(line == "F")
+            continue;
+
+        char queryString[line.size() + 1];
+        strcpy(queryString, line.c_str());
+
+        queries[readNum] = new Query(queryString);
+        readNum++;
+    }
+
+    TEST_ASSERT(readNum == queriesNum);
+
+    // The orders found by optimizing the queries one after the other
+    for(unsigned int i = 0; i < queriesNum; i++)
+    {
+        QueryOptimizer optimizer(tables, queries[i]);
+        List *order = optimizer.getOptimalPredicatesOrder();
+
+        expectedOrders[i] = new List();
+        expectedOrders[i]->append(order);
+
+        // Redundant filters and implied joins are left out of the order
+        TEST_ASSERT(order->getCounter() <= queries[i]->getPredicates()->getCounter());
+        optimizer.deleteOptimalPredicatesOrder(order);
+    }
+
+    // Many optimizers running at the same time find the same orders
+    const unsigned int threadsNum = 4;
+    pthread_t threads[threadsNum];
+    OptimizerThreadInput inputs[threadsNum];
+
+    for(unsigned int t = 0; t < threadsNum; t++)
+    {
+        inputs[t].tables = tables;
+        inputs[t].queries = queries;
+        inputs[t].expectedOrders = expectedOrders;
+        inputs[t].queriesNum = queriesNum;
+        inputs[t].mismatchesNum = 0;
+
+        pthread_create(&threads[t], NULL, optimizeQueries, &inputs[t]);
+    }
+
+    for(unsigned int t = 0; t < threadsNum; t++)
+    {
+        pthread_join(threads[t], NULL);
+        TEST_ASSERT(inputs[t].mismatchesNum == 0);
+    }
+
+    for(unsigned int i = 0; i < queriesNum; i++)
+    {
+        delete expectedOrders[i];
+        delete queries[i];
+    }
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
+}
+
+void planCacheTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+
+    // The same template with a different order of predicates and a slightly
+    // different constant (so the filter falls in the same selectivity bucket)
+    char queryString_1[64] = "3 0 1|0.2=1.0&0.1=2.0&0.2>3499|1.2 0.1";
+    char queryString_2[64] = "3 0 1|0.1=2.0&0.2>3500&1.0=0.2|1.2 0.1";
+    char queryString_3[64] = "3 0 1|0.2=1.0&0.1=2.0&0.2>99999999|1.2 0.1";
+    char queryString_4[64] = "9 0 2|0.1=1.0&1.0=2.2&0.0>12472|1.0 0.3 0.4";
+
+    Query query_1(queryString_1);
+    Query query_2(queryString_2);
+    Query query_3(queryString_3);
+    Query query_4(queryString_4);
+
+    PlanCache cache(tables, 2);
+
+    // The first query of a template finds nothing
+    TEST_ASSERT(cache.getPredicatesOrder(&query_1) == NULL);
+
+    QueryOptimizer optimizer(tables, &query_1);
+    List *order_1 = optimizer.getOptimalPredicatesOrder();
+    cache.insertPredicatesOrder(&query_1, order_1);
+
+    TEST_ASSERT(cache.getPlansNum() == 1);
+
+    // The second query of the template reuses the order with its own predicates
+    double *selectivities_2 = NULL;
+    List *order_2 = cache.getPredicatesOrder(&query_2, &selectivities_2);
+
+    TEST_ASSERT(order_2 != NULL);
+    TEST_ASSERT(selectivities_2 == NULL);
+    TEST_ASSERT(order_2->getCounter() == order_1->getCounter());
+
+    for(unsigned int pos = 1; pos <= order_1->getCounter(); pos++)
+    {
+        PredicatesParser *pred_1 = (PredicatesParser *) order_1->getItemInPos(pos);
+        PredicatesParser *pred_2 = (PredicatesParser *) order_2->getItemInPos(pos);
+
+        TEST_ASSERT(query_2.getPredicates()->getItemInPos(1) == pred_2
+            || query_2.getPredicates()->getItemInPos(2) == pred_2
+            || query_2.getPredicates()->getItemInPos(3) == pred_2);
+
+        TEST_ASSERT(pred_1->hasConstant() == pred_2->hasConstant());
+
+        // The join sides may be swapped in the other query
+        bool sameSides = pred_1->getLeftArray() == pred_2->getLeftArray()
+            && pred_1->getLeftArrayColumn() == pred_2->getLeftArrayColumn();
+
+        bool swappedSides = !pred_1->hasConstant()
+            && pred_1->getLeftArray() == pred_2->getRightArray()
+            && pred_1->getLeftArrayColumn() == pred_2->getRightArrayColumn();
+
+        TEST_ASSERT(sameSides || swappedSides);
+    }
+
+    delete order_2;
+
+    // A filter that is much more selective does not reuse the order
+    TEST_ASSERT(cache.getPredicatesOrder(&query_3) == NULL);
+    TEST_ASSERT(cache.getHitsNum() == 1);
+    TEST_ASSERT(cache.getMissesNum() == 2);
+
+    // When the cache is full, the oldest plan is evicted
+    QueryOptimizer optimizer_3(tables, &query_3);
+    List *order_3 = optimizer_3.getOptimalPredicatesOrder();
+    cache.insertPredicatesOrder(&query_3, order_3);
+
+    // The selectivities of the predicates are kept with their order
+    QueryOptimizer optimizer_4(tables, &query_4);
+    List *order_4 = optimizer_4.getOptimalPredicatesOrder();
+    double selectivities_4[8];
+
+    for(unsigned int pos = 0; pos < order_4->getCounter(); pos++)
+        selectivities_4[pos] = 1.0 / (pos + 2);
+
+    cache.insertPredicatesOrder(&query_4, order_4, selectivities_4);
+
+    TEST_ASSERT(cache.getPlansNum() == 2);
+    TEST_ASSERT(cache.getPredicatesOrder(&query_1) == NULL);
+
+    double *cachedSelectivities_4 = NULL;
+    List *cachedOrder_4 = cache.getPredicatesOrder(&query_4, &cachedSelectivities_4);
+    TEST_ASSERT(cachedOrder_4 != NULL);
+    TEST_ASSERT(cachedSelectivities_4 != NULL);
+
+    for(unsigned int pos = 1; cachedOrder_4 != NULL && pos <= order_4->getCounter(); pos++)
+    {
+        TEST_ASSERT(cachedOrder_4->getItemInPos(pos) == order_4->getItemInPos(pos));
+        TEST_ASSERT(cachedSelectivities_4[pos - 1] == selectivities_4[pos - 1]);
+    }
+
+    delete cachedOrder_4;
+    delete[] cachedSelectivities_4;
+
+    optimizer.deleteOptimalPredicatesOrder(order_1);
+    optimizer_3.deleteOptimalPredicatesOrder(order_3);
+    optimizer_4.deleteOptimalPredicatesOrder(order_4);
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
+}
+
+void costModelTest()
+{
+    PartitionedHashJoinInput *phji = new PartitionedHashJoinInput("../config.txt");
+
+    // A cache where 1024 tuples fit without being partitioned
+    CostModel costModel(phji, (long) (1024 * sizeof(Tuple) / phji->maxAllowedSizeModifier) + 1);
+
+    TEST_ASSERT(costModel.getPartitionPasses(100, 500) == 0);
+    TEST_ASSERT(costModel.getPartitionPasses(1000000, 100) >= 1);
+    TEST_ASSERT(costModel.getPartitionPasses(1000000, 100) <= phji->maxPartitionDepth);
+
+    // Scan, filter, partition, build, probe & materialize
+    costModel.setCostsPerTuple(1, 2, 3, 4, 5, 6);
+    costModel.setHashTableCost(7);
+
+    TEST_ASSERT(costModel.estimateRelationCost(1000, 2) == 5000);
+
+    // Both inputs are scanned, the smaller one is built, the larger one probes
+    TEST_ASSERT(costModel.estimateJoinCost(100, 500, 50) == 600 + 7 + 400 + 2500 + 300);
+    TEST_ASSERT(costModel.estimateJoinCost(500, 100, 50) == costModel.estimateJoinCost(100, 500, 50));
+
+    // Partitioned inputs are also partitioned and every non-empty bucket
+    // of the smaller input gets its own hash table
+    unsigned int passes = costModel.getPartitionPasses(1000000, 100);
+
+    TEST_ASSERT(costModel.getBucketsNum(passes) >= 100);
+    TEST_ASSERT(costModel.estimateJoinCost(1000000, 100, 0)
+        == 1000100 + 3.0 * 1000100 * passes + 100 * 7 + 400 + 5000000);
+
+    // The cost of the best plan of a join enumerator is the time of the query
+    char predicate_01[8] = "0.0=1.0";
+    PredicatesParser pp_01(predicate_01);
+
+    JoinEnumerator enumerator(2, 1, &costModel);
+
+    enumerator.setRelationSize(0, 128);
+    enumerator.setRelationSize(1, 512);
+    enumerator.setRelationCost(0, costModel.estimateRelationCost(128, 0));
+    enumerator.setRelationCost(1, costModel.estimateRelationCost(512, 1));
+    enumerator.insertPredicate(&pp_01, 0.0625);
+    enumerator.enumerate();
+
+    TEST_ASSERT(enumerator.getPlanSize(0x3) == 4096);
+    TEST_ASSERT(enumerator.getPlanCost(0x3) == 128 + 1536 + 640 + 7 + 512 + 2560 + 24576);
+
+    // The calibration measures a positive cost for every operator
+    costModel.calibrate();
+
+    TEST_ASSERT(costModel.getScanCostPerTuple() > 0);
+    TEST_ASSERT(costModel.getFilterCostPerTuple() > 0);
+    TEST_ASSERT(costModel.getPartitionCostPerTuple() > 0);
+    TEST_ASSERT(costModel.getBuildCostPerTuple() > 0);
+    TEST_ASSERT(costModel.getProbeCostPerTuple() > 0);
+    TEST_ASSERT(costModel.getMaterializeCostPerTuple() > 0);
+    TEST_ASSERT(costModel.getHashTableCost() > 0);
+
+    delete phji;
+}
+
+void reoptimizationTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+
+    char queryString[64] = "9 1 11|0.2=1.0&1.0=2.1&1.0=0.2&0.3>3991|1.0";
+    Query query(queryString);
+
+    PredicatesParser *pred_1 = (PredicatesParser *) query.getPredicates()->getItemInPos(1);
+    PredicatesParser *pred_2 = (PredicatesParser *) query.getPredicates()->getItemInPos(2);
+    PredicatesParser *pred_3 = (PredicatesParser *) query.getPredicates()->getItemInPos(3);
+
+    QueryOptimizer optimizer(tables, &query);
+
+    TEST_ASSERT(optimizer.getJoinSelectivity(pred_1) > 0);
+    TEST_ASSERT(optimizer.getJoinSelectivity(pred_1) <= 1);
+
+    // The first join has been executed, so aliases 0 and 1 form a group
+    List executedJoins;
+    executedJoins.insertLast(pred_1);
+
+    List remainingJoins;
+    remainingJoins.insertLast(pred_3);
+    remainingJoins.insertLast(pred_2);
+
+    unsigned int groupOfAlias[3] = {0, 0, 1};
+    double groupRows[2] = {50, 1000};
+
+    // The predicate that has already been executed (with swapped
+    // sides) does not cut off any tuples, so it is placed last
+    List *order = optimizer.reoptimizeJoinsOrder(&remainingJoins,
+        &executedJoins, groupOfAlias, groupRows, 2);
+
+    TEST_ASSERT(order->getCounter() == 2);
+    TEST_ASSERT(order->getItemInPos(1) == pred_2);
+    TEST_ASSERT(order->getItemInPos(2) == pred_3);
+
+    delete order;
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
+}
+
+void cardinalityFeedbackTest()
+{
+    CardinalityFeedback feedback(2);
+
+    // Nothing has been observed yet
+    TEST_ASSERT(feedback.getFilterCorrection(3, 2, '>') == 1);
+    TEST_ASSERT(feedback.getVersion() == 0);
+
+    // The first observation of a shape is taken as it is
+    feedback.recordFilter(3, 2, '>', 100, 400);
+
+    TEST_ASSERT(fabs(feedback.getFilterCorrection(3, 2, '>') - 4) < 0.000001);
+    TEST_ASSERT(feedback.getFilterCorrection(3, 2, '<') == 1);
+    TEST_ASSERT(feedback.getVersion() > 0);
+
+    // An accurate estimation with the correction keeps the correction
+    unsigned long long version = feedback.getVersion();
+    feedback.recordFilter(3, 2, '>', 400, 400);
+
+    TEST_ASSERT(fabs(feedback.getFilterCorrection(3, 2, '>') - 4) < 0.000001);
+    TEST_ASSERT(feedback.getVersion() == version);
+
+    // The order of the sides of a join does not matter
+    feedback.recordJoin(5, 0, 3, 1, 1000, 10);
+
+    TEST_ASSERT(fabs(feedback.getJoinCorrection(3, 1, 5, 0) - 0.01) < 0.000001);
+    TEST_ASSERT(feedback.getEntriesNum() == 2);
+
+    // The corrections are kept between executions
+    TEST_ASSERT(feedback.save("feedback_test.txt"));
+
+    CardinalityFeedback loadedFeedback(16);
+
+    TEST_ASSERT(loadedFeedback.load("feedback_test.txt"));
+    TEST_ASSERT(loadedFeedback.getEntriesNum() == 2);
+    TEST_ASSERT(fabs(loadedFeedback.getJoinCorrection(5, 0, 3, 1) - 0.01) < 0.000001);
+    TEST_ASSERT(fabs(loadedFeedback.getFilterCorrection(3, 2, '>') - 4) < 0.000001);
+
+    remove("feedback_test.txt");
+
+    // When the store is full, the least recently observed shape is evicted
+    feedback.recordFilter(3, 2, '>', 400, 400);
+    feedback.recordJoin(0, 1, 2, 0, 10, 10);
+
+    TEST_ASSERT(feedback.getEntriesNum() == 2);
+    TEST_ASSERT(feedback.getJoinCorrection(3, 1, 5, 0) == 1);
+    TEST_ASSERT(fabs(feedback.getFilterCorrection(3, 2, '>') - 4) < 0.000001);
+
+    // The optimizer corrects its estimations with the feedback
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+
+    char queryString[64] = "3 0 1|0.2=1.0&0.1=2.0&0.2>3499|1.2 0.1";
+    Query query(queryString);
+
+    PredicatesParser *join = (PredicatesParser *) query.getPredicates()->getItemInPos(1);
+    PredicatesParser *filter = (PredicatesParser *) query.getPredicates()->getItemInPos(3);
+
+    CardinalityFeedback queryFeedback(16);
+    queryFeedback.recordFilter(3, 2, '>', 100, 50);
+    queryFeedback.recordJoin(3, 2, 0, 0, 100, 200);
+
+    QueryOptimizer optimizer(tables, &query);
+    QueryOptimizer correctedOptimizer(tables, &query, NULL, &queryFeedback);
+
+    double filterSelectivity = optimizer.getFilterSelectivity(filter);
+    double joinSelectivity = optimizer.getJoinSelectivity(join);
+
+    TEST_ASSERT(filterSelectivity > 0);
+    TEST_ASSERT(fabs(correctedOptimizer.getFilterSelectivity(filter)
+        - filterSelectivity / 2) < 0.000001);
+
+    // The join is estimated after the (corrected) filter
+    TEST_ASSERT(correctedOptimizer.getJoinSelectivity(join) > 0);
+    TEST_ASSERT(correctedOptimizer.getJoinSelectivity(join) <= 1);
+    TEST_ASSERT(joinSelectivity < 0.5);
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
+}
+
+void predicateInferenceTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+
+    // The filter of 0.2 is also applied to 1.0, which is equal to it
+    char queryString[64] = "3 0 1|0.2=1.0&0.1=2.0&0.2>3499|1.2 0.1";
+    Query query(queryString);
+
+    TEST_ASSERT(QueryOptimizer::inferImpliedPredicates(&query) == 1);
+    TEST_ASSERT(query.getPredicates()->getCounter() == 4);
+
+    PredicatesParser *implied = (PredicatesParser *) query.getPredicates()->getItemInPos(4);
+
+    TEST_ASSERT(implied->hasConstant());
+    TEST_ASSERT(implied->getLeftArray() == 1);
+    TEST_ASSERT(implied->getLeftArrayColumn() == 0);
+    TEST_ASSERT(implied->getFilterOperator() == '>');
+    TEST_ASSERT(implied->getFilterValue() == 3499);
+
+    // Nothing more is implied the second time
+    TEST_ASSERT(QueryOptimizer::inferImpliedPredicates(&query) == 0);
+
+    // In a chain of joins of the same column, the filter is applied to
+    // all three columns and the first and the last column are joined too
+    char chainString[64] = "3 0 1|0.1=1.0&1.0=2.2&0.1>100|1.0";
+    Query chainQuery(chainString);
+
+    TEST_ASSERT(QueryOptimizer::inferImpliedPredicates(&chainQuery) == 3);
+
+    // The order has the three filters and only two joins, since
+    // the third join is implied by the other two
+    QueryOptimizer chainOptimizer(tables, &chainQuery);
+    List *chainOrder = chainOptimizer.getOptimalPredicatesOrder();
+
+    TEST_ASSERT(chainOrder->getCounter() == 5);
+
+    unsigned int filtersNum = 0;
+
+    for(Listnode *current = chainOrder->getHead(); current != NULL; current = current->getNext())
+    {
+        if(((PredicatesParser *) current->getItem())->hasConstant())
+            filtersNum++;
+    }
+
+    TEST_ASSERT(filtersNum == 3);
+
+    chainOptimizer.deleteOptimalPredicatesOrder(chainOrder);
+
+    // A filter that is implied by a stricter filter of the same column is
+    // not executed, and neither is the duplicate of a join
+    char redundantString[64] = "0 1|0.1=1.0&0.1>100&0.1>200&1.0=0.1|1.0";
+    Query redundantQuery(redundantString);
+
+    PredicatesParser *strictFilter = (PredicatesParser *)
+        redundantQuery.getPredicates()->getItemInPos(3);
+
+    QueryOptimizer redundantOptimizer(tables, &redundantQuery);
+    List *redundantOrder = redundantOptimizer.getOptimalPredicatesOrder();
+
+    TEST_ASSERT(redundantOrder->getCounter() == 2);
+    TEST_ASSERT(redundantOrder->getItemInPos(1) == strictFilter);
+
+    redundantOptimizer.deleteOptimalPredicatesOrder(redundantOrder);
+
+    // The filters of each relation are placed together, from the most
+    // to the least selective one
+    char filtersString[64] = "0 1|0.1=1.0&0.2<9000&1.0>100&0.1<100|1.0";
+    Query filtersQuery(filtersString);
+
+    List *filtersPredicates = filtersQuery.getPredicates();
+    PredicatesParser *wideFilter = (PredicatesParser *) filtersPredicates->getItemInPos(2);
+    PredicatesParser *otherFilter = (PredicatesParser *) filtersPredicates->getItemInPos(3);
+    PredicatesParser *narrowFilter = (PredicatesParser *) filtersPredicates->getItemInPos(4);
+
+    QueryOptimizer filtersOptimizer(tables, &filtersQuery);
+    List *filtersOrder = filtersOptimizer.getOptimalPredicatesOrder();
+
+    TEST_ASSERT(filtersOptimizer.getFilterSelectivity(narrowFilter)
+        < filtersOptimizer.getFilterSelectivity(wideFilter));
+    TEST_ASSERT(filtersOrder->getItemInPos(1) == narrowFilter);
+    TEST_ASSERT(filtersOrder->getItemInPos(2) == wideFilter);
+    TEST_ASSERT(filtersOrder->getItemInPos(3) == otherFilter);
+
+    filtersOptimizer.deleteOptimalPredicatesOrder(filtersOrder);
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
+}
+
+void queryExplanationTest()
+{
+    List *tables = FileReader::readInitFile("../input/small/small.init", "../config.txt");
+    JobScheduler *jobScheduler = new JobScheduler(2);
+
+    char queryString[64] = "3 0 1|0.2=1.0&0.1=2.0&0.2>3499|1.2 0.1";
+    Query query(queryString);
+
+    PredicatesParser *firstJoin = (PredicatesParser *) query.getPredicates()->getItemInPos(1);
+    PredicatesParser *secondJoin = (PredicatesParser *) query.getPredicates()->getItemInPos(2);
+    PredicatesParser *filter = (PredicatesParser *) query.getPredicates()->getItemInPos(3);
+
+    double rows[3];
+
+    for(unsigned int alias = 0; alias < 3; alias++)
+        rows[alias] = ((Table *) tables->getItemInPos(query.getRelationInPos(alias) + 1))->getNumOfTuples();
+
+    // No thread has executed a job yet
+    TEST_ASSERT(jobScheduler->getBusyTime() == 0);
+
+    QueryExplanation explanation(&query, tables, AnalyzeExplain, jobScheduler);
+
+    // A filter keeps its estimated share of the rows of its alias
+    double selectivity = 0.5;
+    explanation.beginFilters(1, &filter, &selectivity);
+    explanation.endStep(100);
+
+    // A join combines the estimated rows of its two sides
+    JoinStatistics statistics;
+    statistics.hashTablesNum = 1;
+    statistics.largestHashTableSize = 100;
+
+    explanation.beginJoin(firstJoin, 0.01, false);
+    explanation.endStep(300, statistics);
+
+    // A repeated join keeps the rows of its intermediate result
+    explanation.beginJoin(firstJoin, 0.01, true);
+    explanation.endStep(300);
+
+    // After the reordering the steps are estimated from the actual rows
+    double actualRows[3] = {300, 300, rows[2]};
+    explanation.reoptimize(actualRows);
+
+    explanation.beginJoin(secondJoin, 0.001, false);
+    explanation.endStep(1000, statistics);
+
+    List *steps = explanation.getSteps();
+    TEST_ASSERT(steps->getCounter() == 4);
+
+    ExplainedStep *step = (ExplainedStep *) steps->getItemInPos(1);
+    TEST_ASSERT(strcmp(step->description, "0.2>3499") == 0);
+    TEST_ASSERT(fabs(step->estimatedRows - rows[0] * 0.5) < 0.001);
+    TEST_ASSERT(step->actualRows == 100);
+    TEST_ASSERT(step->milliseconds >= 0);
+
+    step = (ExplainedStep *) steps->getItemInPos(2);
+    TEST_ASSERT(strcmp(step->description, "0.2=1.0") == 0);
+    TEST_ASSERT(fabs(step->estimatedRows - rows[0] * 0.5 * rows[1] * 0.01) < 0.001);
+    TEST_ASSERT(step->joinStatistics.largestHashTableSize == 100);
+
+    step = (ExplainedStep *) steps->getItemInPos(3);
+    TEST_ASSERT(fabs(step->estimatedRows - rows[0] * 0.5 * rows[1] * 0.01) < 0.001);
+    TEST_ASSERT(step->precedesReoptimization);
+    TEST_ASSERT(step->joinStatistics.hashTablesNum == 0);
+
+    step = (ExplainedStep *) steps->getItemInPos(4);
+    TEST_ASSERT(strcmp(step->description, "0.1=2.0") == 0);
+    TEST_ASSERT(fabs(step->estimatedRows - 300 * rows[2] * 0.001) < 0.001);
+    TEST_ASSERT(step->precedesReoptimization == false);
+    TEST_ASSERT(step->threadUtilization == 0);
+
+    delete jobScheduler;
+
+    tables->traverseFromHead(deleteTable);
+    delete tables;
 }
 
 /***************************************************************************
@@ -2149,6 +4604,22 @@ TEST_LIST = {
     { "Position of first ace in Bitmap", test_posOfFirstAce},
     { "Position of first ace from given position in Bitmap", test_posOfFirstAce_from_Pos},
     { "Reset and resize Bitmap", test_reset_and_resize},
+    { "Bloom Filter", bloomFilterTest},
+    // Column Statistics testing
+    { "Uniform Sampling Statistics", uniformSamplingStatisticsTest},
+    { "Block Sampling Statistics", blockSamplingStatisticsTest},
+    { "Background Refinement Of Statistics", backgroundRefinementStatisticsTest},
+    // Compressed Column testing
+    { "Frame Of Reference Compression", frameOfReferenceCompressionTest},
+    { "Dictionary Compression", dictionaryCompressionTest},
+    { "Compressed Table", compressedTableTest},
+    // Zone Map testing
+    { "Zone Map Ranges", zoneMapRangesTest},
+    { "Zone Map Filter", zoneMapFilterTest},
+    { "Fused Filter", fusedFilterTest},
+    // Column Index testing
+    { "Column Index Lookup", columnIndexLookupTest},
+    { "Index Nested Loop Join", indexNestedLoopJoinTest},
     // Filereader testing
     { "Reading Configuration File", read_config_test},
     { "Reading Init File", read_init_file_test},
@@ -2156,6 +4627,7 @@ TEST_LIST = {
     { "Hash Insert",  insertWithoutRehashTest},
     { "Hash Rehash",  rehashTest},
     { "Hash Bulk Search",  bulkSearchTest},
+    { "Hash Exact Size",  exactSizeTest},
     // Intermediate Array
     { "Intermediate Array Search", testIntermediateArraySearch},
     { "Intermediate Array Execute Join With Foreign Relation", testExecuteJoinWithForeignRelation},
@@ -2177,9 +4649,29 @@ TEST_LIST = {
     { "List Append", testAppend},
     // Partitioned Hash Join Testing
     { "Partitioned Hash Join", partitionedHashJoinTest},
+    { "Build Side Cache", buildSideCacheTest},
+    { "Sideways Filter", sidewaysFilterTest},
+    { "Parallel Subjoins", parallelSubjoinsTest},
+    { "Heavy Hitters", heavyHittersTest},
+    { "Bucket Batches", bucketBatchesTest},
+    { "Scratch Arena", scratchArenaTest},
+    { "Wide Counts", wideCountsTest},
+    { "Hash Functions", hashFunctionsTest},
+    { "Partition Tuning", partitionTuningTest},
+    { "Sort Merge Join", sortMergeJoinTest},
+    { "Array Join", arrayJoinTest},
     // Query
     { "Predicates Parser Test", predicatesParserTest},
     { "Projections Parser Test", projectionsParserTest},
+    // Query Optimization
+    { "Join Enumerator", joinEnumeratorTest},
+    { "Query Optimizer Concurrency", queryOptimizerConcurrencyTest},
+    { "Plan Cache", planCacheTest},
+    { "Cost Model", costModelTest},
+    { "Reoptimization", reoptimizationTest},
+    { "Cardinality Feedback", cardinalityFeedbackTest},
+    { "Predicate Inference", predicateInferenceTest},
+    { "Query Explanation", queryExplanationTest},
     // Queue
     { "Queue Insert Test", queueInsertTest},
     { "Queue Remove Test", queueRemoveTest},
@@ -5,21 +5,29 @@
  * A function pointer used to store the user's compare function *
  ****************************************************************/
 
-static int (*userCompare)(void *, void *);
+static thread_local int (*userCompare)(void *, void *);
 
 /**************************************************************
  * Function pointers used to store the user's visit functions *
  **************************************************************/
 
-static void (*userVisitItems)(void *);
-static void (*userVisitKeys)(void *);
-static void (*userVisitBoth)(void *, void *);
+static thread_local void (*userVisitItems)(void *);
+static thread_local void (*userVisitKeys)(void *);
+static thread_local void (*userVisitBoth)(void *, void *);
 
 /*******************************************************
  * A function pointer used to store the user's actions *
  *******************************************************/
 
-static void (*userActions)(void *, void *);
+static thread_local void (*userActions)(void *, void *);
+
+/*************************************************************
+ * A function pointer used to store the user's actions that  *
+ * expect a context and a pointer used to store that context *
+ *************************************************************/
+
+static thread_local void (*userActionsWithContext)(void *, void *, void *);
+static thread_local void *userContext;
 
 /******************************************
  * Compare function of the implementation *
@@ -65,6 +73,16 @@ static void abImpActions(void *item)
 	userActions(ab_item->getItem(), ab_item->getKey());
 }
 
+/*********************************************************
+ * Passes the stored context to the user's actions along *
+ *             with the user's item and key              *
+ *********************************************************/
+
+static void abImpActionsWithContext(void *item, void *key)
+{
+	userActionsWithContext(item, key, userContext);
+}
+
 /******************************************
  * Destroy function of the implementation *
  ******************************************/
@@ -1567,6 +1585,30 @@ void AB_Tree::traverse(OrderOfTraversal traversalOrder, void (*actions)(void *,
 	traverseRec(root, traversalOrder, actions);
 }
 
+/**************************************************************
+ *  Does the same as the above 'traverse' operation, but the  *
+ * given 'context' is also passed to every call of the user's *
+ *               function as the third argument               *
+ **************************************************************/
+
+void AB_Tree::traverse(OrderOfTraversal traversalOrder,
+	void (*actions)(void *, void *, void *), void *context)
+{
+	/* We keep the previous actions and context in
+	 * case this traversal is nested in another one
+	 */
+	void (*previousActions)(void *, void *, void *) = userActionsWithContext;
+	void *previousContext = userContext;
+
+	userActionsWithContext = actions;
+	userContext = context;
+
+	traverseRec(root, traversalOrder, abImpActionsWithContext);
+
+	userActionsWithContext = previousActions;
+	userContext = previousContext;
+}
+
 /******************************************************************
  * Traverses recursively both the items and the keys of the given *
  *     node and all its children in the given traversal order     *
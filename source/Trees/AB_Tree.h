@@ -152,6 +152,14 @@ public:
 	 */
 	void traverse(OrderOfTraversal traversalOrder, void (*actions)(void *, void *));
 
+	/* Does the same as the above 'traverse' operation, but the given
+	 * 'context' is also passed to every call of the user's function as
+	 * the third argument. This way the user can gather information from
+	 * the tree without storing it in static variables.
+	 */
+	void traverse(OrderOfTraversal traversalOrder,
+		void (*actions)(void *, void *, void *), void *context);
+
 	/* Destroys every node from the tree */
 	void destroy();
 
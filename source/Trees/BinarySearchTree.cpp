@@ -5,8 +5,8 @@
  * Function pointers that store the user's visit functions *
  ***********************************************************/
 
-static void (*bstUserVisit)(void *);
-static void (*bstUserVisitBoth)(void *, void *);
+static thread_local void (*bstUserVisit)(void *);
+static thread_local void (*bstUserVisitBoth)(void *, void *);
 
 /*********************************************
  * The visit functions of the implementation *
@@ -20,7 +20,7 @@ static void bstImpVisitBoth(void *item);
  * Function pointer that stores the user's traverse function *
  *************************************************************/
 
-static void (*bstUserTraverse)(void *, void *);
+static thread_local void (*bstUserTraverse)(void *, void *);
 
 /***********************************************
  * The traverse function of the implementation *
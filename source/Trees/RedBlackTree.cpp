@@ -6,15 +6,15 @@
  * User & Implementation compare functions *
  *******************************************/
 
-static int (*rbtUserCompare)(void *, void *);
+static thread_local int (*rbtUserCompare)(void *, void *);
 static int rbtImpCompare(void *, void *);
 
 /*****************************************
  * User & Implementation visit functions *
  *****************************************/
 
-static void (*rbtUserVisit)(void *);
-static void (*rbtUserVisitBoth)(void *, void *);
+static thread_local void (*rbtUserVisit)(void *);
+static thread_local void (*rbtUserVisitBoth)(void *, void *);
 static void rbtImpVisitKeys(void *);
 static void rbtImpVisitColoredKeys(void *);
 static void rbtImpVisitBoth(void *, void *);
@@ -25,15 +25,25 @@ static void rbtImpVisitColoredBoth(void *, void *);
  * user and the implementation *
  *******************************/
 
-static void (*rbtUserTraverse)(void *, void *);
+static thread_local void (*rbtUserTraverse)(void *, void *);
 static void rbtImpTraverse(void *item);
 
+/*******************************
+ * Traverse operation (and its *
+ *  context) of the user that  *
+ *      expects a context      *
+ *******************************/
+
+static thread_local void (*rbtUserTraverseWithContext)(void *, void *, void *);
+static thread_local void *rbtUserContext;
+static void rbtImpTraverseWithContext(void *item, void *key);
+
 /*********************************
  * User color notation functions *
  *********************************/
 
-static void (*rbtUserRedNotation)();
-static void (*rbtUserBlackNotation)();
+static thread_local void (*rbtUserRedNotation)();
+static thread_local void (*rbtUserBlackNotation)();
 
 /************************************
  * Default color notation functions *
@@ -1235,6 +1245,40 @@ void RedBlackTree::traverse(OrderOfTraversal traversal_order,
 	BinaryTree::traverse(traversal_order, rbtImpTraverse);
 }
 
+/*************************************************************
+ * Does the same as the above 'traverse' operation, but the  *
+ * given 'context' is also passed to every call of 'actions' *
+ *                   as the third argument                   *
+ *************************************************************/
+
+void RedBlackTree::traverse(OrderOfTraversal traversal_order,
+	void (*actions)(void *, void *, void *), void *context)
+{
+	/* We keep the previous actions and context in
+	 * case this traversal is nested in another one
+	 */
+	void (*previousActions)(void *, void *, void *) = rbtUserTraverseWithContext;
+	void *previousContext = rbtUserContext;
+
+	rbtUserTraverseWithContext = actions;
+	rbtUserContext = context;
+
+	traverse(traversal_order, rbtImpTraverseWithContext);
+
+	rbtUserTraverseWithContext = previousActions;
+	rbtUserContext = previousContext;
+}
+
+/*****************************************************
+ * Passes the stored context to the user's 'actions' *
+ *    along with the user's original item and key    *
+ *****************************************************/
+
+void rbtImpTraverseWithContext(void *item, void *key)
+{
+	rbtUserTraverseWithContext(item, key, rbtUserContext);
+}
+
 /************************************************************
  * Operation that accesses the user's original item and key *
  * and calls the user's 'actions' operation by passing the  *
@@ -131,6 +131,12 @@ public:
 	void traverse(OrderOfTraversal traversal_order,
 		void (*actions)(void *, void *));
 
+/* Does the same as the above 'traverse' operation, but the given 'context'
+ * is also passed to every call of 'actions' as the third argument
+ */
+	void traverse(OrderOfTraversal traversal_order,
+		void (*actions)(void *, void *, void *), void *context);
+
 /* Removes every node from the tree */
 	void destroy();
 